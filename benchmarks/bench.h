@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_BENCH_H
+#define FTL_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/* Accumulating every measured result into a volatile forces the compiler to
+ * actually compute it; without this, whole benchmark bodies are liable to be
+ * optimized away.
+ */
+static volatile std::uint64_t bench_sink = 0;
+
+/**
+ * Times body and prints its cost in ns per call.
+ *
+ * body must return something convertible to uint64_t (its result is fed to
+ * the sink). Each benchmark is run three times after a warm-up round and the
+ * best time is reported, to dampen scheduling noise.
+ */
+template<typename F>
+void bench(const std::string& name, std::size_t iterations, F body) {
+	using clock = std::chrono::steady_clock;
+
+	for(std::size_t i = 0; i < iterations/10 + 1; ++i)
+		bench_sink += static_cast<std::uint64_t>(body());
+
+	double best = 0;
+	for(int rep = 0; rep < 3; ++rep) {
+		auto t0 = clock::now();
+		for(std::size_t i = 0; i < iterations; ++i)
+			bench_sink += static_cast<std::uint64_t>(body());
+
+		auto t1 = clock::now();
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			t1 - t0
+		).count();
+
+		double perOp = static_cast<double>(ns)/iterations;
+		if(rep == 0 || perOp < best)
+			best = perOp;
+	}
+
+	std::printf("%-44s %10.1f ns/op\n", name.c_str(), best);
+}
+
+#endif
+
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+
+/* Micro benchmarks of FTL's hot primitives.
+ *
+ * These complement the correctness suites in tests/: a change that keeps
+ * every test green can still, say, add an allocation to ftl::function or a
+ * branch to sum_type dispatch, and this is where such regressions show up.
+ * Compare ns/op figures before and after a change on the same machine;
+ * absolute numbers between machines are meaningless.
+ */
+
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ftl/functional.h>
+#include <ftl/lazy.h>
+#include <ftl/prelude.h>
+#include <ftl/sum_type.h>
+#include <ftl/vector.h>
+
+#include "../examples/parser_combinator/parser_combinator.h"
+#include "../examples/parser_combinator/static_parser.h"
+#include "../examples/parser_combinator/token_stream.h"
+#include "bench.h"
+
+int add(int x, int y) {
+	return x + y;
+}
+
+static void benchFunctionCall() {
+	// The volatile pointer is the baseline's analogue of bench_sink: it
+	// stops the calls from being inlined and constant folded.
+	int (* volatile raw)(int,int) = add;
+
+	ftl::function<int(int,int)> ff = add;
+	std::function<int(int,int)> sf = add;
+
+	bench("call: raw function pointer", 10000000, [&]{
+		return raw(1, 2);
+	});
+
+	bench("call: ftl::function", 10000000, [&]{
+		return ff(1, 2);
+	});
+
+	bench("call: std::function", 10000000, [&]{
+		return sf(1, 2);
+	});
+}
+
+static void benchCurry() {
+	auto curried = ftl::curry(add);
+
+	bench("curry: one argument at a time", 5000000, [&]{
+		return curried(1)(2);
+	});
+
+	bench("curry: all arguments at once", 5000000, [&]{
+		return curried(1, 2);
+	});
+}
+
+static void benchSumType() {
+	using ftl::sum_type;
+	using ftl::constructor;
+
+	std::vector<sum_type<int,char>> xs;
+	for(int i = 0; i < 256; ++i) {
+		if(i % 2 == 0)
+			xs.emplace_back(constructor<int>(), i);
+		else
+			xs.emplace_back(constructor<char>(), char(i));
+	}
+
+	size_t i = 0;
+	bench("sum_type: exhaustive match", 10000000, [&]{
+		auto& x = xs[i++ & 255];
+		return x.match(
+			[](int n){ return n; },
+			[](char c){ return int(c); }
+		);
+	});
+
+	// Columnar load: runs of 16 equal tags, as a row-group file would yield
+	std::vector<unsigned char> tags(4096);
+	std::vector<int> ints;
+	std::vector<char> chars;
+	for(size_t j = 0; j < tags.size(); ++j) {
+		tags[j] = (j / 16) % 2;
+		if(tags[j] == 0)
+			ints.push_back(int(j));
+		else
+			chars.push_back(char(j));
+	}
+
+	bench("sum_type: columnar load, element-wise [4096]", 10000, [&]{
+		std::vector<sum_type<int,char>> v;
+		v.reserve(tags.size());
+
+		size_t ni = 0, nc = 0;
+		for(auto t : tags) {
+			if(t == 0)
+				v.emplace_back(constructor<int>(), ints[ni++]);
+			else
+				v.emplace_back(constructor<char>(), chars[nc++]);
+		}
+
+		return v.size();
+	});
+
+	bench("sum_type: columnar load, fromColumns [4096]", 10000, [&]{
+		auto v = ftl::fromColumns(
+			tags.data(), tags.size(), ints.data(), chars.data()
+		);
+
+		return v.size();
+	});
+}
+
+static void benchLazy() {
+	bench("lazy: construct and force", 2000000, []{
+		ftl::lazy<int> l{[](){ return 42; }};
+		return *l;
+	});
+
+	ftl::lazy<int> forced{[](){ return 42; }};
+	*forced;
+
+	bench("lazy: access already forced value", 10000000, [&]{
+		return *forced;
+	});
+}
+
+static void benchContainers() {
+	using ftl::operator%;
+
+	std::vector<int> v(1000);
+	std::iota(v.begin(), v.end(), 0);
+
+	bench("vector: fmap [1000 ints]", 50000, [&]{
+		auto v2 = [](int x){ return 2*x; } % v;
+		return v2.back();
+	});
+
+	bench("vector: foldMap sum [1000 ints]", 50000, [&]{
+		return static_cast<int>(ftl::foldMap(ftl::sum<int>, v));
+	});
+
+	bench("vector: concatMap [1000 ints -> 2000]", 20000, [&]{
+		auto v2 = ftl::concatMap(
+			[](int x){ return std::vector<int>{x, -x}; }, v
+		);
+		return v2.back();
+	});
+}
+
+/* A replica of the grammar in examples/parser_combinatorics.cpp, so the
+ * figure tracks what a user of the combinators actually experiences.
+ */
+namespace {
+	int string2int(const std::string& str) {
+		return std::stoi(str);
+	}
+
+	template<typename T>
+	parser<T> option(parser<T> p, T&& t) {
+		using ftl::operator|;
+
+		return p | ftl::monad<parser<T>>::pure(std::forward<T>(t));
+	}
+
+	parser<int> parseNatural() {
+		using ftl::operator%;
+
+		return string2int % many1(oneOf("0123456789"));
+	}
+
+	parser<std::string> whitespace() {
+		return many1(oneOf(" \t\r\n"));
+	}
+
+	std::vector<int> cons(int n, std::vector<int> v) {
+		v.insert(v.begin(), n);
+		return v;
+	}
+
+	parser<std::vector<int>> parseList() {
+		using namespace ftl;
+
+		return curry(cons)
+			% (parseNatural())
+			* option(
+				whitespace() >> ::lazy(parseList),
+				std::vector<int>());
+	}
+
+	parser<std::vector<int>> parseLispList() {
+		using namespace ftl;
+		return parseChar('(') >> parseList() << parseChar(')');
+	}
+}
+
+/* The same grammar once more, in the statically typed combinator tier.
+ * Each rule is one concrete expression type; erasure happens only at the
+ * compile() boundary and at the recursion point.
+ */
+namespace {
+	parser<std::vector<int>> staticList() {
+		static const parser<std::vector<int>> self = sp::compile(
+			sp::liftA2(
+				cons,
+				string2int % sp::many1(sp::oneOf("0123456789")),
+				sp::option(
+					sp::many1(sp::oneOf(" \t\r\n"))
+						>> sp::lazy(&staticList),
+					std::vector<int>()
+				)
+			)
+		);
+
+		return self;
+	}
+
+	parser<std::vector<int>> staticLispList() {
+		return sp::compile(
+			sp::parseChar('(')
+				>> sp::wrap(staticList())
+				<< sp::parseChar(')')
+		);
+	}
+}
+
+/* And once more over a token stream: the lexer does one table-driven scan,
+ * whitespace and all, and the grammar dispatches on whole tokens.
+ */
+namespace {
+	enum lisp_tokens { tkNumber = 1, tkLParen, tkRParen };
+
+	tok::lexer lispLexer() {
+		tok::lexer lx;
+		lx.skip(" \t\r\n");
+		lx.literal('(', tkLParen).literal(')', tkRParen);
+		lx.char_class("0123456789", "0123456789", tkNumber);
+		return lx;
+	}
+
+	template<typename T>
+	tok::tparser<T> tokOption(tok::tparser<T> p, T&& t) {
+		using ftl::operator|;
+
+		return p | ftl::monad<tok::tparser<T>>::pure(std::forward<T>(t));
+	}
+
+	tok::tparser<std::vector<int>> tokList() {
+		using namespace ftl;
+
+		return curry(cons)
+			% (string2int % tok::lexeme(tkNumber, "number"))
+			* tokOption(tok::lazy(&tokList), std::vector<int>());
+	}
+
+	tok::tparser<std::vector<int>> tokLispList() {
+		using namespace ftl;
+
+		return tok::match(tkLParen, "'('")
+			>> tokList()
+			<< tok::match(tkRParen, "')'");
+	}
+}
+
+static void benchParser() {
+	std::ostringstream oss;
+	oss << "(1";
+	for(int i = 2; i <= 100; ++i)
+		oss << " " << i;
+	oss << ")";
+
+	auto input = oss.str();
+	auto p = parseLispList();
+
+	bench("parser: lisp list of 100 naturals", 5000, [&]{
+		parser_input in{input};
+		auto r = run(p, in);
+		return (*r).size();
+	});
+
+	auto ps = staticLispList();
+
+	bench("parser: lisp list, static tier", 5000, [&]{
+		parser_input in{input};
+		auto r = run(ps, in);
+		return (*r).size();
+	});
+
+	auto lx = lispLexer();
+	auto pt = tokLispList();
+
+	// Includes the lexing pass, for an honest end-to-end comparison
+	bench("parser: lisp list, token stream", 5000, [&]{
+		parser_input in{input};
+		auto r = tok::run(lx, pt, in);
+		return (*r).size();
+	});
+}
+
+namespace {
+	// parseList with the shared natural rule passed in, so it can be
+	// memoized through a session
+	parser<std::vector<int>> parseListOf(parser<int> nat) {
+		using namespace ftl;
+
+		function<parser<std::vector<int>>()> self = [nat]() {
+			return parseListOf(nat);
+		};
+
+		return curry(cons)
+			% nat
+			* option(
+				whitespace() >> ::lazy(self),
+				std::vector<int>());
+	}
+}
+
+/* The interesting comparison is between the two memoized variants: the
+ * grammar and the per-run work are identical, only where the memo entries'
+ * storage comes from differs.
+ */
+static void benchParserSession() {
+	std::ostringstream oss;
+	oss << "(1";
+	for(int i = 2; i <= 100; ++i)
+		oss << " " << i;
+	oss << ")";
+
+	auto input = oss.str();
+
+	using ftl::operator>>;
+	using ftl::operator<<;
+
+	auto heapNat = memoize(parseNatural());
+	auto heapP = parseChar('(') >> parseListOf(heapNat) << parseChar(')');
+
+	bench("parser: packrat memo, heap tables", 5000, [&]{
+		parser_input in{input};
+		auto r = run(heapP, in);
+		return (*r).size();
+	});
+
+	parser_session session;
+	auto nat = session.memoize(parseNatural());
+	auto p = parseChar('(') >> parseListOf(nat) << parseChar(')');
+
+	// Steady state: every memo entry recycles through the session's pool
+	bench("parser: packrat memo, pooled session", 5000, [&]{
+		parser_input in{input};
+		auto r = session.run(p, in);
+		return (*r).size();
+	});
+}
+
+/* One-shot parsing of a pre-framed batch vs feeding the same bytes through
+ * the incremental driver in small chunks. The delta is the cost of the
+ * stream_parser bookkeeping plus re-parsing whatever value straddles each
+ * chunk boundary.
+ */
+static void benchStreamParser() {
+	std::ostringstream oss;
+	for(int l = 0; l < 100; ++l) {
+		oss << "(1";
+		for(int i = 2; i <= 20; ++i)
+			oss << " " << i;
+		oss << ")";
+	}
+
+	auto input = oss.str();
+	auto p = parseLispList();
+
+	bench("parser: 100 lists, one-shot batch", 2000, [&]{
+		size_t total = 0;
+		parser_input in{input};
+
+		while(in.tell() < in.size()) {
+			auto r = run(p, in);
+			if(!r)
+				break;
+
+			total += (*r).size();
+		}
+
+		return total;
+	});
+
+	bench("parser: 100 lists, streamed in 64B chunks", 2000, [&]{
+		stream_parser<std::vector<int>> sp{p};
+
+		size_t total = 0;
+		auto keep = [&total](std::vector<int> v) {
+			total += v.size();
+		};
+
+		for(size_t i = 0; i < input.size(); i += 64) {
+			auto n = input.size() - i < 64 ? input.size() - i : 64;
+			sp.feed(input.data() + i, n, keep);
+		}
+
+		sp.finish(keep);
+
+		return total;
+	});
+}
+
+int main(int, char**) {
+	benchFunctionCall();
+	benchCurry();
+	benchSumType();
+	benchLazy();
+	benchContainers();
+	benchParser();
+	benchParserSession();
+	benchStreamParser();
+
+	return 0;
+}
+
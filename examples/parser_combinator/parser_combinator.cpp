@@ -1,75 +1,161 @@
-#include "parser_combinator.h" 
+#include "parser_combinator.h"
+#include <istream>
+#include <iterator>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+parser_input parser_input::from_file(const std::string& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("cannot open '" + path + "'");
+
+	struct stat st;
+	if(::fstat(fd, &st) < 0) {
+		::close(fd);
+		throw std::runtime_error("cannot stat '" + path + "'");
+	}
+
+	auto size = static_cast<size_t>(st.st_size);
+
+	// Zero length mappings are invalid; an empty file is simply an
+	// empty input
+	if(size == 0) {
+		::close(fd);
+		return parser_input(nullptr, 0);
+	}
+
+	void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping holds its own reference to the file
+	::close(fd);
+
+	if(mapping == MAP_FAILED)
+		throw std::runtime_error("cannot map '" + path + "'");
+
+	parser_input in(static_cast<const char*>(mapping), size);
+	in.owner_ = std::shared_ptr<const void>(
+		mapping,
+		[size](const void* p) {
+			::munmap(const_cast<void*>(p), size);
+		}
+	);
+
+	return in;
+}
+
+parser_input parser_input::from_stream(std::istream& is) {
+	auto buffer = std::make_shared<std::string>(
+		std::istreambuf_iterator<char>(is),
+		std::istreambuf_iterator<char>()
+	);
+
+	parser_input in(buffer->data(), buffer->size());
+	in.owner_ = buffer;
+
+	return in;
+}
+
+namespace {
+	std::vector<std::weak_ptr<memo_table_base>>& memo_registry() {
+		static std::vector<std::weak_ptr<memo_table_base>> tables;
+		return tables;
+	}
+}
+
+void register_memo_table(std::shared_ptr<memo_table_base> table) {
+	memo_registry().push_back(std::move(table));
+}
+
+void reset_memo_tables() {
+	auto& tables = memo_registry();
+
+	// Also drop tables whose parsers no longer exist
+	auto it = tables.begin();
+	while(it != tables.end()) {
+		if(auto table = it->lock()) {
+			table->clear();
+			++it;
+		}
+		else {
+			it = tables.erase(it);
+		}
+	}
+}
 
 parser<char> anyChar() {
-	return parser<char>([](std::istream& s) {
+	return parser<char>([](parser_input& s) {
 		char ch;
 		if(s.get(ch)) {
 			return yield(ch);
 		}
 
-		return fail<char>("any character");
+		return fail<char>(s.tell(), error::expectation::anyChar());
 	});
 }
 
 parser<char> parseChar(char c) {
-	return parser<char>{[c](std::istream& s) {
-		if(s) {
-			char ch = s.peek();
-			if(ch == c) {
-				// Don't forget to acutally eat a char from the stream too
-				s.get();
-				return yield(c);
-			}
+	return parser<char>{[c](parser_input& s) {
+		// Compare as unsigned so a negative char never matches EOF (-1)
+		if(s.peek() == static_cast<unsigned char>(c)) {
+			s.get();
+			return yield(c);
 		}
 
-		std::ostringstream oss;
-		oss << "'" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(s.tell(), error::expectation::lit(c));
 	}};
 }
 
 parser<char> notChar(char c) {
-	return parser<char>([c](std::istream& s) {
-		if(s) {
-			char ch = s.peek();
-			if(ch != c) {
-				s.get();
-				return yield(ch);
-			}
+	return parser<char>([c](parser_input& s) {
+		int ch = s.peek();
+		if(ch >= 0 && ch != static_cast<unsigned char>(c)) {
+			s.get();
+			return yield(static_cast<char>(ch));
 		}
 
-		std::ostringstream oss;
-		oss << "any character but '" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(s.tell(), error::expectation::excluding(c));
 	});
 }
 
 parser<char> oneOf(std::string str) {
-	return parser<char>{[str](std::istream& s) {
-		if(s) {
-			char peek = s.peek();
-			auto pos = str.find(peek);
+	// The set is rendered into the failure message only on demand, so it
+	// is built once here and shared with every failure record
+	auto set = std::make_shared<const std::string>(std::move(str));
+
+	return parser<char>{[set](parser_input& s) {
+		int peek = s.peek();
+		if(peek >= 0) {
+			auto pos = set->find(static_cast<char>(peek));
 			if(pos != std::string::npos) {
 				s.get();
-				return yield(peek);
+				return yield(static_cast<char>(peek));
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "one of \"" << str << "\"";
-		return fail<char>(oss.str());
+		return fail<char>(s.tell(), error::expectation::in(set));
 	}};
 }
 
 parser<std::string> many(parser<char> p) {
-	return parser<std::string>([p](std::istream& s) {
-		auto r = (*p)(s);
+	return parser<std::string>([p](parser_input& s) {
 		std::ostringstream oss;
+
+		// Rewinding a failed attempt is a mere integer copy, so many can
+		// afford to backtrack even parsers that consume before failing
+		auto pos = s.tell();
+		auto r = (*p)(s);
 		while(r) {
 			oss << *r;
+			pos = s.tell();
 			r = (*p)(s);
 		}
+		s.seek(pos);
 
 		return yield(oss.str());
 	});
@@ -80,7 +166,7 @@ parser<std::string> many1(parser<char> p) {
 
 	// Run p once normally, bind with what's essentially "many"
 	return p >>= [p](char t) {
-		return parser<std::string>([p,t](std::istream& strm) {
+		return parser<std::string>([p,t](parser_input& strm) {
 			auto r = (*many(p))(strm);
 			if(r) {
 				r->insert(r->begin(), t);
@@ -94,4 +180,3 @@ parser<std::string> many1(parser<char> p) {
 		});
 	};
 }
-
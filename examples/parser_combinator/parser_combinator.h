@@ -1,47 +1,205 @@
+#include <map>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
 #include <ftl/either_trans.h>
 #include <ftl/functional.h>
+#include <ftl/memory.h>
 
 #ifndef PARSER_GEN_H
 #define PARSER_GEN_H
 
 /**
  * Error reporting class.
- * 
- * We could have used a string directly, but this thin wrapper conveys more
- * semantic information to users of the library.
+ *
+ * A failure is recorded as a cheap position-plus-expectation record; the
+ * human readable message is rendered only if message() is actually called.
+ * Backtracking-heavy grammars construct and throw away a failure per
+ * rejected alternative, so the record must cost next to nothing: an
+ * expectation is a tag, a character, and&mdash;for character sets and
+ * custom messages&mdash;a pointer to a string that is built once when the
+ * grammar is constructed, not per failure.
  */
 class error {
 public:
-	// Default versions of c-tors default, copy, and move are acceptable
+	/// What a failed parser expected at the point of failure.
+	struct expectation {
+		enum kind_t {
+			nothing,   ///< Unused slot
+			any,       ///< Any character (failed at end of input)
+			char_lit,  ///< One specific character
+			not_char,  ///< Any character but one
+			one_of,    ///< A character from a set
+			custom     ///< Pre-rendered message
+		};
+
+		kind_t kind = nothing;
+		char c = '\0';
+
+		// Shared with the closure that produced the failure; copying an
+		// expectation never copies characters
+		std::shared_ptr<const std::string> text{};
+
+		// In-class member initializers make this a non-aggregate in
+		// C++11, hence factories over brace initialization
+		static expectation anyChar() noexcept {
+			expectation e;
+			e.kind = any;
+			return e;
+		}
+
+		static expectation lit(char c) noexcept {
+			expectation e;
+			e.kind = char_lit;
+			e.c = c;
+			return e;
+		}
+
+		static expectation excluding(char c) noexcept {
+			expectation e;
+			e.kind = not_char;
+			e.c = c;
+			return e;
+		}
+
+		static expectation in(std::shared_ptr<const std::string> set) noexcept {
+			expectation e;
+			e.kind = one_of;
+			e.text = std::move(set);
+			return e;
+		}
+
+		static expectation message(std::string msg) {
+			expectation e;
+			e.kind = custom;
+			e.text = std::make_shared<const std::string>(std::move(msg));
+			return e;
+		}
+
+		/// Render this expectation as human readable text.
+		std::string render() const {
+			switch(kind) {
+			case any:      return "any character";
+			case char_lit: return std::string("'") + c + "'";
+			case not_char:
+				return std::string("any character but '") + c + "'";
+			case one_of:   return "one of \"" + *text + "\"";
+			case custom:   return *text;
+			default:       return "";
+			}
+		}
+
+		bool operator== (const expectation& other) const noexcept {
+			return kind == other.kind && c == other.c
+				&& text == other.text;
+		}
+	};
+
+	/// Alternatives tracked per error; further ones are dropped on merge.
+	static constexpr size_t max_expectations = 4;
+
+	/// The empty error; carries no expectations.
+	error() = default;
+
+	/**
+	 * Construct from a string error message.
+	 *
+	 * This renders eagerly&mdash;the string is copied into shared storage
+	 * up front&mdash;so reserve it for one-off failures; hot rejection
+	 * paths should carry an expectation record instead.
+	 */
+	explicit error(const std::string& msg)
+	: n(1) {
+		exps[0] = expectation::message(msg);
+	}
+
+	/// \overload
+	explicit error(std::string&& msg)
+	: n(1) {
+		exps[0] = expectation::message(std::move(msg));
+	}
+
+	/// Construct from a failure position and what was expected there
+	error(size_t pos, expectation e) noexcept
+	: pos(pos), n(1) {
+		exps[0] = std::move(e);
+	}
 
-	/// Construct from string error message
-	explicit error(const std::string& msg) noexcept : e(msg) {}
-	explicit error(std::string&& msg) noexcept : e(std::move(msg)) {}
+	/**
+	 * Render the error message.
+	 *
+	 * This is the only point where message strings are put together;
+	 * until here, a failure is just its record.
+	 */
+	std::string message() const {
+		std::string msg;
+		for(size_t i = 0; i < n; ++i) {
+			if(i > 0)
+				msg += " or ";
+
+			msg += exps[i].render();
+		}
+
+		return msg;
+	}
+
+	/// Input position the failure occurred at
+	size_t position() const noexcept {
+		return pos;
+	}
+
+	/// Whether this is the empty error
+	bool empty() const noexcept {
+		return n == 0;
+	}
+
+	/**
+	 * Merge two failures.
+	 *
+	 * The failure that got further into the input wins outright; at equal
+	 * positions, the expectations are combined (up to capacity), so the
+	 * rendered message reads "a or b" like alternation suggests.
+	 */
+	static error merge(const error& e1, const error& e2) {
+		if(e1.empty() || e1.pos < e2.pos)
+			return e2;
+
+		if(e2.empty() || e2.pos < e1.pos)
+			return e1;
+
+		error e{e1};
+		for(size_t i = 0; i < e2.n; ++i) {
+			if(e.n == max_expectations)
+				break;
+
+			bool dup = false;
+			for(size_t j = 0; j < e.n; ++j)
+				dup = dup || e.exps[j] == e2.exps[i];
+
+			if(!dup)
+				e.exps[e.n++] = e2.exps[i];
+		}
 
-	/// Access the error message
-	std::string message() const noexcept {
 		return e;
 	}
 
 private:
-	std::string e;
+	size_t pos = 0;
+	size_t n = 0;
+	expectation exps[max_expectations];
 };
 
 namespace ftl {
 	template<>
 	struct monoid<error> {
 		static error id() {
-			return error(std::string(""));
+			return error();
 		}
 
 		static error append(const error& e1, const error& e2) {
-			if(e1.message().empty())
-				return error(e2.message());
-			if(e2.message().empty())
-				return error(e1.message());
-
-			return error(e1.message() + " or " + e2.message());
+			return error::merge(e1, e2);
 		}
 
 		static constexpr bool instance = true;
@@ -54,32 +212,540 @@ ftl::either<error,T> fail(const std::string& s) {
 	return ftl::make_left<T>(error(s));
 }
 
+/**
+ * \overload
+ *
+ * The cheap form: records where the parse failed and what was expected,
+ * without rendering any message.
+ */
+template<typename T>
+ftl::either<error,T> fail(size_t pos, error::expectation e) {
+	return ftl::make_left<T>(error(pos, std::move(e)));
+}
+
 /// Convenience function to reduce template gibberish
 template<typename T>
 auto yield(T&& t) -> decltype(ftl::make_right<error>(std::forward<T>(t))) {
 	return ftl::make_right<error>(std::forward<T>(t));
 }
 
+/**
+ * The input parsers consume: a read-only, in-memory span of characters.
+ *
+ * Compared to pulling characters out of a std::istream, every operation here
+ * is a pointer or integer manipulation&mdash;no virtual calls, no sentry
+ * objects, no stream state flags. In particular, saving and restoring the
+ * position for backtracking is a plain integer copy.
+ *
+ * The span itself is not owned unless the input was created by one of the
+ * \c from_file / \c from_stream factories; when constructed from a string or
+ * a raw buffer, the caller must keep the characters alive for as long as the
+ * input is used.
+ */
+class parser_input {
+public:
+	using position = size_t;
+
+	parser_input() = delete;
+	parser_input(const parser_input&) = default;
+	parser_input(parser_input&&) = default;
+
+	/// View a raw buffer. Does not take ownership.
+	parser_input(const char* data, size_t size)
+	: data_(data), size_(size), pos_(0) {}
+
+	/// View a string. The string must outlive the input.
+	explicit parser_input(const std::string& s)
+	: data_(s.data()), size_(s.size()), pos_(0) {}
+
+	parser_input& operator= (const parser_input&) = default;
+	parser_input& operator= (parser_input&&) = default;
+
+	/**
+	 * Memory-map the given file and parse straight out of the mapping.
+	 *
+	 * No characters are copied; the kernel pages the file in as the parser
+	 * advances. The mapping is unmapped when the last copy of the returned
+	 * input is destroyed.
+	 *
+	 * Throws std::runtime_error if the file cannot be opened or mapped.
+	 */
+	static parser_input from_file(const std::string& path);
+
+	/// Read the entire stream into an internal buffer.
+	static parser_input from_stream(std::istream& is);
+
+	/// Whether the end of the input has been reached
+	bool eof() const noexcept {
+		return pos_ == size_;
+	}
+
+	/// Next character without consuming it, or -1 at end of input
+	int peek() const noexcept {
+		return pos_ < size_
+			? static_cast<unsigned char>(data_[pos_])
+			: -1;
+	}
+
+	/// Consume and return the next character, or -1 at end of input
+	int get() noexcept {
+		return pos_ < size_
+			? static_cast<unsigned char>(data_[pos_++])
+			: -1;
+	}
+
+	/// Consume the next character into c. Returns false at end of input.
+	bool get(char& c) noexcept {
+		if(pos_ == size_)
+			return false;
+
+		c = data_[pos_++];
+		return true;
+	}
+
+	/// Current position, for later use with seek()
+	position tell() const noexcept {
+		return pos_;
+	}
+
+	/// Backtrack (or skip) to a position previously obtained from tell()
+	void seek(position p) noexcept {
+		pos_ = p;
+	}
+
+	/// Total size of the input, in characters
+	size_t size() const noexcept {
+		return size_;
+	}
+
+	/**
+	 * Direct read access to the underlying characters.
+	 *
+	 * `data()[tell()]` is the next character to be consumed. Intended for
+	 * bulk operations&mdash;lexing, lexeme extraction&mdash;that would
+	 * otherwise pay a call per character.
+	 */
+	const char* data() const noexcept {
+		return data_;
+	}
+
+private:
+	// Keeps a mapping or buffer alive for inputs that own their characters
+	std::shared_ptr<const void> owner_;
+
+	const char* data_;
+	size_t size_;
+	position pos_;
+};
+
 /**
  * A parser of Ts.
  *
  * This is the central data type of the library.
  *
  * \par Concepts
- * \li Monad 
+ * \li Monad
  * \li MonoidAlternative
  */
 template<typename T>
-using parser = ftl::eitherT<error,ftl::function<T(std::istream&)>>;
+using parser = ftl::eitherT<error,ftl::function<T(parser_input&)>>;
+
+/**
+ * Base class of the type erased, per-rule memo tables.
+ *
+ * Each \c memoize'd rule owns one table; this interface only exists so the
+ * library can clear every table when a new parse is started.
+ */
+class memo_table_base {
+public:
+	virtual ~memo_table_base() {}
+
+	/// Drop all memoized results.
+	virtual void clear() = 0;
+};
+
+/**
+ * Registers a memo table to be cleared by reset_memo_tables().
+ *
+ * Called by \c memoize; users should not need to call this themselves.
+ */
+void register_memo_table(std::shared_ptr<memo_table_base> table);
+
+/**
+ * Clears every registered memo table.
+ *
+ * Memoized results are only valid for a single input, so \c run calls this
+ * before handing the input to the parser.
+ */
+void reset_memo_tables();
+
+/**
+ * Memo table of a single rule, indexed by input position.
+ *
+ * An entry records where the rule left the input and what it produced, so
+ * a later visit to the same position can skip the parse entirely.
+ */
+template<typename T>
+class memo_table : public memo_table_base {
+public:
+	using entry = std::pair<parser_input::position,ftl::either<error,T>>;
+
+	void clear() {
+		entries.clear();
+	}
+
+	std::map<parser_input::position,entry> entries;
+};
+
+/**
+ * Makes p a backtracking parser.
+ *
+ * If p fails, the input is rewound to where p started, regardless of how
+ * much of it p consumed before failing. This makes alternation with
+ * operator| safe for alternatives that fail more than one character deep.
+ */
+template<typename T>
+parser<T> attempt(parser<T> p) {
+	return parser<T>{[p](parser_input& s) {
+		auto pos = s.tell();
+		auto r = (*p)(s);
+		if(!r)
+			s.seek(pos);
+
+		return r;
+	}};
+}
+
+/**
+ * Packrat memoization of p.
+ *
+ * The returned parser records its result&mdash;success or failure&mdash;per
+ * starting position, so no matter how often backtracking revisits a
+ * position, the rule is parsed there at most once. With every rule
+ * memoized, parsing is linear in the input size even for grammars whose
+ * naive backtracking behaviour is exponential.
+ *
+ * Rule identity is the table created by this call. Hence, a rule must be
+ * constructed once and shared for the cache to pay off:
+ * \code
+ *   // One memoized "expr" rule used by both alternatives; the second
+ *   // alternative reuses the first one's parse of expr.
+ *   auto expr = memoize(parseExpr());
+ *   auto sum = attempt(expr << parseChar('+')) | expr;
+ * \endcode
+ *
+ * Like \c attempt, a memoized rule rewinds the input when it fails.
+ */
+template<typename T>
+parser<T> memoize(parser<T> p) {
+	auto table = std::make_shared<memo_table<T>>();
+	register_memo_table(table);
+
+	return parser<T>{[p,table](parser_input& s) {
+		auto pos = s.tell();
+
+		auto it = table->entries.find(pos);
+		if(it != table->entries.end()) {
+			s.seek(it->second.first);
+			return it->second.second;
+		}
+
+		auto r = (*p)(s);
+		if(!r)
+			s.seek(pos);
+
+		table->entries.emplace(pos, std::make_pair(s.tell(), r));
+
+		return r;
+	}};
+}
+
+/**
+ * Memo table drawing its entries from a shared pool.
+ *
+ * Functionally identical to \c memo_table, but the map nodes are allocated
+ * through an ftl::pool_allocator, so clearing the table between runs
+ * returns every node to a free list instead of the general purpose
+ * allocator. See \c parser_session.
+ */
+template<typename T>
+class pooled_memo_table : public memo_table_base {
+public:
+	using entry = std::pair<parser_input::position,ftl::either<error,T>>;
+	using allocator_type = ftl::pool_allocator<
+		std::pair<const parser_input::position,entry>
+	>;
+
+	explicit pooled_memo_table(const allocator_type& a)
+	: entries(std::less<parser_input::position>(), a) {}
+
+	void clear() {
+		entries.clear();
+	}
+
+	std::map<
+		parser_input::position, entry,
+		std::less<parser_input::position>, allocator_type
+	> entries;
+};
+
+/**
+ * A reusable parsing session with pooled memoization storage.
+ *
+ * Plain \c memoize gives packrat complexity, but its per-position entries
+ * are map nodes that \c run's table reset frees and the next parse
+ * reallocates. At tens of thousands of small documents per second, that
+ * steady-state churn on the general purpose allocator costs more than the
+ * parsing itself. A parser_session owns its memoized rules' tables and
+ * backs them with one ftl::pool_allocator: clearing a table between runs
+ * pushes every node onto the session's free list, and the next run pops
+ * them straight back. Once the pool has grown to the high-water mark of
+ * the grammar/input combination, running the same compiled parser against
+ * new inputs allocates nothing for memoization.
+ *
+ * \code
+ *   parser_session session;
+ *   auto expr = session.memoize(parseExpr());
+ *   auto grammar = ...; // combinators over expr, built once
+ *
+ *   for(const auto& doc : documents) {
+ *       parser_input in{doc};
+ *       auto r = session.run(grammar, in);
+ *       ...
+ *   }
+ * \endcode
+ *
+ * Rules memoized through a session must be run through that session.
+ * Like the pool underneath, a session is not synchronised; confine it,
+ * and the parsers built from it, to one thread.
+ */
+class parser_session {
+public:
+	explicit parser_session(size_t slab_blocks = 256)
+	: pool(slab_blocks) {}
+
+	// A session's pool is tied to the parsers built from it; copying
+	// would silently split them between two pools
+	parser_session(const parser_session&) = delete;
+	parser_session(parser_session&&) = default;
+	parser_session& operator= (const parser_session&) = delete;
+
+	/**
+	 * Session-scoped packrat memoization of p.
+	 *
+	 * Semantics are those of the free \c memoize, but the memo table
+	 * belongs to this session and its entries recycle through the
+	 * session's pool.
+	 */
+	template<typename T>
+	parser<T> memoize(parser<T> p) {
+		auto table = std::make_shared<pooled_memo_table<T>>(
+			typename pooled_memo_table<T>::allocator_type(pool)
+		);
+		tables.push_back(table);
+
+		return parser<T>{[p,table](parser_input& s) {
+			auto pos = s.tell();
+
+			auto it = table->entries.find(pos);
+			if(it != table->entries.end()) {
+				s.seek(it->second.first);
+				return it->second.second;
+			}
+
+			auto r = (*p)(s);
+			if(!r)
+				s.seek(pos);
+
+			table->entries.emplace(pos, std::make_pair(s.tell(), r));
+
+			return r;
+		}};
+	}
+
+	/**
+	 * Run a parser against a fresh input.
+	 *
+	 * Resets this session's memo tables&mdash;recycling their storage
+	 * &mdash;as well as the global registry, in case the grammar also
+	 * contains rules memoized outside the session.
+	 */
+	template<typename T>
+	ftl::either<error,T> run(parser<T> p, parser_input& in) {
+		for(auto& t : tables)
+			t->clear();
+
+		reset_memo_tables();
+		return (*p)(in);
+	}
+
+private:
+	ftl::pool_allocator<char> pool;
+	std::vector<std::shared_ptr<memo_table_base>> tables;
+};
 
 /**
  * Function for running parsers.
  */
 template<typename T>
+ftl::either<error,T> run(parser<T> p, parser_input& in) {
+	reset_memo_tables();
+	return (*p)(in);
+}
+
+/**
+ * \overload
+ *
+ * Convenience for stream based input: buffers the entire stream and parses
+ * the buffer.
+ */
+template<typename T>
 ftl::either<error,T> run(parser<T> p, std::istream& is) {
-	return (*p)(is);
+	auto in = parser_input::from_stream(is);
+	return run(p, in);
 }
 
+/**
+ * Incremental run mode: parse an unbounded stream chunk by chunk.
+ *
+ * A stream_parser applies a parser of top-level values repeatedly to an
+ * internal window of not yet consumed input. feed() appends a chunk and
+ * emits every value that completes; whatever remains&mdash;at most the
+ * current, still incomplete value&mdash;is retained and retried when the
+ * next chunk arrives. Retained memory is thus bounded by the backtrack
+ * window of the value in progress, not by the length of the stream.
+ *
+ * Two conditions make the driver wait for more input rather than commit:
+ * - the parser failed at the very end of the window, meaning it ran out
+ *   of characters rather than rejecting one, or
+ * - the parser succeeded but consumed the entire window, in which case a
+ *   greedy rule may have stopped at the chunk boundary instead of the
+ *   value's true end.
+ * finish() lifts both: remaining input must parse to completion, and a
+ * trailing partial value is reported as the error it is.
+ *
+ * Error positions are relative to the retained window; consumed() gives
+ * the absolute stream offset of the window's first character.
+ *
+ * \code
+ *   stream_parser<record> sp{parseRecord()};
+ *
+ *   while(socketHasData()) {
+ *       auto r = sp.feed(nextChunk(), [](record r){ handle(r); });
+ *       if(!r)
+ *           break;  // r.left() rejects the stream; see reset()
+ *   }
+ *
+ *   sp.finish([](record r){ handle(r); });
+ * \endcode
+ */
+template<typename T>
+class stream_parser {
+public:
+	explicit stream_parser(parser<T> p) : p(std::move(p)) {}
+
+	/**
+	 * Append a chunk and emit the top-level values that complete.
+	 *
+	 * `out` is invoked once per completed value, in input order. Yields
+	 * the number of values emitted, or the error if the parser rejected
+	 * input before the end of the window. After an error the offending
+	 * window is retained for inspection; feed more input or reset() to
+	 * resynchronise.
+	 */
+	template<typename F>
+	ftl::either<error,size_t> feed(const char* data, size_t size, F&& out) {
+		window.append(data, size);
+		return drain(out, false);
+	}
+
+	/// \overload
+	template<typename F>
+	ftl::either<error,size_t> feed(const std::string& chunk, F&& out) {
+		window.append(chunk);
+		return drain(out, false);
+	}
+
+	/**
+	 * Signal the end of the stream.
+	 *
+	 * Everything retained must now parse to completion: a value deferred
+	 * only because it reached the end of the window is emitted, and a
+	 * trailing partial value becomes an error.
+	 */
+	template<typename F>
+	ftl::either<error,size_t> finish(F&& out) {
+		return drain(out, true);
+	}
+
+	/// Number of retained characters: the current backtrack window
+	size_t buffered() const noexcept {
+		return window.size();
+	}
+
+	/// Absolute stream offset of the first retained character
+	size_t consumed() const noexcept {
+		return base;
+	}
+
+	/// Drop all retained input, e.g. to resynchronise after an error
+	void reset() {
+		window.clear();
+		base = 0;
+	}
+
+private:
+	template<typename F>
+	ftl::either<error,size_t> drain(F& out, bool at_end) {
+		size_t emitted = 0;
+
+		while(!window.empty()) {
+			parser_input in{window};
+
+			// Memoized positions are relative to a window that shifts
+			// between attempts
+			reset_memo_tables();
+
+			auto r = (*p)(in);
+
+			if(r) {
+				// Consuming the entire window may mean a greedy rule
+				// stopped at the chunk boundary, not at the value's end
+				if(in.eof() && !at_end)
+					break;
+
+				auto consumed_now = in.tell();
+
+				out(std::move(*r));
+				++emitted;
+
+				base += consumed_now;
+				window.erase(0, consumed_now);
+
+				// A parser that succeeds without consuming would emit
+				// forever; hand control back instead
+				if(consumed_now == 0)
+					break;
+
+				continue;
+			}
+
+			// Failing at the window's end means the value is merely
+			// incomplete
+			if(!at_end && r.left().position() >= window.size())
+				break;
+
+			return ftl::make_left<size_t>(std::move(r.left()));
+		}
+
+		return yield(emitted);
+	}
+
+	parser<T> p;
+	std::string window;
+	size_t base = 0;
+};
+
 /* What follows is a basic set of blocks that a user of the library can
  * combine with the various combinators available (operator||, monad instance,
  * applicative instance, functor instance).
@@ -88,14 +754,14 @@ ftl::either<error,T> run(parser<T> p, std::istream& is) {
 /**
  * Parses any one character.
  *
- * This parser can only fail if the end of stream has been reached.
+ * This parser can only fail if the end of input has been reached.
  */
 parser<char> anyChar();
 
 /**
  * Parses one specific character.
  *
- * This parser will fail if the next character in the stream is not equal
+ * This parser will fail if the next character in the input is not equal
  * to \c c.
  */
 parser<char> parseChar(char c);
@@ -110,7 +776,7 @@ parser<char> notChar(char c);
 /**
  * Parses one of the characters in str.
  *
- * This parser will fail if the next character in the stream does not appear
+ * This parser will fail if the next character in the input does not appear
  * in str.
  */
 parser<char> oneOf(std::string str);
@@ -118,7 +784,7 @@ parser<char> oneOf(std::string str);
 /**
  * Greedily parses 0 or more of p.
  *
- * This parser cannot fail. If end of stream is reached or p fails on the
+ * This parser cannot fail. If end of input is reached or p fails on the
  * first run, the result will be an empty string.
  */
 parser<std::string> many(parser<char> p);
@@ -137,7 +803,7 @@ parser<std::string> many1(parser<char> p);
  */
 template<typename T>
 parser<T> lazy(ftl::function<parser<T>()> f) {
-	return parser<T>([f](std::istream& is) {
+	return parser<T>([f](parser_input& is) {
 		return (*f())(is);
 	});
 }
@@ -145,7 +811,7 @@ parser<T> lazy(ftl::function<parser<T>()> f) {
 /// \overload
 template<typename T>
 parser<T> lazy(parser<T>(*f)()) {
-	return parser<T>([f](std::istream& is) {
+	return parser<T>([f](parser_input& is) {
 			return (*f())(is);
 	});
 }
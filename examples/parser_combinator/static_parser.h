@@ -0,0 +1,436 @@
+#include <string>
+#include <utility>
+#include <ftl/type_functions.h>
+#include "parser_combinator.h"
+
+#ifndef STATIC_PARSER_H
+#define STATIC_PARSER_H
+
+/**
+ * Statically typed combinator tier.
+ *
+ * The combinators in parser_combinator.h compose type erased
+ * ftl::function pieces: every sub-parser is an opaque indirect call, so
+ * the optimizer sees the grammar as a chain of black boxes. The
+ * combinators in this namespace instead return small concrete expression
+ * types&mdash;`sp::parseChar('(') >> p << sp::parseChar(')')` is one
+ * stack-only object whose call operator the compiler can inline from top
+ * to bottom. Type erasure happens only where the user explicitly asks
+ * for it, at \c sp::compile boundaries (and at \c sp::lazy, since a
+ * recursive grammar cannot be a finite type).
+ *
+ * The expression protocol is minimal: every parser expression `P` has a
+ * `P::value_type` and a const call operator
+ * `ftl::either<error,P::value_type> operator()(parser_input&)`.
+ * Semantics&mdash;including alternation without automatic
+ * backtracking&mdash;exactly mirror the erased tier, so rules can be
+ * moved between the tiers freely.
+ */
+namespace sp {
+
+	/// Result type of running the parser expression `P`.
+	template<typename P>
+	using value_of = typename P::value_type;
+
+	struct any_char_expr {
+		using value_type = char;
+
+		ftl::either<error,char> operator()(parser_input& s) const {
+			char c;
+			if(s.get(c))
+				return yield(c);
+
+			return fail<char>(s.tell(), error::expectation::anyChar());
+		}
+	};
+
+	/// Parses any one character; fails only at end of input.
+	inline any_char_expr anyChar() {
+		return any_char_expr{};
+	}
+
+	struct char_expr {
+		char c;
+
+		using value_type = char;
+
+		ftl::either<error,char> operator()(parser_input& s) const {
+			if(s.peek() == static_cast<unsigned char>(c)) {
+				s.get();
+				return yield(c);
+			}
+
+			return fail<char>(s.tell(), error::expectation::lit(c));
+		}
+	};
+
+	/// Parses one specific character.
+	inline char_expr parseChar(char c) {
+		return char_expr{c};
+	}
+
+	struct not_char_expr {
+		char c;
+
+		using value_type = char;
+
+		ftl::either<error,char> operator()(parser_input& s) const {
+			int x = s.peek();
+			if(x >= 0 && x != static_cast<unsigned char>(c)) {
+				s.get();
+				return yield(static_cast<char>(x));
+			}
+
+			return fail<char>(s.tell(), error::expectation::excluding(c));
+		}
+	};
+
+	/// Parses any character except `c`.
+	inline not_char_expr notChar(char c) {
+		return not_char_expr{c};
+	}
+
+	struct one_of_expr {
+		// Shared with every failure the expression produces
+		std::shared_ptr<const std::string> set;
+
+		using value_type = char;
+
+		ftl::either<error,char> operator()(parser_input& s) const {
+			int x = s.peek();
+			if(x >= 0 && set->find(static_cast<char>(x)) != std::string::npos) {
+				s.get();
+				return yield(static_cast<char>(x));
+			}
+
+			return fail<char>(s.tell(), error::expectation::in(set));
+		}
+	};
+
+	/// Parses one of the characters in `str`.
+	inline one_of_expr oneOf(std::string str) {
+		return one_of_expr{
+			std::make_shared<const std::string>(std::move(str))
+		};
+	}
+
+	template<typename P>
+	struct attempt_expr {
+		P p;
+
+		using value_type = value_of<P>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto pos = s.tell();
+			auto r = p(s);
+			if(!r)
+				s.seek(pos);
+
+			return r;
+		}
+	};
+
+	/// As the erased attempt: rewinds the input when `p` fails.
+	template<typename P>
+	attempt_expr<P> attempt(P p) {
+		return attempt_expr<P>{std::move(p)};
+	}
+
+	template<typename F, typename P>
+	struct map_expr {
+		F f;
+		P p;
+
+		using value_type = ftl::result_of<F(value_of<P>)>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto r = p(s);
+			if(!r)
+				return ftl::make_left<value_type>(r.left());
+
+			return yield(f(*r));
+		}
+	};
+
+	/// Equivalent of the functor instance's `f % p`.
+	template<typename F, typename P, typename = value_of<P>>
+	map_expr<F,P> operator% (F f, P p) {
+		return map_expr<F,P>{std::move(f), std::move(p)};
+	}
+
+	template<typename F, typename P1, typename P2>
+	struct lift2_expr {
+		F f;
+		P1 p1;
+		P2 p2;
+
+		using value_type = ftl::result_of<F(value_of<P1>,value_of<P2>)>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto r1 = p1(s);
+			if(!r1)
+				return ftl::make_left<value_type>(r1.left());
+
+			auto r2 = p2(s);
+			if(!r2)
+				return ftl::make_left<value_type>(r2.left());
+
+			return yield(f(*r1, *r2));
+		}
+	};
+
+	/**
+	 * Equivalent of the applicative chain `f % p1 * p2`.
+	 *
+	 * Runs `p1` then `p2` and combines their results with the binary
+	 * function `f`.
+	 */
+	template<typename F, typename P1, typename P2>
+	lift2_expr<F,P1,P2> liftA2(F f, P1 p1, P2 p2) {
+		return lift2_expr<F,P1,P2>{
+			std::move(f), std::move(p1), std::move(p2)
+		};
+	}
+
+	template<typename P1, typename P2>
+	struct seq_right_expr {
+		P1 p1;
+		P2 p2;
+
+		using value_type = value_of<P2>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto r1 = p1(s);
+			if(!r1)
+				return ftl::make_left<value_type>(r1.left());
+
+			return p2(s);
+		}
+	};
+
+	/// Sequence two parsers, keeping the right result.
+	template<typename P1, typename P2, typename = value_of<P1>>
+	seq_right_expr<P1,P2> operator>> (P1 p1, P2 p2) {
+		return seq_right_expr<P1,P2>{std::move(p1), std::move(p2)};
+	}
+
+	template<typename P1, typename P2>
+	struct seq_left_expr {
+		P1 p1;
+		P2 p2;
+
+		using value_type = value_of<P1>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto r1 = p1(s);
+			if(!r1)
+				return r1;
+
+			auto r2 = p2(s);
+			if(!r2)
+				return ftl::make_left<value_type>(r2.left());
+
+			return r1;
+		}
+	};
+
+	/// Sequence two parsers, keeping the left result.
+	template<typename P1, typename P2, typename = value_of<P1>>
+	seq_left_expr<P1,P2> operator<< (P1 p1, P2 p2) {
+		return seq_left_expr<P1,P2>{std::move(p1), std::move(p2)};
+	}
+
+	template<typename P1, typename P2>
+	struct or_expr {
+		P1 p1;
+		P2 p2;
+
+		static_assert(
+			std::is_same<value_of<P1>,value_of<P2>>::value,
+			"Both alternatives must parse the same type"
+		);
+
+		using value_type = value_of<P1>;
+
+		ftl::either<error,value_type> operator()(parser_input& s) const {
+			auto r1 = p1(s);
+			if(r1)
+				return r1;
+
+			auto r2 = p2(s);
+			if(r2)
+				return r2;
+
+			return ftl::make_left<value_type>(
+				error::merge(r1.left(), r2.left())
+			);
+		}
+	};
+
+	/**
+	 * Alternation, as the erased tier's `operator|`.
+	 *
+	 * Note that, exactly like there, the input is _not_ rewound when the
+	 * first alternative fails; wrap it in \c attempt if it can fail after
+	 * consuming input.
+	 */
+	template<typename P1, typename P2, typename = value_of<P1>>
+	or_expr<P1,P2> operator| (P1 p1, P2 p2) {
+		return or_expr<P1,P2>{std::move(p1), std::move(p2)};
+	}
+
+	template<typename P, typename T>
+	struct option_expr {
+		P p;
+		T t;
+
+		using value_type = T;
+
+		ftl::either<error,T> operator()(parser_input& s) const {
+			auto r = p(s);
+			if(r)
+				return r;
+
+			return yield(T(t));
+		}
+	};
+
+	/// Parses `p`, yielding `t` instead if `p` fails.
+	template<typename P, typename T = value_of<P>>
+	option_expr<P,T> option(P p, T t) {
+		return option_expr<P,T>{std::move(p), std::move(t)};
+	}
+
+	template<typename P>
+	struct many_expr {
+		P p;
+
+		using value_type = std::string;
+
+		ftl::either<error,std::string> operator()(parser_input& s) const {
+			std::string res;
+			for(;;) {
+				auto pos = s.tell();
+				auto r = p(s);
+				if(!r) {
+					s.seek(pos);
+					return yield(std::move(res));
+				}
+
+				res.push_back(*r);
+			}
+		}
+	};
+
+	/// Greedily parses 0 or more of the char parser `p`; cannot fail.
+	template<typename P>
+	many_expr<P> many(P p) {
+		static_assert(
+			std::is_same<value_of<P>,char>::value,
+			"many requires a parser of chars"
+		);
+
+		return many_expr<P>{std::move(p)};
+	}
+
+	template<typename P>
+	struct many1_expr {
+		P p;
+
+		using value_type = std::string;
+
+		ftl::either<error,std::string> operator()(parser_input& s) const {
+			auto r = p(s);
+			if(!r)
+				return ftl::make_left<std::string>(r.left());
+
+			std::string res;
+			res.push_back(*r);
+			for(;;) {
+				auto pos = s.tell();
+				auto r2 = p(s);
+				if(!r2) {
+					s.seek(pos);
+					return yield(std::move(res));
+				}
+
+				res.push_back(*r2);
+			}
+		}
+	};
+
+	/// Greedily parses 1 or more of the char parser `p`.
+	template<typename P>
+	many1_expr<P> many1(P p) {
+		static_assert(
+			std::is_same<value_of<P>,char>::value,
+			"many1 requires a parser of chars"
+		);
+
+		return many1_expr<P>{std::move(p)};
+	}
+
+	template<typename T>
+	struct lazy_expr {
+		parser<T> (*f)();
+
+		using value_type = T;
+
+		ftl::either<error,T> operator()(parser_input& s) const {
+			return (*f())(s);
+		}
+	};
+
+	/**
+	 * Lazily run the (erased) parser generated by `f`.
+	 *
+	 * Recursion is necessarily an erasure boundary: a grammar that
+	 * contained itself as a sub-expression would be an infinite type.
+	 * A recursive rule is therefore built as an erased, \c sp::compile'd
+	 * parser and re-enters the static tier through here.
+	 */
+	template<typename T>
+	lazy_expr<T> lazy(parser<T>(*f)()) {
+		return lazy_expr<T>{f};
+	}
+
+	template<typename T>
+	struct erased_expr {
+		parser<T> p;
+
+		using value_type = T;
+
+		ftl::either<error,T> operator()(parser_input& s) const {
+			return (*p)(s);
+		}
+	};
+
+	/**
+	 * Embed an erased parser in a static expression.
+	 *
+	 * Useful for mixing tiers: a \c memoize'd or session-managed rule can
+	 * take part in an otherwise statically-typed grammar.
+	 */
+	template<typename T>
+	erased_expr<T> wrap(parser<T> p) {
+		return erased_expr<T>{std::move(p)};
+	}
+
+	/**
+	 * The erasure boundary: turn a parser expression into a \ref parser.
+	 *
+	 * Everything below the compile call is a single concrete type, which
+	 * the optimizer is free to inline into one function; only the
+	 * compiled result is an indirect call.
+	 */
+	template<typename P, typename T = value_of<P>>
+	parser<T> compile(P p) {
+		return parser<T>{[p](parser_input& s) {
+			return p(s);
+		}};
+	}
+
+}
+
+#endif
+
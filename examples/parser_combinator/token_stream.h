@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "parser_combinator.h"
+
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+/**
+ * Token-stream layer between lexing and the parser combinators.
+ *
+ * The character-level combinators re-execute per-character machinery&mdash;
+ * with its eitherT wrapping&mdash;for every byte of a keyword or literal.
+ * This layer splits the work instead: a table driven lexer scans the input
+ * once into a contiguous vector of tokens, and the grammar then dispatches
+ * over whole tokens. A keyword match at parse time is a single kind
+ * comparison rather than one combinator invocation per character.
+ *
+ * Token parsers are the same transformer stack as `parser<T>`, with a
+ * \c token_stream as the threaded state, so the whole generic combinator
+ * API&mdash;`operator|`, `%`, `*`, `>>=`, and friends&mdash;applies to them
+ * unchanged.
+ */
+namespace tok {
+
+	/**
+	 * One lexed token: a kind plus the source span of its lexeme.
+	 *
+	 * Tokens never copy characters; the lexeme lives in the input the lexer
+	 * ran over, and is extracted on demand via token_stream::text.
+	 */
+	struct token {
+		unsigned kind;
+		size_t begin;
+		size_t end;
+	};
+
+	/**
+	 * A table driven lexer.
+	 *
+	 * The rules registered below are compiled into per-byte dispatch
+	 * tables when the lexer is built, so the scan itself is one table
+	 * lookup per character:
+	 *
+	 * \code
+	 *   enum { number = 1, lparen, rparen, identifier, kw_let };
+	 *
+	 *   tok::lexer lx;
+	 *   lx.skip(" \t\r\n");
+	 *   lx.literal('(', lparen).literal(')', rparen);
+	 *   lx.char_class("0123456789", "0123456789", number);
+	 *   lx.char_class(alphas, alnums, identifier);
+	 *   lx.keyword("let", kw_let);
+	 * \endcode
+	 *
+	 * At each position, keywords are tried first (longest match wins),
+	 * then character classes, then single-character literals. A keyword
+	 * whose lead byte also starts a character class only matches when the
+	 * following character does not continue that class&mdash;so `letter`
+	 * lexes as one identifier, not `let` + `ter`. When several classes
+	 * claim the same start byte, the first registered wins.
+	 */
+	class lexer {
+	public:
+		lexer() {
+			std::memset(action_, none, sizeof(action_));
+			std::memset(kind_, 0, sizeof(kind_));
+			std::memset(class_of_, 0, sizeof(class_of_));
+		}
+
+		/// Characters to silently skip between tokens.
+		lexer& skip(const std::string& cs) {
+			for(auto c : cs)
+				action_[byte(c)] = skip_ws;
+
+			return *this;
+		}
+
+		/// A single-character token.
+		lexer& literal(char c, unsigned kind) {
+			action_[byte(c)] = single;
+			kind_[byte(c)] = kind;
+			return *this;
+		}
+
+		/**
+		 * A fixed multi-character token (keyword or operator).
+		 */
+		lexer& keyword(std::string kw, unsigned kind) {
+			auto& bucket = keywords_[byte(kw[0])];
+			bucket.push_back(std::make_pair(std::move(kw), kind));
+
+			// Longest first, so the scan can take the first fit
+			std::sort(
+				bucket.begin(), bucket.end(),
+				[](const std::pair<std::string,unsigned>& a,
+						const std::pair<std::string,unsigned>& b) {
+					return a.first.size() > b.first.size();
+				}
+			);
+
+			return *this;
+		}
+
+		/**
+		 * A character-class token.
+		 *
+		 * Characters in `first` start the token; it then greedily extends
+		 * over characters in `rest`.
+		 */
+		lexer& char_class(
+				const std::string& first,
+				const std::string& rest,
+				unsigned kind) {
+			classes_.push_back(class_rule());
+			auto& cr = classes_.back();
+			std::memset(cr.rest, 0, sizeof(cr.rest));
+			cr.kind = kind;
+
+			for(auto c : rest)
+				cr.rest[byte(c)] = true;
+
+			for(auto c : first) {
+				if(class_of_[byte(c)] == 0)
+					class_of_[byte(c)] = classes_.size();
+			}
+
+			return *this;
+		}
+
+		/**
+		 * Tokenize the remainder of the input into a contiguous vector.
+		 *
+		 * The input itself is not consumed; token spans are absolute
+		 * offsets into it.
+		 */
+		ftl::either<error,std::vector<token>> operator() (
+				const parser_input& in) const {
+			std::vector<token> out;
+			out.reserve(in.size() / 4 + 1);
+
+			auto const data = in.data();
+			auto const size = in.size();
+			auto pos = in.tell();
+
+			while(pos < size) {
+				auto const c = byte(data[pos]);
+
+				if(action_[c] == skip_ws) {
+					++pos;
+					continue;
+				}
+
+				auto const kw = matchKeyword(data, size, pos, c);
+				if(kw != nokw) {
+					auto& k = keywords_[c][kw];
+					out.push_back(
+						token{k.second, pos, pos + k.first.size()}
+					);
+					pos += k.first.size();
+					continue;
+				}
+
+				if(class_of_[c] != 0) {
+					auto& cr = classes_[class_of_[c] - 1];
+					auto end = pos + 1;
+					while(end < size && cr.rest[byte(data[end])])
+						++end;
+
+					out.push_back(token{cr.kind, pos, end});
+					pos = end;
+					continue;
+				}
+
+				if(action_[c] == single) {
+					out.push_back(token{kind_[c], pos, pos + 1});
+					++pos;
+					continue;
+				}
+
+				return ftl::make_left<std::vector<token>>(
+					error(pos, error::expectation::message("a valid token"))
+				);
+			}
+
+			return ftl::make_right<error>(std::move(out));
+		}
+
+	private:
+		enum action_t : unsigned char { none, skip_ws, single };
+
+		static constexpr size_t nokw = size_t(-1);
+
+		static size_t byte(char c) noexcept {
+			return static_cast<unsigned char>(c);
+		}
+
+		/* Index into keywords_[c] of the longest keyword matching at pos,
+		 * or nokw. A match is rejected when the lead byte starts a
+		 * character class and the character following the keyword would
+		 * continue that class.
+		 */
+		size_t matchKeyword(
+				const char* data, size_t size,
+				size_t pos, size_t c) const {
+			auto& bucket = keywords_[c];
+			for(size_t i = 0; i < bucket.size(); ++i) {
+				auto& kw = bucket[i].first;
+				if(pos + kw.size() > size)
+					continue;
+
+				if(std::memcmp(data + pos, kw.data(), kw.size()) != 0)
+					continue;
+
+				if(class_of_[c] != 0
+						&& pos + kw.size() < size
+						&& classes_[class_of_[c] - 1]
+							.rest[byte(data[pos + kw.size()])])
+					continue;
+
+				return i;
+			}
+
+			return nokw;
+		}
+
+		struct class_rule {
+			bool rest[256];
+			unsigned kind;
+		};
+
+		unsigned char action_[256];
+		unsigned kind_[256];
+		unsigned char class_of_[256];   // class index + 1; 0 = none
+		std::vector<class_rule> classes_;
+		std::vector<std::pair<std::string,unsigned>> keywords_[256];
+	};
+
+	/**
+	 * The state token parsers thread: a position in a vector of tokens.
+	 *
+	 * The same shape as parser_input one level up&mdash;backtracking is a
+	 * plain integer copy, and errors report the source character offset of
+	 * the offending token, so messages point into the original input.
+	 */
+	class token_stream {
+	public:
+		using position = size_t;
+
+		token_stream(std::vector<token> ts, parser_input src)
+		: toks_(std::move(ts)), src_(std::move(src)) {}
+
+		/// Whether all tokens have been consumed
+		bool eof() const noexcept {
+			return pos_ == toks_.size();
+		}
+
+		/// Next token without consuming it, or nullptr at end of input
+		const token* peek() const noexcept {
+			return pos_ < toks_.size() ? &toks_[pos_] : nullptr;
+		}
+
+		/// Consume and return the next token, or nullptr at end of input
+		const token* get() noexcept {
+			return pos_ < toks_.size() ? &toks_[pos_++] : nullptr;
+		}
+
+		/// Current position, for later use with seek()
+		position tell() const noexcept {
+			return pos_;
+		}
+
+		/// Backtrack (or skip) to a position previously obtained from tell()
+		void seek(position p) noexcept {
+			pos_ = p;
+		}
+
+		/// Source character offset of the current token, for error reporting
+		size_t char_pos() const noexcept {
+			return pos_ < toks_.size() ? toks_[pos_].begin : src_.size();
+		}
+
+		/// Copy of the lexeme of t
+		std::string text(const token& t) const {
+			return std::string(src_.data() + t.begin, t.end - t.begin);
+		}
+
+		/// Whether t's lexeme equals s, without copying characters
+		bool matches(const token& t, const std::string& s) const noexcept {
+			return t.end - t.begin == s.size()
+				&& std::memcmp(src_.data() + t.begin, s.data(), s.size()) == 0;
+		}
+
+	private:
+		std::vector<token> toks_;
+		parser_input src_;
+		position pos_ = 0;
+	};
+
+	/**
+	 * A parser of Ts over tokens.
+	 *
+	 * The same transformer stack as `parser<T>`, with the token stream as
+	 * the threaded state; every generic combinator that works on `parser`
+	 * works here too.
+	 *
+	 * \par Concepts
+	 * \li Monad
+	 * \li MonoidAlternative
+	 */
+	template<typename T>
+	using tparser = ftl::eitherT<error,ftl::function<T(token_stream&)>>;
+
+	/**
+	 * Parses any one token.
+	 *
+	 * This parser can only fail if the end of the token stream has been
+	 * reached.
+	 */
+	inline tparser<token> anyToken() {
+		auto e = error::expectation::message("any token");
+
+		return tparser<token>{[e](token_stream& s) {
+			auto t = s.get();
+			if(t)
+				return yield(*t);
+
+			return fail<token>(s.char_pos(), e);
+		}};
+	}
+
+	/**
+	 * Parses one token of the given kind.
+	 *
+	 * `what` names the token in error messages; it is rendered into the
+	 * shared expectation once, when the grammar is built.
+	 */
+	inline tparser<token> match(unsigned kind, std::string what) {
+		auto e = error::expectation::message(std::move(what));
+
+		return tparser<token>{[kind,e](token_stream& s) {
+			auto t = s.peek();
+			if(t && t->kind == kind) {
+				s.get();
+				return yield(*t);
+			}
+
+			return fail<token>(s.char_pos(), e);
+		}};
+	}
+
+	/// \overload
+	inline tparser<token> match(unsigned kind) {
+		return match(kind, "token kind " + std::to_string(kind));
+	}
+
+	/**
+	 * Parses one token whose lexeme equals kw, regardless of kind.
+	 *
+	 * Mostly useful for grammars whose lexer folds all words into one
+	 * identifier-like kind instead of registering each keyword.
+	 */
+	inline tparser<token> match(std::string kw) {
+		auto e = error::expectation::message("\"" + kw + "\"");
+
+		return tparser<token>{[kw,e](token_stream& s) {
+			auto t = s.peek();
+			if(t && s.matches(*t, kw)) {
+				s.get();
+				return yield(*t);
+			}
+
+			return fail<token>(s.char_pos(), e);
+		}};
+	}
+
+	/**
+	 * Parses one token of the given kind, yielding its lexeme.
+	 */
+	inline tparser<std::string> lexeme(unsigned kind, std::string what) {
+		auto e = error::expectation::message(std::move(what));
+
+		return tparser<std::string>{[kind,e](token_stream& s) {
+			auto t = s.peek();
+			if(t && t->kind == kind) {
+				s.get();
+				return yield(s.text(*t));
+			}
+
+			return fail<std::string>(s.char_pos(), e);
+		}};
+	}
+
+	/// \overload
+	inline tparser<std::string> lexeme(unsigned kind) {
+		return lexeme(kind, "token kind " + std::to_string(kind));
+	}
+
+	/**
+	 * Lazily run the token parser generated by f.
+	 *
+	 * This is useful e.g. if you want a parser to recurse.
+	 */
+	template<typename T>
+	tparser<T> lazy(tparser<T>(*f)()) {
+		return tparser<T>{[f](token_stream& s) {
+			return (*f())(s);
+		}};
+	}
+
+	/**
+	 * Function for running token parsers.
+	 */
+	template<typename T>
+	ftl::either<error,T> run(tparser<T> p, token_stream& s) {
+		return (*p)(s);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Lexes the input and parses the resulting token stream in one go.
+	 * Lexing errors are reported through the same error type as parse
+	 * errors.
+	 */
+	template<typename T>
+	ftl::either<error,T> run(
+			const lexer& lx, tparser<T> p, const parser_input& in) {
+		auto ts = lx(in);
+		if(!ts)
+			return ftl::make_left<T>(ts.left());
+
+		token_stream s{std::move(*ts), in};
+		return (*p)(s);
+	}
+
+}
+
+#endif
+
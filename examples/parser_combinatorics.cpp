@@ -52,14 +52,21 @@ int main(int, char**) {
 	using std::string;
 
 	auto parser = parseLispList();
-	auto res = run(parser, std::cin);
+
+	string line;
+	std::getline(std::cin, line);
+
+	auto in = parser_input{line};
+	auto res = run(parser, in);
 
 	while(!res) {
 		std::cout << "expected " << res.left().message() << std::endl;
 
-		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		if(!std::getline(std::cin, line))
+			return 1;
 
-		res = run(parser, std::cin);
+		in = parser_input{line};
+		res = run(parser, in);
 	}
 
 	for(auto e : *res) {
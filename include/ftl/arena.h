@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_ARENA_H
+#define FTL_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace ftl {
+
+	/**
+	 * \defgroup arena Arena
+	 *
+	 * Bump-pointer region allocation.
+	 *
+	 * \code
+	 *   #include <ftl/arena.h>
+	 * \endcode
+	 *
+	 * An \ref ftl::arena "arena" hands out memory by advancing a pointer
+	 * through pre-allocated blocks; individual deallocation is a no-op and
+	 * everything is released wholesale by rewinding. This suits workloads
+	 * that build and tear down many short lived objects with a common
+	 * lifetime&mdash;most notably graphs of heap allocated `ftl::function`
+	 * closures, which accept an allocator via their `std::allocator_arg_t`
+	 * constructors:
+	 *
+	 * \code
+	 *   ftl::arena a{4096};
+	 *
+	 *   for(auto& request : requests) {
+	 *       ftl::arena_scope scope{a};
+	 *
+	 *       ftl::function<int(int)> f{
+	 *           std::allocator_arg,
+	 *           ftl::scoped_arena_allocator<char>{},
+	 *           someBigClosure
+	 *       };
+	 *
+	 *       // ... build and run the closure graph ...
+	 *
+	 *   } // scope rewinds the arena; all closure storage is reclaimed
+	 * \endcode
+	 *
+	 * Arenas are not thread safe; use one per thread, or guard externally.
+	 *
+	 * \par Dependencies
+	 * - <cstddef>
+	 * - <memory>
+	 * - <new>
+	 * - <vector>
+	 */
+
+	/**
+	 * A growable bump-pointer arena.
+	 *
+	 * Allocation advances an offset into the current block; when a block is
+	 * exhausted, a new one of twice the size is chained on. Deallocation of
+	 * individual objects does nothing&mdash;memory is reclaimed only by
+	 * rewind(), reset(), or destruction. Objects with non-trivial
+	 * destructors must still be destroyed by their owners as usual; the
+	 * arena only recycles their storage.
+	 *
+	 * \ingroup arena
+	 */
+	class arena {
+	public:
+		/// Opaque position in the arena, as used by save() and rewind()
+		struct position {
+			size_t block;
+			size_t used;
+		};
+
+		arena(const arena&) = delete;
+		arena(arena&&) = default;
+
+		/// Construct an arena with the given initial capacity, in bytes.
+		explicit arena(size_t initial_capacity = 4096) {
+			blocks.emplace_back(initial_capacity > 0 ? initial_capacity : 1);
+		}
+
+		arena& operator= (const arena&) = delete;
+		arena& operator= (arena&&) = default;
+
+		/**
+		 * Allocate bytes of storage, aligned to alignment.
+		 *
+		 * Never fails short of the underlying allocator failing; if the
+		 * current block cannot satisfy the request, a larger one is chained
+		 * on.
+		 */
+		void* allocate(
+				size_t bytes,
+				size_t alignment = std::alignment_of<std::max_align_t>::value) {
+
+			for(;;) {
+				auto& b = blocks[current];
+				size_t aligned = (b.used + alignment - 1) & ~(alignment - 1);
+
+				if(aligned + bytes <= b.size) {
+					b.used = aligned + bytes;
+					return b.mem.get() + aligned;
+				}
+
+				if(current + 1 == blocks.size()) {
+					auto next = blocks.back().size * 2;
+					blocks.emplace_back(
+						next > bytes + alignment ? next : bytes + alignment
+					);
+				}
+
+				++current;
+			}
+		}
+
+		/// No-op; arena storage is reclaimed wholesale.
+		void deallocate(void*, size_t) noexcept {
+		}
+
+		/// Total number of bytes handed out and not yet rewound
+		size_t used() const noexcept {
+			size_t total = 0;
+			for(size_t i = 0; i <= current; ++i)
+				total += blocks[i].used;
+
+			return total;
+		}
+
+		/// Current position, for later use with rewind()
+		position save() const noexcept {
+			return position{current, blocks[current].used};
+		}
+
+		/**
+		 * Rewind to a position previously obtained from save().
+		 *
+		 * Everything allocated since is reclaimed in one step; the blocks
+		 * themselves are retained for reuse. Positions must be rewound in
+		 * reverse order of saving.
+		 */
+		void rewind(position p) noexcept {
+			for(size_t i = p.block + 1; i <= current; ++i)
+				blocks[i].used = 0;
+
+			current = p.block;
+			blocks[current].used = p.used;
+		}
+
+		/**
+		 * Reclaim everything and release all but the initial block.
+		 */
+		void reset() noexcept {
+			blocks.erase(blocks.begin() + 1, blocks.end());
+			blocks[0].used = 0;
+			current = 0;
+		}
+
+	private:
+		struct block {
+			explicit block(size_t sz)
+			: mem(new char[sz]), size(sz), used(0) {}
+
+			block(block&&) = default;
+			block& operator= (block&&) = default;
+
+			std::unique_ptr<char[]> mem;
+			size_t size;
+			size_t used;
+		};
+
+		std::vector<block> blocks;
+		size_t current = 0;
+	};
+
+	namespace _dtl {
+		/* The arena currently bound to this thread by the innermost live
+		 * arena_scope, if any. scoped_arena_allocator draws from this,
+		 * because ftl::function's storage scheme only admits empty
+		 * allocator classes.
+		 */
+		inline arena*& bound_arena() noexcept {
+			static thread_local arena* current = nullptr;
+			return current;
+		}
+	}
+
+	/**
+	 * Scoped reset handle for an arena.
+	 *
+	 * Saves the arena's position on construction and rewinds to it on
+	 * destruction, reclaiming everything allocated in between. For its
+	 * lifetime, the scope also makes the arena the thread's bound arena,
+	 * from which \ref scoped_arena_allocator allocates.
+	 *
+	 * Scopes nest, as long as they are destroyed in reverse order of
+	 * construction (which block scoped locals guarantee).
+	 *
+	 * \ingroup arena
+	 */
+	class arena_scope {
+	public:
+		arena_scope() = delete;
+		arena_scope(const arena_scope&) = delete;
+		arena_scope(arena_scope&&) = delete;
+
+		explicit arena_scope(arena& a) noexcept
+		: a(a), mark(a.save()), previous(_dtl::bound_arena()) {
+			_dtl::bound_arena() = &a;
+		}
+
+		~arena_scope() {
+			_dtl::bound_arena() = previous;
+			a.rewind(mark);
+		}
+
+		arena_scope& operator= (const arena_scope&) = delete;
+
+	private:
+		arena& a;
+		arena::position mark;
+		arena* previous;
+	};
+
+	/**
+	 * The calling thread's scratch arena.
+	 *
+	 * One lazily created arena per thread, intended for intermediate values
+	 * that never outlive an enclosing \ref scratch_scope. It is never
+	 * rewound behind the caller's back; open a scope to reclaim storage.
+	 *
+	 * \ingroup arena
+	 */
+	inline arena& scratch_arena() {
+		static thread_local arena a{4096};
+		return a;
+	}
+
+	/**
+	 * Scope handle for the thread's scratch arena.
+	 *
+	 * Equivalent to an \ref arena_scope on \ref scratch_arena "scratch_arena()":
+	 * for its lifetime, \ref scoped_arena_allocator draws from the scratch
+	 * arena, and on destruction everything allocated within the scope is
+	 * reclaimed in one step. Scopes nest; the outermost releases the arena
+	 * wholesale.
+	 *
+	 * The intended use is eliminating intermediaries in monad transformer
+	 * bind chains. `Rebind` preserves a container's allocator, so a stack
+	 * whose inner monad is e.g. `std::vector<T, scoped_arena_allocator<T>>`
+	 * places every intermediate wrapper container a `maybeT`/`eitherT` bind
+	 * constructs in the scratch arena:
+	 *
+	 * \code
+	 *   template<typename T>
+	 *   using scratch_vector = std::vector<T, ftl::scoped_arena_allocator<T>>;
+	 *
+	 *   std::vector<int> result = ftl::withScratch([&]() -> std::vector<int> {
+	 *       ftl::maybeT<scratch_vector<int>> m{...};
+	 *
+	 *       auto r = m >>= ...;   // intermediaries land in the scratch arena
+	 *
+	 *       return {(*r).begin(), (*r).end()};   // copy out of the arena
+	 *   });
+	 * \endcode
+	 *
+	 * \ingroup arena
+	 */
+	class scratch_scope {
+	public:
+		scratch_scope() noexcept
+		: scope(scratch_arena()) {}
+
+		scratch_scope(const scratch_scope&) = delete;
+		scratch_scope(scratch_scope&&) = delete;
+
+		scratch_scope& operator= (const scratch_scope&) = delete;
+
+	private:
+		arena_scope scope;
+	};
+
+	/**
+	 * Evaluate `f` inside a \ref scratch_scope.
+	 *
+	 * Whatever `f` allocates from the scratch arena is reclaimed wholesale
+	 * once it returns. The result is constructed before the scope closes,
+	 * so `f` may freely read arena-backed values while computing it&mdash;
+	 * but its declared result type must own its storage (or use a regular
+	 * allocator), since the arena memory is gone by the time the caller
+	 * sees the value.
+	 *
+	 * \ingroup arena
+	 */
+	template<typename F>
+	auto withScratch(F&& f) -> decltype(std::forward<F>(f)()) {
+		scratch_scope scope;
+		return std::forward<F>(f)();
+	}
+
+	/**
+	 * Standard conforming allocator handing out arena storage.
+	 *
+	 * Usable anywhere an Allocator is accepted: containers, ftl::function's
+	 * `std::allocator_arg_t` constructors, allocator aware factories, and
+	 * so on. `deallocate` is a no-op; storage lives until the arena is
+	 * rewound or reset. The referenced arena must outlive every allocator
+	 * and every allocation made through one.
+	 *
+	 * \ingroup arena
+	 */
+	template<typename T>
+	class arena_allocator {
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind {
+			using other = arena_allocator<U>;
+		};
+
+		arena_allocator() = delete;
+
+		explicit arena_allocator(arena& a) noexcept : a(&a) {}
+
+		arena_allocator(const arena_allocator&) noexcept = default;
+
+		template<typename U>
+		arena_allocator(const arena_allocator<U>& other) noexcept
+		: a(&other.underlying()) {}
+
+		arena_allocator& operator= (const arena_allocator&) noexcept = default;
+
+		T* allocate(size_t n) {
+			return static_cast<T*>(
+				a->allocate(n * sizeof(T), std::alignment_of<T>::value)
+			);
+		}
+
+		void deallocate(T*, size_t) noexcept {
+		}
+
+		/// Access the arena this allocator draws from
+		arena& underlying() const noexcept {
+			return *a;
+		}
+
+	private:
+		arena* a;
+	};
+
+	template<typename T, typename U>
+	bool operator== (
+			const arena_allocator<T>& a1, const arena_allocator<U>& a2
+	) noexcept {
+		return &a1.underlying() == &a2.underlying();
+	}
+
+	template<typename T, typename U>
+	bool operator!= (
+			const arena_allocator<T>& a1, const arena_allocator<U>& a2
+	) noexcept {
+		return !(a1 == a2);
+	}
+
+	/**
+	 * Stateless allocator drawing from the thread's bound arena.
+	 *
+	 * `ftl::function` stores its allocator in the space of a single pointer
+	 * and therefore requires an empty allocator class; this allocator
+	 * carries no arena reference of its own, but allocates from whichever
+	 * arena the innermost live \ref arena_scope on the current thread has
+	 * bound:
+	 *
+	 * \code
+	 *   ftl::arena a{4096};
+	 *   ftl::arena_scope scope{a};
+	 *
+	 *   ftl::function<int(int)> f{
+	 *       std::allocator_arg,
+	 *       ftl::scoped_arena_allocator<char>{},
+	 *       someBigClosure
+	 *   };
+	 * \endcode
+	 *
+	 * Allocating without a live arena_scope throws std::bad_alloc. The
+	 * scope must outlive everything allocated through this allocator.
+	 *
+	 * \ingroup arena
+	 */
+	template<typename T>
+	class scoped_arena_allocator {
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind {
+			using other = scoped_arena_allocator<U>;
+		};
+
+		scoped_arena_allocator() noexcept = default;
+
+		scoped_arena_allocator(const scoped_arena_allocator&) noexcept
+			= default;
+
+		template<typename U>
+		scoped_arena_allocator(const scoped_arena_allocator<U>&) noexcept {}
+
+		scoped_arena_allocator& operator= (
+				const scoped_arena_allocator&) noexcept = default;
+
+		T* allocate(size_t n) {
+			auto a = _dtl::bound_arena();
+			if(!a)
+				throw std::bad_alloc();
+
+			return static_cast<T*>(
+				a->allocate(n * sizeof(T), std::alignment_of<T>::value)
+			);
+		}
+
+		void deallocate(T*, size_t) noexcept {
+		}
+	};
+
+	template<typename T, typename U>
+	bool operator== (
+			const scoped_arena_allocator<T>&, const scoped_arena_allocator<U>&
+	) noexcept {
+		return true;
+	}
+
+	template<typename T, typename U>
+	bool operator!= (
+			const scoped_arena_allocator<T>&, const scoped_arena_allocator<U>&
+	) noexcept {
+		return false;
+	}
+
+}
+
+#endif
+
@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CHUNKED_LIST_H
+#define FTL_CHUNKED_LIST_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup chunkedlist Chunked List
+	 *
+	 * A cache friendly list type and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/chunked_list.h>
+	 * \endcode
+	 *
+	 * `std::list` is the natural fit for FTL's Haskell style idioms&mdash;
+	 * its monoid append is a cheap splice&mdash;but one heap node per
+	 * element makes folds over large lists an exercise in pointer chasing.
+	 * ftl::chunked_list keeps the same interface surface and concept
+	 * instances while storing elements in cache-line-sized blocks, so
+	 * iteration mostly walks contiguous memory and the per-element
+	 * allocation cost disappears.
+	 *
+	 * This module implements the following concepts for chunked_list:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - `<initializer_list>`
+	 * - `<iterator>`
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 */
+
+	/**
+	 * A list of cache-line-sized element blocks.
+	 *
+	 * Elements live in fixed capacity chunks, each sized to roughly one
+	 * cache line, linked into a doubly linked chain. Compared to
+	 * `std::list` this trades per-element allocations and pointer chasing
+	 * for mostly contiguous iteration, while keeping the property that
+	 * makes lists attractive to the monoid instance: appending two lists
+	 * by r-value is an O(1) splice of their chunk chains.
+	 *
+	 * The interface is the subset of `std::list`'s that FTL's concept
+	 * machinery and typical comprehension-style code require: back
+	 * insertion, bidirectional iteration, positional insert, and equality
+	 * comparison. There is deliberately no positional erase; build new
+	 * lists instead, as functional style code does anyway.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref fwditerable
+	 * - \ref eq, if `T` is EqualityComparable.
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<typename T>
+	class chunked_list {
+		struct chunk {
+			static constexpr size_t capacity =
+				sizeof(T) < 64 ? 64/sizeof(T) : 1;
+
+			typename std::aligned_storage<sizeof(T),alignof(T)>::type
+				storage[capacity];
+
+			size_t count = 0;
+			chunk* next = nullptr;
+			chunk* prev = nullptr;
+
+			T* data() noexcept {
+				return reinterpret_cast<T*>(storage);
+			}
+		};
+
+		template<bool Const>
+		class basic_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer =
+				typename std::conditional<Const,const T*,T*>::type;
+			using reference =
+				typename std::conditional<Const,const T&,T&>::type;
+
+			basic_iterator() = default;
+
+			// Implicit iterator-to-const_iterator conversion
+			basic_iterator(const basic_iterator<false>& other)
+			: c(other.c), i(other.i), owner(other.owner) {}
+
+			reference operator* () const {
+				return c->data()[i];
+			}
+
+			pointer operator-> () const {
+				return c->data() + i;
+			}
+
+			basic_iterator& operator++ () {
+				if(++i == c->count) {
+					c = c->next;
+					i = 0;
+				}
+
+				return *this;
+			}
+
+			basic_iterator operator++ (int) {
+				auto old = *this;
+				++*this;
+				return old;
+			}
+
+			basic_iterator& operator-- () {
+				if(!c) {
+					c = owner->tail;
+					i = c->count - 1;
+				}
+				else if(i == 0) {
+					c = c->prev;
+					i = c->count - 1;
+				}
+				else {
+					--i;
+				}
+
+				return *this;
+			}
+
+			basic_iterator operator-- (int) {
+				auto old = *this;
+				--*this;
+				return old;
+			}
+
+			template<bool C2>
+			bool operator== (const basic_iterator<C2>& other) const {
+				return c == other.c && i == other.i;
+			}
+
+			template<bool C2>
+			bool operator!= (const basic_iterator<C2>& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			friend class chunked_list;
+			friend class basic_iterator<!Const>;
+
+			basic_iterator(chunk* c, size_t i, const chunked_list* owner)
+			: c(c), i(i), owner(owner) {}
+
+			chunk* c = nullptr;
+			size_t i = 0;
+			const chunked_list* owner = nullptr;
+		};
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		chunked_list() = default;
+
+		chunked_list(const chunked_list& other) {
+			for(auto& e : other)
+				push_back(e);
+		}
+
+		chunked_list(chunked_list&& other) noexcept
+		: head(other.head), tail(other.tail), count(other.count) {
+			other.head = other.tail = nullptr;
+			other.count = 0;
+		}
+
+		chunked_list(std::initializer_list<T> elems) {
+			for(auto& e : elems)
+				push_back(e);
+		}
+
+		~chunked_list() {
+			clear();
+		}
+
+		chunked_list& operator= (const chunked_list& other) {
+			if(this != &other) {
+				chunked_list tmp{other};
+				swap(tmp);
+			}
+
+			return *this;
+		}
+
+		chunked_list& operator= (chunked_list&& other) noexcept {
+			if(this != &other) {
+				clear();
+				head = other.head;
+				tail = other.tail;
+				count = other.count;
+				other.head = other.tail = nullptr;
+				other.count = 0;
+			}
+
+			return *this;
+		}
+
+		iterator begin() noexcept {
+			return iterator{head, 0, this};
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator{head, 0, this};
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		iterator end() noexcept {
+			return iterator{nullptr, 0, this};
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{nullptr, 0, this};
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return reverse_iterator{end()};
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator{end()};
+		}
+
+		reverse_iterator rend() noexcept {
+			return reverse_iterator{begin()};
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator{begin()};
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_type size() const noexcept {
+			return count;
+		}
+
+		T& front() {
+			return head->data()[0];
+		}
+
+		const T& front() const {
+			return head->data()[0];
+		}
+
+		T& back() {
+			return tail->data()[tail->count - 1];
+		}
+
+		const T& back() const {
+			return tail->data()[tail->count - 1];
+		}
+
+		/// Construct a new element at the back of the list.
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			if(!tail || tail->count == chunk::capacity)
+				append_chunk();
+
+			new (tail->data() + tail->count) T(std::forward<Args>(args)...);
+			++tail->count;
+			++count;
+		}
+
+		void push_back(const T& t) {
+			emplace_back(t);
+		}
+
+		void push_back(T&& t) {
+			emplace_back(std::move(t));
+		}
+
+		/**
+		 * Insert an element before the given position.
+		 *
+		 * Amortised O(1) at the end of the list; inserting in the middle
+		 * shifts at most one chunk's worth of elements.
+		 *
+		 * \return An iterator to the inserted element.
+		 */
+		iterator insert(iterator pos, const T& t) {
+			return emplace(pos, t);
+		}
+
+		/// \overload
+		iterator insert(iterator pos, T&& t) {
+			return emplace(pos, std::move(t));
+		}
+
+		/**
+		 * Splice another list onto the end of this one, in O(1).
+		 *
+		 * `other` is left empty.
+		 */
+		void splice_back(chunked_list&& other) noexcept {
+			if(other.empty())
+				return;
+
+			if(empty()) {
+				head = other.head;
+				tail = other.tail;
+			}
+			else {
+				tail->next = other.head;
+				other.head->prev = tail;
+				tail = other.tail;
+			}
+
+			count += other.count;
+			other.head = other.tail = nullptr;
+			other.count = 0;
+		}
+
+		/// Destroy all elements and release all chunks.
+		void clear() noexcept {
+			for(chunk* c = head; c;) {
+				for(size_t i = 0; i < c->count; ++i)
+					c->data()[i].~T();
+
+				auto next = c->next;
+				delete c;
+				c = next;
+			}
+
+			head = tail = nullptr;
+			count = 0;
+		}
+
+		void swap(chunked_list& other) noexcept {
+			std::swap(head, other.head);
+			std::swap(tail, other.tail);
+			std::swap(count, other.count);
+		}
+
+	private:
+		void append_chunk() {
+			auto c = new chunk;
+			c->prev = tail;
+
+			if(tail)
+				tail->next = c;
+			else
+				head = c;
+
+			tail = c;
+		}
+
+		template<typename...Args>
+		iterator emplace(iterator pos, Args&&...args) {
+			if(!pos.c) {
+				emplace_back(std::forward<Args>(args)...);
+				return iterator{tail, tail->count - 1, this};
+			}
+
+			auto c = pos.c;
+			auto i = pos.i;
+
+			if(c->count == chunk::capacity) {
+				// Full chunk; move the elements from the insertion point
+				// onwards into a fresh chunk spliced in after this one.
+				auto n = new chunk;
+				n->prev = c;
+				n->next = c->next;
+
+				if(c->next)
+					c->next->prev = n;
+				else
+					tail = n;
+
+				c->next = n;
+
+				for(size_t j = i; j < c->count; ++j) {
+					new (n->data() + (j - i)) T(std::move(c->data()[j]));
+					c->data()[j].~T();
+				}
+
+				n->count = c->count - i;
+				c->count = i;
+			}
+			else {
+				// Room in the chunk; shift the tail end one slot right
+				for(size_t j = c->count; j > i; --j) {
+					new (c->data() + j) T(std::move(c->data()[j-1]));
+					c->data()[j-1].~T();
+				}
+			}
+
+			new (c->data() + i) T(std::forward<Args>(args)...);
+			++c->count;
+			++count;
+
+			return iterator{c, i, this};
+		}
+
+		chunk* head = nullptr;
+		chunk* tail = nullptr;
+		size_type count = 0;
+	};
+
+	template<typename T>
+	bool operator== (const chunked_list<T>& l1, const chunked_list<T>& l2) {
+		return l1.size() == l2.size()
+			&& std::equal(l1.begin(), l1.end(), l2.begin());
+	}
+
+	template<typename T>
+	bool operator!= (const chunked_list<T>& l1, const chunked_list<T>& l2) {
+		return !(l1 == l2);
+	}
+
+	/**
+	 * Maps and concatenates in one step.
+	 *
+	 * \tparam F must satisfy \ref fn`<`\ref container`<U>(T)>`
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<
+			typename F,
+			typename T,
+			typename U = typename result_of<F(T)>::value_type
+	>
+	chunked_list<U> concatMap(F&& f, const chunked_list<T>& l) {
+
+		chunked_list<U> result;
+		auto nested = std::forward<F>(f) % l;
+
+		for(auto& el : nested)
+			result.splice_back(std::move(el));
+
+		return result;
+	}
+
+	/// \overload
+	template<
+			typename F,
+			typename T,
+			typename U = typename result_of<F(T)>::value_type
+	>
+	chunked_list<U> concatMap(F&& f, chunked_list<T>&& l) {
+
+		chunked_list<U> result;
+		auto nested = std::forward<F>(f) % std::move(l);
+
+		for(auto& el : nested)
+			result.splice_back(std::move(el));
+
+		return result;
+	}
+
+	/**
+	 * Monoid implementation for chunked_list.
+	 *
+	 * Exactly mirrors the `std::list` instance: the identity element is
+	 * the empty list and append concatenates. When both operands are
+	 * r-values, append is an O(1) splice of the chunk chains.
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<typename T>
+	struct monoid<chunked_list<T>> {
+		static chunked_list<T> id() {
+			return chunked_list<T>();
+		}
+
+		static chunked_list<T> append(
+				const chunked_list<T>& l1,
+				const chunked_list<T>& l2) {
+			auto l3 = l1;
+			for(auto& e : l2)
+				l3.push_back(e);
+
+			return l3;
+		}
+
+		// For performance reasons, we give overloads for cases where we
+		// don't have to copy any of the lists
+		static chunked_list<T> append(
+				chunked_list<T>&& l1,
+				const chunked_list<T>& l2) {
+			for(auto& e : l2)
+				l1.push_back(e);
+
+			return std::move(l1);
+		}
+
+		static chunked_list<T> append(
+				const chunked_list<T>& l1,
+				chunked_list<T>&& l2) {
+			auto l3 = l1;
+			l3.splice_back(std::move(l2));
+			return l3;
+		}
+
+		static chunked_list<T> append(
+				chunked_list<T>&& l1,
+				chunked_list<T>&& l2) {
+			l1.splice_back(std::move(l2));
+			return std::move(l1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad implementation for chunked_list.
+	 *
+	 * Behaves like the `std::list` instance; which is to say, the monad
+	 * can be said to model nondeterministic computations.
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<typename T>
+	struct monad<chunked_list<T>>
+	: deriving_monad<back_insertable_container<chunked_list<T>>> {};
+
+	/**
+	 * Foldable instance for chunked_list.
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<typename T>
+	struct foldable<chunked_list<T>>
+	: deriving_foldable<bidirectional_iterable<chunked_list<T>>> {};
+
+	/**
+	 * \ref zippablepg instance for chunked_list.
+	 *
+	 * As with the `std::list` instance, a `chunked_list` may be zipped
+	 * with any type that satisfies \ref fwditerable.
+	 *
+	 * \ingroup chunkedlist
+	 */
+	template<typename T>
+	struct zippable<chunked_list<T>>
+	: deriving_zippable<back_insertable_container<chunked_list<T>>> {};
+
+}
+
+#endif
+
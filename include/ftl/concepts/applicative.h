@@ -23,6 +23,7 @@
 #ifndef FTL_APPLICATIVE_H
 #define FTL_APPLICATIVE_H
 
+#include <tuple>
 #include "basic.h"
 #include "functor.h"
 
@@ -349,6 +350,180 @@ namespace ftl {
 	aapply;
 #endif
 
+	namespace _dtl {
+		// The value type of applying G to one element of each operand, in
+		// curried steps: ((G(A))(B))(C)...
+		template<typename G, typename...Xs>
+		struct ap_applied_type;
+
+		template<typename G, typename X>
+		struct ap_applied_type<G,X> {
+			using type = result_of<G(X)>;
+		};
+
+		template<typename G, typename X, typename...Xs>
+		struct ap_applied_type<G,X,Xs...> {
+			using type = typename ap_applied_type<result_of<G(X)>,Xs...>::type;
+		};
+
+		template<typename C>
+		auto ap_reserve(C& c, size_t n, int) -> decltype(c.reserve(n), void()) {
+			c.reserve(n);
+		}
+
+		template<typename C>
+		void ap_reserve(C&, size_t, long) {}
+	}
+
+	/**
+	 * Deferred applicative chain over containers.
+	 *
+	 * Evaluating applicative style&mdash;`fn % a * b * c`&mdash;goes left to
+	 * right, materialising a full intermediate container of partial
+	 * applications at every `*`. `ap_expr` is the expression template
+	 * equivalent: the operator chain merely records the function and
+	 * references to the operands, and evaluation&mdash;triggered by `eval()`
+	 * or by conversion to the result container&mdash;runs the whole cartesian
+	 * combination in one pass, emitting each finished element directly into
+	 * the final result. Semantics are identical to the eager chain; only the
+	 * intermediates disappear.
+	 *
+	 * A chain is started by wrapping the _first_ operand in \ref ap; the
+	 * remaining operands are passed to `*` as they are:
+	 *
+	 * \code
+	 *   ftl::function<int(int,int,int)> fn = ...;
+	 *
+	 *   std::vector<int> r = fn % ftl::ap(a) * b * c;
+	 *   // same elements as fn % a * b * c, but no intermediate vectors
+	 * \endcode
+	 *
+	 * As with the eager operators, `fn` must be curriable one operand at a
+	 * time&mdash;`ftl::function` and the \ref prelude's curried function
+	 * objects qualify.
+	 *
+	 * \warning The expression holds _references_ to its operands; evaluate
+	 *          it in the same full expression that creates it.
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename Fn, typename...As>
+	class ap_expr {
+	public:
+		/// Element type of the evaluated expression.
+		using value_type = typename _dtl::ap_applied_type<
+			Fn, Value_type<As>...
+		>::type;
+
+		/// Container type the expression evaluates to.
+		using result_type = Rebind<
+			typename std::tuple_element<0,std::tuple<As...>>::type,
+			value_type
+		>;
+
+		ap_expr(Fn fn, std::tuple<const As&...> operands)
+		: fn(std::move(fn)), operands(operands) {}
+
+		/// Extend the chain with one more operand.
+		template<typename B>
+		ap_expr<Fn,As...,B> operator* (const B& b) const {
+			return ap_expr<Fn,As...,B>{
+				fn, std::tuple_cat(operands, std::tie(b))
+			};
+		}
+
+		/**
+		 * Run the combination, emitting straight into the result.
+		 *
+		 * The result is reserved to its final size up front when the
+		 * container supports it.
+		 */
+		result_type eval() const {
+			return evalImpl(gen_seq<0,sizeof...(As)-1>{});
+		}
+
+		/// Implicit evaluation, so the chain can initialise its result.
+		operator result_type() const {
+			return eval();
+		}
+
+	private:
+		template<size_t...Is>
+		result_type evalImpl(seq<Is...>) const {
+			result_type out;
+
+			size_t n = 1;
+			size_t sizes[] = {
+				static_cast<size_t>(std::distance(
+					std::begin(std::get<Is>(operands)),
+					std::end(std::get<Is>(operands))
+				))...
+			};
+			for(auto s : sizes)
+				n *= s;
+
+			_dtl::ap_reserve(out, n, 0);
+
+			if(n > 0)
+				emit(out, fn, std::get<Is>(operands)...);
+
+			return out;
+		}
+
+		template<typename G, typename A>
+		static void emit(result_type& out, const G& g, const A& a) {
+			for(const auto& x : a)
+				out.push_back(g(x));
+		}
+
+		template<typename G, typename A, typename B, typename...Cs>
+		static void emit(
+				result_type& out, const G& g,
+				const A& a, const B& b, const Cs&...cs) {
+			for(const auto& x : a)
+				emit(out, g(x), b, cs...);
+		}
+
+		Fn fn;
+		std::tuple<const As&...> operands;
+	};
+
+	namespace _dtl {
+		/// First operand of an ap_expr, marked for deferred combination.
+		template<typename A>
+		struct ap_operand {
+			const A& a;
+		};
+	}
+
+	/**
+	 * Mark the first operand of a deferred applicative chain.
+	 *
+	 * `fn % ap(a) * b * c` builds an \ref ap_expr instead of evaluating
+	 * eagerly; see there for details.
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename A>
+	_dtl::ap_operand<plain_type<A>> ap(const A& a) {
+		return _dtl::ap_operand<plain_type<A>>{a};
+	}
+
+	/**
+	 * Start a deferred applicative chain.
+	 *
+	 * The expression template counterpart of `fmap`'s `operator%`; records
+	 * `fn` and the operand rather than mapping immediately.
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename Fn, typename A>
+	ap_expr<plain_type<Fn>,A> operator% (Fn&& fn, _dtl::ap_operand<A> a) {
+		return ap_expr<plain_type<Fn>,A>{
+			std::forward<Fn>(fn), std::tie(a.a)
+		};
+	}
+
 	/**
 	 * \page monoidapg Monoidal Alternatives
 	 *
@@ -458,6 +633,128 @@ namespace ftl {
 		using Fm = Rebind<F,maybe<A>>;
 		return value<A> % f | applicative<Fm>::pure(maybe<A>{});
 	}
+
+	namespace _dtl {
+		template<typename C>
+		auto try_reserve(C& c, size_t n, int)
+		-> decltype(c.reserve(n), void()) {
+			c.reserve(n);
+		}
+
+		template<typename C>
+		void try_reserve(C&, size_t, ...) {
+		}
+
+		/**
+		 * Forward a container element with the value category of its container.
+		 *
+		 * When `C` is an lvalue reference, elements are passed through as-is;
+		 * when the container was an rvalue, its elements may be moved from.
+		 */
+		template<typename C, typename T>
+		typename std::conditional<
+			std::is_lvalue_reference<C>::value, T&, T&&
+		>::type
+		forward_element(T& t) noexcept {
+			using result = typename std::conditional<
+				std::is_lvalue_reference<C>::value, T&, T&&
+			>::type;
+
+			return static_cast<result>(t);
+		}
+	}
+
+	/**
+	 * \interface applicative_traverse
+	 *
+	 * Effectful traversal of a container, in the applicative `A`.
+	 *
+	 * Instances provide `traverse`, mapping every element of a container
+	 * through an effectful function and collecting the results&mdash;so e.g.
+	 * `vector<T>` and `T -> either<E,U>` combine into `either<E,vector<U>>`.
+	 * An instance is expected to make a single pass, pre-size the result
+	 * container where possible, move results into place, and stop at the
+	 * first failed element.
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename A>
+	struct applicative_traverse {
+#ifdef DOCUMENTATION_GENERATOR
+		/**
+		 * Map `f` over `c`, sequencing the effects left to right.
+		 *
+		 * `f` maps elements of `c` to `A<U>`; the result is the rebound
+		 * container of `U`s, in `A`. Elements of an rvalue container may be
+		 * moved into `f`.
+		 */
+		template<typename F, typename C>
+		static A_Cu traverse(F&& f, C&& c);
+#endif
+
+		/// Compile time constant to check if a type is an instance.
+		static constexpr bool instance = false;
+	};
+
+	/**
+	 * Traverse a container with an effectful function.
+	 *
+	 * The classic use is validating a batch in one pass:
+	 * \code
+	 *   std::vector<request> batch = ...;
+	 *
+	 *   // either<error,std::vector<parsed>>; stops at the first bad request
+	 *   auto parsed = ftl::traverse(parseRequest, batch);
+	 * \endcode
+	 *
+	 * \tparam F must satisfy \ref fn`<A<U>(T)>`, where `A` is an instance of
+	 *         \ref applicative_traverse and `T` is the element type of `C`.
+	 *
+	 * \ingroup applicative
+	 */
+	template<
+			typename F,
+			typename C,
+			typename T = Value_type<plain_type<C>>,
+			typename AU = plain_type<result_of<F(T)>>,
+			typename = Requires<applicative_traverse<AU>::instance>
+	>
+	auto traverse(F&& f, C&& c)
+	-> decltype(
+			applicative_traverse<AU>::traverse(
+				std::forward<F>(f), std::forward<C>(c))) {
+		return applicative_traverse<AU>::traverse(
+				std::forward<F>(f), std::forward<C>(c));
+	}
+
+	namespace _dtl {
+		struct seq_identity {
+			template<typename A>
+			plain_type<A> operator()(A&& a) const {
+				return std::forward<A>(a);
+			}
+		};
+	}
+
+	/**
+	 * Turn a container of applicatives "inside out".
+	 *
+	 * `sequenceA` on e.g. a `vector<maybe<T>>` yields `maybe<vector<T>>`:
+	 * all values, if every element was a value, otherwise `nothing`. It is
+	 * simply `traverse` with the identity function; passing the container as
+	 * an rvalue moves the elements rather than copying them.
+	 *
+	 * \ingroup applicative
+	 */
+	template<
+			typename C,
+			typename A = Value_type<plain_type<C>>,
+			typename = Requires<applicative_traverse<A>::instance>
+	>
+	auto sequenceA(C&& c)
+	-> decltype(traverse(_dtl::seq_identity{}, std::forward<C>(c))) {
+		return traverse(_dtl::seq_identity{}, std::forward<C>(c));
+	}
 }
 
 #endif
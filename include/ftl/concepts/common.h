@@ -77,6 +77,21 @@ namespace ftl {
 	template<typename It>
 	struct bidirectional_iterable {};
 
+	/**
+	 * Tag for node-based containers whose iteration chases pointers.
+	 *
+	 * Some _deriving_ constructs are specialised for this tag to generate
+	 * implementations that software-prefetch ahead of the element being
+	 * processed, hiding part of the per-node cache miss that dominates
+	 * traversals of e.g. red-black trees.
+	 *
+	 * \tparam C must be BidirectionalIterable.
+	 *
+	 * \ingroup concept_common
+	 */
+	template<typename C>
+	struct node_based_container {};
+
 }
 
 #endif
@@ -23,6 +23,8 @@
 #ifndef FTL_FOLDABLE_H
 #define FTL_FOLDABLE_H
 
+#include <memory>
+#include <vector>
 #include "monoid.h"
 #include "../prelude.h"
 #include "common.h"
@@ -263,13 +265,90 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		// Detect reverse iterability, to pick the cheapest stack-safe
+		// right fold below
+		template<typename F>
+		struct has_rbegin {
+		private:
+			template<typename G>
+			static std::true_type test(
+				decltype(std::declval<const G&>().rbegin())*);
+
+			template<typename>
+			static std::false_type test(...);
+
+		public:
+			using type = decltype(test<F>(nullptr));
+			static constexpr bool value = type::value;
+		};
+
+		// ReverseIterable: walk the reverse iterators directly
+		template<typename Fn, typename U, typename F>
+		U foldr_impl(Fn&& fn, U z, const F& f, std::true_type) {
+			for(auto it = f.rbegin(); it != f.rend(); ++it) {
+				z = fn(*it, z);
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename U, typename F>
+		U foldr_impl_rv(Fn&& fn, U z, F& f, std::true_type) {
+			for(auto it = f.rbegin(); it != f.rend(); ++it) {
+				z = fn(std::move(*it), z);
+			}
+
+			return z;
+		}
+
+		/* Forward-only iterable: buffer the element addresses, then loop
+		 * backwards over the buffer. O(n) heap scratch instead of O(n)
+		 * call stack; recursing element-per-frame overflows on large
+		 * containers and defeats the inliner long before that.
+		 */
+		template<typename Fn, typename U, typename F>
+		U foldr_impl(Fn&& fn, U z, const F& f, std::false_type) {
+			std::vector<decltype(std::addressof(*f.begin()))> elems;
+			for(auto& e : f) {
+				elems.push_back(std::addressof(e));
+			}
+
+			for(auto it = elems.rbegin(); it != elems.rend(); ++it) {
+				z = fn(**it, z);
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename U, typename F>
+		U foldr_impl_rv(Fn&& fn, U z, F& f, std::false_type) {
+			std::vector<decltype(std::addressof(*f.begin()))> elems;
+			for(auto& e : f) {
+				elems.push_back(std::addressof(e));
+			}
+
+			for(auto it = elems.rbegin(); it != elems.rend(); ++it) {
+				z = fn(std::move(**it), z);
+			}
+
+			return z;
+		}
+	}
+
 	/**
 	 * An inheritable implementation of `foldable::foldr`.
 	 *
-	 * Any type that satisfies ReverseIterable may have their \ref foldablepg
+	 * Any type that satisfies \ref fwditerable may have their \ref foldablepg
 	 * instance simply inherit this implementation of `foldr` instead of
 	 * implementing it manually.
 	 *
+	 * The fold is always an iterative loop, never recursion whose depth
+	 * grows with the container: reverse iterators are walked directly
+	 * when the container has them, and forward-only containers get one
+	 * pass collecting element addresses into a scratch buffer which is
+	 * then consumed back to front.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -294,11 +373,10 @@ namespace ftl {
 				"The result of Fn(T,U) must be convertible to U"
 			);
 
-			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(*it, z);
-			}
-
-			return z;
+			return _dtl::foldr_impl(
+				std::forward<Fn>(fn), std::move(z), f,
+				typename _dtl::has_rbegin<F>::type{}
+			);
 		}
 
 		template<typename Fn, typename U>
@@ -310,11 +388,10 @@ namespace ftl {
 				"The result of Fn(T,U) must be convertible to U"
 			);
 
-			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(std::move(*it), z);
-			}
-
-			return z;
+			return _dtl::foldr_impl_rv(
+				std::forward<Fn>(fn), std::move(z), f,
+				typename _dtl::has_rbegin<F>::type{}
+			);
 		}
 	};
 
@@ -349,14 +426,20 @@ namespace ftl {
 				"The result of Fn(T) is not an instance of Monoid."
 			);
 
-			return foldable<F>::foldl(
-					[fn](const T& a, const M& b) {
-						return monoid<M>::append(
-							fn(a),
-							b);
+			/* The monoid value is accumulated on the side, in place when M
+			 * has an accumulator instance; threading it through the fold by
+			 * value would copy heap-backed monoids once per element.
+			 */
+			auto m = monoid<M>::id();
+			foldable<F>::foldl(
+					[&m,&fn](bool z, const T& a) {
+						appendTo(m, fn(a));
+						return z;
 					},
-					monoid<M>::id(),
+					true,
 					f);
+
+			return m;
 		}
 	};
 
@@ -413,6 +496,165 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	namespace _dtl {
+		/// Best-effort software prefetch; a no-op where unsupported.
+		inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(p);
+#else
+			(void) p;
+#endif
+		}
+
+		// How many nodes ahead of the one being processed to prefetch.
+		// Far enough to cover one memory round trip's worth of fold work,
+		// near enough not to thrash small caches.
+		constexpr size_t fold_prefetch_distance = 4;
+	}
+
+	/**
+	 * Foldable implementation for node-based containers.
+	 *
+	 * Functionally identical to the BidirectionalIterable derivation, but
+	 * the folds run a second iterator a few nodes ahead of the element
+	 * being processed and software-prefetch it. Pointer-chasing traversals
+	 * of e.g. red-black trees are memory latency bound&mdash;a cache miss
+	 * per node&mdash;so overlapping the next misses with the current
+	 * element's work recovers a large part of that latency.
+	 *
+	 * Requires that the instance type is BidirectionalIterable.
+	 *
+	 * Example:
+	 * \code
+	 *   template<typename T>
+	 *   struct foldable<MyTree<T>>
+	 *   : deriving_foldable<node_based_container<MyTree<T>>> {};
+	 * \endcode
+	 *
+	 * \ingroup foldable
+	 */
+	template<typename F>
+	struct deriving_foldable<node_based_container<F>>
+	: deriving_fold<F>, deriving_foldMap<F> {
+		using T = Value_type<F>;
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const F& f) {
+			static_assert(
+				std::is_convertible<
+					typename std::result_of<Fn(U,T)>::type,U
+				>::value,
+				"The result of Fn(U,T) must be convertible to U"
+			);
+
+			auto pf = f.begin();
+			for(size_t i = 0; i < _dtl::fold_prefetch_distance
+					&& pf != f.end(); ++i) {
+				++pf;
+			}
+
+			for(auto it = f.begin(); it != f.end(); ++it) {
+				if(pf != f.end()) {
+					_dtl::prefetch(std::addressof(*pf));
+					++pf;
+				}
+
+				z = fn(z, *it);
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const F& f) {
+			static_assert(
+				std::is_convertible<
+					typename std::result_of<Fn(T,U)>::type,U
+				>::value,
+				"The result of Fn(T,U) must be convertible to U"
+			);
+
+			auto pf = f.rbegin();
+			for(size_t i = 0; i < _dtl::fold_prefetch_distance
+					&& pf != f.rend(); ++i) {
+				++pf;
+			}
+
+			for(auto it = f.rbegin(); it != f.rend(); ++it) {
+				if(pf != f.rend()) {
+					_dtl::prefetch(std::addressof(*pf));
+					++pf;
+				}
+
+				z = fn(*it, z);
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Take a contiguous snapshot of a foldable's elements.
+	 *
+	 * Copies the elements&mdash;in fold order&mdash;into a plain vector,
+	 * which is itself Foldable. When the same structure is folded over and
+	 * over, folding a snapshot instead turns every traversal after the
+	 * first into a linear scan of contiguous memory, sidestepping the
+	 * per-node cache miss entirely.
+	 *
+	 * \see foldSnapshot
+	 *
+	 * \ingroup foldable
+	 */
+	template<
+			typename F,
+			typename T = Value_type<F>,
+			typename = Requires<Foldable<F>{}>
+	>
+	std::vector<T> snapshot(const F& f) {
+		std::vector<T> buf;
+		foldable<F>::foldl(
+			[&buf](char z, const T& t) {
+				buf.push_back(t);
+				return z;
+			},
+			char(0),
+			f
+		);
+
+		return buf;
+	}
+
+	/**
+	 * Left fold through a contiguous snapshot of the elements.
+	 *
+	 * Equivalent to `foldl(fn, z, f)`, except the elements are first bulk
+	 * copied into a contiguous buffer and the fold runs over that. One
+	 * pointer-chasing pass is still paid to build the buffer; the win is
+	 * when the fold itself is heavy enough that its memory stalls dominate,
+	 * or as a one-liner where a reusable \ref snapshot is overkill.
+	 *
+	 * \see snapshot
+	 *
+	 * \ingroup foldable
+	 */
+	template<
+			typename Fn,
+			typename U,
+			typename F,
+			typename T = Value_type<F>,
+			typename = Requires<Foldable<F>{}>
+	>
+	U foldSnapshot(Fn fn, U z, const F& f) {
+		for(const auto& t : snapshot(f)) {
+			z = fn(z, t);
+		}
+
+		return z;
+	}
+
 #ifndef DOCUMENTATION_GENERATOR
 	constexpr struct _fold {
 		template<
@@ -226,7 +226,9 @@ namespace ftl {
 				e = fn(std::move(e));
 			}
 
-			return f;
+			// Note: f is a named rvalue reference and hence an lvalue here;
+			// without the move, the container would be copied on return.
+			return std::move(f);
 		}
 	};
 
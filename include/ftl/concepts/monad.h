@@ -1007,6 +1007,168 @@ namespace ftl {
 	 */
 	mjoin;
 #endif
+
+	namespace _dtl {
+		template<typename M, typename...Fs>
+		struct mdo_result {
+			using type = plain_type<M>;
+		};
+
+		template<typename M, typename F, typename...Fs>
+		struct mdo_result<M,F,Fs...> {
+			using type = typename mdo_result<
+				decltype(std::declval<M>() >>= std::declval<F>()), Fs...
+			>::type;
+		};
+	}
+
+	template<
+			typename M,
+			typename = Requires<Monad<plain_type<M>>{}>
+	>
+	plain_type<M> mdo(M&& m) {
+		return std::forward<M>(m);
+	}
+
+	/**
+	 * Do-notation style chaining of monadic computations.
+	 *
+	 * Binds `m` through each of the given continuations, in left-to-right
+	 * order. Equivalent to a left associative chain of `operator>>=`:
+	 * \code
+	 *   mdo(m, f, g, h) <=> ((m >>= f) >>= g) >>= h
+	 * \endcode
+	 * but without the parenthesisation that `operator>>=`'s right
+	 * associativity would otherwise force on long chains.
+	 *
+	 * Whatever short-circuiting `M`'s bind performs applies to the whole
+	 * chain&mdash;a `nothing` or left value produced at any step skips the
+	 * remaining continuations. Because the steps are evaluated eagerly in a
+	 * single call frame, chaining this way introduces no intermediate lambda
+	 * captures or closure allocations of its own; for value monads like
+	 * \ref maybe and \ref either, a ten step chain is just ten conditional
+	 * calls.
+	 *
+	 * \note For monads that are themselves deferred computations&mdash;e.g.
+	 *       `ftl::function` and its transformer stacks&mdash;each step still
+	 *       pays `M`'s usual bind cost; see \ref ftl::fuse "fuse" for how to
+	 *       avoid per-step type erasure there.
+	 *
+	 * \par Examples
+	 * \code
+	 *   ftl::maybe<int> mightFail(int);
+	 *   ftl::maybe<float> alsoMightFail(int);
+	 *
+	 *   ftl::maybe<float> example(int x) {
+	 *       return ftl::mdo(
+	 *           mightFail(x),
+	 *           mightFail,
+	 *           alsoMightFail
+	 *       );
+	 *   }
+	 * \endcode
+	 *
+	 * \ingroup monad
+	 */
+	template<
+			typename M,
+			typename F,
+			typename...Fs,
+			typename = Requires<Monad<plain_type<M>>{}>
+	>
+	typename _dtl::mdo_result<M,F,Fs...>::type
+	mdo(M&& m, F&& f, Fs&&...fs) {
+		return mdo(
+			std::forward<M>(m) >>= std::forward<F>(f),
+			std::forward<Fs>(fs)...
+		);
+	}
+
+	/**
+	 * \interface monad_rec
+	 *
+	 * Monads supporting constant-space tail recursion.
+	 *
+	 * Expressing a loop as a chain of `operator>>=` grows the stack&mdash;or
+	 * the thunk chain, for deferred monads&mdash;linearly with the iteration
+	 * count. Instances of monad_rec know how to run such a loop as a
+	 * trampoline instead: `tailRec` keeps re-applying the step function
+	 * iteratively, in constant space, however many steps it takes.
+	 *
+	 * The step function signals its intent through an `ftl::either`: a left
+	 * value is the seed of the next iteration, a right value ends the loop
+	 * as the final result.
+	 *
+	 * Rather than using an instance directly, go through `ftl::tailRecM`.
+	 *
+	 * \ingroup monad
+	 */
+	template<typename M>
+	struct monad_rec {
+#ifdef DOCUMENTATION_GENERATOR
+		/**
+		 * Run a monadic loop in constant space.
+		 *
+		 * `f` maps a seed `S` to `M<either<S,R>>`; iteration continues on
+		 * left values and ends on the first right.
+		 */
+		template<typename F, typename S>
+		static M_R tailRec(F&& f, S seed);
+#endif
+
+		/// Compile time constant to check if a type is an instance.
+		static constexpr bool instance = false;
+	};
+
+	/**
+	 * Concepts lite-compatible check for monad_rec instances.
+	 *
+	 * \ingroup monad
+	 */
+	template<typename M>
+	struct MonadRec {
+		static constexpr bool value = monad_rec<M>::instance;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	/**
+	 * Tail-call-safe monadic recursion.
+	 *
+	 * The monadic counterpart of a while loop: starting from `seed`, `f` is
+	 * applied over and over&mdash;each application in the monad `M`&mdash;
+	 * until it yields a right value, which becomes the result. Execution is
+	 * trampolined by the monad's \ref monad_rec instance, so ten iterations
+	 * and ten million consume the same stack space:
+	 *
+	 * \code
+	 *   auto r = ftl::tailRecM(
+	 *       [](int n) -> ftl::either<int,std::string> {
+	 *           return n < 1000000
+	 *               ? ftl::make_left<std::string>(n+1)
+	 *               : ftl::make_right<int>(std::string("done"));
+	 *       },
+	 *       0
+	 *   );
+	 * \endcode
+	 *
+	 * \tparam F must satisfy \ref fn`<M<either<S,R>>(S)>`, where `M` is an
+	 *         instance of \ref monad_rec.
+	 *
+	 * \ingroup monad
+	 */
+	template<
+			typename F,
+			typename S,
+			typename ME = plain_type<result_of<F(S)>>,
+			typename = Requires<MonadRec<ME>{}>
+	>
+	auto tailRecM(F&& f, S seed)
+	-> decltype(monad_rec<ME>::tailRec(std::forward<F>(f), std::move(seed))) {
+		return monad_rec<ME>::tailRec(std::forward<F>(f), std::move(seed));
+	}
 }
 
 #endif
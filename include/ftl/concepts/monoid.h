@@ -23,6 +23,7 @@
 #ifndef FTL_MONOID_H
 #define FTL_MONOID_H
 
+#include <limits>
 #include <type_traits>
 #include "../prelude.h"
 
@@ -242,6 +243,100 @@ namespace ftl {
 	mappend;
 #endif
 
+	/**
+	 * \interface accumulator
+	 *
+	 * \brief Optional in-place refinement of \ref monoidpg.
+	 *
+	 * `monoid::append` is value-oriented: it constructs a fresh monoid value
+	 * from its operands. For heap-backed monoids&mdash;vectors, strings, and
+	 * the like&mdash;that means copying the entire accumulated state once per
+	 * appended element, turning a streaming fold quadratic. Monoids that can
+	 * do better may specialise this interface to splice new elements into an
+	 * existing accumulator in place; `ftl::appendTo` (and through it, the
+	 * derived `foldMap`) picks the in-place path up automatically.
+	 *
+	 * Instances must be consistent with the monoid:
+	 * \code
+	 *   append_to(m, x) <=> m = monoid<M>::append(std::move(m), x)
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename M>
+	struct accumulator {
+#ifdef DOCUMENTATION_GENERATOR
+		/**
+		 * Append `x` into `m`, mutating `m`.
+		 *
+		 * Implementations are encouraged to also provide an rvalue overload
+		 * that cannibalises `x`.
+		 */
+		static void append_to(M& m, const M& x);
+#endif
+
+		/// Compile time constant to check if a type is an instance.
+		static constexpr bool instance = false;
+	};
+
+	/**
+	 * Concepts lite-compatible check for accumulator instances.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename M>
+	struct Accumulator {
+		static constexpr bool value = accumulator<M>::instance;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	namespace _dtl {
+		template<typename M, typename X>
+		void append_to_impl(M& m, X&& x, std::true_type) {
+			accumulator<M>::append_to(m, std::forward<X>(x));
+		}
+
+		template<typename M, typename X>
+		void append_to_impl(M& m, X&& x, std::false_type) {
+			m = monoid<M>::append(std::move(m), std::forward<X>(x));
+		}
+	}
+
+	/**
+	 * Append a monoid value into an existing accumulator.
+	 *
+	 * Dispatches to `accumulator<M>::append_to` when `M` has an instance,
+	 * and falls back on move-assigning the result of `monoid::append`
+	 * otherwise, so it is always safe to call on any monoid.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto acc = ftl::monoid<std::vector<int>>::id();
+	 *   for(auto& fragment : fragments)
+	 *       ftl::appendTo(acc, fragment);
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<
+			typename M,
+			typename X,
+			typename = Requires<
+				Monoid<M>{}
+				&& std::is_same<M,plain_type<X>>::value
+			>
+	>
+	void appendTo(M& m, X&& x) {
+		_dtl::append_to_impl(
+			m, std::forward<X>(x),
+			std::integral_constant<bool,accumulator<M>::instance>{}
+		);
+	}
+
 	/**
 	 * Implementation of monoid for numbers, interpreted as sums.
 	 *
@@ -466,6 +561,401 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Monoid of numbers under `min`.
+	 *
+	 * The identity is the largest representable `N`, so folding an empty
+	 * range yields `std::numeric_limits<N>::max()`.
+	 *
+	 * \tparam N Any arithmetic type, or a type that specialises
+	 *           `std::numeric_limits` and is \ref orderablepg.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct min_monoid {
+		/// Allows implicit conversion from `N`, like the other wrappers.
+		constexpr min_monoid(N num)
+		noexcept(std::is_nothrow_copy_constructible<N>::value)
+			: n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create min values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr min_monoid<N> minOf(N num)
+	noexcept(std::is_nothrow_constructible<min_monoid<N>,N>::value) {
+		return min_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for min.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<min_monoid<N>> {
+		static constexpr min_monoid<N> id() noexcept {
+			return minOf(std::numeric_limits<N>::max());
+		}
+
+		static constexpr min_monoid<N> append(
+				const min_monoid<N>& n1,
+				const min_monoid<N>& n2) {
+
+			return n2.n < n1.n ? n2 : n1;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of numbers under `max`.
+	 *
+	 * The identity is the smallest representable `N`&mdash;
+	 * `std::numeric_limits<N>::lowest()`, which unlike `min()` is also
+	 * correct for floating point types.
+	 *
+	 * \tparam N Any arithmetic type, or a type that specialises
+	 *           `std::numeric_limits` and is \ref orderablepg.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct max_monoid {
+		/// Allows implicit conversion from `N`, like the other wrappers.
+		constexpr max_monoid(N num)
+		noexcept(std::is_nothrow_copy_constructible<N>::value)
+			: n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create max values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr max_monoid<N> maxOf(N num)
+	noexcept(std::is_nothrow_constructible<max_monoid<N>,N>::value) {
+		return max_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for max.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<max_monoid<N>> {
+		static constexpr max_monoid<N> id() noexcept {
+			return maxOf(std::numeric_limits<N>::lowest());
+		}
+
+		static constexpr max_monoid<N> append(
+				const max_monoid<N>& n1,
+				const max_monoid<N>& n2) {
+
+			return n1.n < n2.n ? n2 : n1;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of integers under bitwise AND.
+	 *
+	 * The identity is the all-ones bit pattern `~N(0)`.
+	 *
+	 * \tparam N Any integral type. Unsigned types are recommended, as the
+	 *           wrapper is about bit patterns, not arithmetic values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct and_monoid {
+		static_assert(
+			std::is_integral<N>::value,
+			"Bitwise monoids require an integral type"
+		);
+
+		/// Allows implicit conversion from `N`, like the other wrappers.
+		constexpr and_monoid(N num) noexcept : n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create AND values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr and_monoid<N> bitAnd(N num) noexcept {
+		return and_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for bitwise AND.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<and_monoid<N>> {
+		static constexpr and_monoid<N> id() noexcept {
+			return bitAnd(N(~N(0)));
+		}
+
+		static constexpr and_monoid<N> append(
+				const and_monoid<N>& n1,
+				const and_monoid<N>& n2) noexcept {
+
+			return bitAnd(N(n1.n & n2.n));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of integers under bitwise OR.
+	 *
+	 * The identity is `N(0)`.
+	 *
+	 * \tparam N Any integral type. Unsigned types are recommended, as the
+	 *           wrapper is about bit patterns, not arithmetic values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct or_monoid {
+		static_assert(
+			std::is_integral<N>::value,
+			"Bitwise monoids require an integral type"
+		);
+
+		/// Allows implicit conversion from `N`, like the other wrappers.
+		constexpr or_monoid(N num) noexcept : n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create OR values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr or_monoid<N> bitOr(N num) noexcept {
+		return or_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for bitwise OR.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<or_monoid<N>> {
+		static constexpr or_monoid<N> id() noexcept {
+			return bitOr(N(0));
+		}
+
+		static constexpr or_monoid<N> append(
+				const or_monoid<N>& n1,
+				const or_monoid<N>& n2) noexcept {
+
+			return bitOr(N(n1.n | n2.n));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of integers under bitwise XOR.
+	 *
+	 * The identity is `N(0)`; every element is its own inverse, making this
+	 * the classic parity/checksum accumulator.
+	 *
+	 * \tparam N Any integral type. Unsigned types are recommended, as the
+	 *           wrapper is about bit patterns, not arithmetic values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct xor_monoid {
+		static_assert(
+			std::is_integral<N>::value,
+			"Bitwise monoids require an integral type"
+		);
+
+		/// Allows implicit conversion from `N`, like the other wrappers.
+		constexpr xor_monoid(N num) noexcept : n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create XOR values.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr xor_monoid<N> bitXor(N num) noexcept {
+		return xor_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for bitwise XOR.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<xor_monoid<N>> {
+		static constexpr xor_monoid<N> id() noexcept {
+			return bitXor(N(0));
+		}
+
+		static constexpr xor_monoid<N> append(
+				const xor_monoid<N>& n1,
+				const xor_monoid<N>& n2) noexcept {
+
+			return bitXor(N(n1.n ^ n2.n));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		// Identifies monoids whose append is a plain arithmetic operation on
+		// an underlying arithmetic type. Folds over contiguous storage may
+		// use the exposed primitive operation in reassociated, vectorizable
+		// loops; the monoid laws license the reordering.
+		template<typename M>
+		struct arith_monoid : std::false_type {};
+
+		template<typename N>
+		struct arith_monoid<sum_monoid<N>> : std::is_arithmetic<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return N(0);
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return a + b;
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<prod_monoid<N>> : std::is_arithmetic<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return N(1);
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return a * b;
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<min_monoid<N>> : std::is_arithmetic<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return std::numeric_limits<N>::max();
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return b < a ? b : a;
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<max_monoid<N>> : std::is_arithmetic<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return std::numeric_limits<N>::lowest();
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return a < b ? b : a;
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<and_monoid<N>> : std::is_integral<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return N(~N(0));
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return N(a & b);
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<or_monoid<N>> : std::is_integral<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return N(0);
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return N(a | b);
+			}
+		};
+
+		template<typename N>
+		struct arith_monoid<xor_monoid<N>> : std::is_integral<N>::type {
+			using primitive = N;
+
+			static constexpr N raw_id() noexcept {
+				return N(0);
+			}
+
+			static constexpr N combine(N a, N b) noexcept {
+				return N(a ^ b);
+			}
+		};
+	}
+
 	/**
 	 * Wrapper for booleans to make them a monoid.
 	 *
@@ -136,6 +136,57 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<typename...Is>
+		struct all_fwd_iterable : std::true_type {};
+
+		template<typename I, typename...Is>
+		struct all_fwd_iterable<I,Is...>
+		: std::integral_constant<
+			bool,
+			ForwardIterable<I>() && all_fwd_iterable<Is...>::value
+		> {};
+
+		/* N-way zip machinery: the iterators travel in a tuple, but the
+		 * elements themselves flow straight from the sources into the
+		 * zipping function—no intermediate tuples of payload.
+		 */
+		template<size_t...Ns, typename Tup>
+		bool zip_at_end(seq<Ns...>, const Tup& its, const Tup& ends) {
+			bool bs[] = { (std::get<Ns>(its) == std::get<Ns>(ends))... };
+
+			for(bool b : bs) {
+				if(b)
+					return true;
+			}
+
+			return false;
+		}
+
+		template<size_t...Ns, typename Tup>
+		void zip_advance(seq<Ns...>, Tup& its) {
+			int expand[] = {(++std::get<Ns>(its), 0)...};
+			(void) expand;
+		}
+
+		template<
+				typename R, typename F, typename Z,
+				typename Tup, size_t...Ns
+		>
+		R variadic_zip(F& f, const Z& z, Tup its, Tup ends, seq<Ns...>) {
+			R result;
+
+			auto zit = z.begin();
+			while(zit != z.end() && !zip_at_end(seq<Ns...>{}, its, ends)) {
+				result.push_back(f(*zit, *std::get<Ns>(its)...));
+				++zit;
+				zip_advance(seq<Ns...>{}, its);
+			}
+
+			return result;
+		}
+	}
+
 	template<typename>
 	struct deriving_zippable {};
 
@@ -195,6 +246,36 @@ namespace ftl {
 			return result;
 		}
 
+		/**
+		 * N-way overload: zip three or more sources in a single pass.
+		 *
+		 * Equivalent in result to nesting binary zips and unpacking the
+		 * tuples in `f`, but each element is read from its source exactly
+		 * once and handed straight to `f`&mdash;no tuple-of-tuples
+		 * temporaries at any level. The result ends at the shortest
+		 * source, as the binary laws dictate.
+		 */
+		template<
+				typename F, typename I1, typename...Is,
+				typename U = result_of<
+					F(T,Value_type<I1>,Value_type<Is>...)
+				>,
+				typename = Requires<
+					(sizeof...(Is) > 0)
+					&& _dtl::all_fwd_iterable<I1,Is...>::value
+				>
+		>
+		static Z_<U> zipWith(
+				F f, const Z_<T>& z, const I1& i1, const Is&...is) {
+
+			return _dtl::variadic_zip<Z_<U>>(
+				f, z,
+				std::make_tuple(i1.begin(), is.begin()...),
+				std::make_tuple(i1.end(), is.end()...),
+				gen_seq<0,sizeof...(Is)>{}
+			);
+		}
+
 		static constexpr bool instance = true;
 
 	};
@@ -211,6 +292,24 @@ namespace ftl {
 			return zippable<Z>::zipWith(std::forward<F>(f), z, i);
 		}
 
+		// N-way zips dispatch to the instance's variadic zipWith, where
+		// available. No currying at four-plus arguments.
+		template<
+				typename F, typename Z,
+				typename I1, typename I2, typename...Is,
+				typename = Requires<Zippable<Z>{}>
+		>
+		auto operator() (
+				F&& f, const Z& z,
+				const I1& i1, const I2& i2, const Is&...is) const
+		-> decltype(
+				zippable<Z>::zipWith(std::forward<F>(f), z, i1, i2, is...)
+		) {
+			return zippable<Z>::zipWith(
+				std::forward<F>(f), z, i1, i2, is...
+			);
+		}
+
 		using curried_ternf<_zipWith>::operator();
 	} zipWith{};
 #else
@@ -226,6 +325,11 @@ namespace ftl {
 	 *
 	 * Allows a clean and terse call syntax of the concept method.
 	 *
+	 * Also callable with three or more sources&mdash;
+	 * `zipWith(f, z1, z2, ..., zn)`&mdash;in which case all sources are
+	 * iterated in one pass and their elements fed directly to `f`, with
+	 * no nested zips or tuple temporaries. The n-ary form is not curried.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -24,8 +24,11 @@
 #define FTL_EITHER_H
 
 #include <stdexcept>
+#include <utility>
+#include <vector>
 #include "concepts/orderable.h"
 #include "concepts/monad.h"
+#include "sum_type.h"
 
 namespace ftl {
 
@@ -36,22 +39,6 @@ namespace ftl {
 		};
 	}
 
-	/**
-	 * \defgroup either Either
-	 *
-	 * The either data type and associated concept instances.
-	 *
-	 * \code
-	 *   #include <ftl/either.h>
-	 * \endcode
-	 *
-	 * \par Dependencies
-	 * The following additional headers and modules are included by this module.
-	 * - `<stdexcept>`
-	 * - \ref monad
-	 * - \ref orderable
-	 */
-
 	/**
 	 * Tag used to distinguish which "side" to construct
 	 *
@@ -70,6 +57,349 @@ namespace ftl {
 	 */
 	struct right_tag_t {};
 
+	namespace _dtl {
+
+		/* Selects the storage layout of either<L,R>:
+		 *
+		 * 0 - general: manual construction, destruction and copying of the
+		 *     active side.
+		 * 1 - trivial: both sides are trivially copyable, so all special
+		 *     members are defaulted and the whole either is trivially
+		 *     copyable (and hence register passable in common ABIs).
+		 * 2 - empty left: the left side is an empty, trivial tag type and
+		 *     no L subobject is stored at all.
+		 */
+		template<typename L, typename R>
+		struct either_layout {
+			static constexpr int value =
+				std::is_trivially_copyable<L>::value
+				&& std::is_trivially_copyable<R>::value
+				? 1
+				: (std::is_empty<L>::value && std::is_trivial<L>::value
+					? 2
+					: 0);
+		};
+
+		template<typename L, typename R, int = either_layout<L,R>::value>
+		struct either_storage;
+
+		template<typename L, typename R>
+		struct either_storage<L,R,0> {
+
+			either_storage() = delete;
+
+			either_storage(const either_storage& e)
+			noexcept(  std::is_nothrow_copy_constructible<L>::value
+					&& std::is_nothrow_copy_constructible<R>::value)
+			: tag(e.tag) {
+				if(tag == LEFT)
+					new (&l) L(e.l);
+				else if(tag == RIGHT)
+					new (&r) R(e.r);
+			}
+
+			either_storage(either_storage&& e)
+			noexcept(  std::is_nothrow_move_constructible<L>::value
+					&& std::is_nothrow_move_constructible<R>::value)
+			: tag(e.tag) {
+				if(tag == LEFT)
+					new (&l) L(std::move(e.l));
+				else if(tag == RIGHT)
+					new (&r) R(std::move(e.r));
+			}
+
+			constexpr either_storage(left_tag_t, const L& left)
+			noexcept(std::is_nothrow_copy_constructible<L>::value)
+			: l(left), tag(LEFT) {
+			}
+
+			constexpr either_storage(left_tag_t, L&& left)
+			noexcept(std::is_nothrow_move_constructible<L>::value)
+			: l(std::move(left)), tag(LEFT) {
+			}
+
+			constexpr either_storage(right_tag_t, const R& right)
+			noexcept(std::is_nothrow_copy_constructible<R>::value)
+			: r(right), tag(RIGHT) {
+			}
+
+			constexpr either_storage(right_tag_t, R&& right)
+			noexcept(std::is_nothrow_move_constructible<R>::value)
+			: r(std::move(right)), tag(RIGHT) {
+			}
+
+			~either_storage() {
+				if(tag == LEFT)
+					l.~L();
+				else if(tag == RIGHT)
+					r.~R();
+			}
+
+			either_storage& operator= (const either_storage& e) {
+				if(this == &e)
+					return *this;
+
+				switch(tag) {
+				case LEFT:
+					if(e.tag == LEFT)
+						l = e.l;
+
+					else {
+						l.~L();
+						tag = e.tag;
+						new (&r) R(e.r);
+					}
+					break;
+
+				case RIGHT:
+					if(e.tag == RIGHT)
+						r = e.r;
+
+					else {
+						r.~R();
+						tag = e.tag;
+						new (&l) L(e.l);
+					}
+					break;
+				}
+
+				return *this;
+			}
+
+			either_storage& operator= (either_storage&& e) {
+				switch(tag) {
+				case LEFT:
+					if(e.tag == LEFT)
+						l = std::move(e.l);
+
+					else {
+						l.~L();
+						tag = e.tag;
+						new (&r) R(std::move(e.r));
+					}
+					break;
+
+				case RIGHT:
+					if(e.tag == RIGHT)
+						r = std::move(e.r);
+
+					else {
+						r.~R();
+						tag = e.tag;
+						new (&l) L(std::move(e.l));
+					}
+					break;
+				}
+
+				return *this;
+			}
+
+			L& get_left() noexcept {
+				return l;
+			}
+
+			constexpr const L& get_left() const noexcept {
+				return l;
+			}
+
+			R& get_right() noexcept {
+				return r;
+			}
+
+			constexpr const R& get_right() const noexcept {
+				return r;
+			}
+
+			union {
+				L l;
+				R r;
+			};
+
+			tag_t tag;
+		};
+
+		template<typename L, typename R>
+		struct either_storage<L,R,1> {
+
+			either_storage() = delete;
+			either_storage(const either_storage&) = default;
+			either_storage(either_storage&&) = default;
+
+			constexpr either_storage(left_tag_t, const L& left) noexcept
+			: l(left), tag(LEFT) {
+			}
+
+			constexpr either_storage(left_tag_t, L&& left) noexcept
+			: l(std::move(left)), tag(LEFT) {
+			}
+
+			constexpr either_storage(right_tag_t, const R& right) noexcept
+			: r(right), tag(RIGHT) {
+			}
+
+			constexpr either_storage(right_tag_t, R&& right) noexcept
+			: r(std::move(right)), tag(RIGHT) {
+			}
+
+			~either_storage() = default;
+
+			either_storage& operator= (const either_storage&) = default;
+			either_storage& operator= (either_storage&&) = default;
+
+			L& get_left() noexcept {
+				return l;
+			}
+
+			constexpr const L& get_left() const noexcept {
+				return l;
+			}
+
+			R& get_right() noexcept {
+				return r;
+			}
+
+			constexpr const R& get_right() const noexcept {
+				return r;
+			}
+
+			union {
+				L l;
+				R r;
+			};
+
+			tag_t tag;
+		};
+
+		template<typename L, typename R>
+		struct either_storage<L,R,2> {
+
+			either_storage() = delete;
+
+			either_storage(const either_storage& e)
+			noexcept(std::is_nothrow_copy_constructible<R>::value)
+			: tag(e.tag) {
+				if(tag == RIGHT)
+					new (&r) R(e.r);
+			}
+
+			either_storage(either_storage&& e)
+			noexcept(std::is_nothrow_move_constructible<R>::value)
+			: tag(e.tag) {
+				if(tag == RIGHT)
+					new (&r) R(std::move(e.r));
+			}
+
+			constexpr either_storage(left_tag_t, const L&) noexcept
+			: tag(LEFT) {
+			}
+
+			constexpr either_storage(left_tag_t, L&&) noexcept
+			: tag(LEFT) {
+			}
+
+			constexpr either_storage(right_tag_t, const R& right)
+			noexcept(std::is_nothrow_copy_constructible<R>::value)
+			: r(right), tag(RIGHT) {
+			}
+
+			constexpr either_storage(right_tag_t, R&& right)
+			noexcept(std::is_nothrow_move_constructible<R>::value)
+			: r(std::move(right)), tag(RIGHT) {
+			}
+
+			~either_storage() {
+				if(tag == RIGHT)
+					r.~R();
+			}
+
+			either_storage& operator= (const either_storage& e) {
+				if(this == &e)
+					return *this;
+
+				if(tag == RIGHT) {
+					if(e.tag == RIGHT)
+						r = e.r;
+
+					else {
+						r.~R();
+						tag = e.tag;
+					}
+				}
+				else if(e.tag == RIGHT) {
+					new (&r) R(e.r);
+					tag = e.tag;
+				}
+
+				return *this;
+			}
+
+			either_storage& operator= (either_storage&& e) {
+				if(tag == RIGHT) {
+					if(e.tag == RIGHT)
+						r = std::move(e.r);
+
+					else {
+						r.~R();
+						tag = e.tag;
+					}
+				}
+				else if(e.tag == RIGHT) {
+					new (&r) R(std::move(e.r));
+					tag = e.tag;
+				}
+
+				return *this;
+			}
+
+			/* No L is stored; left accesses all refer to one shared
+			 * instance, which is harmless precisely because L is stateless.
+			 */
+			static L& left_instance() noexcept {
+				static L inst;
+				return inst;
+			}
+
+			L& get_left() noexcept {
+				return left_instance();
+			}
+
+			const L& get_left() const noexcept {
+				return left_instance();
+			}
+
+			R& get_right() noexcept {
+				return r;
+			}
+
+			constexpr const R& get_right() const noexcept {
+				return r;
+			}
+
+			union {
+				R r;
+			};
+
+			tag_t tag;
+		};
+	}
+
+	/**
+	 * \defgroup either Either
+	 *
+	 * The either data type and associated concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/either.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * The following additional headers and modules are included by this module.
+	 * - `<stdexcept>`
+	 * - \ref monad
+	 * - \ref orderable
+	 * - \ref sum_type
+	 */
+
 	/**
 	 * \brief Data type modelling a "one of" type.
 	 *
@@ -113,81 +443,53 @@ namespace ftl {
 		either() = delete;
 
 		/// Copy c-tor
-		either(const either& e)
-		noexcept(  std::is_nothrow_copy_constructible<L>::value
-				&& std::is_nothrow_copy_constructible<R>::value)
-		: tag(e.tag) {
-			if(tag == _dtl::LEFT)
-				new (&l) L(e.l);
-			else if(tag == _dtl::RIGHT)
-				new (&r) R(e.r);
-		}
+		either(const either&) = default;
 
 		/// Move c-tor
-		either(either&& e)
-		noexcept(  std::is_nothrow_move_constructible<L>::value
-				&& std::is_nothrow_move_constructible<R>::value)
-		: tag(e.tag) {
-			switch(tag) {
-			case _dtl::LEFT:
-				new (&l) L(std::move(e.l));
-				break;
-
-			case _dtl::RIGHT:
-				new (&r) R(std::move(e.r));
-				break;
-			default:
-				break;
-			}
-		}
+		either(either&&) = default;
 
 		/**
 		 * Construct a left value
 		 */
-		constexpr either(left_tag_t, const L& left)
+		constexpr either(left_tag_t t, const L& left)
 		noexcept(std::is_nothrow_copy_constructible<L>::value)
-		: l(left), tag(_dtl::LEFT) {
+		: store(t, left) {
 		}
 
 		/**
 		 * Move a left value
 		 */
-		constexpr either(left_tag_t, L&& left)
+		constexpr either(left_tag_t t, L&& left)
 		noexcept(std::is_nothrow_copy_constructible<L>::value)
-		: l(std::move(left)), tag(_dtl::LEFT) {
+		: store(t, std::move(left)) {
 		}
 
 		/// Construct a right type value
-		constexpr either(right_tag_t, const R& right)
+		constexpr either(right_tag_t t, const R& right)
 		noexcept(std::is_nothrow_copy_constructible<R>::value)
-		: r(right), tag(_dtl::RIGHT) {
+		: store(t, right) {
 		}
 
 		/// Move a right value
-		constexpr either(right_tag_t, R&& right)
+		constexpr either(right_tag_t t, R&& right)
 		noexcept(std::is_nothrow_move_constructible<R>::value)
-		: r(std::move(right)), tag(_dtl::RIGHT) {
+		: store(t, std::move(right)) {
 		}
 
-		~either() {
-			if(tag == _dtl::LEFT)
-				l.~L();
-			else if(tag == _dtl::RIGHT)
-				r.~R();
-		}
+		~either() = default;
 
 		/**
 		 *  Check if the either instance contains the left type.
 		 */
 		constexpr bool isLeft() const noexcept {
-			return tag == _dtl::LEFT;
+			return store.tag == _dtl::LEFT;
 		}
 
 		/**
 		 *  Check if the either instance contains the right type.
 		 */
 		constexpr bool isRight() const noexcept {
-			return tag == _dtl::RIGHT;
+			return store.tag == _dtl::RIGHT;
 		}
 
 		/**
@@ -197,7 +499,7 @@ namespace ftl {
 		 *  really of type R.
 		 */
 		L& left() noexcept {
-			return l;
+			return store.get_left();
 		}
 
 		/**
@@ -207,17 +509,17 @@ namespace ftl {
 		 *  really of type L.
 		 */
 		R& right() noexcept {
-			return r;
+			return store.get_right();
 		}
 
 		/// \overload
 		constexpr L left() const noexcept {
-			return l;
+			return store.get_left();
 		}
 
 		/// \overload
 		constexpr R right() const noexcept {
-			return r;
+			return store.get_right();
 		}
 
 		/**
@@ -226,7 +528,7 @@ namespace ftl {
 		 * \return true if the instance is of \em right type.
 		 */
 		explicit constexpr operator bool () const noexcept {
-			return tag == _dtl::RIGHT;
+			return store.tag == _dtl::RIGHT;
 		}
 
 		/**
@@ -235,8 +537,8 @@ namespace ftl {
 		 * \throws std::logic_error if called on a left type.
 		 */
 		R& operator* () {
-			if(tag == _dtl::RIGHT)
-				return r;
+			if(store.tag == _dtl::RIGHT)
+				return store.get_right();
 
 			throw std::logic_error(
 					"Attempting to access 'right' value of left type.");
@@ -244,8 +546,8 @@ namespace ftl {
 
 		/// \overload
 		const R& operator* () const {
-			if(tag == _dtl::RIGHT)
-				return r;
+			if(store.tag == _dtl::RIGHT)
+				return store.get_right();
 
 			throw std::logic_error(
 					"Attempting to access 'right' value of right left.");
@@ -257,8 +559,8 @@ namespace ftl {
 		 * \throws std::logic_error if called on a left type.
 		 */
 		R* operator-> () {
-			if(tag == _dtl::RIGHT)
-				return &r;
+			if(store.tag == _dtl::RIGHT)
+				return &store.get_right();
 
 			throw std::logic_error(
 					"Attempting to access 'right' value of left type.");
@@ -266,76 +568,83 @@ namespace ftl {
 
 		/// \overload
 		const R* operator-> () const {
-			if(tag == _dtl::RIGHT)
-				return &r;
+			if(store.tag == _dtl::RIGHT)
+				return &store.get_right();
 
 			throw std::logic_error(
 					"Attempting to access 'right' value of left type.");
 		}
 
-		either& operator= (const either& e) {
-			// Deal with self assignment
-			if(this == &e)
-				return *this;
-
-			switch(tag) {
-			case _dtl::LEFT:
-				if(e.tag == _dtl::LEFT) 
-					l = e.l;
-
-				else {
-					l.~L();
-					tag = e.tag;
-					new (&r) R(e.r);
-				}
-				break;
-
-			case _dtl::RIGHT:
-				if(e.tag == _dtl::RIGHT)
-					r = e.r;
-
-				else {
-					r.~R();
-					tag = e.tag;
-					new (&l) L(e.l);
-				}
-				break;
-			}
-
-			return *this;
+		/**
+		 * Pattern match on the contained value.
+		 *
+		 * The noexcept-friendly way of consuming an either: both sides must
+		 * be handled, so no access can ever go wrong and no throwing branch
+		 * is generated on the happy path&mdash;the whole thing compiles down
+		 * to a tag test and a load. Semantics&mdash;exhaustiveness checking,
+		 * handler selection, and the common return type&mdash;are exactly
+		 * those of `sum_type::match`.
+		 *
+		 * Example:
+		 * \code
+		 *   either<errc,page_ref> e = readPage(id);
+		 *
+		 *   auto r = e.match(
+		 *       [](const page_ref& p){ return use(p); },
+		 *       [](errc e){ return errorResult(e); }
+		 *   );
+		 * \endcode
+		 *
+		 * \note Like `sum_type::match`, if `L` and `R` are implicitly
+		 *       convertible between each other, the first matching case
+		 *       clause wins; the left side is tried first.
+		 */
+		template<typename...Fs>
+		auto match(Fs&&...fs) const -> typename ::ftl::_dtl::common_return_type<
+			type_seq<L,R>,type_seq<Fs...>
+		>::type {
+
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<L,R>>::value,
+				"Match statements must be exhaustive"
+			);
+
+			if(store.tag == _dtl::LEFT)
+				return _dtl::pick_handler<const L&,Fs...>
+					::get(fs...)(store.get_left());
+
+			return _dtl::pick_handler<const R&,Fs...>
+				::get(fs...)(store.get_right());
 		}
 
-		either& operator= (either&& e) {
-			switch(tag) {
-			case _dtl::LEFT:
-				if(e.tag == _dtl::LEFT)
-					l = std::move(e.l);
-
-				else {
-					l.~L();
-					tag = e.tag;
-					new (&r) R(std::move(e.r));
-				}
-				break;
-
-			case _dtl::RIGHT:
-				if(e.tag == _dtl::RIGHT)
-					r = std::move(e.r);
+		/// \overload
+		template<typename...Fs>
+		auto match(Fs&&...fs) -> typename ::ftl::_dtl::common_return_type<
+			type_seq<L,R>,type_seq<Fs...>
+		>::type {
+
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<L,R>>::value,
+				"Match statements must be exhaustive"
+			);
+
+			if(store.tag == _dtl::LEFT)
+				return _dtl::pick_handler<L&,Fs...>
+					::get(fs...)(store.get_left());
+
+			return _dtl::pick_handler<R&,Fs...>
+				::get(fs...)(store.get_right());
+		}
 
-				else {
-					r.~R();
-					tag = e.tag;
-					new (&l) L(std::move(e.l));
-				}
-				break;
-			}
+		either& operator= (const either& e) = default;
 
-			return *this;
-		}
+		either& operator= (either&& e) = default;
 
 		constexpr bool operator== (const either& e) const noexcept {
-			return tag == e.tag
-				? (tag == _dtl::LEFT ? l == e.l : r == e.r)
+			return store.tag == e.store.tag
+				? (store.tag == _dtl::LEFT
+					? store.get_left() == e.store.get_left()
+					: store.get_right() == e.store.get_right())
 				: false;
 		}
 
@@ -344,12 +653,7 @@ namespace ftl {
 		}
 
 	private:
-		union {
-			L l;
-			R r;
-		};
-
-		_dtl::tag_t tag;
+		_dtl::either_storage<L,R> store;
 	};
 
 	template<typename L, typename R>
@@ -468,6 +772,71 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Monad_rec implementation for either.
+	 *
+	 * The trampoline iterates as long as the step function yields a right
+	 * value containing a left; the first left short-circuits the whole loop,
+	 * exactly as a chain of binds would.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename T>
+	struct monad_rec<either<L,T>> {
+
+		template<typename F, typename S, typename R = Value_type<T>>
+		static either<L,R> tailRec(F&& f, S seed) {
+			for(;;) {
+				auto e = f(std::move(seed));
+				if(!e)
+					return either<L,R>(left_tag_t(), std::move(e.left()));
+
+				auto& step = *e;
+				if(step)
+					return either<L,R>(right_tag_t(), std::move(*step));
+
+				seed = std::move(step.left());
+			}
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Applicative_traverse implementation for either.
+	 *
+	 * The output container is reserved up front and results are moved into
+	 * it, so a successful traversal is a single pass with no reallocation.
+	 * The first left value aborts the pass and becomes the overall result.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename T>
+	struct applicative_traverse<either<L,T>> {
+
+		template<
+				typename F,
+				typename C,
+				typename Cu = Rebind<plain_type<C>,T>
+		>
+		static either<L,Cu> traverse(F&& f, C&& c) {
+			Cu out;
+			_dtl::try_reserve(out, c.size(), 0);
+
+			for(auto& x : c) {
+				auto e = f(_dtl::forward_element<C>(x));
+				if(!e)
+					return either<L,Cu>(left_tag_t(), std::move(e.left()));
+
+				out.push_back(std::move(*e));
+			}
+
+			return either<L,Cu>(right_tag_t(), std::move(out));
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	/**
 	 * Smart constructor of left values.
 	 *
@@ -514,6 +883,59 @@ namespace ftl {
 		return either<L,R>(right_tag_t(), std::forward<R_>(r));
 	}
 
+	/**
+	 * Trait marking either types that never throw on the noexcept tier.
+	 *
+	 * `value` is true exactly when both sides of the either are nothrow
+	 * copy and move constructible. For such types, construction via
+	 * `make_left`/`make_right`, the unchecked accessors `left` and `right`,
+	 * `isLeft`/`isRight` and copies and moves are all statically known not
+	 * to throw; only the checked accessors (`operator*`, `operator->`) can.
+	 * Functions that stick to the former tier&mdash;`match`-based
+	 * consumption plus the unchecked accessors&mdash;may therefore be
+	 * declared `noexcept`, which lets the compiler discard their unwinding
+	 * tables entirely.
+	 *
+	 * Example:
+	 * \code
+	 *   either<errc,page_ref> readPage(page_id id) noexcept {
+	 *       static_assert(
+	 *           ftl::is_nothrow_either<ftl::either<errc,page_ref>>::value,
+	 *           "page access must not generate throwing paths"
+	 *       );
+	 *       ...
+	 *   }
+	 * \endcode
+	 *
+	 * \ingroup either
+	 */
+	template<typename>
+	struct is_nothrow_either {
+		static constexpr bool value = false;
+	};
+
+	template<typename L, typename R>
+	struct is_nothrow_either<either<L,R>> {
+		static constexpr bool value =
+			std::is_nothrow_copy_constructible<L>::value
+			&& std::is_nothrow_move_constructible<L>::value
+			&& std::is_nothrow_copy_constructible<R>::value
+			&& std::is_nothrow_move_constructible<R>::value;
+	};
+
+	/**
+	 * Predicate version of `is_nothrow_either`.
+	 *
+	 * Mainly useful in concept-style contexts, e.g. together with
+	 * `Requires`.
+	 *
+	 * \ingroup either
+	 */
+	template<typename E>
+	constexpr bool NothrowEither() noexcept {
+		return is_nothrow_either<E>::value;
+	}
+
 	/**
 	 * Less than comparison of two equivalently parametrised eithers.
 	 *
@@ -581,6 +1003,204 @@ namespace ftl {
 			: (e2.isRight() ? e1.right() > e2.right() : true);
 	}
 
+	namespace _dtl {
+		/* Tag pre-count for the partition kernels below: a plain scan of the
+		 * discriminants, with no payload access for the compiler to worry
+		 * about.
+		 */
+		template<typename L, typename R, typename A>
+		size_t count_rights(const std::vector<either<L,R>,A>& es) noexcept {
+			size_t n = 0;
+			for(const auto& e : es)
+				n += e.isRight();
+
+			return n;
+		}
+
+		// Trivially copyable, default constructible payloads: unchecked
+		// indexed stores into an exactly pre-sized output. The value
+		// initialisation requires the default constructor.
+		template<typename L, typename R, typename A>
+		std::vector<L> collect_lefts(
+				const std::vector<either<L,R>,A>& es, size_t nl,
+				std::true_type) {
+			std::vector<L> ls(nl);
+
+			size_t i = 0;
+			for(const auto& e : es) {
+				if(e.isLeft())
+					ls[i++] = e.left();
+			}
+
+			return ls;
+		}
+
+		template<typename L, typename R, typename A>
+		std::vector<L> collect_lefts(
+				const std::vector<either<L,R>,A>& es, size_t nl,
+				std::false_type) {
+			std::vector<L> ls;
+			ls.reserve(nl);
+
+			for(const auto& e : es) {
+				if(e.isLeft())
+					ls.push_back(e.left());
+			}
+
+			return ls;
+		}
+
+		template<typename L, typename R, typename A>
+		std::vector<R> collect_rights(
+				const std::vector<either<L,R>,A>& es, size_t nr,
+				std::true_type) {
+			std::vector<R> rs(nr);
+
+			size_t i = 0;
+			for(const auto& e : es) {
+				if(e.isRight())
+					rs[i++] = e.right();
+			}
+
+			return rs;
+		}
+
+		template<typename L, typename R, typename A>
+		std::vector<R> collect_rights(
+				const std::vector<either<L,R>,A>& es, size_t nr,
+				std::false_type) {
+			std::vector<R> rs;
+			rs.reserve(nr);
+
+			for(const auto& e : es) {
+				if(e.isRight())
+					rs.push_back(e.right());
+			}
+
+			return rs;
+		}
+	}
+
+	/**
+	 * Extract every left value from a sequence of eithers.
+	 *
+	 * A single pass over the discriminants sizes the output exactly, so the
+	 * fill pass never reallocates; for trivially copyable `L`, it runs as
+	 * plain indexed stores with no capacity checks.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	std::vector<L> lefts(const std::vector<either<L,R>,A>& es) {
+		return _dtl::collect_lefts(
+			es, es.size() - _dtl::count_rights(es),
+			std::integral_constant<
+				bool,
+				std::is_trivially_copyable<L>::value
+				&& std::is_default_constructible<L>::value
+			>{}
+		);
+	}
+
+	/// \overload
+	template<typename L, typename R, typename A>
+	std::vector<L> lefts(std::vector<either<L,R>,A>&& es) {
+		std::vector<L> ls;
+		ls.reserve(es.size() - _dtl::count_rights(es));
+
+		for(auto& e : es) {
+			if(e.isLeft())
+				ls.push_back(std::move(e.left()));
+		}
+
+		return ls;
+	}
+
+	/**
+	 * Extract every right value from a sequence of eithers.
+	 *
+	 * The mirror image of `ftl::lefts`, with the same exact pre-sizing.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	std::vector<R> rights(const std::vector<either<L,R>,A>& es) {
+		return _dtl::collect_rights(
+			es, _dtl::count_rights(es),
+			std::integral_constant<
+				bool,
+				std::is_trivially_copyable<R>::value
+				&& std::is_default_constructible<R>::value
+			>{}
+		);
+	}
+
+	/// \overload
+	template<typename L, typename R, typename A>
+	std::vector<R> rights(std::vector<either<L,R>,A>&& es) {
+		std::vector<R> rs;
+		rs.reserve(_dtl::count_rights(es));
+
+		for(auto& e : es) {
+			if(e.isRight())
+				rs.push_back(std::move(e.right()));
+		}
+
+		return rs;
+	}
+
+	/**
+	 * Split a sequence of eithers into its lefts and its rights.
+	 *
+	 * Equivalent to `std::make_pair(lefts(es), rights(es))`, but the tags
+	 * are counted once and each payload is visited once. Both outputs are
+	 * sized exactly up front; a batch of N validation results partitions
+	 * with N payload copies and zero reallocations, however the tags are
+	 * distributed. Order is preserved on both sides.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	std::pair<std::vector<L>,std::vector<R>> partitionEithers(
+			const std::vector<either<L,R>,A>& es) {
+		auto nr = _dtl::count_rights(es);
+
+		std::vector<L> ls;
+		std::vector<R> rs;
+		ls.reserve(es.size() - nr);
+		rs.reserve(nr);
+
+		for(const auto& e : es) {
+			if(e.isLeft())
+				ls.push_back(e.left());
+			else
+				rs.push_back(e.right());
+		}
+
+		return std::make_pair(std::move(ls), std::move(rs));
+	}
+
+	/// \overload
+	template<typename L, typename R, typename A>
+	std::pair<std::vector<L>,std::vector<R>> partitionEithers(
+			std::vector<either<L,R>,A>&& es) {
+		auto nr = _dtl::count_rights(es);
+
+		std::vector<L> ls;
+		std::vector<R> rs;
+		ls.reserve(es.size() - nr);
+		rs.reserve(nr);
+
+		for(auto& e : es) {
+			if(e.isLeft())
+				ls.push_back(std::move(e.left()));
+			else
+				rs.push_back(std::move(e.right()));
+		}
+
+		return std::make_pair(std::move(ls), std::move(rs));
+	}
+
 }
 
 #endif
@@ -25,6 +25,7 @@
 
 #include "prelude.h"
 #include "either.h"
+#include "function.h"
 #include "concepts/monoid.h"
 
 namespace ftl {
@@ -37,9 +38,19 @@ namespace ftl {
 	 *   #include <ftl/either_trans.h>
 	 * \endcode
 	 *
+	 * \note When transforming a container monad, every bind step constructs
+	 *       a wrapper container per layer&mdash;and one per transformer in a
+	 *       stacked `eitherT`/`maybeT` chain. Giving the container
+	 *       `ftl::scoped_arena_allocator` and running the chain inside
+	 *       \ref ftl::scratch_scope "ftl::scratch_scope" (or
+	 *       \ref ftl::withScratch "withScratch") places all such
+	 *       intermediaries in the thread's scratch arena, reclaimed
+	 *       wholesale at the outermost bind.
+	 *
 	 * \par Dependencies
 	 * - \ref prelude
 	 * - \ref either
+	 * - \ref function
 	 * - \ref monoid
 	 */
 
@@ -456,7 +467,190 @@ namespace ftl {
 		static constexpr bool instance = monoid<L>::instance;
 	};
 
-}	
+	template<typename L, typename T, typename F, typename...Ps>
+	class fused_eitherT;
+
+	namespace _dtl {
+
+		// Concept parameter of a fused continuation's result, whether that
+		// is an eitherT or an already fused chain.
+		template<typename M>
+		struct fused_value_type {
+			using type = Value_type<M>;
+		};
+
+		template<typename L, typename T, typename F, typename...Ps>
+		struct fused_value_type<fused_eitherT<L,T,F,Ps...>> {
+			using type = T;
+		};
+
+		/* Composed closure of a fused bind: runs the previous step and, on
+		 * rightness, feeds the result to the continuation. The closure's
+		 * concrete type carries the whole chain, so composing one of these
+		 * never allocates and never dispatches through a function manager.
+		 */
+		template<typename L, typename U, typename F, typename Fn, typename...Ps>
+		struct fused_bind {
+			F f;
+			Fn fn;
+
+			either<L,U> operator() (Ps...ps) const {
+				auto r = f(ps...);
+				if(r)
+					return finish(fn(*r), ps...);
+
+				return make_left<U>(r.left());
+			}
+
+			template<typename M2>
+			either<L,U> finish(const eitherT<L,M2>& e, Ps...ps) const {
+				return (*e)(ps...);
+			}
+
+			template<typename F2>
+			either<L,U> finish(
+					const fused_eitherT<L,U,F2,Ps...>& e, Ps...ps) const {
+				return e(ps...);
+			}
+		};
+
+		/// Composed closure of a fused functorial map.
+		template<typename L, typename U, typename F, typename Fn, typename...Ps>
+		struct fused_map {
+			F f;
+			Fn fn;
+
+			either<L,U> operator() (Ps...ps) const {
+				return fn % f(ps...);
+			}
+		};
+	}
+
+	/**
+	 * A statically composed chain of eitherT-over-function computations.
+	 *
+	 * Every `monad::bind` on an `eitherT<L,ftl::function<T(Ps...)>>` wraps a
+	 * fresh `ftl::function` around the previous one, adding a type erased
+	 * indirection&mdash;and potentially a heap allocation&mdash;per
+	 * combinator. A fused chain instead keeps the concrete closure type of
+	 * the whole composition: binds and maps on it (via the usual `>>=` and
+	 * `%` operators) nest plain structs that the compiler can inline, and
+	 * type erasure happens at most once, when the finished chain is
+	 * \ref fused_eitherT::unfuse "unfused" back into an ordinary `eitherT`.
+	 *
+	 * \code
+	 *   using parser = ftl::eitherT<error,ftl::function<int(state&)>>;
+	 *
+	 *   parser p = ...;
+	 *
+	 *   parser q = (
+	 *       ftl::fuse(p)
+	 *       >>= [](int x){ return someParser(x); }
+	 *   ).unfuse();
+	 * \endcode
+	 *
+	 * The same fusion pattern applies to any transformer whose base monad is
+	 * `ftl::function`&mdash;e.g. the \ref maybeT and \ref lazyT
+	 * equivalents&mdash;by substituting the transformer's plain value for
+	 * `either` in the composed closures.
+	 *
+	 * \tparam F The concrete callable type of the composed chain; satisfies
+	 *           \ref fn`<either<L,T>(Ps...)>`.
+	 *
+	 * \ingroup eitherT
+	 */
+	template<typename L, typename T, typename F, typename...Ps>
+	class fused_eitherT {
+	public:
+		explicit fused_eitherT(F f)
+		noexcept(std::is_nothrow_move_constructible<F>::value)
+		: f(std::move(f)) {}
+
+		/// Run the fused chain directly, with no erased dispatch.
+		either<L,T> operator() (Ps...ps) const {
+			return f(ps...);
+		}
+
+		/**
+		 * Erase the composed chain behind a single `ftl::function`.
+		 *
+		 * \tparam N Inline storage size of the resulting function. Long
+		 *           chains compose into large closures; raising `N` keeps
+		 *           them off the heap.
+		 */
+		template<size_t N = _dtl::default_function_padding>
+		eitherT<L,function<T(Ps...),inline_storage<N>>> unfuse() const {
+			return eitherT<L,function<T(Ps...),inline_storage<N>>>{
+				inplace_tag(), f
+			};
+		}
+
+	private:
+		F f;
+	};
+
+	/**
+	 * Start a fused chain from an ordinary eitherT-over-function.
+	 *
+	 * The given computation remains the (already erased) root of the chain;
+	 * fusion guarantees that no _further_ erasure layers are added by
+	 * subsequent binds and maps.
+	 *
+	 * \ingroup eitherT
+	 */
+	template<typename L, typename T, size_t N, typename...Ps>
+	fused_eitherT<L,T,function<either<L,T>(Ps...),inline_storage<N>>,Ps...>
+	fuse(const eitherT<L,function<T(Ps...),inline_storage<N>>>& e) {
+		using F = function<either<L,T>(Ps...),inline_storage<N>>;
+
+		return fused_eitherT<L,T,F,Ps...>{*e};
+	}
+
+	/**
+	 * Fused equivalent of `monad::bind`.
+	 *
+	 * `fn` may return either an `eitherT<L,ftl::function<U(Ps...)>>` or
+	 * another fused chain; in both cases the composition itself is free of
+	 * erasure.
+	 *
+	 * \ingroup eitherT
+	 */
+	template<
+			typename L, typename T, typename F, typename Fn, typename...Ps,
+			typename U = typename _dtl::fused_value_type<result_of<Fn(T)>>::type
+	>
+	fused_eitherT<
+		L, U, _dtl::fused_bind<L,U,fused_eitherT<L,T,F,Ps...>,Fn,Ps...>, Ps...
+	>
+	operator>>= (fused_eitherT<L,T,F,Ps...> f, Fn fn) {
+		using closure = _dtl::fused_bind<L,U,fused_eitherT<L,T,F,Ps...>,Fn,Ps...>;
+
+		return fused_eitherT<L,U,closure,Ps...>{
+			closure{std::move(f), std::move(fn)}
+		};
+	}
+
+	/**
+	 * Fused equivalent of `functor::map`.
+	 *
+	 * \ingroup eitherT
+	 */
+	template<
+			typename L, typename T, typename F, typename Fn, typename...Ps,
+			typename U = result_of<Fn(T)>
+	>
+	fused_eitherT<
+		L, U, _dtl::fused_map<L,U,fused_eitherT<L,T,F,Ps...>,Fn,Ps...>, Ps...
+	>
+	operator% (Fn fn, fused_eitherT<L,T,F,Ps...> f) {
+		using closure = _dtl::fused_map<L,U,fused_eitherT<L,T,F,Ps...>,Fn,Ps...>;
+
+		return fused_eitherT<L,U,closure,Ps...>{
+			closure{std::move(f), std::move(fn)}
+		};
+	}
+
+}
 
 #endif
 
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_EXTERN_TEMPLATES_H
+#define FTL_EXTERN_TEMPLATES_H
+
+#include <string>
+#include "function.h"
+#include "sum_type.h"
+#include "maybe.h"
+#include "either.h"
+
+/**
+ * \defgroup externtemplates Extern Templates
+ *
+ * Opt-in pre-instantiation of the most commonly used FTL specialisations.
+ *
+ * \code
+ *   #define FTL_EXTERN_TEMPLATES
+ *   #include <ftl/extern_templates.h>
+ * \endcode
+ *
+ * FTL is header only, so every translation unit that uses, say,
+ * `function<void()>` instantiates it anew, and the linker is left to
+ * deduplicate the identical sections. Projects that include FTL from many
+ * translation units can instead define `FTL_EXTERN_TEMPLATES` before
+ * including this header (typically via the build system, project wide) and
+ * link against the companion library built in `lib/`. The `extern template`
+ * declarations below then suppress local instantiation of the listed
+ * specialisations, cutting both compile time and object size.
+ *
+ * Without the macro, this header is inert and FTL remains fully header
+ * only; nothing else in the library depends on it.
+ *
+ * Note that explicit instantiation only covers a class' non-template
+ * members. That is exactly the expensive part of `ftl::function` (the
+ * small-object storage management) and of `sum_type`/`maybe`/`either`
+ * (copying, moving, destruction), but member templates like `match` and
+ * the curried call wrappers in `implementation/currying.h` are instantiated
+ * per call shape at their points of use and cannot be pre-compiled.
+ *
+ * The list below is a starting set; projects with other hot shapes are
+ * encouraged to maintain their own companion TU alongside this one, using
+ * `lib/instantiations.cpp` as a template.
+ *
+ * \par Dependencies
+ * - `<string>`
+ * - \ref function
+ * - \ref sum_type
+ * - \ref maybe
+ * - \ref either
+ */
+
+#if defined(FTL_EXTERN_TEMPLATES) || defined(FTL_INSTANTIATE_TEMPLATES)
+
+/* FTL_INSTANTIATE_TEMPLATES is defined by lib/instantiations.cpp only: the
+ * same list then becomes the matching explicit instantiation definitions,
+ * so header and library cannot drift apart.
+ */
+#ifdef FTL_INSTANTIATE_TEMPLATES
+#define FTL_TEMPLATE_DECL template
+#else
+#define FTL_TEMPLATE_DECL extern template
+#endif
+
+namespace ftl {
+
+	FTL_TEMPLATE_DECL class function<void()>;
+	FTL_TEMPLATE_DECL class function<bool()>;
+	FTL_TEMPLATE_DECL class function<bool(int)>;
+	FTL_TEMPLATE_DECL class function<void(int)>;
+	FTL_TEMPLATE_DECL class function<int(int)>;
+	FTL_TEMPLATE_DECL class function<int(int,int)>;
+
+	FTL_TEMPLATE_DECL class maybe<int>;
+	FTL_TEMPLATE_DECL class maybe<size_t>;
+	FTL_TEMPLATE_DECL class maybe<double>;
+	FTL_TEMPLATE_DECL class maybe<std::string>;
+
+	FTL_TEMPLATE_DECL class sum_type<bool,int>;
+	FTL_TEMPLATE_DECL class sum_type<int,double>;
+	FTL_TEMPLATE_DECL class sum_type<int,std::string>;
+
+	FTL_TEMPLATE_DECL class either<int,int>;
+	FTL_TEMPLATE_DECL class either<int,std::string>;
+	FTL_TEMPLATE_DECL class either<std::string,int>;
+
+}
+
+#undef FTL_TEMPLATE_DECL
+
+#endif // FTL_EXTERN_TEMPLATES || FTL_INSTANTIATE_TEMPLATES
+
+#endif
+
@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FLAT_MAP_H
+#define FTL_FLAT_MAP_H
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "concepts/monoid.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup flatmap Flat Map
+	 *
+	 * A contiguous small-map and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/flat_map.h>
+	 * \endcode
+	 *
+	 * `std::map` pays a heap node and two pointer hops per entry, which
+	 * makes it a poor fit for the small lookup tables&mdash;a few to a few
+	 * dozen entries&mdash;that dominate hot paths. ftl::flat_map keeps its
+	 * entries sorted in one contiguous buffer with inline capacity for `N`
+	 * of them, so small tables live entirely on the stack and lookups are
+	 * a binary search over a couple of cache lines.
+	 *
+	 * This module adds the following concept instances to flat_map:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<initializer_list>`
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref monoid
+	 */
+
+	/**
+	 * A sorted, contiguous map with inline capacity for `N` entries.
+	 *
+	 * Entries are kept sorted by key in a single buffer. Up to `N` of them
+	 * are stored inline in the map object itself; beyond that the buffer
+	 * spills to the heap, doubling as it grows. Lookup is a binary search,
+	 * iteration walks contiguous memory, and insertion shifts the tail of
+	 * the buffer&mdash;O(n), which is the right trade as long as tables
+	 * are small or built once and queried often.
+	 *
+	 * The interface is the subset of `std::map`'s that lookup-table code
+	 * requires: `insert` (with the usual end() hint fast path), `find`,
+	 * `count`, `operator[]`, and random access iteration. There is
+	 * deliberately no erase; rebuild the table instead, as table-driven
+	 * code does anyway.
+	 *
+	 * Unlike `std::map`, `value_type` is `pair<K,V>` rather than
+	 * `pair<const K,V>`, since entries must be movable within the buffer.
+	 * Keys still cannot be modified through the map's own interface.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref fwditerable
+	 * - \ref eq, if `K` and `V` are EqualityComparable.
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \ingroup flatmap
+	 */
+	template<typename K, typename V, size_t N = 8, typename Cmp = std::less<K>>
+	class flat_map {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K,V>;
+		using key_compare = Cmp;
+		using size_type = size_t;
+		using iterator = value_type*;
+		using const_iterator = const value_type*;
+
+		flat_map()
+		noexcept(std::is_nothrow_default_constructible<Cmp>::value)
+		: elems(inlineData()) {}
+
+		explicit flat_map(Cmp cmp)
+		noexcept(std::is_nothrow_move_constructible<Cmp>::value)
+		: elems(inlineData()), cmp(std::move(cmp)) {}
+
+		flat_map(std::initializer_list<value_type> l) : flat_map() {
+			reserve(l.size());
+			for(const auto& e : l)
+				insert(e);
+		}
+
+		flat_map(const flat_map& other) : elems(inlineData()), cmp(other.cmp) {
+			reserve(other.sz);
+			for(size_t i = 0; i < other.sz; ++i)
+				::new (elems + i) value_type(other.elems[i]);
+
+			sz = other.sz;
+		}
+
+		flat_map(flat_map&& other)
+		: elems(inlineData()), cmp(std::move(other.cmp)) {
+			if(other.onHeap()) {
+				// Steal the heap buffer outright
+				elems = other.elems;
+				sz = other.sz;
+				cap = other.cap;
+				other.elems = other.inlineData();
+				other.sz = 0;
+				other.cap = N;
+			}
+			else {
+				for(size_t i = 0; i < other.sz; ++i)
+					::new (elems + i) value_type(std::move(other.elems[i]));
+
+				sz = other.sz;
+				other.clear();
+			}
+		}
+
+		~flat_map() {
+			clear();
+			if(onHeap())
+				::operator delete(elems);
+		}
+
+		flat_map& operator= (const flat_map& other) {
+			if(this != std::addressof(other)) {
+				clear();
+				cmp = other.cmp;
+				reserve(other.sz);
+				for(size_t i = 0; i < other.sz; ++i)
+					::new (elems + i) value_type(other.elems[i]);
+
+				sz = other.sz;
+			}
+
+			return *this;
+		}
+
+		flat_map& operator= (flat_map&& other) {
+			if(this != std::addressof(other)) {
+				clear();
+				if(onHeap()) {
+					::operator delete(elems);
+					elems = inlineData();
+					cap = N;
+				}
+
+				cmp = std::move(other.cmp);
+				if(other.onHeap()) {
+					elems = other.elems;
+					sz = other.sz;
+					cap = other.cap;
+					other.elems = other.inlineData();
+					other.sz = 0;
+					other.cap = N;
+				}
+				else {
+					for(size_t i = 0; i < other.sz; ++i)
+						::new (elems + i)
+							value_type(std::move(other.elems[i]));
+
+					sz = other.sz;
+					other.clear();
+				}
+			}
+
+			return *this;
+		}
+
+		iterator begin() noexcept {
+			return elems;
+		}
+
+		const_iterator begin() const noexcept {
+			return elems;
+		}
+
+		iterator end() noexcept {
+			return elems + sz;
+		}
+
+		const_iterator end() const noexcept {
+			return elems + sz;
+		}
+
+		size_type size() const noexcept {
+			return sz;
+		}
+
+		bool empty() const noexcept {
+			return sz == 0;
+		}
+
+		size_type capacity() const noexcept {
+			return cap;
+		}
+
+		/// Whether the entries currently live in the inline buffer.
+		bool inline_storage() const noexcept {
+			return !onHeap();
+		}
+
+		/// First entry whose key does not compare less than `k`.
+		iterator lower_bound(const K& k) {
+			return std::lower_bound(
+				begin(), end(), k,
+				[this](const value_type& e, const K& k) {
+					return cmp(e.first, k);
+				}
+			);
+		}
+
+		/// \overload
+		const_iterator lower_bound(const K& k) const {
+			return std::lower_bound(
+				begin(), end(), k,
+				[this](const value_type& e, const K& k) {
+					return cmp(e.first, k);
+				}
+			);
+		}
+
+		iterator find(const K& k) {
+			auto it = lower_bound(k);
+			return it != end() && !cmp(k, it->first) ? it : end();
+		}
+
+		const_iterator find(const K& k) const {
+			auto it = lower_bound(k);
+			return it != end() && !cmp(k, it->first) ? it : end();
+		}
+
+		size_type count(const K& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		/**
+		 * Insert an entry, keeping the buffer sorted.
+		 *
+		 * As with `std::map`, an entry whose key is already present is
+		 * left untouched.
+		 *
+		 * \return Position of the entry with the given key, and whether
+		 *         the insertion took place.
+		 */
+		std::pair<iterator,bool> insert(const value_type& e) {
+			return emplaceAt(lower_bound(e.first), e);
+		}
+
+		/// \overload
+		std::pair<iterator,bool> insert(value_type&& e) {
+			return emplaceAt(lower_bound(e.first), std::move(e));
+		}
+
+		/**
+		 * Hinted insert.
+		 *
+		 * A correct `end()` hint&mdash;the new key ordering after every
+		 * existing one&mdash;skips the binary search, making sorted bulk
+		 * construction O(1) amortized per entry. A wrong hint merely
+		 * falls back on the unhinted overload.
+		 */
+		iterator insert(const_iterator pos, const value_type& e) {
+			if(pos == end() && (sz == 0 || cmp(elems[sz-1].first, e.first)))
+				return emplaceAt(end(), e).first;
+
+			return insert(e).first;
+		}
+
+		/// \overload
+		iterator insert(const_iterator pos, value_type&& e) {
+			if(pos == end() && (sz == 0 || cmp(elems[sz-1].first, e.first)))
+				return emplaceAt(end(), std::move(e)).first;
+
+			return insert(std::move(e)).first;
+		}
+
+		/// Access the value at `k`, default constructing it if missing.
+		V& operator[] (const K& k) {
+			auto it = lower_bound(k);
+			if(it != end() && !cmp(k, it->first))
+				return it->second;
+
+			return emplaceAt(it, value_type(k, V())).first->second;
+		}
+
+		/// Grow the buffer to hold at least `n` entries without spilling.
+		void reserve(size_type n) {
+			if(n > cap)
+				grow(n);
+		}
+
+		void clear() noexcept {
+			for(size_t i = 0; i < sz; ++i)
+				elems[i].~value_type();
+
+			sz = 0;
+		}
+
+		bool operator== (const flat_map& other) const {
+			return sz == other.sz
+				&& std::equal(begin(), end(), other.begin());
+		}
+
+		bool operator!= (const flat_map& other) const {
+			return !(*this == other);
+		}
+
+	private:
+		value_type* inlineData() noexcept {
+			return reinterpret_cast<value_type*>(inlineStorage);
+		}
+
+		bool onHeap() const noexcept {
+			return elems !=
+				reinterpret_cast<const value_type*>(inlineStorage);
+		}
+
+		template<typename E>
+		std::pair<iterator,bool> emplaceAt(const_iterator pos, E&& e) {
+			auto i = static_cast<size_t>(pos - elems);
+			if(i < sz && !cmp(e.first, elems[i].first))
+				return std::make_pair(elems + i, false);
+
+			if(sz == cap)
+				grow(cap * 2);
+
+			if(i < sz) {
+				// Shift the tail one slot right, back to front
+				::new (elems + sz)
+					value_type(std::move(elems[sz-1]));
+				for(size_t j = sz - 1; j > i; --j)
+					elems[j] = std::move(elems[j-1]);
+
+				elems[i] = std::forward<E>(e);
+			}
+			else {
+				::new (elems + i) value_type(std::forward<E>(e));
+			}
+
+			++sz;
+			return std::make_pair(elems + i, true);
+		}
+
+		void grow(size_type newCap) {
+			auto bigger = static_cast<value_type*>(
+				::operator new(newCap * sizeof(value_type))
+			);
+
+			for(size_t i = 0; i < sz; ++i) {
+				::new (bigger + i) value_type(std::move(elems[i]));
+				elems[i].~value_type();
+			}
+
+			if(onHeap())
+				::operator delete(elems);
+
+			elems = bigger;
+			cap = newCap;
+		}
+
+		typename std::aligned_storage<
+			sizeof(value_type), alignof(value_type)
+		>::type inlineStorage[N];
+
+		value_type* elems;
+		size_t sz = 0;
+		size_t cap = N;
+		Cmp cmp;
+	};
+
+	template<typename K, typename V, size_t N, typename Cmp>
+	struct parametric_type_traits<flat_map<K,V,N,Cmp>> {
+		using value_type = V;
+
+		template<typename W>
+		using rebind = flat_map<K,W,N,Cmp>;
+	};
+
+	/**
+	 * Functor instance for flat_map.
+	 *
+	 * \ingroup flatmap
+	 */
+	template<typename K, typename T, size_t N, typename Cmp>
+	struct functor<flat_map<K,T,N,Cmp>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = flat_map<K,U,N,Cmp>;
+
+		/**
+		 * Maps the function `f` over all values in `m`.
+		 *
+		 * Keys are unchanged and traversed in sorted order, so the result
+		 * is built back to back with hinted insertions.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			Map<U> rm;
+			rm.reserve(m.size());
+			for(const auto& kv : m) {
+				rm.insert(
+					rm.end(), std::make_pair(kv.first, f(kv.second))
+				);
+			}
+
+			return rm;
+		}
+
+		/**
+		 * R-value overload.
+		 *
+		 * Moves keys and values from `m`.
+		 */
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static Map<U> map(F&& f, Map<T>&& m) {
+			Map<U> rm;
+			rm.reserve(m.size());
+			for(auto& kv : m) {
+				rm.insert(
+					rm.end(),
+					std::make_pair(
+						std::move(kv.first), f(std::move(kv.second))
+					)
+				);
+			}
+
+			return rm;
+		}
+
+		/**
+		 * No-copy overload for endofunctions on temporary maps.
+		 *
+		 * \note Requires a \ref moveassignable `T`.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			for(auto& kv : m) {
+				kv.second = f(std::move(kv.second));
+			}
+
+			return std::move(m);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Implementation of Foldable for flat_map.
+	 *
+	 * \ingroup flatmap
+	 */
+	template<typename K, typename T, size_t N, typename Cmp>
+	struct foldable<flat_map<K,T,N,Cmp>>
+	: deriving_fold<flat_map<K,T,N,Cmp>>
+	, deriving_foldMap<flat_map<K,T,N,Cmp>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const flat_map<K,T,N,Cmp>& m) {
+			for(auto& kv : m) {
+				z = f(z, kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const flat_map<K,T,N,Cmp>& m) {
+			for(auto it = m.end(); it != m.begin();) {
+				--it;
+				z = f(it->second, z);
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Implementation of the \ref monoidpg concept.
+	 *
+	 * Behaviour of the monoid operations is equivalent to:
+	 * \code
+	 *   id() == flat_map{}
+	 *   append(a, b) == a, with b's entries inserted
+	 * \endcode
+	 *
+	 * As with `std::map::insert`, the left operand wins on duplicate
+	 * keys. Both operands being sorted, the append is a single O(n+m)
+	 * merge rather than m binary-search insertions.
+	 *
+	 * \ingroup flatmap
+	 */
+	template<typename K, typename V, size_t N, typename Cmp>
+	struct monoid<flat_map<K,V,N,Cmp>> {
+
+		static flat_map<K,V,N,Cmp> id()
+		noexcept(std::is_nothrow_default_constructible<Cmp>::value) {
+			return flat_map<K,V,N,Cmp>{};
+		}
+
+		static flat_map<K,V,N,Cmp> append(
+				const flat_map<K,V,N,Cmp>& m1,
+				const flat_map<K,V,N,Cmp>& m2) {
+
+			Cmp cmp;
+			flat_map<K,V,N,Cmp> rm;
+			rm.reserve(m1.size() + m2.size());
+
+			auto i1 = m1.begin();
+			auto i2 = m2.begin();
+			while(i1 != m1.end() && i2 != m2.end()) {
+				if(cmp(i2->first, i1->first))
+					rm.insert(rm.end(), *i2++);
+
+				else {
+					if(!cmp(i1->first, i2->first))
+						++i2;
+
+					rm.insert(rm.end(), *i1++);
+				}
+			}
+
+			for(; i1 != m1.end(); ++i1)
+				rm.insert(rm.end(), *i1);
+
+			for(; i2 != m2.end(); ++i2)
+				rm.insert(rm.end(), *i2);
+
+			return rm;
+		}
+
+		static flat_map<K,V,N,Cmp> append(
+				flat_map<K,V,N,Cmp>&& m1,
+				const flat_map<K,V,N,Cmp>& m2) {
+
+			m1.reserve(m1.size() + m2.size());
+			for(const auto& e : m2)
+				m1.insert(e);
+
+			return std::move(m1);
+		}
+
+		static flat_map<K,V,N,Cmp> append(
+				const flat_map<K,V,N,Cmp>& m1,
+				flat_map<K,V,N,Cmp>&& m2) {
+
+			m2.reserve(m1.size() + m2.size());
+			for(const auto& e : m1)
+				m2[e.first] = e.second;
+
+			return std::move(m2);
+		}
+
+		static flat_map<K,V,N,Cmp> append(
+				flat_map<K,V,N,Cmp>&& m1,
+				flat_map<K,V,N,Cmp>&& m2) {
+
+			m1.reserve(m1.size() + m2.size());
+			for(auto& e : m2)
+				m1.insert(std::move(e));
+
+			return std::move(m1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
+
@@ -90,13 +90,23 @@ namespace ftl {
 	 *          made. Every time you invoke `operator()` without filling the
 	 *          complete parameter list, you are creating copies.
 	 *
+	 * \tparam Storage An instance of ftl::inline_storage, giving the size in
+	 *         bytes of the buffer used for the small object optimisation.
+	 *         Function objects larger than this are heap allocated. Defaults
+	 *         to two words, but can be raised per call site to keep bigger
+	 *         closures off the heap, e.g.
+	 *         `function<int(int),inline_storage<64>>`.
+	 *
 	 * \ingroup function
 	 */
-	template<typename>
+	template<typename, typename Storage>
 	class function {};
 
-	template<typename R, typename...Ps>
-	class function<R(Ps...)> : private ::ftl::_dtl::curried<R,Ps...> {
+	template<typename R, size_t InlineBytes, typename...Ps>
+	class function<R(Ps...),inline_storage<InlineBytes>>
+	: private ::ftl::_dtl::curried<
+			function<R(Ps...),inline_storage<InlineBytes>>,R,Ps...
+	> {
 	public:
 		/**
 		 * Type sequence representation of the function's parameter list.
@@ -122,7 +132,9 @@ namespace ftl {
 		function(const function& f) : call(f.call) {
 			f.manager_storage.manager(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(&f.manager_storage),
+					const_cast<::ftl::_dtl::manager_storage_type<InlineBytes>*>(
+						&f.manager_storage
+					),
 					::ftl::_dtl::call_copy);
 		}
 
@@ -146,7 +158,8 @@ namespace ftl {
 		)
 		noexcept(::ftl::_dtl::is_inplace_allocated<
 				F,
-				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>>::value
+				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>,
+				InlineBytes>::value
 		)
 		{
 			if(::ftl::_dtl::is_null(f))
@@ -188,14 +201,22 @@ namespace ftl {
 				typename std::enable_if<
 					::ftl::_dtl::is_valid_function_argument<F, R (Ps...)>::value,
 					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct())
-		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
+		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator, InlineBytes>::value) {
 
 			if(::ftl::_dtl::is_null(functor))
 				initialise_empty();
 
 			else {
+				// The heap fallback allocates value_type objects, so the
+				// allocator must be rebound to the functor's type
+				using functor_type =
+					typename ::ftl::_dtl::functor_type<F>::type;
+
+				using rebound_alloc = typename std::allocator_traits<Allocator>
+					::template rebind_alloc<functor_type>;
+
 				initialise(::ftl::_dtl::to_functor(
-					std::forward<F>(functor)), Allocator(allocator)
+					std::forward<F>(functor)), rebound_alloc(allocator)
 				);
 			}
 		}
@@ -215,7 +236,7 @@ namespace ftl {
 			// first try to see if the allocator matches the target type
 			::ftl::_dtl::manager_type manager_for_allocator =
 				&::ftl::_dtl::function_manager<
-					typename alloc_traits::value_type, Allocator
+					typename alloc_traits::value_type, Allocator, InlineBytes
 				>;
 
 			if(other.manager_storage.manager == manager_for_allocator) {
@@ -228,7 +249,7 @@ namespace ftl {
 
 				manager_for_allocator(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(
+					const_cast<::ftl::_dtl::manager_storage_type<InlineBytes>*>(
 						&other.manager_storage
 					),
 					::ftl::_dtl::call_copy_functor_only
@@ -239,7 +260,9 @@ namespace ftl {
 			// breaks the recursion of the last case. otherwise repeated copies
 			// would allocate more and more memory
 			else if(other.manager_storage.manager
-					== &::ftl::_dtl::function_manager<function, MyAllocator>
+					== &::ftl::_dtl::function_manager<
+						function, MyAllocator, InlineBytes
+					>
 			) {
 
 				::ftl::_dtl::create_manager<function, MyAllocator>(
@@ -247,9 +270,9 @@ namespace ftl {
 					MyAllocator(allocator)
 				);
 
-				::ftl::_dtl::function_manager<function, MyAllocator>(
+				::ftl::_dtl::function_manager<function, MyAllocator, InlineBytes>(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(
+					const_cast<::ftl::_dtl::manager_storage_type<InlineBytes>*>(
 						&other.manager_storage
 					),
 					::ftl::_dtl::call_copy_functor_only
@@ -284,7 +307,8 @@ namespace ftl {
 		}
 
 		// Inherit the curried function call operator(s)
-		using ::ftl::_dtl::curried<R,Ps...>::operator();
+		using ::ftl::_dtl::curried<function,R,Ps...>::operator();
+
 
 		/// Call the wrapped function object
 		R operator()(Ps...ps) const {
@@ -293,12 +317,12 @@ namespace ftl {
 
 		template<typename F, typename Allocator>
 		void assign(F&& f, const Allocator& alloc)
-		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
+		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator, InlineBytes>::value) {
 			function(std::allocator_arg, alloc, f).swap(*this);
 		}
 
 		void swap(function& other) noexcept {
-			::ftl::_dtl::manager_storage_type temp_storage;
+			::ftl::_dtl::manager_storage_type<InlineBytes> temp_storage;
 
 			other.manager_storage.manager(
 					&temp_storage,
@@ -320,25 +344,27 @@ namespace ftl {
 
 		/// Check if function is nullary
 		constexpr operator bool() const noexcept {
-			return call != &::ftl::_dtl::empty_call<R, Ps...>;
+			return call != &::ftl::_dtl::empty_call<R, InlineBytes, Ps...>;
 		}
 
 	private:
-		::ftl::_dtl::manager_storage_type manager_storage;
-		R (*call)(const ::ftl::_dtl::functor_padding&, Ps...);
+		::ftl::_dtl::manager_storage_type<InlineBytes> manager_storage;
+		R (*call)(const ::ftl::_dtl::functor_padding<InlineBytes>&, Ps...);
 
 		template<typename F, typename Allocator>
 		void initialise(F f, Allocator&& alloc) {
 
-			call = &::ftl::_dtl::function_manager_inplace_specialisation<F,Allocator>
-				::template call<R, Ps...>;
+			call = &::ftl::_dtl::function_manager_inplace_specialisation<
+					F, Allocator, InlineBytes
+				>::template call<R, Ps...>;
 
 			::ftl::_dtl::create_manager<F,Allocator>(
 					manager_storage,
 					std::forward<Allocator>(alloc));
 
-			::ftl::_dtl::function_manager_inplace_specialisation<F, Allocator>
-				::store_functor(manager_storage, std::forward<F>(f));
+			::ftl::_dtl::function_manager_inplace_specialisation<
+					F, Allocator, InlineBytes
+				>::store_functor(manager_storage, std::forward<F>(f));
 		}
 
 		using empty_fn_type = R(*)(Ps...);
@@ -347,7 +373,9 @@ namespace ftl {
 			using Allocator = std::allocator<empty_fn_type>;
 
 			static_assert(
-				::ftl::_dtl::is_inplace_allocated<empty_fn_type, Allocator>::value,
+				::ftl::_dtl::is_inplace_allocated<
+					empty_fn_type, Allocator, InlineBytes
+				>::value,
 				"The empty function should benefit from small functor optimization");
 
 			::ftl::_dtl::create_manager<empty_fn_type,Allocator>(
@@ -355,20 +383,303 @@ namespace ftl {
 					Allocator()
 			);
 
-			::ftl::_dtl
-				::function_manager_inplace_specialisation<empty_fn_type,Allocator>
-					::store_functor(manager_storage, nullptr);
+			::ftl::_dtl::function_manager_inplace_specialisation<
+					empty_fn_type, Allocator, InlineBytes
+				>::store_functor(manager_storage, nullptr);
+
+			call = &::ftl::_dtl::empty_call<R, InlineBytes, Ps...>;
+		}
+	};
+
+	/**
+	 * Move-only counterpart of ftl::function.
+	 *
+	 * Shares ftl::function's storage machinery&mdash;including the small
+	 * buffer optimisation and its `Storage` parameter&mdash;but never
+	 * requires the wrapped callable to be copyable. Closures capturing
+	 * `unique_ptr`s, owned buffers and the like can thus be type erased
+	 * directly, without the `shared_ptr` indirection (an extra allocation
+	 * plus atomic reference counting) otherwise needed to satisfy
+	 * ftl::function's copyability requirement.
+	 *
+	 * The price is, of course, that `unique_function` itself is move-only,
+	 * and&mdash;since curried calling copies the wrapped callable&mdash;that
+	 * it supports plain calls only.
+	 *
+	 * An ftl::function converts implicitly, so APIs taking a
+	 * `unique_function` accept both.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref movecons
+	 * - \ref moveassignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   struct owner {
+	 *       std::unique_ptr<int> buf;
+	 *       int operator()() const { return *buf; }
+	 *   };
+	 *
+	 *   ftl::unique_function<int()> f{
+	 *       owner{std::unique_ptr<int>(new int(42))}
+	 *   };
+	 *
+	 *   // f() == 42; no shared_ptr wrapper, no control block
+	 * \endcode
+	 *
+	 * \ingroup function
+	 */
+	template<typename, typename Storage>
+	class unique_function {};
+
+	template<typename R, size_t InlineBytes, typename...Ps>
+	class unique_function<R(Ps...),inline_storage<InlineBytes>> {
+	public:
+		/// Type sequence representation of the function's parameter list.
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the function object.
+		using result_type = R;
+
+		/// Equivalent of unique_function(std::nullptr_t)
+		unique_function() noexcept {
+			initialise_empty();
+		}
+
+		/// Initialise an empty function wrapper
+		unique_function(std::nullptr_t) noexcept {
+			initialise_empty();
+		}
+
+		unique_function(const unique_function&) = delete;
+
+		unique_function(unique_function&& f) noexcept {
+			initialise_empty();
+			swap(f);
+		}
+
+		/**
+		 * Construct from arbitrary&mdash;possibly move-only&mdash;function
+		 * object.
+		 *
+		 * \tparam F must have a function call operator matching the type the
+		 *           `unique_function` is declared as.
+		 */
+		template<typename F>
+		unique_function(
+				F f,
+				typename std::enable_if<
+					::ftl::_dtl::is_valid_unique_function_argument<F, R (Ps...)>::value,
+					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct()
+		)
+		noexcept(::ftl::_dtl::is_inplace_allocated<
+				F,
+				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>,
+				InlineBytes>::value
+		)
+		{
+			if(::ftl::_dtl::is_null(f))
+				initialise_empty();
+
+			else {
+				using functor_type = typename ::ftl::_dtl::functor_type<F>::type;
+				initialise(
+					::ftl::_dtl::to_functor(std::move(f)),
+					std::allocator<functor_type>()
+				);
+			}
+		}
+
+		~unique_function() noexcept {
+			manager_storage.manager(
+					&manager_storage,
+					nullptr,
+					::ftl::_dtl::call_destroy);
+		}
+
+		unique_function& operator= (const unique_function&) = delete;
+
+		unique_function& operator= (unique_function&& other) noexcept {
+			swap(other);
+			return *this;
+		}
+
+		/// Call the wrapped function object
+		R operator()(Ps...ps) const {
+			return call(manager_storage.functor, std::forward<Ps>(ps)...);
+		}
+
+		void swap(unique_function& other) noexcept {
+			::ftl::_dtl::manager_storage_type<InlineBytes> temp_storage;
+
+			other.manager_storage.manager(
+					&temp_storage,
+					&other.manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			manager_storage.manager(
+					&other.manager_storage,
+					&manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			temp_storage.manager(
+					&manager_storage,
+					&temp_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			std::swap(call, other.call);
+		}
+
+		/// Check if a callable is wrapped at all
+		constexpr operator bool() const noexcept {
+			return call != &::ftl::_dtl::empty_call<R, InlineBytes, Ps...>;
+		}
+
+	private:
+		::ftl::_dtl::manager_storage_type<InlineBytes> manager_storage;
+		R (*call)(const ::ftl::_dtl::functor_padding<InlineBytes>&, Ps...);
+
+		template<typename F, typename Allocator>
+		void initialise(F f, Allocator&& alloc) {
+
+			call = &::ftl::_dtl::function_manager_inplace_specialisation<
+					F, Allocator, InlineBytes
+				>::template call<R, Ps...>;
+
+			::ftl::_dtl::create_unique_manager<F,Allocator>(
+					manager_storage,
+					std::forward<Allocator>(alloc));
+
+			::ftl::_dtl::function_manager_inplace_specialisation<
+					F, Allocator, InlineBytes
+				>::store_functor(manager_storage, std::move(f));
+		}
+
+		using empty_fn_type = R(*)(Ps...);
+
+		void initialise_empty() noexcept {
+			using Allocator = std::allocator<empty_fn_type>;
+
+			static_assert(
+				::ftl::_dtl::is_inplace_allocated<
+					empty_fn_type, Allocator, InlineBytes
+				>::value,
+				"The empty function should benefit from small functor optimization");
+
+			::ftl::_dtl::create_unique_manager<empty_fn_type,Allocator>(
+					manager_storage,
+					Allocator()
+			);
+
+			::ftl::_dtl::function_manager_inplace_specialisation<
+					empty_fn_type, Allocator, InlineBytes
+				>::store_functor(manager_storage, nullptr);
 
-			call = &::ftl::_dtl::empty_call<R, Ps...>;
+			call = &::ftl::_dtl::empty_call<R, InlineBytes, Ps...>;
 		}
 	};
 
+	/**
+	 * Non-owning reference to an arbitrary callable.
+	 *
+	 * A `function_ref` is two words: a pointer to the referenced callable and
+	 * a pointer to a trampoline that invokes it. It performs no allocation
+	 * and no copy of the callee, and is trivially copyable, so it passes in
+	 * registers. The price is that it does not extend the callee's lifetime:
+	 * a `function_ref` must never outlive what it was created from. It is
+	 * intended for parameters of functions that simply invoke the callable
+	 * and return&mdash;the common case in higher order combinators&mdash;
+	 * where the full type erasure of ftl::function buys nothing.
+	 *
+	 * \par Concepts
+	 * - \ref copycons (trivially)
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   int twice(ftl::function_ref<int(int)> f) {
+	 *       return f(f(0));
+	 *   }
+	 *
+	 *   auto r = twice([](int x){ return x+1; });
+	 *   // r == 2
+	 * \endcode
+	 *
+	 * \ingroup function
+	 */
+	template<typename>
+	class function_ref {};
+
 	template<typename R, typename...Ps>
-	struct parametric_type_traits<function<R(Ps...)>> {
+	class function_ref<R(Ps...)> {
+	public:
+		using result_type = R;
+
+		function_ref() = delete;
+		function_ref(const function_ref&) noexcept = default;
+		function_ref(function_ref&&) noexcept = default;
+		~function_ref() = default;
+
+		/**
+		 * Reference an arbitrary function object.
+		 *
+		 * \tparam F must have a function call operator matching the type the
+		 *           `function_ref` is declared as. The referenced object is
+		 *           _not_ copied; it must outlive the `function_ref`.
+		 */
+		template<
+				typename F,
+				typename = typename std::enable_if<
+					!std::is_same<function_ref,plain_type<F>>::value
+					&& ::ftl::_dtl::is_valid_function_argument<
+						plain_type<F>, R (Ps...)
+					>::value
+				>::type
+		>
+		function_ref(F&& f) noexcept
+		: obj(const_cast<void*>(
+				reinterpret_cast<const void*>(std::addressof(f)))
+		)
+		, call(&invoke<typename std::remove_reference<F>::type>) {}
+
+		/// Reference a plain function.
+		function_ref(R (&f)(Ps...)) noexcept
+		: obj(reinterpret_cast<void*>(&f))
+		, call(&invoke_fn) {}
+
+		function_ref& operator= (const function_ref&) noexcept = default;
+
+		/// Invoke the referenced callable
+		R operator()(Ps...ps) const {
+			return call(obj, std::forward<Ps>(ps)...);
+		}
+
+	private:
+		template<typename F>
+		static R invoke(void* o, Ps...ps) {
+			return (*reinterpret_cast<F*>(o))(std::forward<Ps>(ps)...);
+		}
+
+		static R invoke_fn(void* o, Ps...ps) {
+			return (*reinterpret_cast<R(*)(Ps...)>(o))(
+				std::forward<Ps>(ps)...
+			);
+		}
+
+		void* obj;
+		R (*call)(void*, Ps...);
+	};
+
+	template<typename R, size_t N, typename...Ps>
+	struct parametric_type_traits<function<R(Ps...),inline_storage<N>>> {
 		using value_type = R;
 
 		template<typename S>
-		using rebind = function<S(Ps...)>;
+		using rebind = function<S(Ps...),inline_storage<N>>;
 	};
 
 }
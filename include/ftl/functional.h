@@ -75,14 +75,14 @@ namespace ftl {
 	 *
 	 * \ingroup functional
 	 */
-	template<typename R, typename P, typename...Ps>
-	struct monad<function<R(P,Ps...)>>
-	: deriving_join<in_terms_of_bind<function<R(P,Ps...)>>>
-	, deriving_apply<in_terms_of_bind<function<R(P,Ps...)>>> {
+	template<typename R, size_t N, typename P, typename...Ps>
+	struct monad<function<R(P,Ps...),inline_storage<N>>>
+	: deriving_join<in_terms_of_bind<function<R(P,Ps...),inline_storage<N>>>>
+	, deriving_apply<in_terms_of_bind<function<R(P,Ps...),inline_storage<N>>>> {
 
 		// TODO: C++14 - Create version that lambda captures a by move
 		/// Creates a function that returns `a`, regardless of its parameters.
-		static function<R(P,Ps...)> pure(R a) {
+		static function<R(P,Ps...),inline_storage<N>> pure(R a) {
 			return [a](P,Ps...) { return a; };
 		}
 
@@ -93,7 +93,7 @@ namespace ftl {
 				typename F,
 				typename S = typename std::result_of<F(R)>::type
 		>
-		static function<S(P,Ps...)> map(F f, function<R(P,Ps...)> fn) {
+		static function<S(P,Ps...),inline_storage<N>> map(F f, function<R(P,Ps...),inline_storage<N>> fn) {
 			return [f,fn] (P&& p, Ps&&...ps) {
 				return f(fn(std::forward<P>(p), std::forward<Ps>(ps)...));
 			};
@@ -130,7 +130,7 @@ namespace ftl {
 				typename Fs = typename std::result_of<Fn(R)>::type,
 				typename S = typename std::result_of<Fs(P,Ps...)>::type
 		>
-		static function<S(P,Ps...)> bind(function<R(P,Ps...)> f, Fn fn) {
+		static function<S(P,Ps...),inline_storage<N>> bind(function<R(P,Ps...),inline_storage<N>> f, Fn fn) {
 			return [=](P p, Ps...ps) {
 				return fn(f(p, ps...))(p, ps...);
 			};
@@ -139,6 +139,37 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Monad_rec implementation for ftl::function.
+	 *
+	 * In the function ("reader") monad, a bind chain of N steps nests N
+	 * closures, each re-invoked per call. The trampoline returns a single
+	 * function that, when invoked, runs the loop iteratively: every step is
+	 * given the same argument list, and the stack stays flat no matter how
+	 * many iterations the seed takes to resolve.
+	 *
+	 * \ingroup functional
+	 */
+	template<typename R, size_t N, typename P, typename...Ps>
+	struct monad_rec<function<R(P,Ps...),inline_storage<N>>> {
+
+		template<typename F, typename S, typename T = Value_type<R>>
+		static function<T(P,Ps...),inline_storage<N>> tailRec(F f, S seed) {
+			return [f,seed](P p, Ps...ps) -> T {
+				S s = seed;
+				for(;;) {
+					auto step = f(s)(p, ps...);
+					if(step)
+						return std::move(*step);
+
+					s = std::move(step.left());
+				}
+			};
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	template<typename>
 	struct monoid;
 
@@ -207,8 +238,8 @@ namespace ftl {
 	 *
 	 * \ingroup functional
 	 */
-	template<typename M, typename...Ps>
-	struct monoid<function<M(Ps...)>> {
+	template<typename M, size_t N, typename...Ps>
+	struct monoid<function<M(Ps...),inline_storage<N>>> {
 
 		/**
 		 * Function returning monoid<M>::id().
@@ -216,7 +247,7 @@ namespace ftl {
 		static auto id()
 		-> typename std::enable_if<
 				monoid<M>::instance,
-				function<M(Ps...)>>::type {
+				function<M(Ps...),inline_storage<N>>>::type {
 			return [](Ps...) { return monoid<M>::id(); };
 		}
 
@@ -233,11 +264,11 @@ namespace ftl {
 		 *          `f2` has side effects.
 		 */
 		static auto append(
-				const function<M(Ps...)>& f1,
-				const function<M(Ps...)>& f2)
+				const function<M(Ps...),inline_storage<N>>& f1,
+				const function<M(Ps...),inline_storage<N>>& f2)
 		-> typename std::enable_if<
 				monoid<M>::instance,
-				function<M(Ps...)>>::type {
+				function<M(Ps...),inline_storage<N>>>::type {
 			return [=] (Ps...ps) {
 				return monoid<M>::append(f1(ps...), f2(ps...));
 			};
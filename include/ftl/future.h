@@ -24,15 +24,22 @@
 #define FTL_FUTURE_H
 
 #include <future>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <tuple>
 #include "concepts/monad.h"
 #include "concepts/monoid.h"
+#include "either.h"
+#include "sum_type.h"
 
 namespace ftl {
 
 	/**
 	 * \defgroup future Future
 	 *
-	 * Concept instances for `std::future`.
+	 * Concept instances for `std::future`, and FTL's own continuation based
+	 * future, ftl::task.
 	 *
 	 * \code
 	 *   #include <ftl/future.h>
@@ -46,8 +53,14 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - `<future>`
+	 * - `<mutex>`
+	 * - `<condition_variable>`
+	 * - `<atomic>`
+	 * - `<tuple>`
 	 * - \ref monad
 	 * - \ref monoid
+	 * - \ref either
+	 * - \ref sum_type
 	 */
 
 	// Because futures cannot be copied, only moved, we need to specialise
@@ -229,6 +242,896 @@ namespace ftl {
 
 		static constexpr bool instance = monoid<T>::instance;
 	};
+
+	namespace _dtl {
+		/* Shared state of an ftl::task.
+		 *
+		 * Holds the eventual value (or exception), plus at most one attached
+		 * continuation. Continuations run on whichever thread completes the
+		 * state, or immediately on the attaching thread if the state is
+		 * already completed.
+		 */
+		template<typename T>
+		struct task_state {
+			task_state() : ready(false), has_continuation(false) {}
+
+			task_state(const task_state&) = delete;
+			task_state(task_state&&) = delete;
+
+			~task_state() {
+				if(ready && !error)
+					value_ptr()->~T();
+			}
+
+			T* value_ptr() {
+				return reinterpret_cast<T*>(&val);
+			}
+
+			/// Publish a value and run any attached continuation.
+			void complete(T&& t) {
+				std::unique_lock<std::mutex> l{lock};
+				new (&val) T(std::move(t));
+				publish(std::move(l));
+			}
+
+			/// Publish an exception and run any attached continuation.
+			void fail(std::exception_ptr e) {
+				std::unique_lock<std::mutex> l{lock};
+				error = e;
+				publish(std::move(l));
+			}
+
+			/**
+			 * Attach the continuation to run on completion.
+			 *
+			 * If the state is already completed, `f` is invoked immediately.
+			 * At most one continuation may ever be attached to a given state.
+			 */
+			void attach(function<void()> f) {
+				std::unique_lock<std::mutex> l{lock};
+				if(ready) {
+					l.unlock();
+					f();
+				}
+				else {
+					continuation = std::move(f);
+					has_continuation = true;
+				}
+			}
+
+			/// Block until the state is completed.
+			void wait() {
+				std::unique_lock<std::mutex> l{lock};
+				while(!ready)
+					ready_signal.wait(l);
+			}
+
+			/// Check whether the state is completed, without blocking.
+			bool is_ready() {
+				std::unique_lock<std::mutex> l{lock};
+				return ready;
+			}
+
+			std::mutex lock;
+			std::condition_variable ready_signal;
+			bool ready;
+			bool has_continuation;
+			std::exception_ptr error;
+			function<void()> continuation;
+			typename std::aligned_storage<sizeof(T),alignof(T)>::type val;
+
+		private:
+			void publish(std::unique_lock<std::mutex> l) {
+				ready = true;
+				bool run_continuation = has_continuation;
+				function<void()> cont;
+				if(run_continuation)
+					cont = std::move(continuation);
+
+				l.unlock();
+				ready_signal.notify_all();
+
+				if(run_continuation)
+					cont();
+			}
+		};
+	}
+
+	template<typename T>
+	class task;
+
+	template<typename L, typename T>
+	class asyncEither;
+
+	template<typename...Ts>
+	task<std::tuple<Ts...>> whenAll(task<Ts>&&...);
+
+	template<typename...Ts>
+	task<sum_type<Ts...>> whenAny(task<Ts>&&...);
+
+	/**
+	 * Producer side of an ftl::task.
+	 *
+	 * Works much like std::promise: create one, hand out the associated
+	 * task with `get_task`, and eventually call `set_value` or
+	 * `set_exception` from whatever thread produces the result.
+	 *
+	 * \see task
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	class task_promise {
+	public:
+		task_promise() : state(std::make_shared<_dtl::task_state<T>>()) {}
+		task_promise(const task_promise&) = delete;
+		task_promise(task_promise&&) = default;
+		~task_promise() = default;
+
+		task_promise& operator= (const task_promise&) = delete;
+		task_promise& operator= (task_promise&&) = default;
+
+		/// Get the task associated with this promise.
+		task<T> get_task();
+
+		/// Make the result available, running any attached continuation.
+		void set_value(T t) {
+			state->complete(std::move(t));
+		}
+
+		/// Propagate an exception to the consumer side.
+		void set_exception(std::exception_ptr e) {
+			state->fail(e);
+		}
+
+	private:
+		std::shared_ptr<_dtl::task_state<T>> state;
+	};
+
+	/**
+	 * A continuation based future.
+	 *
+	 * Unlike the std::future instances&mdash;which wrap every monadic step in
+	 * a new `std::async(std::launch::deferred,...)` and hence unwind a chain
+	 * of N binds through N nested futures&mdash;a task attaches each
+	 * continuation directly to the shared state of its predecessor. A chain
+	 * of binds is thus a flat sequence of callbacks, each invoked as soon as
+	 * the previous value is available, on the thread that produced it.
+	 *
+	 * Tasks are single-consumer and move-only, just like std::future; all
+	 * monadic and applicative combinators operate on r-values.
+	 *
+	 * \par Concepts
+	 * - \ref movecons
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	class task {
+	public:
+		task() = delete;
+		task(const task&) = delete;
+		task(task&&) = default;
+		~task() = default;
+
+		task& operator= (const task&) = delete;
+		task& operator= (task&&) = default;
+
+		/**
+		 * Create an already completed task.
+		 *
+		 * Costs a single allocation: the shared state, with the value
+		 * constructed in place.
+		 */
+		static task ready(T t) {
+			auto s = std::make_shared<_dtl::task_state<T>>();
+			s->complete(std::move(t));
+			return task{std::move(s)};
+		}
+
+		/**
+		 * Wait for, and return, the result.
+		 *
+		 * Invalidates the task. If the producer set an exception, it is
+		 * rethrown here.
+		 */
+		T get() {
+			auto s = std::move(state);
+			s->wait();
+			if(s->error)
+				std::rethrow_exception(s->error);
+
+			return std::move(*s->value_ptr());
+		}
+
+		/// Check whether the task still refers to a shared state.
+		bool valid() const noexcept {
+			return static_cast<bool>(state);
+		}
+
+		/// Block until the result is available, without consuming it.
+		void wait() const {
+			state->wait();
+		}
+
+		/// Check whether the result is available, without blocking.
+		bool is_ready() const {
+			return state->is_ready();
+		}
+
+		/**
+		 * Attach a continuation, returning the task of its result.
+		 *
+		 * `f` is invoked with the result as soon as it is available, on the
+		 * completing thread&mdash;or immediately, if the task is already
+		 * completed. Invalidates this task.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		task<U> then(F f) {
+			auto src = std::move(state);
+			auto dst = std::make_shared<_dtl::task_state<U>>();
+
+			src->attach(function<void()>{[src,dst,f]() {
+				if(src->error) {
+					dst->fail(src->error);
+					return;
+				}
+
+				try {
+					dst->complete(f(std::move(*src->value_ptr())));
+				}
+				catch(...) {
+					dst->fail(std::current_exception());
+				}
+			}});
+
+			return task<U>{std::move(dst)};
+		}
+
+		/**
+		 * Forward this task's result to the given state.
+		 *
+		 * Low-level building block used by the monad instance to flatten
+		 * nested tasks without any intermediate wrapper. Invalidates this
+		 * task.
+		 */
+		void forward_to(std::shared_ptr<_dtl::task_state<T>> dst) {
+			auto src = std::move(state);
+			src->attach(function<void()>{[src,dst]() {
+				if(src->error)
+					dst->fail(src->error);
+				else
+					dst->complete(std::move(*src->value_ptr()));
+			}});
+		}
+
+		explicit task(std::shared_ptr<_dtl::task_state<T>> s)
+		: state(std::move(s)) {}
+
+	private:
+		template<typename U>
+		friend class task;
+
+		template<typename U, typename V>
+		friend class asyncEither;
+
+		template<typename U>
+		friend struct monad;
+
+		template<typename...Ts>
+		friend task<std::tuple<Ts...>> whenAll(task<Ts>&&...);
+
+		template<typename...Ts>
+		friend task<sum_type<Ts...>> whenAny(task<Ts>&&...);
+
+		std::shared_ptr<_dtl::task_state<T>> state;
+	};
+
+	template<typename T>
+	task<T> task_promise<T>::get_task() {
+		return task<T>{state};
+	}
+
+	/**
+	 * Monad instance for ftl::task.
+	 *
+	 * Sequencing with this instance builds flat continuation chains: each
+	 * step runs as soon as its input is ready, with no nested future unwind
+	 * and no blocking `get()` in between the steps.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	struct monad<task<T>>
+#ifndef DOCUMENTATION_GENERATOR
+	: deriving_join<in_terms_of_bind<task<T>>>
+#endif
+	{
+		/// Creates an already completed task, without launching anything.
+		static task<T> pure(T t) {
+			return task<T>::ready(std::move(t));
+		}
+
+		/// Apply a function to the result, once it is available.
+		template<typename F, typename U = result_of<F(T)>>
+		static task<U> map(F f, task<T>&& t) {
+			return std::move(t).then(f);
+		}
+
+		/**
+		 * In the future, give `f` one of its arguments.
+		 *
+		 * Note that both operands progress independently; the result is
+		 * completed by whichever of them finishes last. Combining tasks
+		 * already running on separate threads with `apply` thus runs them
+		 * concurrently.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static task<U> apply(task<F>&& f, task<T>&& m) {
+			auto fs = std::move(f.state);
+			auto ms = std::move(m.state);
+			auto dst = std::make_shared<_dtl::task_state<U>>();
+
+			fs->attach(function<void()>{[fs,ms,dst]() {
+				ms->attach(function<void()>{[fs,ms,dst]() {
+					if(fs->error) {
+						dst->fail(fs->error);
+						return;
+					}
+
+					if(ms->error) {
+						dst->fail(ms->error);
+						return;
+					}
+
+					try {
+						dst->complete(
+							(*fs->value_ptr())(std::move(*ms->value_ptr()))
+						);
+					}
+					catch(...) {
+						dst->fail(std::current_exception());
+					}
+				}});
+			}});
+
+			return task<U>{std::move(dst)};
+		}
+
+		/**
+		 * Binds a task to another asynchronous computation.
+		 *
+		 * The continuation is attached directly to `t`'s shared state; the
+		 * inner task produced by `f` forwards its result straight to the
+		 * returned task's state. No wrapper futures are created.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static task<U> bind(task<T>&& t, F&& f) {
+			auto src = std::move(t.state);
+			auto dst = std::make_shared<_dtl::task_state<U>>();
+			plain_type<F> fn = std::forward<F>(f);
+
+			src->attach(function<void()>{[src,dst,fn]() {
+				if(src->error) {
+					dst->fail(src->error);
+					return;
+				}
+
+				try {
+					fn(std::move(*src->value_ptr())).forward_to(dst);
+				}
+				catch(...) {
+					dst->fail(std::current_exception());
+				}
+			}});
+
+			return task<U>{std::move(dst)};
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		/* Shared bookkeeping of a whenAll: the source states, the output
+		 * state, and an atomic countdown. The continuation attached to each
+		 * source only decrements; whoever brings the counter to zero builds
+		 * the tuple (or forwards the first error) without any further
+		 * synchronisation, since every source is completed by then.
+		 */
+		template<typename...Ts>
+		struct when_all_state {
+			when_all_state(
+					std::shared_ptr<task_state<std::tuple<Ts...>>> d,
+					std::shared_ptr<task_state<Ts>>...ss)
+			: dst(std::move(d)), srcs(std::move(ss)...)
+			, remaining(sizeof...(Ts)) {}
+
+			template<size_t...Is>
+			void attach_all(
+					std::shared_ptr<when_all_state> self, seq<Is...>) {
+				int expand[] = {(attach_one<Is>(self), 0)...};
+				(void) expand;
+			}
+
+			template<size_t I>
+			void attach_one(std::shared_ptr<when_all_state> self) {
+				std::get<I>(srcs)->attach(function<void()>{[self]() {
+					if(self->remaining.fetch_sub(1) == 1)
+						self->finish(gen_seq<0,sizeof...(Ts)-1>{});
+				}});
+			}
+
+			template<size_t...Is>
+			void finish(seq<Is...>) {
+				std::exception_ptr errs[]
+					= {std::get<Is>(srcs)->error...};
+
+				for(auto& e : errs) {
+					if(e) {
+						dst->fail(e);
+						return;
+					}
+				}
+
+				dst->complete(std::tuple<Ts...>(
+					std::move(*std::get<Is>(srcs)->value_ptr())...
+				));
+			}
+
+			std::shared_ptr<task_state<std::tuple<Ts...>>> dst;
+			std::tuple<std::shared_ptr<task_state<Ts>>...> srcs;
+			std::atomic<size_t> remaining;
+		};
+
+		/* Shared bookkeeping of a whenAny: first completion claims the
+		 * atomic flag and resolves the output; every later completion sees
+		 * the flag already set and does nothing.
+		 */
+		template<typename...Ts>
+		struct when_any_state {
+			when_any_state(
+					std::shared_ptr<task_state<sum_type<Ts...>>> d,
+					std::shared_ptr<task_state<Ts>>...ss)
+			: dst(std::move(d)), srcs(std::move(ss)...), done(false) {}
+
+			template<size_t...Is>
+			void attach_all(
+					std::shared_ptr<when_any_state> self, seq<Is...>) {
+				int expand[] = {(attach_one<Is>(self), 0)...};
+				(void) expand;
+			}
+
+			template<size_t I>
+			void attach_one(std::shared_ptr<when_any_state> self) {
+				std::get<I>(srcs)->attach(function<void()>{[self]() {
+					if(self->done.exchange(true))
+						return;
+
+					auto& s = std::get<I>(self->srcs);
+					if(s->error)
+						self->dst->fail(s->error);
+
+					else {
+						self->dst->complete(sum_type<Ts...>{
+							constructor<type_at<I,Ts...>>(),
+							std::move(*s->value_ptr())
+						});
+					}
+				}});
+			}
+
+			std::shared_ptr<task_state<sum_type<Ts...>>> dst;
+			std::tuple<std::shared_ptr<task_state<Ts>>...> srcs;
+			std::atomic<bool> done;
+		};
+	}
+
+	/**
+	 * Combine a heterogeneous set of tasks into a task of a tuple.
+	 *
+	 * The result completes as soon as the _last_ operand does, so awaiting a
+	 * fan-out costs the maximum of the legs' latencies rather than their
+	 * sum. Completion is driven by an atomic countdown shared between the
+	 * operands' continuations; no thread blocks or polls on behalf of the
+	 * combinator. If any leg fails, the combined task fails with the first
+	 * error, in operand order. All operands are invalidated.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *
+	 *   auto t = ftl::whenAll(
+	 *       ftl::async(pool, queryUsers),
+	 *       ftl::async(pool, queryOrders)
+	 *   );
+	 *
+	 *   auto rs = t.get();  // waits for the slowest leg only
+	 *   use(std::get<0>(rs), std::get<1>(rs));
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename...Ts>
+	task<std::tuple<Ts...>> whenAll(task<Ts>&&...ts) {
+		static_assert(
+			sizeof...(Ts) > 0,
+			"whenAll requires at least one operand"
+		);
+
+		auto dst = std::make_shared<_dtl::task_state<std::tuple<Ts...>>>();
+		auto st = std::make_shared<_dtl::when_all_state<Ts...>>(
+			dst, std::move(ts.state)...
+		);
+
+		st->attach_all(st, gen_seq<0,sizeof...(Ts)-1>{});
+
+		return task<std::tuple<Ts...>>{std::move(dst)};
+	}
+
+	/**
+	 * Race a heterogeneous set of tasks, yielding the first result.
+	 *
+	 * The returned task resolves with the first operand to complete,
+	 * wrapped in a `sum_type` whose active alternative tells which leg won;
+	 * `match` on it to handle the cases. The first completion wins whether
+	 * it is a value or an error. Later completions are discarded. As with
+	 * `whenAll`, resolution is claimed with a shared atomic flag&mdash;no
+	 * polling thread is involved. All operands are invalidated.
+	 *
+	 * \note The operand types must be distinct, as they identify the
+	 *       winning leg in the resulting `sum_type`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto t = ftl::whenAny(
+	 *       ftl::async(pool, queryPrimary),
+	 *       ftl::async(pool, queryReplica)
+	 *   );
+	 *
+	 *   t.get().match(
+	 *       [](const primary_result& r){ ... },
+	 *       [](const replica_result& r){ ... }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename...Ts>
+	task<sum_type<Ts...>> whenAny(task<Ts>&&...ts) {
+		static_assert(
+			sizeof...(Ts) > 0,
+			"whenAny requires at least one operand"
+		);
+
+		auto dst = std::make_shared<_dtl::task_state<sum_type<Ts...>>>();
+		auto st = std::make_shared<_dtl::when_any_state<Ts...>>(
+			dst, std::move(ts.state)...
+		);
+
+		st->attach_all(st, gen_seq<0,sizeof...(Ts)-1>{});
+
+		return task<sum_type<Ts...>>{std::move(dst)};
+	}
+
+	/**
+	 * Fused either-transformer over ftl::task.
+	 *
+	 * Stacking the generic `eitherT` on top of a future pays the deferred
+	 * wrapper problem twice: every bind builds the transformer's plumbing on
+	 * top of a fresh inner future, so a chain that fails at its first step
+	 * still constructs&mdash;and eventually wakes&mdash;each downstream
+	 * shell. An `asyncEither<L,T>` is instead a single `either<L,T>`
+	 * completion state per step: bind attaches one continuation directly to
+	 * its predecessor, and a left result is forwarded straight from state to
+	 * state&mdash;the continuation is never invoked, and the computation it
+	 * would have produced is never allocated.
+	 *
+	 * Exceptions thrown by producers or continuations propagate like they do
+	 * through task, and are rethrown by `get`. Lefts are for the expected,
+	 * recoverable failures of the domain.
+	 *
+	 * Like task, asyncEither is single-consumer and move-only; all
+	 * combinators operate on r-values.
+	 *
+	 * \par Concepts
+	 * - \ref movecons
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using step = ftl::asyncEither<error,record>;
+	 *
+	 *   step fetch(id);
+	 *   step validate(record);
+	 *   step persist(record);
+	 *
+	 *   auto r = (fetch(x) >>= validate) >>= persist;
+	 *
+	 *   // A left from fetch reaches r.get() without ever constructing
+	 *   // the validate or persist computations.
+	 *   r.get().match(...);
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename L, typename T>
+	class asyncEither {
+	public:
+		using value_type = T;
+
+		asyncEither() = delete;
+		asyncEither(const asyncEither&) = delete;
+		asyncEither(asyncEither&&) = default;
+		~asyncEither() = default;
+
+		asyncEither& operator= (const asyncEither&) = delete;
+		asyncEither& operator= (asyncEither&&) = default;
+
+		/**
+		 * Wrap an existing task of eithers.
+		 *
+		 * Free: the task's shared state is stolen, not re-wrapped.
+		 */
+		explicit asyncEither(task<either<L,T>>&& t) noexcept
+		: state(std::move(t.state)) {}
+
+		/**
+		 * Create an already completed, right-valued computation.
+		 *
+		 * Costs a single allocation: the shared state.
+		 */
+		static asyncEither right(T t) {
+			auto s = std::make_shared<_dtl::task_state<either<L,T>>>();
+			s->complete(make_right<L>(std::move(t)));
+			return asyncEither{std::move(s)};
+		}
+
+		/// Create an already completed, left-valued computation.
+		static asyncEither left(L l) {
+			auto s = std::make_shared<_dtl::task_state<either<L,T>>>();
+			s->complete(make_left<T>(std::move(l)));
+			return asyncEither{std::move(s)};
+		}
+
+		/// Lift a plain task into the transformer, as an always-right step.
+		static asyncEither lift(task<T>&& t) {
+			return asyncEither{std::move(t).then([](T&& x) {
+				return make_right<L>(std::move(x));
+			})};
+		}
+
+		/**
+		 * Wait for, and return, the result.
+		 *
+		 * Invalidates the computation. Exceptions are rethrown here; lefts
+		 * are returned like any other result.
+		 */
+		either<L,T> get() {
+			auto s = std::move(state);
+			s->wait();
+			if(s->error)
+				std::rethrow_exception(s->error);
+
+			return std::move(*s->value_ptr());
+		}
+
+		/// Check whether a shared state is still referred to.
+		bool valid() const noexcept {
+			return static_cast<bool>(state);
+		}
+
+		/// Block until the result is available, without consuming it.
+		void wait() const {
+			state->wait();
+		}
+
+		/// Check whether the result is available, without blocking.
+		bool is_ready() const {
+			return state->is_ready();
+		}
+
+		/// Recover the underlying task of eithers. Invalidates this.
+		task<either<L,T>> unwrap() {
+			return task<either<L,T>>{std::move(state)};
+		}
+
+		/**
+		 * Forward this computation's result to the given state.
+		 *
+		 * The monadic plumbing's equivalent of task::forward_to: lefts,
+		 * rights, and exceptions alike move from state to state without any
+		 * intermediate wrapper. Invalidates this.
+		 */
+		void forward_to(std::shared_ptr<_dtl::task_state<either<L,T>>> dst) {
+			auto src = std::move(state);
+			src->attach(function<void()>{[src,dst]() {
+				if(src->error)
+					dst->fail(src->error);
+				else
+					dst->complete(std::move(*src->value_ptr()));
+			}});
+		}
+
+		explicit asyncEither(
+				std::shared_ptr<_dtl::task_state<either<L,T>>> s) noexcept
+		: state(std::move(s)) {}
+
+	private:
+		template<typename U, typename V>
+		friend class asyncEither;
+
+		template<typename U>
+		friend struct monad;
+
+		std::shared_ptr<_dtl::task_state<either<L,T>>> state;
+	};
+
+	// asyncEither's parametric traits are non-default.
+	template<typename L, typename T>
+	struct parametric_type_traits<asyncEither<L,T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = asyncEither<L,U>;
+	};
+
+	/**
+	 * Monad instance for asyncEither.
+	 *
+	 * Sequencing builds the same flat continuation chains as task's
+	 * instance, with left results short-circuiting: a step that resolves
+	 * left completes the whole remaining chain immediately, skipping every
+	 * downstream continuation and allocating nothing for them.
+	 *
+	 * \ingroup future
+	 */
+	template<typename L, typename T>
+	struct monad<asyncEither<L,T>>
+#ifndef DOCUMENTATION_GENERATOR
+	: deriving_join<in_terms_of_bind<asyncEither<L,T>>>
+#endif
+	{
+		/// Creates an already completed, right-valued computation.
+		static asyncEither<L,T> pure(T t) {
+			return asyncEither<L,T>::right(std::move(t));
+		}
+
+		/// Apply a function to the right result, once it is available.
+		template<typename F, typename U = result_of<F(T)>>
+		static asyncEither<L,U> map(F f, asyncEither<L,T>&& e) {
+			auto src = std::move(e.state);
+			auto dst = std::make_shared<_dtl::task_state<either<L,U>>>();
+
+			src->attach(function<void()>{[src,dst,f]() {
+				if(src->error) {
+					dst->fail(src->error);
+					return;
+				}
+
+				auto& r = *src->value_ptr();
+				if(!r) {
+					dst->complete(make_left<U>(std::move(r.left())));
+					return;
+				}
+
+				try {
+					dst->complete(make_right<L>(f(std::move(*r))));
+				}
+				catch(...) {
+					dst->fail(std::current_exception());
+				}
+			}});
+
+			return asyncEither<L,U>{std::move(dst)};
+		}
+
+		/**
+		 * In the future, give `f` one of its arguments.
+		 *
+		 * As with task, both operands progress independently. If the
+		 * function operand resolves left, the result is completed right
+		 * away; the value operand is then never even subscribed to.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static asyncEither<L,U> apply(
+				asyncEither<L,F>&& f, asyncEither<L,T>&& m) {
+			auto fs = std::move(f.state);
+			auto ms = std::move(m.state);
+			auto dst = std::make_shared<_dtl::task_state<either<L,U>>>();
+
+			fs->attach(function<void()>{[fs,ms,dst]() {
+				if(fs->error) {
+					dst->fail(fs->error);
+					return;
+				}
+
+				auto& rf = *fs->value_ptr();
+				if(!rf) {
+					dst->complete(make_left<U>(std::move(rf.left())));
+					return;
+				}
+
+				ms->attach(function<void()>{[fs,ms,dst]() {
+					if(ms->error) {
+						dst->fail(ms->error);
+						return;
+					}
+
+					auto& rm = *ms->value_ptr();
+					if(!rm) {
+						dst->complete(make_left<U>(std::move(rm.left())));
+						return;
+					}
+
+					try {
+						dst->complete(make_right<L>(
+							(*(*fs->value_ptr()))(std::move(*rm))
+						));
+					}
+					catch(...) {
+						dst->fail(std::current_exception());
+					}
+				}});
+			}});
+
+			return asyncEither<L,U>{std::move(dst)};
+		}
+
+		/**
+		 * Binds the right result to another fallible, asynchronous step.
+		 *
+		 * One continuation is attached to `e`'s state; the inner
+		 * computation produced by `f` forwards its result straight to the
+		 * returned state. On a left, `f` is never invoked and no inner
+		 * state is ever allocated&mdash;the left simply completes `dst`.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static asyncEither<L,U> bind(asyncEither<L,T>&& e, F&& f) {
+			auto src = std::move(e.state);
+			auto dst = std::make_shared<_dtl::task_state<either<L,U>>>();
+			plain_type<F> fn = std::forward<F>(f);
+
+			src->attach(function<void()>{[src,dst,fn]() {
+				if(src->error) {
+					dst->fail(src->error);
+					return;
+				}
+
+				auto& r = *src->value_ptr();
+				if(!r) {
+					// Short-circuit: skipped continuations are neither
+					// constructed nor woken
+					dst->complete(make_left<U>(std::move(r.left())));
+					return;
+				}
+
+				try {
+					fn(std::move(*r)).forward_to(dst);
+				}
+				catch(...) {
+					dst->fail(std::current_exception());
+				}
+			}});
+
+			return asyncEither<L,U>{std::move(dst)};
+		}
+
+		static constexpr bool instance = true;
+	};
 }
 
 #endif
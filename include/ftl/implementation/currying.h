@@ -30,48 +30,113 @@
 
 namespace ftl {
 	namespace _dtl {
+		// Flat record of a partially applied function: the wrapped function
+		// object plus every argument bound so far, stored in a single tuple.
+		// Further partial applications append to the tuple instead of
+		// wrapping another layer of copies, and rvalue applications move the
+		// whole record along rather than copying it.
+		template<typename F, typename...Ps>
+		struct bound_args {
+			F f;
+			std::tuple<Ps...> ps;
+
+			template<typename G, typename Tuple>
+			bound_args(G&& g, Tuple&& t)
+			: f(std::forward<G>(g)), ps(std::forward<Tuple>(t)) {}
+
+		private:
+			template<size_t...S, typename...Qs>
+			auto apply(seq<S...>, Qs&&...qs) const
+			-> result_of<F(Ps...,Qs...)> {
+				return f(std::get<S>(ps)..., std::forward<Qs>(qs)...);
+			}
+
+			template<size_t...S, typename...Qs>
+			auto apply_moved(seq<S...>, Qs&&...qs)
+			-> result_of<F(Ps...,Qs...)> {
+				return std::move(f)(
+					std::get<S>(std::move(ps))..., std::forward<Qs>(qs)...
+				);
+			}
+
+		public:
+			template<
+					typename...Qs,
+					typename = typename std::enable_if<
+						is_callable<F,Ps...,Qs...>::value
+					>::type
+			>
+			auto operator() (Qs&&...qs) const &
+			-> result_of<F(Ps...,Qs...)> {
+				return apply(
+					gen_seq<0,sizeof...(Ps)-1>{}, std::forward<Qs>(qs)...
+				);
+			}
+
+			template<
+					typename...Qs,
+					typename = typename std::enable_if<
+						is_callable<F,Ps...,Qs...>::value
+					>::type
+			>
+			auto operator() (Qs&&...qs) &&
+			-> result_of<F(Ps...,Qs...)> {
+				return apply_moved(
+					gen_seq<0,sizeof...(Ps)-1>{}, std::forward<Qs>(qs)...
+				);
+			}
+
+			template<
+					typename...Qs,
+					typename = typename std::enable_if<
+						!is_callable<F,Ps...,Qs...>::value
+					>::type
+			>
+			auto operator() (Qs&&...qs) const &
+			-> bound_args<F,Ps...,plain_type<Qs>...> {
+				return bound_args<F,Ps...,plain_type<Qs>...>(
+					f,
+					std::tuple_cat(
+						ps, std::make_tuple(std::forward<Qs>(qs)...)
+					)
+				);
+			}
+
+			template<
+					typename...Qs,
+					typename = typename std::enable_if<
+						!is_callable<F,Ps...,Qs...>::value
+					>::type
+			>
+			auto operator() (Qs&&...qs) &&
+			-> bound_args<F,Ps...,plain_type<Qs>...> {
+				return bound_args<F,Ps...,plain_type<Qs>...>(
+					std::move(f),
+					std::tuple_cat(
+						std::move(ps),
+						std::make_tuple(std::forward<Qs>(qs)...)
+					)
+				);
+			}
+		};
+
 		// This struct is used to generate curried calling convention for
 		// arbitrary binary functions
 		template<typename F>
 		struct curried_binf {
-		private:
 			template<typename P>
-			struct curried {
-				curried(const F& f, const P& p) : f(f), p(p) {}
-				curried(const F& f, P&& p) : f(f), p(std::move(p)) {}
-				curried(F&& f, const P& p) : f(std::move(f)), p(p) {}
-				curried(F&& f, P&& p) : f(std::move(f)), p(std::move(p)) {}
-
-				F f;
-				P p;
-
-				template<typename T>
-				auto operator() (T&& t) const &
-				-> decltype(f(p, std::forward<T>(t))) {
-					return f(p, std::forward<T>(t));
-				}
-
-				template<typename T>
-				auto operator() (T&& t) &&
-				-> decltype(std::move(f)(std::move(p), std::forward<T>(t))) {
-					return std::move(f)(std::move(p), std::forward<T>(t));
-				}
-			};
-
-		public:
-			template<typename P>
-			curried<plain_type<P>> operator() (P&& p) const & {
-				return curried<plain_type<P>>(
+			bound_args<F,plain_type<P>> operator() (P&& p) const & {
+				return bound_args<F,plain_type<P>>(
 						*static_cast<const F*>(this),
-						std::forward<P>(p)
+						std::make_tuple(std::forward<P>(p))
 				);
 			}
 
 			template<typename P>
-			curried<plain_type<P>> operator() (P&& p) && {
-				return curried<plain_type<P>>(
+			bound_args<F,plain_type<P>> operator() (P&& p) && {
+				return bound_args<F,plain_type<P>>(
 						std::move(*static_cast<F*>(this)),
-						std::forward<P>(p)
+						std::make_tuple(std::forward<P>(p))
 				);
 			}
 		};
@@ -80,198 +145,41 @@ namespace ftl {
 		// arbitrary ternary functions
 		template<typename F>
 		struct curried_ternf {
-		private:
-			template<typename P1>
-			struct curried1 {
-			private:
-				template<typename P2>
-				struct curried {
-					curried(const F& f, const P1& p1, const P2& p2)
-					: f(f), p1(p1), p2(p2) {}
-
-					curried(const F& f, const P1& p1, P2&& p2)
-					: f(f), p1(p1), p2(std::move(p2)) {}
-
-					curried(const F& f, P1&& p1, const P2& p2)
-					: f(f), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, const P1& p1, const P2& p2)
-					: f(std::move(f)), p1(p1), p2(p2) {}
-
-					curried(const F& f, P1&& p1, P2&& p2)
-					: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-					curried(F&& f, const P1& p1, P2&& p2)
-					: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-					curried(F&& f, P1&& p1, const P2& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, P1&& p1, P2&& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
-
-					F f;
-					P1 p1;
-					P2 p2;
-
-					template<typename P3>
-					auto operator() (P3&& p3) const &
-					-> decltype(f(p1, p2, std::forward<P3>(p3))) {
-						return f(p1, p2, std::forward<P3>(p3));
-					}
-
-					template<typename P3>
-					auto operator() (P3&& p3) &&
-					-> decltype(std::move(f)(
-								std::move(p1), std::move(p2), std::forward<P3>(p3)
-					)) {
-						return std::move(f)(
-								std::move(p1), std::move(p2), std::forward<P3>(p3)
-						);
-					}
-				};
-
-			public:
-				curried1(const F& f, const P1& p) : f(f), p(p) {}
-				curried1(const F& f, P1&& p) : f(f), p(std::move(p)) {}
-				curried1(F&& f, const P1& p) : f(std::move(f)), p(p) {}
-				curried1(F&& f, P1&& p) : f(std::move(f)), p(std::move(p)) {}
-
-				F f;
-				P1 p;
-
-				template<typename P2, typename P3>
-				auto operator() (P2&& p2, P3&& p3) const &
-				-> decltype(f(p, std::forward<P2>(p2), std::forward<P3>(p3))) {
-					return f(p, std::forward<P2>(p2), std::forward<P3>(p3));
-				}
-
-				template<typename P2, typename P3>
-				auto operator() (P2&& p2, P3&& p3) &&
-				-> decltype(std::move(f)(
-						std::move(p), std::forward<P2>(p2), std::forward<P3>(p3)
-				)) {
-					return std::move(f)(
-						std::move(p), std::forward<P2>(p2), std::forward<P3>(p3)
-					);
-				}
-
-				template<typename P2>
-				curried<plain_type<P2>> operator() (P2&& p2) const &  {
-					return curried<plain_type<P2>>(f, p, std::forward<P2>(p2));
-				}
-
-				template<typename P2>
-				curried<plain_type<P2>> operator() (P2&& p2) && {
-					return curried<plain_type<P2>>(
-							std::move(f), std::move(p), std::forward<P2>(p2)
-					);
-				}
-			};
-
-			template<typename P1, typename P2>
-			struct curried2 {
-				F f;
-				P1 p1;
-				P2 p2;
-
-				curried2(const F& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(p1), p2(p2) {}
-
-				curried2(const F& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(p1), p2(std::move(p2)) {}
-
-				curried2(const F& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(p2) {}
-
-				curried2(const F& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-				curried2(F&& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-				curried2(F&& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
-
-				template<typename P3>
-				auto operator() (P3&& p3) const &
-				-> decltype(f(p1, p2, std::forward<P3>(p3))) {
-					return f(p1, p2, std::forward<P3>(p3));
-				}
-
-				template<typename P3>
-				auto operator() (P3&& p3) &&
-				-> decltype(std::move(f)(
-							std::move(p1), std::move(p2), std::forward<P3>(p3)
-				)) {
-					return std::move(f)(
-							std::move(p1), std::move(p2), std::forward<P3>(p3)
-					);
-				}
-			};
-
-		public:
 			template<typename P>
-			curried1<plain_type<P>> operator() (P&& p) const & {
-				return curried1<plain_type<P>>(
+			bound_args<F,plain_type<P>> operator() (P&& p) const & {
+				return bound_args<F,plain_type<P>>(
 						*static_cast<const F*>(this),
-						std::forward<P>(p)
+						std::make_tuple(std::forward<P>(p))
 				);
 			}
 
 			template<typename P>
-			curried1<plain_type<P>> operator() (P&& p) && {
-				return curried1<plain_type<P>>(
+			bound_args<F,plain_type<P>> operator() (P&& p) && {
+				return bound_args<F,plain_type<P>>(
 						std::move(*static_cast<F*>(this)),
-						std::forward<P>(p)
+						std::make_tuple(std::forward<P>(p))
 				);
 			}
 
 			template<typename P1, typename P2>
-			curried2<plain_type<P1>,plain_type<P2>>
+			bound_args<F,plain_type<P1>,plain_type<P2>>
 			operator() (P1&& p1, P2&& p2) const & {
-				return curried2<plain_type<P1>,plain_type<P2>>(
+				return bound_args<F,plain_type<P1>,plain_type<P2>>(
 					*static_cast<const F*>(this),
-					std::forward<P1>(p1), std::forward<P2>(p2)
+					std::make_tuple(
+						std::forward<P1>(p1), std::forward<P2>(p2)
+					)
 				);
 			}
 
 			template<typename P1, typename P2>
-			curried2<plain_type<P1>,plain_type<P2>>
+			bound_args<F,plain_type<P1>,plain_type<P2>>
 			operator() (P1&& p1, P2&& p2) && {
-				return curried2<plain_type<P1>,plain_type<P2>>(
+				return bound_args<F,plain_type<P1>,plain_type<P2>>(
 					std::move(*static_cast<F*>(this)),
-					std::forward<P1>(p1), std::forward<P2>(p2)
+					std::make_tuple(
+						std::forward<P1>(p1), std::forward<P2>(p2)
+					)
 				);
 			}
 		};
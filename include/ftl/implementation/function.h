@@ -30,10 +30,12 @@
 #ifndef FTL_FUNCTION_IMPL_H
 #define FTL_FUNCTION_IMPL_H
 
+#include <atomic>
 #include <memory>
 #include <stdexcept>
 #include <functional>
 #include "../type_functions.h"
+#include "../profile.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -42,36 +44,86 @@
 
 namespace ftl {
 
-	template<typename> class function;
+	namespace _dtl {
+		/// Inline storage capacity of an ftl::function, unless overridden.
+		constexpr size_t default_function_padding = 2*sizeof(size_t);
+	}
+
+	/**
+	 * Tag type used to select the inline storage size of an ftl::function.
+	 *
+	 * \see function
+	 *
+	 * \ingroup function
+	 */
+	template<size_t Bytes>
+	struct inline_storage {
+		static constexpr size_t value = Bytes;
+	};
+
+	template<
+			typename,
+			typename = inline_storage<::ftl::_dtl::default_function_padding>
+	>
+	class function;
+
+	template<
+			typename,
+			typename = inline_storage<::ftl::_dtl::default_function_padding>
+	>
+	class unique_function;
 
 	template<typename>
 	struct force_function_heap_allocation : std::false_type {};
 
+	/**
+	 * Opt-in trait enabling shared storage of heap allocated functors.
+	 *
+	 * When specialised to derive `std::true_type` for a functor type that
+	 * would spill to the heap, copies of any ftl::function wrapping it share
+	 * one reference counted heap block instead of cloning the functor. This
+	 * turns copying a function with a large captured state into an atomic
+	 * increment, at the price of the sharing: opt in only for targets that
+	 * are immutable when invoked, since all copies observe the same state.
+	 *
+	 * \see function
+	 *
+	 * \ingroup function
+	 */
+	template<typename>
+	struct share_function_heap_storage : std::false_type {};
+
 	// Namespace for internal details
 	namespace _dtl {
-		struct manager_storage_type;
-
+		template<size_t> struct manager_storage_type;
+
+		/* Raw storage for in-place allocated functors.
+		 *
+		 * `Bytes` is rounded up to whole words; the default gives the classic
+		 * two-word buffer.
+		 */
+		template<size_t Bytes>
 		struct functor_padding {
 		protected:
-			size_t padding_fst;
-			size_t padding_snd;
+			size_t padding[(Bytes + sizeof(size_t) - 1)/sizeof(size_t)];
 		};
 
 		struct empty_struct {};
 
-		template<typename R, typename...Ps>
-		R empty_call(const functor_padding&, Ps...) {
+		template<typename R, size_t N, typename...Ps>
+		R empty_call(const functor_padding<N>&, Ps...) {
 			throw std::bad_function_call();
 		}
 
-		template<typename T, typename Alloc>
+		template<typename T, typename Alloc,
+				size_t N = default_function_padding>
 		struct is_inplace_allocated {
 			static constexpr bool value
 				// so that it fits
-				= sizeof(T) <= sizeof(functor_padding)
+				= sizeof(T) <= sizeof(functor_padding<N>)
 
 				// so that it will be aligned
-				&& (std::alignment_of<functor_padding>::value
+				&& (std::alignment_of<functor_padding<N>>::value
 					% std::alignment_of<T>::value == 0)
 
 				// so that we can offer noexcept move
@@ -124,8 +176,32 @@ namespace ftl {
 			static constexpr bool value = false;
 		};
 
-		template<typename R, typename...Ps>
-		struct is_valid_function_argument<function<R(Ps...)>, R (Ps...)> {
+		template<typename R, typename S, typename...Ps>
+		struct is_valid_function_argument<function<R(Ps...),S>, R (Ps...)> {
+			static constexpr bool value = false;
+		};
+
+		template<typename R, typename S, typename...Ps>
+		struct is_valid_function_argument<unique_function<R(Ps...),S>, R (Ps...)> {
+			static constexpr bool value = false;
+		};
+
+		/* Same as is_valid_function_argument, except an ftl::function of the
+		 * very same signature is a perfectly good target for a
+		 * unique_function&mdash;only wrapping a unique_function in itself is
+		 * excluded.
+		 */
+		template<typename T, typename S>
+		struct is_valid_unique_function_argument
+		: is_valid_function_argument<T,S> {};
+
+		template<typename R, typename S, typename...Ps>
+		struct is_valid_unique_function_argument<function<R(Ps...),S>, R (Ps...)> {
+			static constexpr bool value = true;
+		};
+
+		template<typename R, typename S, typename...Ps>
+		struct is_valid_unique_function_argument<unique_function<R(Ps...),S>, R (Ps...)> {
 			static constexpr bool value = false;
 		};
 
@@ -153,7 +229,7 @@ namespace ftl {
 			call_destroy,
 		};
 
-		template<typename T, typename Allocator>
+		template<typename T, typename Allocator, size_t N>
 		void* function_manager(
 				void* first_arg,
 				void* second_arg,
@@ -161,6 +237,7 @@ namespace ftl {
 
 		typedef void *(*manager_type)(void*, void*, function_manager_calls);
 
+		template<size_t N>
 		struct manager_storage_type {
 
 			template<typename Allocator>
@@ -173,70 +250,81 @@ namespace ftl {
 				return reinterpret_cast<const Allocator&>(manager);
 			}
 
-			functor_padding functor;
+			functor_padding<N> functor;
 			manager_type manager;
 		};
 
-		template<typename T, typename Allocator, typename Enable = void>
+		template<typename T, typename Allocator, size_t N,
+				typename Enable = void>
 		struct function_manager_inplace_specialisation {
 
 			template<typename R, typename...Ps>
-			static R call(const functor_padding& storage, Ps... ps) {
+			static R call(const functor_padding<N>& storage, Ps... ps) {
 				// do not call get_functor_ref because I want this function to
 				// be fast in debug when nothing gets inlined
 				return
 					reinterpret_cast<T&>(
-						const_cast<functor_padding&>(storage))(std::forward<Ps>(ps)...);
+						const_cast<functor_padding<N>&>(storage))(std::forward<Ps>(ps)...);
 			}
 
-			static void store_functor(manager_storage_type& storage, T to_store) {
+			static void store_functor(manager_storage_type<N>& storage, T to_store) {
 				new (&get_functor_ref(storage)) T(std::forward<T>(to_store));
 			}
 
+			static void copy_functor(
+					manager_storage_type<N>& lhs,
+					const manager_storage_type<N>& rhs
+			) {
+				store_functor(lhs, const_cast<const T&>(get_functor_ref(rhs)));
+			}
+
 			static void move_functor(
-					manager_storage_type& lhs, manager_storage_type&& rhs
+					manager_storage_type<N>& lhs, manager_storage_type<N>&& rhs
 			)
 			noexcept {
 				new (&get_functor_ref(lhs)) T(std::move(get_functor_ref(rhs)));
 			}
 
 			static void destroy_functor(
-					Allocator &, manager_storage_type & storage
+					Allocator &, manager_storage_type<N> & storage
 			)
 			noexcept {
 				get_functor_ref(storage).~T();
 			}
 
-			static T& get_functor_ref(const manager_storage_type& storage) noexcept {
+			static T& get_functor_ref(const manager_storage_type<N>& storage) noexcept {
 				return reinterpret_cast<T&>(
-					const_cast<functor_padding&>(storage.functor)
+					const_cast<functor_padding<N>&>(storage.functor)
 				);
 			}
 		};
 
-		template<typename T, typename Allocator>
+		template<typename T, typename Allocator, size_t N>
 		struct function_manager_inplace_specialisation<
 					T,
 					Allocator,
+					N,
 					typename std::enable_if<
-						!is_inplace_allocated<T, Allocator>::value>::type> {
+						!is_inplace_allocated<T, Allocator, N>::value
+						&& !share_function_heap_storage<T>::value>::type> {
 
 			using alloc_traits = std::allocator_traits<Allocator>;
 			using ptr_t = typename alloc_traits::pointer;
 
 			template<typename R, typename...Ps>
-			static R call(const functor_padding& storage, Ps... ps) {
+			static R call(const functor_padding<N>& storage, Ps... ps) {
 				// do not call get_functor_ptr_ref because I want this function
 				// to be fast in debug when nothing gets inlined
 				return
-					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding&>(storage)))(
+					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding<N>&>(storage)))(
 						std::forward<Ps>(ps)...
 					);
 			}
 
-			static void store_functor(manager_storage_type& self, T to_store) {
+			static void store_functor(manager_storage_type<N>& self, T to_store) {
+				profile_count_function_heap_allocation();
 
-				Allocator& allocator = self.get_allocator<Allocator>();;
+				Allocator& allocator = self.template get_allocator<Allocator>();;
 				static_assert(
 						sizeof(ptr_t) <= sizeof(self.functor),
 						"The allocator's pointer type is too big"
@@ -249,8 +337,15 @@ namespace ftl {
 				alloc_traits::construct(allocator, *ptr, std::forward<T>(to_store));
 			}
 
+			static void copy_functor(
+					manager_storage_type<N>& lhs,
+					const manager_storage_type<N>& rhs
+			) {
+				store_functor(lhs, const_cast<const T&>(get_functor_ref(rhs)));
+			}
+
 			static void move_functor(
-					manager_storage_type& lhs, manager_storage_type&& rhs
+					manager_storage_type<N>& lhs, manager_storage_type<N>&& rhs
 			)
 			noexcept {
 
@@ -269,7 +364,7 @@ namespace ftl {
 			}
 
 			static void destroy_functor(
-					Allocator& allocator, manager_storage_type& storage
+					Allocator& allocator, manager_storage_type<N>& storage
 			)
 			noexcept {
 
@@ -281,35 +376,149 @@ namespace ftl {
 				alloc_traits::deallocate(allocator, pointer, 1);
 			}
 
-			static T & get_functor_ref(const manager_storage_type& storage) noexcept {
+			static T & get_functor_ref(const manager_storage_type<N>& storage) noexcept {
 				return *get_functor_ptr_ref(storage);
 			}
 
-			static ptr_t& get_functor_ptr_ref(const manager_storage_type& storage)
+			static ptr_t& get_functor_ptr_ref(const manager_storage_type<N>& storage)
 			noexcept {
 				return reinterpret_cast<ptr_t&>(
-						const_cast<functor_padding&>(storage.functor)
+						const_cast<functor_padding<N>&>(storage.functor)
 				);
 			}
 		};
 
-		template<typename T, typename Allocator>
-		static void create_manager(manager_storage_type& storage, Allocator&& allocator)
+		/* Shared-immutable variant of the heap path.
+		 *
+		 * Selected when the user has opted T in via
+		 * share_function_heap_storage. The functor lives in a single reference
+		 * counted heap block; copying a function bumps the count instead of
+		 * allocating and cloning the functor's state. The count is atomic so
+		 * copies may be handed to other threads, as long as T itself is
+		 * const-safe to invoke concurrently.
+		 */
+		template<typename T, typename Allocator, size_t N>
+		struct function_manager_inplace_specialisation<
+					T,
+					Allocator,
+					N,
+					typename std::enable_if<
+						!is_inplace_allocated<T, Allocator, N>::value
+						&& share_function_heap_storage<T>::value>::type> {
+
+			struct shared_functor {
+				explicit shared_functor(T f)
+				: functor(std::move(f)), refs(1) {}
+
+				T functor;
+				std::atomic<size_t> refs;
+			};
+
+			using shared_alloc = typename std::allocator_traits<Allocator>
+				::template rebind_alloc<shared_functor>;
+			using alloc_traits = std::allocator_traits<shared_alloc>;
+			using ptr_t = typename alloc_traits::pointer;
+
+			template<typename R, typename...Ps>
+			static R call(const functor_padding<N>& storage, Ps... ps) {
+				// do not call get_functor_ptr_ref because I want this function
+				// to be fast in debug when nothing gets inlined
+				return
+					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding<N>&>(storage)))
+						.functor(std::forward<Ps>(ps)...);
+			}
+
+			static void store_functor(manager_storage_type<N>& self, T to_store) {
+				profile_count_function_heap_allocation();
+
+				shared_alloc allocator{self.template get_allocator<Allocator>()};
+				static_assert(
+						sizeof(ptr_t) <= sizeof(self.functor),
+						"The allocator's pointer type is too big"
+				);
+
+				ptr_t* ptr = new (&get_functor_ptr_ref(self)) ptr_t(
+						alloc_traits::allocate(allocator, 1)
+				);
+
+				alloc_traits::construct(allocator, *ptr, std::move(to_store));
+			}
+
+			static void copy_functor(
+					manager_storage_type<N>& lhs,
+					const manager_storage_type<N>& rhs
+			) noexcept {
+				ptr_t p = get_functor_ptr_ref(rhs);
+				p->refs.fetch_add(1, std::memory_order_relaxed);
+				new (&get_functor_ptr_ref(lhs)) ptr_t(p);
+			}
+
+			static void move_functor(
+					manager_storage_type<N>& lhs, manager_storage_type<N>&& rhs
+			)
+			noexcept {
+
+				static_assert(
+					std::is_nothrow_move_constructible<ptr_t>::value,
+					"Cannot offer noexcept swap if the pointer type is "
+					"not nothrow move constructible"
+				);
+
+				new (&get_functor_ptr_ref(lhs)) ptr_t(
+						std::move(get_functor_ptr_ref(rhs))
+				);
+
+				// this next assignment makes the destroy function easier
+				get_functor_ptr_ref(rhs) = nullptr;
+			}
+
+			static void destroy_functor(
+					Allocator& allocator, manager_storage_type<N>& storage
+			)
+			noexcept {
+
+				ptr_t& pointer = get_functor_ptr_ref(storage);
+				if (!pointer)
+					return;
+
+				// Last owner out tears the block down; acq_rel orders any
+				// writes made while constructing before the destruction
+				if (pointer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					shared_alloc shared{allocator};
+					alloc_traits::destroy(shared, pointer);
+					alloc_traits::deallocate(shared, pointer, 1);
+				}
+			}
+
+			static T & get_functor_ref(const manager_storage_type<N>& storage) noexcept {
+				return get_functor_ptr_ref(storage)->functor;
+			}
+
+			static ptr_t& get_functor_ptr_ref(const manager_storage_type<N>& storage)
+			noexcept {
+				return reinterpret_cast<ptr_t&>(
+						const_cast<functor_padding<N>&>(storage.functor)
+				);
+			}
+		};
+
+		template<typename T, typename Allocator, size_t N>
+		static void create_manager(manager_storage_type<N>& storage, Allocator&& allocator)
 		{
-			new (&storage.get_allocator<Allocator>()) Allocator(std::move(allocator));
-			storage.manager = &function_manager<T, Allocator>;
+			new (&storage.template get_allocator<Allocator>()) Allocator(std::move(allocator));
+			storage.manager = &function_manager<T, Allocator, N>;
 		}
 
 		// this function acts as a vtable. it is an optimization to prevent
 		// code-bloat from rtti. see the documentation of boost::function
-		template<typename T, typename Allocator>
+		template<typename T, typename Allocator, size_t N>
 		void* function_manager(
 				void* first_arg, void* second_arg,
 				function_manager_calls call_type
 		)
 		{
 			using specialisation
-				= function_manager_inplace_specialisation<T,Allocator>;
+				= function_manager_inplace_specialisation<T,Allocator,N>;
 
 			static_assert(
 				std::is_empty<Allocator>::value,
@@ -320,64 +529,58 @@ namespace ftl {
 
 			case call_move_and_destroy: {
 
-				manager_storage_type& lhs =
-					*static_cast<manager_storage_type*>(first_arg);
+				manager_storage_type<N>& lhs =
+					*static_cast<manager_storage_type<N>*>(first_arg);
 
-				manager_storage_type& rhs =
-					*static_cast<manager_storage_type*>(second_arg);
+				manager_storage_type<N>& rhs =
+					*static_cast<manager_storage_type<N>*>(second_arg);
 
 				specialisation::move_functor(lhs, std::move(rhs));
-				specialisation::destroy_functor(rhs.get_allocator<Allocator>(), rhs);
+				specialisation::destroy_functor(rhs.template get_allocator<Allocator>(), rhs);
 
 				create_manager<T,Allocator>(
-						lhs, std::move(rhs.get_allocator<Allocator>())
+						lhs, std::move(rhs.template get_allocator<Allocator>())
 				);
 
-				rhs.get_allocator<Allocator>().~Allocator();
+				rhs.template get_allocator<Allocator>().~Allocator();
 
 				return nullptr;
 			}
 
 			case call_copy: {
 
-				manager_storage_type& lhs =
-					*static_cast<manager_storage_type*>(first_arg);
+				manager_storage_type<N>& lhs =
+					*static_cast<manager_storage_type<N>*>(first_arg);
 
-				const manager_storage_type& rhs =
-					*static_cast<const manager_storage_type*>(second_arg);
+				const manager_storage_type<N>& rhs =
+					*static_cast<const manager_storage_type<N>*>(second_arg);
 
 				create_manager<T, Allocator>(
-						lhs, Allocator(rhs.get_allocator<Allocator>())
+						lhs, Allocator(rhs.template get_allocator<Allocator>())
 				);
 
-				specialisation::store_functor(
-						lhs, const_cast<const T&>(specialisation::get_functor_ref(rhs))
-				);
+				specialisation::copy_functor(lhs, rhs);
 
 				return nullptr;
 			}
 
 			case call_destroy: {
 
-				manager_storage_type& self =
-					*static_cast<manager_storage_type *>(first_arg);
+				manager_storage_type<N>& self =
+					*static_cast<manager_storage_type<N>*>(first_arg);
 
-				specialisation::destroy_functor(self.get_allocator<Allocator>(), self);
+				specialisation::destroy_functor(self.template get_allocator<Allocator>(), self);
 
-				self.get_allocator<Allocator>().~Allocator();
+				self.template get_allocator<Allocator>().~Allocator();
 
 				return nullptr;
 			}
 
 			case call_copy_functor_only:
 
-				specialisation::store_functor(
-						*static_cast<manager_storage_type *>(first_arg),
-						const_cast<const T&>(
-							specialisation::get_functor_ref(
-								*static_cast<const manager_storage_type*>(second_arg)
-							)
-						)
+				specialisation::copy_functor(
+						*static_cast<manager_storage_type<N>*>(first_arg),
+						*static_cast<const manager_storage_type<N>*>(second_arg)
 				);
 
 				return nullptr;
@@ -387,31 +590,110 @@ namespace ftl {
 			}
 		}
 
+		template<typename T, typename Allocator, size_t N>
+		void* unique_function_manager(
+				void* first_arg,
+				void* second_arg,
+				function_manager_calls call_type);
+
+		template<typename T, typename Allocator, size_t N>
+		static void create_unique_manager(
+				manager_storage_type<N>& storage, Allocator&& allocator)
+		{
+			new (&storage.template get_allocator<Allocator>()) Allocator(std::move(allocator));
+			storage.manager = &unique_function_manager<T, Allocator, N>;
+		}
+
+		/* Manager for move-only targets.
+		 *
+		 * Same dispatch scheme as function_manager, minus the copying calls.
+		 * Keeping them out of the switch means T's copy constructor is never
+		 * instantiated, which is what admits move-only functors in the first
+		 * place.
+		 */
+		template<typename T, typename Allocator, size_t N>
+		void* unique_function_manager(
+				void* first_arg, void* second_arg,
+				function_manager_calls call_type
+		)
+		{
+			using specialisation
+				= function_manager_inplace_specialisation<T,Allocator,N>;
+
+			static_assert(
+				std::is_empty<Allocator>::value,
+				"Allocator must be an empty class, else it cannot fit in storage"
+			);
+
+			switch(call_type) {
+
+			case call_move_and_destroy: {
+
+				manager_storage_type<N>& lhs =
+					*static_cast<manager_storage_type<N>*>(first_arg);
+
+				manager_storage_type<N>& rhs =
+					*static_cast<manager_storage_type<N>*>(second_arg);
+
+				specialisation::move_functor(lhs, std::move(rhs));
+				specialisation::destroy_functor(rhs.template get_allocator<Allocator>(), rhs);
+
+				create_unique_manager<T,Allocator>(
+						lhs, std::move(rhs.template get_allocator<Allocator>())
+				);
+
+				rhs.template get_allocator<Allocator>().~Allocator();
+
+				return nullptr;
+			}
+
+			case call_destroy: {
+
+				manager_storage_type<N>& self =
+					*static_cast<manager_storage_type<N>*>(first_arg);
+
+				specialisation::destroy_functor(self.template get_allocator<Allocator>(), self);
+
+				self.template get_allocator<Allocator>().~Allocator();
+
+				return nullptr;
+			}
+
+			// The copying calls can never be issued; unique_function has no
+			// copy operations
+			default:
+				return nullptr;
+			}
+		}
+
+		// `Self` is the concrete function type deriving from curried; it is
+		// needed to recover the full object when partially applying, without
+		// fixing the inline storage size.
 		template<typename...>
 		struct curried {};
 
-		template<typename R>
-		struct curried<R> {
+		template<typename Self, typename R>
+		struct curried<Self,R> {
 			R operator()() const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P>
-		struct curried<R,P> {
+		template<typename Self, typename R, typename P>
+		struct curried<Self,R,P> {
 			function<R()> operator()(P) const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P1, typename P2, typename...Ps>
-		struct curried<R,P1,P2,Ps...> {
+		template<typename Self, typename R, typename P1, typename P2, typename...Ps>
+		struct curried<Self,R,P1,P2,Ps...> {
         private:
             using applied_type = function<R(P2,Ps...)>;
 
             // Apply one argument.
             applied_type apply_one(P1 p1) const {
-				auto self = *reinterpret_cast<const function<R(P1,P2,Ps...)>*>(this);
+				auto self = *reinterpret_cast<const Self*>(this);
 				return [self,p1] (P2 p2, Ps...ps) {
 					return self.operator()(
 							p1, std::forward<P2>(p2), std::forward<Ps>(ps)...
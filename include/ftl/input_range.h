@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_INPUT_RANGE_H
+#define FTL_INPUT_RANGE_H
+
+#include <memory>
+#include <vector>
+#include "concepts/foldable.h"
+#include "concepts/functor.h"
+#include "concepts/iterator.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup input_range Input Range
+	 *
+	 * Single-pass source with block-buffered Foldable and Functor
+	 * instances.
+	 *
+	 * \code
+	 *   #include <ftl/input_range.h>
+	 * \endcode
+	 *
+	 * The container instances of \ref foldablepg assume multi-pass
+	 * iteration, so folding a socket, a pipe or an `istream` has so far
+	 * meant materialising the whole thing in a container first. An
+	 * ftl::input_range wraps such a source directly: elements are pulled
+	 * in fixed-size blocks into one reused buffer, folded or mapped from
+	 * there, and never retained&mdash;memory use is one block regardless
+	 * of how much the source produces, and the per-read indirection is
+	 * paid once per block instead of once per element.
+	 *
+	 * This module implements the following concepts for input_range:
+	 * - \ref functorpg
+	 * - \ref foldablepg (left folds only; a single-pass source cannot be
+	 *   folded from the right without materialising it)
+	 *
+	 * \par Dependencies
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - \ref foldable
+	 * - \ref functor
+	 * - \ref concepts_iterator
+	 */
+
+	/**
+	 * A single-pass, block-buffered element source.
+	 *
+	 * An input_range produces values of `T` either from a pair of input
+	 * iterators&mdash;`std::istreambuf_iterator`, say&mdash;or from a
+	 * chunk callback: a callable with the signature
+	 * `size_t(T* out, size_t max)` that writes up to `max` elements to
+	 * `out` and returns how many it wrote, with `0` meaning the source is
+	 * exhausted. The callback form lets readers that naturally produce
+	 * whole buffers (`read(2)`, `recv(2)`, decompressors) skip the
+	 * per-element iterator protocol entirely.
+	 *
+	 * The range is single-pass: consuming it&mdash;by `foldl`, `foldMap`,
+	 * `fmap` or `fill`&mdash;advances the underlying source irrevocably.
+	 * Consumption is allowed through const references, mirroring how the
+	 * generic fold machinery passes its operands; constness of an
+	 * input_range guards the handle, not the source behind it. It is
+	 * movable but not copyable.
+	 *
+	 * `T` must be default constructible and assignable, since elements
+	 * are read into a reused block buffer.
+	 *
+	 * \par Examples
+	 *
+	 * Counting lines in a file, one block of characters at a time:
+	 * \code
+	 *   std::ifstream file{"big.log"};
+	 *
+	 *   ftl::input_range<char> chars{
+	 *       std::istreambuf_iterator<char>{file},
+	 *       std::istreambuf_iterator<char>{}
+	 *   };
+	 *
+	 *   auto lines = ftl::foldl(
+	 *       [](size_t n, char c){ return c == '\n' ? n+1 : n; },
+	 *       size_t(0),
+	 *       chars
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup input_range
+	 */
+	template<typename T>
+	class input_range {
+	public:
+		using value_type = T;
+
+		/// Elements pulled from the source per buffer refill.
+		static constexpr size_t default_block_size = 1024;
+
+		input_range() = delete;
+		input_range(const input_range&) = delete;
+		input_range(input_range&&) = default;
+
+		input_range& operator= (const input_range&) = delete;
+		input_range& operator= (input_range&&) = default;
+
+		/**
+		 * Construct from a chunk callback.
+		 *
+		 * `f` is invoked as `f(out, max)` and must return the number of
+		 * elements written, `0` once exhausted. It is never invoked again
+		 * after returning `0`.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_convertible<
+						result_of<F(T*,size_t)>, size_t
+					>::value
+				>
+		>
+		explicit input_range(F f, size_t block = default_block_size)
+		: src(new fn_source<F>(std::move(f))), block(block) {}
+
+		/**
+		 * Construct from a pair of input iterators.
+		 *
+		 * The iterators are consumed as the range is; single-pass
+		 * iterators like `std::istreambuf_iterator` are the intended
+		 * audience, though any input iterator works. Only \ref
+		 * concepts_iterator "Iterator" is required: stream iterators
+		 * predating C++17 do not all model the full InputIterator check.
+		 */
+		template<
+				typename It,
+				typename = Requires<Iterator<It>::value>
+		>
+		input_range(It first, It last, size_t block = default_block_size)
+		: src(new iter_source<It>(std::move(first), std::move(last)))
+		, block(block) {}
+
+		/**
+		 * Pull up to `max` elements from the source into `out`.
+		 *
+		 * Returns the number of elements written; `0` means the source is
+		 * exhausted and every subsequent call returns `0`. This is the
+		 * primitive the concept instances are built on, exposed for
+		 * consumers with their own buffering needs.
+		 */
+		size_t fill(T* out, size_t max) const {
+			if(!live)
+				return 0;
+
+			auto n = src->next(out, max);
+			if(n == 0)
+				live = false;
+
+			return n;
+		}
+
+		/// The block size folds and maps will buffer by.
+		size_t blockSize() const noexcept {
+			return block;
+		}
+
+	private:
+		struct source_base {
+			virtual ~source_base() {}
+
+			virtual size_t next(T* out, size_t max) = 0;
+		};
+
+		template<typename F>
+		struct fn_source : source_base {
+			explicit fn_source(F f) : f(std::move(f)) {}
+
+			size_t next(T* out, size_t max) override {
+				return f(out, max);
+			}
+
+			F f;
+		};
+
+		template<typename It>
+		struct iter_source : source_base {
+			iter_source(It first, It last)
+			: cur(std::move(first)), end(std::move(last)) {}
+
+			size_t next(T* out, size_t max) override {
+				size_t i = 0;
+				while(i < max && cur != end) {
+					out[i++] = *cur;
+					++cur;
+				}
+
+				return i;
+			}
+
+			It cur;
+			It end;
+		};
+
+		/* The source is advanced through const handles (see the class
+		 * documentation); the pointer is mutable for the same reason a
+		 * memo table would be.
+		 */
+		mutable std::unique_ptr<source_base> src;
+		mutable bool live = true;
+		size_t block = default_block_size;
+	};
+
+	template<typename T>
+	constexpr size_t input_range<T>::default_block_size;
+
+	namespace _dtl {
+		/* Shared state of a mapped input_range: C++11 lambdas cannot
+		 * move-capture, so the consumed source lives behind a shared_ptr.
+		 */
+		template<typename T, typename Fn>
+		struct input_map_state {
+			input_map_state(input_range<T> r, Fn fn)
+			: r(std::move(r)), fn(std::move(fn)) {}
+
+			input_range<T> r;
+			Fn fn;
+			std::vector<T> buf;
+		};
+	}
+
+	/**
+	 * Foldable instance for input_range.
+	 *
+	 * Folds consume the range in blocks of `blockSize()` elements: one
+	 * virtual read per block refills the buffer, then a tight loop folds
+	 * it. Only left-associative folds are provided&mdash;`foldr` over a
+	 * single-pass source would have to materialise it first, which is
+	 * exactly what this type exists to avoid. `foldMap` and `fold`
+	 * accumulate via `foldl` as usual.
+	 *
+	 * \ingroup input_range
+	 */
+	template<typename T>
+	struct foldable<input_range<T>>
+	: deriving_foldMap<input_range<T>>, deriving_fold<input_range<T>> {
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const input_range<T>& r) {
+			std::vector<T> buf(r.blockSize());
+
+			for(size_t n; (n = r.fill(buf.data(), buf.size())) > 0;) {
+				for(size_t i = 0; i < n; ++i)
+					z = fn(std::move(z), buf[i]);
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Functor instance for input_range.
+	 *
+	 * Mapping is lazy and streaming: no element is read or transformed
+	 * until the resulting range is itself consumed, at which point each
+	 * block is pulled from the underlying source and transformed in one
+	 * pass. As mapping consumes the source, only rvalue ranges can be
+	 * mapped:
+	 *
+	 * \code
+	 *   auto lengths = toSize % std::move(words);
+	 * \endcode
+	 *
+	 * \ingroup input_range
+	 */
+	template<typename T>
+	struct functor<input_range<T>> {
+		template<typename Fn, typename U = result_of<Fn(T)>>
+		static input_range<U> map(Fn fn, input_range<T>&& r) {
+			auto block = r.blockSize();
+
+			auto state = std::make_shared<_dtl::input_map_state<T,Fn>>(
+				std::move(r), std::move(fn)
+			);
+
+			return input_range<U>{
+				[state](U* out, size_t max) -> size_t {
+					if(state->buf.size() < max)
+						state->buf.resize(max);
+
+					auto n = state->r.fill(state->buf.data(), max);
+					for(size_t i = 0; i < n; ++i)
+						out[i] = state->fn(state->buf[i]);
+
+					return n;
+				},
+				block
+			};
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
@@ -24,9 +24,16 @@
 #define FTL_LAZY_H
 
 #include <memory>
+#include <atomic>
+#include <initializer_list>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 #include "prelude.h"
 #include "concepts/monoid.h"
+#include "concepts/foldable.h"
 #include "either.h"
+#include "profile.h"
 
 namespace ftl {
 	/**
@@ -39,8 +46,10 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<atomic>`
 	 * - \ref prelude
 	 * - \ref monoid
+	 * - \ref foldable
 	 * - \ref either
 	 */
 
@@ -113,9 +122,20 @@ namespace ftl {
 		 * object will be invoked to compute it. Any subsequent calls to methods
 		 * that would normally force evaluation will simply use the now computed
 		 * value.
+		 *
+		 * The shared state is allocated with `std::make_shared`, fusing the
+		 * reference count, the thunk, and the result slot (the latter two
+		 * share storage in the `either`) into a single heap block. Combined
+		 * with ftl::function's small buffer, constructing a `lazy` from a
+		 * small closure thus costs exactly one allocation.
+		 *
+		 * The thunk is stored as an ftl::unique_function, so move-only
+		 * closures&mdash;capturing e.g. a `unique_ptr`&mdash;work directly;
+		 * an ftl::function converts implicitly.
 		 */
-		explicit lazy(const function<T()>& f)
-		: val(new either<function<T()>,T>(make_left<T>(f)))
+		explicit lazy(unique_function<T()> f)
+		: val(std::make_shared<either<unique_function<T()>,T>>(
+				make_left<T>(std::move(f))))
 		{}
 
 		/**
@@ -162,10 +182,11 @@ namespace ftl {
 			if(*val)
 				return;
 
-			*val = make_right<function<T()>>(val->left()());
+			_dtl::profile_count_lazy_force();
+			*val = make_right<unique_function<T()>>(val->left()());
 		}
 
-		mutable std::shared_ptr<either<function<T()>,T>> val;
+		mutable std::shared_ptr<either<unique_function<T()>,T>> val;
 	};
 
 	// Bool specialisation to allow contextual conversion
@@ -177,8 +198,9 @@ namespace ftl {
 		lazy(lazy&&) = default;
 		~lazy() = default;
 
-		explicit lazy(const function<bool()>& f)
-		: val(new either<function<bool()>,bool>(make_left<bool>(f)))
+		explicit lazy(unique_function<bool()> f)
+		: val(std::make_shared<either<unique_function<bool()>,bool>>(
+				make_left<bool>(std::move(f))))
 		{}
 
 		const bool& operator*() const {
@@ -214,10 +236,136 @@ namespace ftl {
 			if(*val)
 				return;
 
-			*val = make_right<function<bool()>>(val->left()());
+			_dtl::profile_count_lazy_force();
+			*val = make_right<unique_function<bool()>>(val->left()());
 		}
 
-		mutable std::shared_ptr<either<function<bool()>,bool>> val;
+		mutable std::shared_ptr<either<unique_function<bool()>,bool>> val;
+	};
+
+	namespace _dtl {
+		template<typename T>
+		struct atomic_lazy_state {
+			explicit atomic_lazy_state(unique_function<T()> f)
+			: state(0), val(make_left<T>(std::move(f))) {}
+
+			// 0 = deferred, 1 = being computed, 2 = ready
+			std::atomic<int> state;
+			either<unique_function<T()>,T> val;
+		};
+	}
+
+	/**
+	 * Concurrency safe version of the lazy data type.
+	 *
+	 * Exactly like ftl::lazy, except that forcing is a synchronised, once-only
+	 * operation: when several threads force copies of the same computation
+	 * concurrently, exactly one of them runs the deferred function while the
+	 * others wait (by spinning, not blocking in the kernel) until the value is
+	 * ready. There is thus no need to guard shared `atomic_lazy` values with
+	 * external locks.
+	 *
+	 * Should the deferred computation exit by exception, the value reverts to
+	 * the deferred state and the exception propagates out of whichever thread
+	 * won the race; a later force will run the computation anew.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref deref to `T` (_forces_ evaluation).
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T>
+	class atomic_lazy {
+	public:
+		atomic_lazy() = delete;
+		atomic_lazy(const atomic_lazy&) = default;
+		atomic_lazy(atomic_lazy&&) = default;
+		~atomic_lazy() = default;
+
+		/**
+		 * Construct from a no-argument function object.
+		 *
+		 * Works exactly as the corresponding constructor of ftl::lazy.
+		 */
+		explicit atomic_lazy(unique_function<T()> f)
+		: s(std::make_shared<_dtl::atomic_lazy_state<T>>(std::move(f)))
+		{}
+
+		/**
+		 * Get a reference to the value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T& operator*() const {
+			force();
+			return *s->val;
+		}
+
+		/**
+		 * Access members of the lazy value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T* operator->() const {
+			force();
+			return &(*s->val);
+		}
+
+		atomic_lazy& operator= (const atomic_lazy&) = default;
+		atomic_lazy& operator= (atomic_lazy&&) = default;
+
+		/**
+		 * Check the state of the deferred computation.
+		 *
+		 * \return value_status::deferred if computation has not yet been run,
+		 *         and value_status::ready if it has.
+		 */
+		value_status status() const {
+			if(s->state.load(std::memory_order_acquire) == 2)
+				return value_status::ready;
+
+			return value_status::deferred;
+		}
+
+	private:
+		void force() const {
+			for(;;) {
+				int expected = 0;
+				if(s->state.compare_exchange_strong(
+						expected, 1, std::memory_order_acq_rel)) {
+					_dtl::profile_count_lazy_force();
+					try {
+						s->val = make_right<unique_function<T()>>(s->val.left()());
+					}
+					catch(...) {
+						s->state.store(0, std::memory_order_release);
+						throw;
+					}
+
+					s->state.store(2, std::memory_order_release);
+					return;
+				}
+
+				// Someone else is, or was, computing. If they succeeded,
+				// we're done; if they exited by exception, the value is
+				// deferred again and we re-enter the race.
+				int observed;
+				do {
+					observed = s->state.load(std::memory_order_acquire);
+				} while(observed == 1);
+
+				if(observed == 2)
+					return;
+			}
+		}
+
+		mutable std::shared_ptr<_dtl::atomic_lazy_state<T>> s;
 	};
 
 	/**
@@ -248,6 +396,161 @@ namespace ftl {
 		}};
 	}
 
+	namespace _dtl {
+		inline void hash_combine(size_t& seed, size_t h) noexcept {
+			seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+
+		template<typename Tuple, size_t I = std::tuple_size<Tuple>::value>
+		struct tuple_hash {
+			static void apply(size_t& seed, const Tuple& t) {
+				tuple_hash<Tuple,I-1>::apply(seed, t);
+
+				using elem = plain_type<
+					typename std::tuple_element<I-1,Tuple>::type
+				>;
+
+				hash_combine(seed, std::hash<elem>{}(std::get<I-1>(t)));
+			}
+		};
+
+		template<typename Tuple>
+		struct tuple_hash<Tuple,0> {
+			static void apply(size_t&, const Tuple&) noexcept {
+			}
+		};
+
+		// Function identity: compared with operator== when the callable has
+		// one (function pointers, comparable functors); otherwise the type
+		// must carry the whole identity, i.e. the callable must be stateless.
+		template<typename F>
+		auto same_identity(const F& a, const F& b, int)
+		-> decltype(bool(a == b)) {
+			return a == b;
+		}
+
+		template<typename F>
+		bool same_identity(const F&, const F&, ...) {
+			static_assert(
+				std::is_empty<F>::value,
+				"Hash-consed functions must be stateless or "
+				"equality comparable"
+			);
+
+			return true;
+		}
+	}
+
+	/**
+	 * Hash-consing cache for deferred computations.
+	 *
+	 * Plain \ref ftl::defer "defer" memoizes by `shared_ptr` identity only:
+	 * two structurally identical calls produce independent thunks that both
+	 * run. A defer_cache keys cells by (function identity, argument
+	 * fingerprint) instead, so equal deferred computations created in
+	 * different places share one lazy cell&mdash;and one evaluation:
+	 *
+	 * \code
+	 *   ftl::defer_cache cache;
+	 *
+	 *   auto l1 = cache.defer(price, instrument, date);
+	 *   auto l2 = cache.defer(price, instrument, date);  // same cell
+	 *
+	 *   *l1;  // evaluates
+	 *   *l2;  // already forced
+	 * \endcode
+	 *
+	 * Function identity is the callable's type, plus `operator==` when it
+	 * has one (function pointers, comparable functors); stateless lambdas
+	 * thus work as-is, while capturing lambdas without `operator==` are
+	 * rejected at compile time. Arguments must be hashable with `std::hash`
+	 * and equality comparable.
+	 *
+	 * The cache holds strong references to its cells, keeping forced
+	 * results alive until clear(); call it at a rebuild boundary (e.g. once
+	 * per tick) when cached results go stale. A defer_cache is not
+	 * synchronised; confine it to one thread or guard it externally.
+	 *
+	 * \ingroup lazy
+	 */
+	class defer_cache {
+	public:
+		defer_cache() = default;
+		defer_cache(const defer_cache&) = delete;
+		defer_cache(defer_cache&&) = default;
+
+		defer_cache& operator= (const defer_cache&) = delete;
+		defer_cache& operator= (defer_cache&&) = default;
+
+		/**
+		 * Equivalent of \ref ftl::defer "defer", sharing equal thunks.
+		 *
+		 * If an equal (same function, equal arguments) deferred computation
+		 * is already cached, its cell is returned; otherwise a new one is
+		 * created and cached. As with `defer`, all arguments are copied.
+		 */
+		template<
+				typename F,
+				typename...Args,
+				typename T = result_of<F(Args...)>
+		>
+		lazy<T> defer(F f, Args&&...args) {
+			using tuple_t = std::tuple<plain_type<Args>...>;
+			using entry_t = entry<F,tuple_t,lazy<T>>;
+
+			tuple_t t{std::forward<Args>(args)...};
+
+			auto h = std::type_index(typeid(F)).hash_code();
+			_dtl::tuple_hash<tuple_t>::apply(h, t);
+
+			auto range = entries.equal_range(h);
+			for(auto it = range.first; it != range.second; ++it) {
+				auto e = dynamic_cast<entry_t*>(it->second.get());
+				if(e && _dtl::same_identity(e->f, f, 0) && e->args == t)
+					return e->cell;
+			}
+
+			lazy<T> cell{[f,t]() {
+				return tuple_apply(f, t);
+			}};
+
+			entries.emplace(
+				h,
+				std::unique_ptr<entry_base>(new entry_t(f, std::move(t), cell))
+			);
+
+			return cell;
+		}
+
+		/// Number of cached cells
+		size_t size() const noexcept {
+			return entries.size();
+		}
+
+		/// Drop every cached cell, releasing this cache's references
+		void clear() {
+			entries.clear();
+		}
+
+	private:
+		struct entry_base {
+			virtual ~entry_base() {
+			}
+		};
+
+		template<typename F, typename Tuple, typename L>
+		struct entry : entry_base {
+			entry(F f, Tuple t, L l)
+			: f(std::move(f)), args(std::move(t)), cell(std::move(l)) {}
+
+			F f;
+			Tuple args;
+			L cell;
+		};
+
+		std::unordered_multimap<size_t,std::unique_ptr<entry_base>> entries;
+	};
+
 	/**
 	 * Equality comparison.
 	 *
@@ -316,6 +619,90 @@ namespace ftl {
 		}};
 	}
 
+	/**
+	 * Short-circuiting conjunction of deferred booleans.
+	 *
+	 * Does not evaluate anything until the returned computation is itself
+	 * evaluated; forcing it forces `l1` and, only if `l1` came out true,
+	 * `l2`. A decisive first operand thus leaves the second untouched.
+	 *
+	 * \ingroup lazy
+	 */
+	inline lazy<bool> lazyAnd(lazy<bool> l1, lazy<bool> l2) {
+		return lazy<bool>{[l1,l2]() {
+			return *l1 && *l2;
+		}};
+	}
+
+	/**
+	 * Short-circuiting disjunction of deferred booleans.
+	 *
+	 * The dual of \ref lazyAnd: forcing the result forces `l1` and, only
+	 * if `l1` came out false, `l2`.
+	 *
+	 * \ingroup lazy
+	 */
+	inline lazy<bool> lazyOr(lazy<bool> l1, lazy<bool> l2) {
+		return lazy<bool>{[l1,l2]() {
+			return *l1 || *l2;
+		}};
+	}
+
+	/**
+	 * Short-circuiting conjunction of a collection of deferred booleans.
+	 *
+	 * Forcing the result forces the elements left to right, stopping at
+	 * the first false one; everything after it stays unevaluated. The
+	 * empty collection yields true.
+	 *
+	 * \tparam C an iterable of `lazy<bool>`. It is copied into the
+	 *         returned computation, but lazy values are cheap, shared
+	 *         handles, so this does not copy any deferred work.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename C>
+	lazy<bool> lazyAll(C c) {
+		return lazy<bool>{[c]() {
+			for(auto& l : c) {
+				if(!*l)
+					return false;
+			}
+
+			return true;
+		}};
+	}
+
+	/// \overload
+	inline lazy<bool> lazyAll(std::initializer_list<lazy<bool>> ls) {
+		return lazyAll(std::vector<lazy<bool>>(ls));
+	}
+
+	/**
+	 * Short-circuiting disjunction of a collection of deferred booleans.
+	 *
+	 * The dual of \ref lazyAll: elements are forced left to right until
+	 * the first true one, and the empty collection yields false.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename C>
+	lazy<bool> lazyAny(C c) {
+		return lazy<bool>{[c]() {
+			for(auto& l : c) {
+				if(*l)
+					return true;
+			}
+
+			return false;
+		}};
+	}
+
+	/// \overload
+	inline lazy<bool> lazyAny(std::initializer_list<lazy<bool>> ls) {
+		return lazyAny(std::vector<lazy<bool>>(ls));
+	}
+
 	/**
 	 * Monad instance for lazy values.
 	 *
@@ -378,6 +765,105 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Monad instance for concurrency safe lazy values.
+	 *
+	 * Works exactly as the ftl::lazy instance, except that the computations
+	 * built with it may be forced concurrently from several threads.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T>
+	struct monad<atomic_lazy<T>>
+	: deriving_join<in_terms_of_bind<atomic_lazy<T>>>
+	, deriving_apply<in_terms_of_bind<atomic_lazy<T>>> {
+		/// Create a computation that computes `t`
+		static atomic_lazy<T> pure(T t) {
+			return atomic_lazy<T>{[t](){ return t; }};
+		}
+
+		/// Map a function to the deferred value.
+		template<typename F, typename U = result_of<F(T)>>
+		static atomic_lazy<U> map(F f, atomic_lazy<T> l) {
+			return atomic_lazy<U>{function<U()>{[f,l]() { return f(*l); }}};
+		}
+
+		/// Sequences two lazy computations.
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static atomic_lazy<U> bind(atomic_lazy<T> l, F f) {
+			return atomic_lazy<U>{[f,l]() {
+				return *(f(*l));
+			}};
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad_rec implementation for lazy.
+	 *
+	 * A loop written with lazy's `bind` builds a thunk chain as long as the
+	 * iteration count, all of it unwound recursively on the final force.
+	 * The trampoline instead defers a single computation that, when forced,
+	 * runs the loop strictly: each step's thunk is forced and discarded
+	 * before the next, so the stack stays flat however many steps there are.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T>
+	struct monad_rec<lazy<T>> {
+
+		template<typename F, typename S, typename R = Value_type<T>>
+		static lazy<R> tailRec(F f, S seed) {
+			return lazy<R>{[f,seed]() -> R {
+				S s = seed;
+				for(;;) {
+					auto l = f(s);
+
+					const auto& step = *l;
+					if(step)
+						return *step;
+
+					s = step.left();
+				}
+			}};
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad_rec implementation for concurrency safe lazy values.
+	 *
+	 * Works exactly as the ftl::lazy instance.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T>
+	struct monad_rec<atomic_lazy<T>> {
+
+		template<typename F, typename S, typename R = Value_type<T>>
+		static atomic_lazy<R> tailRec(F f, S seed) {
+			return atomic_lazy<R>{function<R()>{[f,seed]() -> R {
+				S s = seed;
+				for(;;) {
+					auto l = f(s);
+
+					const auto& step = *l;
+					if(step)
+						return *step;
+
+					s = step.left();
+				}
+			}}};
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	/**
 	 * Monoid instance of lazy computations.
 	 *
@@ -410,6 +896,97 @@ namespace ftl {
 
 		static constexpr bool instance = monoid<T>::instance;
 	};
+
+	namespace _dtl {
+		template<typename T>
+		struct is_lazy_value : std::false_type {};
+
+		template<typename T>
+		struct is_lazy_value<lazy<T>> : std::true_type {};
+
+		template<typename T>
+		struct is_lazy_value<atomic_lazy<T>> : std::true_type {};
+
+		/* Whether deepForce has anything to do for a T: a lazy value, or a
+		 * foldable structure with lazy values at some depth.
+		 */
+		template<typename T, bool = foldable<T>::instance>
+		struct deep_forceable : is_lazy_value<T> {};
+
+		template<typename T>
+		struct deep_forceable<T,true>
+		: std::integral_constant<
+			bool,
+			is_lazy_value<T>::value
+			|| deep_forceable<Value_type<T>>::value
+		> {};
+
+		template<typename T>
+		void deep_force_inner(const T& t, std::true_type);
+
+		template<typename T>
+		void deep_force_inner(const T&, std::false_type) {}
+	}
+
+	/**
+	 * Force a lazy computation, and everything inside its result.
+	 *
+	 * Exactly like dereferencing, except that if the computed value is
+	 * itself deep-forceable&mdash;another lazy, or a foldable structure
+	 * containing lazies&mdash;it is recursively forced too.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T>
+	void deepForce(const lazy<T>& l) {
+		_dtl::deep_force_inner(*l, _dtl::deep_forceable<T>{});
+	}
+
+	/// \overload
+	template<typename T>
+	void deepForce(const atomic_lazy<T>& l) {
+		_dtl::deep_force_inner(*l, _dtl::deep_forceable<T>{});
+	}
+
+	/**
+	 * Force every lazy value embedded in a foldable structure.
+	 *
+	 * Folds over `xs` and forces each element in turn, recursing into
+	 * nested foldables and lazy-of-lazy values, so e.g. pre-forcing a
+	 * `std::vector<ftl::lazy<T>>` at startup is a single call instead of a
+	 * hand-written loop. The memoized results land in the lazies' shared
+	 * states as usual; forcing a copy of the structure thus warms the
+	 * original too.
+	 *
+	 * \tparam F must be a \ref foldablepg with lazy values at some level
+	 *           of nesting.
+	 *
+	 * \ingroup lazy
+	 */
+	template<
+			typename F,
+			typename = Requires<
+				foldable<F>::instance
+				&& !_dtl::is_lazy_value<F>::value
+				&& _dtl::deep_forceable<F>::value
+			>
+	>
+	void deepForce(const F& xs) {
+		foldable<F>::foldl(
+			[](int z, const Value_type<F>& x) {
+				deepForce(x);
+				return z;
+			},
+			0, xs
+		);
+	}
+
+	namespace _dtl {
+		template<typename T>
+		void deep_force_inner(const T& t, std::true_type) {
+			deepForce(t);
+		}
+	}
 }
 
 #endif
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_LAZY_TABLE_H
+#define FTL_LAZY_TABLE_H
+
+#include <stdexcept>
+#include <unordered_map>
+#include "arena.h"
+#include "lazy.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup lazyTable Lazy Table
+	 *
+	 * A region backed memoisation table for recursive lazy definitions.
+	 *
+	 * \code
+	 *   #include <ftl/lazy_table.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<stdexcept>`
+	 * - `<unordered_map>`
+	 * - \ref arena
+	 * - \ref lazy
+	 */
+
+	/**
+	 * A memoisation table with lazy, per-key evaluation.
+	 *
+	 * Tying a recursive definition together with individual `ftl::lazy`
+	 * cells gives every subproblem its own `shared_ptr` control block; a
+	 * memoised recursion over a million keys makes a million scattered
+	 * allocations. A lazy_table stores the whole recursion in one place
+	 * instead: a single recursion function, an arena every value slot and
+	 * index node is bump-allocated from, and per-key forcing semantics that
+	 * mirror `lazy`&mdash;a key is computed at most once, on first access.
+	 *
+	 * \code
+	 *   ftl::lazy_table<int,long long> fib{
+	 *       [](ftl::lazy_table<int,long long>& self, const int& n)
+	 *       -> long long {
+	 *           return n < 2 ? n : self[n-1] + self[n-2];
+	 *       }
+	 *   };
+	 *
+	 *   auto x = fib[90];   // 89 memoised subproblems, one region
+	 * \endcode
+	 *
+	 * Forcing a key whose computation is already on the stack&mdash;a cyclic
+	 * definition&mdash;raises `std::logic_error` rather than recursing
+	 * forever. Should the recursion function exit by exception, the key
+	 * reverts to deferred, exactly as a `lazy` would.
+	 *
+	 * \par Concepts
+	 * \li Not CopyConstructible, not MoveConstructible
+	 *
+	 * \ingroup lazyTable
+	 */
+	template<typename K, typename T, typename Hash = std::hash<K>>
+	class lazy_table {
+		struct slot;
+
+	public:
+		/// The shape of the tied recursion: compute one key, given the table.
+		using recursion_type = function<T(lazy_table&, const K&)>;
+
+		lazy_table() = delete;
+		lazy_table(const lazy_table&) = delete;
+		lazy_table(lazy_table&&) = delete;
+
+		/**
+		 * Construct a table from its recursion function.
+		 *
+		 * \param recurse computes the value of one key; recursive access to
+		 *                other keys goes through the passed table, so
+		 *                subproblems are memoised.
+		 * \param initial_capacity initial size of the backing region, in
+		 *                bytes.
+		 */
+		explicit lazy_table(
+				recursion_type recurse, size_t initial_capacity = 4096)
+		: store(initial_capacity)
+		, index(
+			8, Hash{}, std::equal_to<K>{},
+			arena_allocator<std::pair<const K,slot*>>{store}
+		)
+		, recurse(std::move(recurse)) {}
+
+		~lazy_table() {
+			for(auto& kv : index) {
+				if(kv.second->state == slot_ready)
+					kv.second->value_ptr()->~T();
+			}
+		}
+
+		lazy_table& operator= (const lazy_table&) = delete;
+		lazy_table& operator= (lazy_table&&) = delete;
+
+		/**
+		 * Force and access the value of a key.
+		 *
+		 * The first access runs the recursion function; every later access
+		 * is a single hash lookup.
+		 */
+		const T& operator[] (const K& k) {
+			auto it = index.find(k);
+			if(it != index.end()) {
+				if(it->second->state == slot_ready)
+					return *it->second->value_ptr();
+
+				throw std::logic_error(
+					"cyclic recursion in ftl::lazy_table"
+				);
+			}
+
+			auto s = static_cast<slot*>(
+				store.allocate(sizeof(slot), alignof(slot))
+			);
+			s->state = slot_computing;
+			index.emplace(k, s);
+
+			try {
+				new (s->value_ptr()) T(recurse(*this, k));
+			}
+			catch(...) {
+				// Revert to deferred; the slot's storage is recycled only
+				// with the region as a whole
+				index.erase(k);
+				throw;
+			}
+
+			s->state = slot_ready;
+			return *s->value_ptr();
+		}
+
+		/**
+		 * Check the state of one key's deferred computation.
+		 *
+		 * \return value_status::deferred if the key has not been forced,
+		 *         and value_status::ready if it has.
+		 */
+		value_status status(const K& k) const {
+			auto it = index.find(k);
+			return it != index.end() && it->second->state == slot_ready
+				? value_status::ready
+				: value_status::deferred;
+		}
+
+		/// Number of memoised keys
+		size_t size() const noexcept {
+			return index.size();
+		}
+
+		/// Total bytes of region storage the table occupies
+		size_t memory_used() const noexcept {
+			return store.used();
+		}
+
+	private:
+		enum : unsigned char { slot_computing, slot_ready };
+
+		struct slot {
+			typename std::aligned_storage<sizeof(T),alignof(T)>::type val;
+			unsigned char state;
+
+			T* value_ptr() {
+				return reinterpret_cast<T*>(&val);
+			}
+		};
+
+		// Declaration order matters: index and every slot draw from store
+		arena store;
+		std::unordered_map<
+			K, slot*, Hash, std::equal_to<K>,
+			arena_allocator<std::pair<const K,slot*>>
+		> index;
+		recursion_type recurse;
+	};
+
+}
+
+#endif
+
@@ -36,6 +36,12 @@ namespace ftl {
 	 *   #include <ftl/lazy_trans.h>
 	 * \endcode
 	 *
+	 * \note When transforming `ftl::function`, long bind chains can avoid
+	 *       per-combinator type erasure the same way
+	 *       \ref ftl::fused_eitherT "fused eitherT chains" do: compose
+	 *       closures returning `lazy<T>` statically and erase only the
+	 *       finished chain.
+	 *
 	 * \par Dependencies
 	 * - \ref prelude
 	 * - \ref lazy
@@ -268,6 +274,155 @@ namespace ftl {
 
 		// TODO: automatic hoisting too
 	};
+
+	template<typename M, typename T, typename F>
+	class fused_lazyT;
+
+	namespace _dtl {
+		/* Composed closure of two fused map steps. Its concrete type carries
+		 * both callables, so composing never erases and the compiler can
+		 * inline the whole transform chain into one thunk body.
+		 */
+		template<typename F2, typename F1>
+		struct fused_lazy_map {
+			F1 f1;
+			F2 f2;
+
+			template<typename A>
+			auto operator() (const A& a) const
+			-> decltype(f2(f1(a))) {
+				return f2(f1(a));
+			}
+		};
+	}
+
+	/**
+	 * A lazyT with its pending maps statically composed.
+	 *
+	 * Every `functor::map` on a lazyT wraps each deferred value in a fresh
+	 * thunk&mdash;one `ftl::function` and one indirect call per map, paid
+	 * again every time the chain is forced. A fused chain instead keeps the
+	 * deferred values untouched and accumulates the mapped functions in a
+	 * concrete composed closure; maps on it (via the usual `%` operator)
+	 * nest plain structs the compiler can inline. The composition collapses
+	 * into a _single_ combined thunk per deferred value when the chain is
+	 * \ref fused_lazyT::unfuse "unfused"&mdash;or implicitly at bind time,
+	 * as `>>=` unfuses before sequencing.
+	 *
+	 * \code
+	 *   ftl::lazyT<ftl::maybe<int>> l = ...;
+	 *
+	 *   auto r = (
+	 *       scale % (offset % ftl::fuse(l))
+	 *   ).unfuse();
+	 *
+	 *   // forcing r runs scale and offset in one thunk, not two
+	 * \endcode
+	 *
+	 * \tparam M The untransformed base monad, applied to the _source_
+	 *           element type (before any fused transforms).
+	 * \tparam T The element type after the fused transforms.
+	 * \tparam F The concrete callable type of the composed transform chain.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M, typename T, typename F>
+	class fused_lazyT {
+	public:
+		/// Source element type, before any fused transforms.
+		using T0 = Value_type<M>;
+
+		/// The underlying type of the source lazyT.
+		using Mlt = Rebind<M,lazy<T0>>;
+
+		fused_lazyT(Mlt src, F f)
+		noexcept(
+			std::is_nothrow_move_constructible<Mlt>::value
+			&& std::is_nothrow_move_constructible<F>::value
+		)
+		: src(std::move(src)), f(std::move(f)) {}
+
+		/**
+		 * Collapse back into an ordinary lazyT.
+		 *
+		 * Each deferred value of the result is wrapped in exactly one new
+		 * thunk, running the whole composed transform chain&mdash;however
+		 * many maps were fused&mdash;in a single call.
+		 */
+		lazyT<Rebind<M,T>> unfuse() const {
+			auto g = f;
+
+			return lazyT<Rebind<M,T>>{
+				[g](const lazy<T0>& l) {
+					return lazy<T>{function<T()>{[g,l]() -> T {
+						return g(*l);
+					}}};
+				} % src
+			};
+		}
+
+	private:
+		template<typename Fn, typename M2, typename T2, typename F2, typename U>
+		friend fused_lazyT<M2,U,_dtl::fused_lazy_map<Fn,F2>>
+		operator% (Fn, fused_lazyT<M2,T2,F2>);
+
+		Mlt src;
+		F f;
+	};
+
+	/**
+	 * Start a fused chain from an ordinary lazyT.
+	 *
+	 * Thunks already wrapped around the deferred values remain; fusion
+	 * guarantees that no _further_ thunk layers are added by subsequent
+	 * maps.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	fused_lazyT<M,Value_type<M>,identity> fuse(const lazyT<M>& l) {
+		return fused_lazyT<M,Value_type<M>,identity>{*l, identity{}};
+	}
+
+	/**
+	 * Fused equivalent of `functor::map`.
+	 *
+	 * The composition itself neither forces anything nor allocates a thunk;
+	 * `fn` simply joins the composed transform chain.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<
+			typename Fn, typename M, typename T, typename F,
+			typename U = result_of<Fn(T)>
+	>
+	fused_lazyT<M,U,_dtl::fused_lazy_map<Fn,F>>
+	operator% (Fn fn, fused_lazyT<M,T,F> l) {
+		using closure = _dtl::fused_lazy_map<Fn,F>;
+
+		return fused_lazyT<M,U,closure>{
+			std::move(l.src), closure{std::move(l.f), std::move(fn)}
+		};
+	}
+
+	/**
+	 * Sequence a fused chain with a monadic continuation.
+	 *
+	 * This is where pending maps collapse: the chain is unfused&mdash;one
+	 * combined thunk per deferred value&mdash;and then bound exactly as an
+	 * ordinary lazyT, including the monad instance's automatic lifting of
+	 * continuations returning the untransformed type.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<
+			typename Fn, typename M, typename T, typename F,
+			typename = result_of<Fn(T)>
+	>
+	auto operator>>= (fused_lazyT<M,T,F> l, Fn fn)
+	-> decltype(l.unfuse() >>= std::move(fn)) {
+		return l.unfuse() >>= std::move(fn);
+	}
 }
 
 #endif
@@ -78,8 +78,10 @@ namespace ftl {
 		template<typename F, typename U = result_of<F(T)>>
 		static Map<U> map(F&& f, const Map<T>& m) {
 			Map<U> rm;
+			// The source is traversed in sorted order and keys are unchanged,
+			// so hinting at end() makes every insertion amortized O(1)
 			for(const auto& kv : m) {
-				rm.insert(std::make_pair(kv.first, f(kv.second)));
+				rm.insert(rm.end(), std::make_pair(kv.first, f(kv.second)));
 			}
 
 			return rm;
@@ -98,7 +100,9 @@ namespace ftl {
 		static Map<U> map(F&& f, Map<T>&& m) {
 			Map<U> rm;
 			for(auto& kv : m) {
-				rm.emplace(std::move(kv.first), f(std::move(kv.second)));
+				rm.emplace_hint(
+					rm.end(), std::move(kv.first), f(std::move(kv.second))
+				);
 			}
 
 			return rm;
@@ -117,10 +121,10 @@ namespace ftl {
 		>
 		static Map<T> map(F&& f, Map<T>&& m) {
 			for(auto& kv : m) {
-				m[kv.first] = f(std::move(kv.second));
+				kv.second = f(std::move(kv.second));
 			}
 
-			return m;
+			return std::move(m);
 		}
 
 		static constexpr bool instance = true;
@@ -143,8 +147,21 @@ namespace ftl {
 				>
 		>
 		static U foldl(F&& f, U z, const std::map<K,T,C,A>& m) {
-			for(auto& kv : m) {
-				z = f(z, kv.second);
+			// Prefetch a few nodes ahead; tree traversal is otherwise
+			// one cache miss per node
+			auto pf = m.begin();
+			for(size_t i = 0; i < _dtl::fold_prefetch_distance
+					&& pf != m.end(); ++i) {
+				++pf;
+			}
+
+			for(auto it = m.begin(); it != m.end(); ++it) {
+				if(pf != m.end()) {
+					_dtl::prefetch(std::addressof(*pf));
+					++pf;
+				}
+
+				z = f(z, it->second);
 			}
 
 			return z;
@@ -158,7 +175,18 @@ namespace ftl {
 				>
 		>
 		static U foldr(F&& f, U z, const std::map<K,T,C,A>& m) {
+			auto pf = m.rbegin();
+			for(size_t i = 0; i < _dtl::fold_prefetch_distance
+					&& pf != m.rend(); ++i) {
+				++pf;
+			}
+
 			for(auto it = m.rbegin(); it != m.rend(); ++it) {
+				if(pf != m.rend()) {
+					_dtl::prefetch(std::addressof(*pf));
+					++pf;
+				}
+
 				z = f(it->second, z);
 			}
 
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MAPPED_RANGE_H
+#define FTL_MAPPED_RANGE_H
+
+#include <cerrno>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ftl {
+
+	/**
+	 * \defgroup mapped_range Mapped Range
+	 *
+	 * Memory-mapped file view with Foldable and Zippable instances.
+	 *
+	 * \code
+	 *   #include <ftl/mapped_range.h>
+	 * \endcode
+	 *
+	 * This module is POSIX only: it is implemented on top of `mmap(2)`.
+	 *
+	 * \par Dependencies
+	 * - `<cerrno>`
+	 * - `<iterator>`
+	 * - `<string>`
+	 * - `<system_error>`
+	 * - `<vector>`
+	 * - \ref foldable
+	 * - \ref zippable
+	 */
+
+	/**
+	 * A read-only view of a file, interpreted as a contiguous array of `T`.
+	 *
+	 * The file is memory-mapped rather than read: folding over a
+	 * `mapped_range` streams directly over page-cache-backed data, so no
+	 * intermediate container is materialized and memory use stays bounded
+	 * by the page cache regardless of file size. The mapping is advised as
+	 * sequentially accessed, matching the access pattern of folds.
+	 *
+	 * `T` must be trivially copyable&mdash;elements are reinterpreted
+	 * straight out of the raw bytes of the file, exactly as a trivially
+	 * copyable value is written by, say, `fwrite`. The file size must be a
+	 * multiple of `sizeof(T)`.
+	 *
+	 * `mapped_range` is movable but not copyable; it owns the mapping.
+	 *
+	 * \par Concepts
+	 * - \ref fwditerable (const iteration only)
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::mapped_range<double> ticks{"2013-06-21.bin"};
+	 *
+	 *   auto total = ftl::foldMap(
+	 *       [](double x){ return ftl::sum(x); }, ticks
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup mapped_range
+	 */
+	template<typename T>
+	class mapped_range {
+		static_assert(
+			std::is_trivially_copyable<T>::value,
+			"mapped_range elements must be trivially copyable"
+		);
+
+	public:
+		using value_type = T;
+		using const_iterator = const T*;
+		using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+		/// The empty range; maps nothing.
+		mapped_range() noexcept {}
+
+		mapped_range(const mapped_range&) = delete;
+		mapped_range& operator= (const mapped_range&) = delete;
+
+		mapped_range(mapped_range&& r) noexcept
+		: base(r.base), bytes(r.bytes), n(r.n) {
+			r.base = nullptr;
+			r.bytes = 0;
+			r.n = 0;
+		}
+
+		mapped_range& operator= (mapped_range&& r) noexcept {
+			if(std::addressof(r) == this)
+				return *this;
+
+			unmap();
+
+			base = r.base;
+			bytes = r.bytes;
+			n = r.n;
+			r.base = nullptr;
+			r.bytes = 0;
+			r.n = 0;
+
+			return *this;
+		}
+
+		/**
+		 * Map the file at `path`.
+		 *
+		 * \throws std::system_error if the file cannot be opened, inspected,
+		 *         or mapped.
+		 * \throws std::invalid_argument if the file size is not a multiple
+		 *         of `sizeof(T)`.
+		 */
+		explicit mapped_range(const std::string& path) {
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if(fd < 0) {
+				throw std::system_error(
+					errno, std::generic_category(),
+					std::string("mapped_range: cannot open ") + path
+				);
+			}
+
+			struct stat st;
+			if(::fstat(fd, &st) < 0) {
+				int e = errno;
+				::close(fd);
+				throw std::system_error(
+					e, std::generic_category(),
+					std::string("mapped_range: cannot stat ") + path
+				);
+			}
+
+			if(st.st_size == 0) {
+				::close(fd);
+				return;
+			}
+
+			if(static_cast<size_t>(st.st_size) % sizeof(T) != 0) {
+				::close(fd);
+				throw std::invalid_argument(
+					std::string("mapped_range: size of ") + path
+					+ " is not a multiple of the element size"
+				);
+			}
+
+			void* p = ::mmap(
+				nullptr, static_cast<size_t>(st.st_size),
+				PROT_READ, MAP_PRIVATE, fd, 0
+			);
+
+			// The mapping holds its own reference to the file
+			::close(fd);
+
+			if(p == MAP_FAILED) {
+				throw std::system_error(
+					errno, std::generic_category(),
+					std::string("mapped_range: cannot map ") + path
+				);
+			}
+
+			::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+			base = p;
+			bytes = static_cast<size_t>(st.st_size);
+			n = bytes / sizeof(T);
+		}
+
+		~mapped_range() {
+			unmap();
+		}
+
+		size_t size() const noexcept {
+			return n;
+		}
+
+		bool empty() const noexcept {
+			return n == 0;
+		}
+
+		const T* data() const noexcept {
+			return static_cast<const T*>(base);
+		}
+
+		const T& operator[] (size_t i) const {
+			return data()[i];
+		}
+
+		const_iterator begin() const noexcept {
+			return data();
+		}
+
+		const_iterator end() const noexcept {
+			return data() + n;
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+	private:
+		void unmap() noexcept {
+			if(base)
+				::munmap(base, bytes);
+		}
+
+		void* base = nullptr;
+		size_t bytes = 0;
+		size_t n = 0;
+	};
+
+	/**
+	 * Foldable instance for mapped_range.
+	 *
+	 * All folds stream straight over the mapping, in file order (reverse
+	 * file order for `foldr`); nothing is ever copied into an intermediate
+	 * container.
+	 *
+	 * \ingroup mapped_range
+	 */
+	template<typename T>
+	struct foldable<mapped_range<T>>
+	: deriving_foldable<bidirectional_iterable<mapped_range<T>>> {};
+
+	/**
+	 * Zippable instance for mapped_range.
+	 *
+	 * Since a mapped_range is a read-only view of a file, the result of a
+	 * zip cannot be another mapped_range; it materializes as a
+	 * `std::vector` instead. The mapped operand itself is still streamed,
+	 * not copied. As with the container instances, the second operand may
+	 * be any \ref fwditerable.
+	 *
+	 * \ingroup mapped_range
+	 */
+	template<typename T>
+	struct zippable<mapped_range<T>> {
+		template<
+				typename F, typename Iterable,
+				typename U = result_of<F(T,Value_type<Iterable>)>,
+				typename = Requires<
+					ForwardIterable<Iterable>()
+				>
+		>
+		static std::vector<U> zipWith(
+				F f, const mapped_range<T>& z, const Iterable& i
+		) {
+			auto it1 = z.begin();
+			auto it2 = i.begin();
+
+			std::vector<U> result;
+
+			while(it1 != z.end() && it2 != i.end()) {
+				result.push_back(f(*it1, *it2));
+				++it1; ++it2;
+			}
+
+			return result;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
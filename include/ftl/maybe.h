@@ -25,6 +25,7 @@
 
 #include <stdexcept>
 #include <type_traits>
+#include <memory>
 #include "prelude.h"
 #include "concepts/monoid.h"
 #include "concepts/monad.h"
@@ -102,6 +103,278 @@ namespace ftl {
 	template<typename T>
 	class maybe;
 
+	/**
+	 * Trait identifying an invalid, "niche" representation of `T`.
+	 *
+	 * When a type has a representation that can never occur as a legitimate
+	 * value&mdash;a null pointer, an empty smart pointer&mdash;`maybe<T>` can
+	 * encode `nothing` in the payload itself instead of keeping a separate
+	 * discriminant, making e.g. `maybe<T*>` exactly pointer sized.
+	 *
+	 * Specialisations must provide:
+	 * \code
+	 *   static constexpr bool value;     // true to enable the optimization
+	 *   static T empty();                // the invalid representation
+	 *   static bool is_empty(const T&);  // does t hold the invalid repr?
+	 * \endcode
+	 *
+	 * FTL provides specialisations for raw pointers, `std::unique_ptr`, and
+	 * `std::shared_ptr`.
+	 *
+	 * \note For niche types, a _value_ equal to the empty representation is
+	 *       indistinguishable from `nothing`; e.g.,
+	 *       `maybe<int*>{nullptr-valued ptr}` _is_ `nothing`. This matches
+	 *       maybe's existing treatment of `nullptr`.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T>
+	struct maybe_niche {
+		static constexpr bool value = false;
+	};
+
+	template<typename T>
+	struct maybe_niche<T*> {
+		static constexpr bool value = true;
+
+		static constexpr T* empty() noexcept {
+			return nullptr;
+		}
+
+		static constexpr bool is_empty(T* const& p) noexcept {
+			return p == nullptr;
+		}
+	};
+
+	template<typename T, typename D>
+	struct maybe_niche<std::unique_ptr<T,D>> {
+		static constexpr bool value = true;
+
+		static std::unique_ptr<T,D> empty() noexcept {
+			return std::unique_ptr<T,D>{};
+		}
+
+		static bool is_empty(const std::unique_ptr<T,D>& p) noexcept {
+			return p == nullptr;
+		}
+	};
+
+	template<typename T>
+	struct maybe_niche<std::shared_ptr<T>> {
+		static constexpr bool value = true;
+
+		static std::shared_ptr<T> empty() noexcept {
+			return std::shared_ptr<T>{};
+		}
+
+		static bool is_empty(const std::shared_ptr<T>& p) noexcept {
+			return p == nullptr;
+		}
+	};
+
+	/**
+	 * Trait enabling speculative, branch-free map and fold paths.
+	 *
+	 * When `T` is trivially copyable, cheap to default construct, and not
+	 * a niche type, `maybe<T>`'s functor and foldable instances apply the
+	 * given function unconditionally&mdash;to a value initialised dummy
+	 * when the maybe is nothing&mdash;and select the result with the
+	 * validity flag instead of branching on it. For payloads like `int`
+	 * or small structs, this turns `fmap` and folds over unpredictable
+	 * maybes into straight line code.
+	 *
+	 * The dummy result is always discarded, so the usual semantics are
+	 * preserved&mdash;but the function _is_ invoked. Functions mapped or
+	 * folded over such maybes must therefore tolerate a value initialised
+	 * `T{}`: no side effects that must not happen for `nothing`, and no
+	 * preconditions that `T{}` violates (a nonzero divisor, say).
+	 * Specialise this trait to `false` for payload types where that
+	 * contract cannot be met.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T>
+	struct maybe_speculation {
+		static constexpr bool value =
+			std::is_trivially_copyable<T>::value
+			&& std::is_default_constructible<T>::value
+			&& !maybe_niche<T>::value;
+	};
+
+	namespace _dtl {
+
+		/* Tag type for the select constructor of the trivially copyable
+		 * storage below.
+		 */
+		struct select_tag {};
+
+		/* Storage policy of maybe<T>: the general case keeps raw storage
+		 * plus a discriminant. Copying, moving and destruction of the
+		 * contained value live here, so that maybe itself can default its
+		 * special members and stay a literal type whenever the storage is.
+		 */
+		template<
+				typename T,
+				bool = maybe_niche<T>::value,
+				bool = std::is_trivially_copyable<T>::value
+		>
+		struct maybe_storage {
+			constexpr maybe_storage() noexcept {}
+
+			maybe_storage(const maybe_storage& s)
+			noexcept(std::is_nothrow_copy_constructible<T>::value) {
+				if(s.valid)
+					construct(s.ref());
+			}
+
+			maybe_storage(maybe_storage&& s)
+			noexcept(std::is_nothrow_move_constructible<T>::value) {
+				if(s.valid)
+					construct(std::move(s.ref()));
+			}
+
+			template<typename...Args>
+			explicit maybe_storage(inplace_tag, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value) {
+				construct(std::forward<Args>(args)...);
+			}
+
+			~maybe_storage() {
+				destroy();
+			}
+
+			bool is_valid() const noexcept {
+				return valid;
+			}
+
+			T& ref() noexcept {
+				return reinterpret_cast<T&>(val);
+			}
+
+			const T& ref() const noexcept {
+				return reinterpret_cast<const T&>(val);
+			}
+
+			template<typename...Args>
+			void construct(Args&&...args) {
+				new (&val) T(std::forward<Args>(args)...);
+				valid = true;
+			}
+
+			void destroy() noexcept {
+				if(valid) {
+					ref().~T();
+					valid = false;
+				}
+			}
+
+			typename std::aligned_storage<
+				sizeof(T),
+				std::alignment_of<T>::value>::type val;
+
+			bool valid = false;
+		};
+
+		/* Trivially copyable payloads get a union based representation
+		 * instead of raw storage: construction can then be constexpr and
+		 * all special members are trivial, making maybe<T> a literal type.
+		 * Values of it are usable in constant expressions and static tables
+		 * of them go in .rodata, with no construction at startup.
+		 */
+		template<typename T>
+		struct maybe_storage<T,false,true> {
+			constexpr maybe_storage() noexcept : dummy(), valid(false) {}
+
+			maybe_storage(const maybe_storage&) = default;
+			maybe_storage(maybe_storage&&) = default;
+
+			template<typename...Args>
+			explicit constexpr maybe_storage(inplace_tag, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value)
+			: val(std::forward<Args>(args)...), valid(true) {}
+
+			/* Select construction: the payload is written and the
+			 * discriminant set independently, leaving no control flow for
+			 * the compiler to turn into a branch. Only the speculative
+			 * map/fold helpers use this, and they never read a payload
+			 * stored with b == false.
+			 */
+			constexpr maybe_storage(select_tag, const T& v, bool b) noexcept
+			: val(v), valid(b) {}
+
+			constexpr bool is_valid() const noexcept {
+				return valid;
+			}
+
+			T& ref() noexcept {
+				return val;
+			}
+
+			constexpr const T& ref() const noexcept {
+				return val;
+			}
+
+			template<typename...Args>
+			void construct(Args&&...args) {
+				val = T(std::forward<Args>(args)...);
+				valid = true;
+			}
+
+			void destroy() noexcept {
+				valid = false;
+			}
+
+			union {
+				char dummy;
+				T val;
+			};
+
+			bool valid;
+		};
+
+		/* Niche storage: a live T is kept at all times and the empty
+		 * representation doubles as the discriminant, so maybe<T> is
+		 * exactly sizeof(T).
+		 */
+		template<typename T, bool Trivial>
+		struct maybe_storage<T,true,Trivial> {
+			maybe_storage() noexcept(
+					std::is_nothrow_move_constructible<T>::value)
+			: val(maybe_niche<T>::empty()) {}
+
+			maybe_storage(const maybe_storage&) = default;
+			maybe_storage(maybe_storage&&) = default;
+
+			template<typename...Args>
+			explicit constexpr maybe_storage(inplace_tag, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value)
+			: val(std::forward<Args>(args)...) {}
+
+			bool is_valid() const noexcept {
+				return !maybe_niche<T>::is_empty(val);
+			}
+
+			T& ref() noexcept {
+				return val;
+			}
+
+			const T& ref() const noexcept {
+				return val;
+			}
+
+			template<typename...Args>
+			void construct(Args&&...args) {
+				val = T(std::forward<Args>(args)...);
+			}
+
+			void destroy() noexcept {
+				val = maybe_niche<T>::empty();
+			}
+
+			T val;
+		};
+	}
+
 	namespace _dtl {
 
 		template<typename T>
@@ -200,6 +473,12 @@ namespace ftl {
 			   	= default;
 			const_maybe_iterator& operator= (const_maybe_iterator&&) = default;
 		};
+
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map_select(F&& f, const maybe<T>& m);
+
+		template<typename Fn, typename U, typename T>
+		U maybe_fold_select(Fn&& fn, U z, const maybe<T>& m);
 	}
 
 	/**
@@ -211,7 +490,12 @@ namespace ftl {
 	 *           and method pointer).
 	 *
 	 * In essence, an instance of maybe is either a value, or nothing.
-	 * 
+	 *
+	 * When `T` is trivially copyable, maybe is additionally a literal type:
+	 * construction, dereferencing, and comparison are all usable in constant
+	 * expressions, so tables of optional values can be built at compile time
+	 * and placed in read-only storage.
+	 *
 	 * \par Concepts
 	 * Maybe is an instance of the following concepts:
 	 * - \ref fullycons
@@ -251,38 +535,22 @@ namespace ftl {
 		constexpr maybe() noexcept {}
 
 		/// Copy c-tor
-		maybe(const maybe& m)
-		noexcept(std::is_nothrow_copy_constructible<T>::value)
-	    : isValid(m.isValid) {
-			if(isValid) {
-				new (&val) value_type(reinterpret_cast<const T&>(m.val));
-			}
-		}
+		maybe(const maybe&) = default;
 
 		/// Move c-tor
-		maybe(maybe&& m)
-		noexcept(std::is_nothrow_move_constructible<T>::value)
-		: isValid(m.isValid) {
-			if(isValid) {
-				new (&val) value_type(std::move(reinterpret_cast<T&>(m.val)));
-			}
-		}
+		maybe(maybe&&) = default;
 
 		/**
 		 * Construct a value by copy.
 		 */
-		explicit maybe(const value_type& v)
+		explicit constexpr maybe(const value_type& v)
 		noexcept(std::is_nothrow_copy_constructible<T>::value)
-		: isValid(true) {
-			 new (&val) value_type(v);
-		}
+		: store(inplace_tag(), v) {}
 
 		/// Construct a value by move.
-		explicit maybe(value_type&& v)
+		explicit constexpr maybe(value_type&& v)
 		noexcept(std::is_nothrow_move_constructible<T>::value)
-		: isValid(true) {
-			new (&val) value_type(std::move(v));
-		}
+		: store(inplace_tag(), std::move(v)) {}
 
 		/// Nothings should cast implicitly to maybes
 		constexpr maybe(nothing_t) noexcept {}
@@ -297,28 +565,22 @@ namespace ftl {
 		 * to `T`'s constructor.
 		 */
 		template<typename...Ts>
-		maybe(inplace_tag, Ts&&...ts)
+		constexpr maybe(inplace_tag t, Ts&&...ts)
 		noexcept(std::is_nothrow_constructible<T,Ts...>::value)
-		: isValid(true) {
-			new (&val) value_type(std::forward<Ts>(ts)...);
-		}
-
-		~maybe() {
-			self_destruct();
-		}
+		: store(t, std::forward<Ts>(ts)...) {}
 
 		/**
 		 * Check if the maybe is nothing.
 		 */
 		constexpr bool isNothing() const noexcept {
-			return !isValid;
+			return !store.is_valid();
 		}
 
 		/**
 		 * Check if the maybe is a value.
 		 */
 		constexpr bool isValue() const noexcept {
-			return isValid;
+			return store.is_valid();
 		}
 
 		/// Copy assignment
@@ -328,12 +590,11 @@ namespace ftl {
 			if(this == &m)
 				return *this;
 
-			if(isValid && m.isValid) {
-				reinterpret_cast<T&>(val) = reinterpret_cast<const T&>(m.val);
+			if(store.is_valid() && m.store.is_valid()) {
+				store.ref() = m.store.ref();
 			}
-			else if (m.isValid) {
-				new (&val) T(reinterpret_cast<const T&>(m.val));
-				isValid = true;
+			else if (m.store.is_valid()) {
+				store.construct(m.store.ref());
 			}
 			else
 				self_destruct();
@@ -348,13 +609,11 @@ namespace ftl {
 			if(this == &m)
 				return *this;
 
-			if(isValid && m.isValid) {
-				reinterpret_cast<T&>(val)
-					= std::move(reinterpret_cast<T&>(m.val));
+			if(store.is_valid() && m.store.is_valid()) {
+				store.ref() = std::move(m.store.ref());
 			}
-			else if (m.isValid) {
-				new (&val) T(std::move(reinterpret_cast<T&>(m.val)));
-				isValid = true;
+			else if (m.store.is_valid()) {
+				store.construct(std::move(m.store.ref()));
 			}
 			else
 				self_destruct();
@@ -367,12 +626,11 @@ namespace ftl {
 		 */
 		maybe& operator= (const T& v)
 		noexcept(std::is_nothrow_copy_assignable<T>::value) {
-			if(isValid)
-				reinterpret_cast<T&>(val) = v;
+			if(store.is_valid())
+				store.ref() = v;
 
 			else {
-				new (&val) T{v};
-				isValid = true;
+				store.construct(v);
 			}
 
 			return *this;
@@ -383,12 +641,11 @@ namespace ftl {
 		 */
 		maybe& operator= (T&& v)
 		noexcept(std::is_nothrow_move_assignable<T>::value) {
-			if(isValid)
-				reinterpret_cast<T&>(val) = std::move(v);
+			if(store.is_valid())
+				store.ref() = std::move(v);
 
 			else {
-				new (&val) T{std::move(v)};
-				isValid = true;
+				store.construct(std::move(v));
 			}
 
 			return *this;
@@ -415,22 +672,23 @@ namespace ftl {
 		 * \throws `invalid_maybe_access` if `this` is not a value.
 		 */
 		value_type& operator* () {
-			if(!isValid)
+			if(!store.is_valid())
 				throw invalid_maybe_access{
 					"Attempting to read the value of Nothing."
 				};
 
-			return reinterpret_cast<T&>(val);
+			return store.ref();
 		}
 
 		/// \overload
-		const value_type& operator* () const {
-			if(!isValid)
-				throw invalid_maybe_access{
+		constexpr const value_type& operator* () const {
+			// The conditional keeps this constexpr under C++11; the throw
+			// is never evaluated unless the maybe really is nothing
+			return store.is_valid()
+				? store.ref()
+				: throw invalid_maybe_access{
 					"Attempting to read the value of Nothing."
 				};
-
-			return reinterpret_cast<const T&>(val);
 		}
 
 		/**
@@ -439,22 +697,21 @@ namespace ftl {
 		 * \throws std::logic_error if `this` is `nothing`.
 		 */
 		value_type* operator-> () {
-			if(!isValid)
+			if(!store.is_valid())
 				throw invalid_maybe_access{
 					"Attempting to read the value of Nothing."
 				};
 
-			return reinterpret_cast<T*>(&val);
+			return &store.ref();
 		}
 
 		/// \overload
-		const value_type* operator-> () const {
-			if(!isValid)
-				throw invalid_maybe_access{
+		constexpr const value_type* operator-> () const {
+			return store.is_valid()
+				? &store.ref()
+				: throw invalid_maybe_access{
 					"Attempting to read the value of Nothing."
 				};
-
-			return reinterpret_cast<const T*>(&val);
 		}
 
 		iterator begin() noexcept {
@@ -496,24 +753,21 @@ namespace ftl {
 		 */
 		template<typename = Requires<std::is_nothrow_move_constructible<T>::value>>
 		void swap(maybe<T>& m) noexcept {
-			if(!isValid && m.isValid)
+			if(!store.is_valid() && m.store.is_valid())
 			{
-				new (this) maybe{std::move(m)};
+				store.construct(std::move(m.store.ref()));
 				m.self_destruct();
 			}
 
-			else if(isValid && !m.isValid)
+			else if(store.is_valid() && !m.store.is_valid())
 			{
-				new (&m) maybe{std::move(*this)};
+				m.store.construct(std::move(store.ref()));
 				self_destruct();
 			}
 
-			else if(isValid && m.isValid)
+			else if(store.is_valid() && m.store.is_valid())
 			{
-				std::swap(
-						reinterpret_cast<T&>(val),
-						reinterpret_cast<T&>(m.val)
-				);
+				std::swap(store.ref(), m.store.ref());
 			}
 		}
 
@@ -529,18 +783,30 @@ namespace ftl {
 		}
 
 	private:
+		/* Branch-free construction, used by the speculative map path. Only
+		 * the trivially copyable storage provides the matching constructor;
+		 * the SFINAE constraint makes explicit instantiation of maybe<T>
+		 * skip this member for every other T, rather than fail to compile
+		 * it.
+		 */
+		template<
+				typename U = T,
+				typename = Requires<std::is_trivially_copyable<U>::value>
+		>
+		constexpr maybe(_dtl::select_tag t, const T& v, bool valid) noexcept
+		: store(t, v, valid) {}
+
+		template<typename U, typename F, typename X>
+		friend maybe<U> _dtl::maybe_map_select(F&&, const maybe<X>&);
+
+		template<typename Fn, typename U, typename X>
+		friend U _dtl::maybe_fold_select(Fn&&, U, const maybe<X>&);
+
 		void self_destruct() {
-			if(isValid) {
-				reinterpret_cast<T&>(val).~T();
-				isValid = false;
-			}
+			store.destroy();
 		}
 
-		typename std::aligned_storage<
-			sizeof(T),
-			std::alignment_of<T>::value>::type val;
-
-		bool isValid = false;
+		_dtl::maybe_storage<T> store;
 	};
 
 	template<typename T>
@@ -566,6 +832,84 @@ namespace ftl {
 		return maybe<plain_type<A>>(std::forward<A>(a));
 	}
 
+	namespace _dtl {
+
+		/* The speculative tier behind maybe's functor and foldable
+		 * instances, enabled by the maybe_speculation trait.
+		 *
+		 * Each helper applies its function unconditionally; for a nothing,
+		 * a value initialised dummy stands in for the payload. The input
+		 * is chosen by indexing a pointer pair and the output by indexing
+		 * a result pair (or, for map, by the select constructor), so the
+		 * occupancy check becomes a data dependency instead of control
+		 * flow. The equivalent ternaries do not cut it: both gcc and clang
+		 * keep them as compare-and-branch.
+		 */
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map_select(F&& f, const maybe<T>& m) {
+			T dummy{};
+			const T* src[2] = {&dummy, &m.store.ref()};
+
+			/* The local copy is free for the trivially copyable payloads
+			 * this path is gated on, and passing it as an rvalue satisfies
+			 * functions expecting either value category.
+			 */
+			T in = *src[m.isValue()];
+
+			return maybe<U>(
+				select_tag{},
+				std::forward<F>(f)(std::move(in)),
+				m.isValue()
+			);
+		}
+
+		template<typename Fn, typename U, typename T>
+		U maybe_fold_select(Fn&& fn, U z, const maybe<T>& m) {
+			T dummy{};
+			const T* src[2] = {&dummy, &m.store.ref()};
+
+			U r[2] = {z, fn(z, *src[m.isValue()])};
+			return r[m.isValue()];
+		}
+
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map(F&& f, const maybe<T>& m, std::true_type) {
+			return maybe_map_select<U>(std::forward<F>(f), m);
+		}
+
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map(F&& f, const maybe<T>& m, std::false_type) {
+			return m ? value(std::forward<F>(f)(*m)) : maybe<U>();
+		}
+
+		template<typename Fn, typename U, typename T>
+		plain_type<U> maybe_fold(
+				Fn&& fn, U&& z, const maybe<T>& m, std::true_type) {
+			return maybe_fold_select(
+				std::forward<Fn>(fn), std::forward<U>(z), m
+			);
+		}
+
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map(F&& f, maybe<T>&& m, std::true_type) {
+			return maybe_map_select<U>(std::forward<F>(f), m);
+		}
+
+		template<typename U, typename F, typename T>
+		maybe<U> maybe_map(F&& f, maybe<T>&& m, std::false_type) {
+			return m ? value(std::forward<F>(f)(std::move(*m))) : maybe<U>();
+		}
+
+		template<typename Fn, typename U, typename T>
+		U maybe_fold(Fn&& fn, U&& z, const maybe<T>& m, std::false_type) {
+			if(m) {
+				return fn(std::forward<U>(z), *m);
+			}
+
+			return std::forward<U>(z);
+		}
+	}
+
 	/**
 	 * Equality comparison for maybe.
 	 *
@@ -575,16 +919,8 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename A>
-	bool operator== (const maybe<A>& m1, const maybe<A>& m2) {
-		if(m1 && m2) {
-			return *m1 == *m2;
-		}
-		else if(!m1 && !m2) {
-			return true;
-		}
-		else {
-			return false;
-		}
+	constexpr bool operator== (const maybe<A>& m1, const maybe<A>& m2) {
+		return m1 && m2 ? *m1 == *m2 : !m1 && !m2;
 	}
 
 	/**
@@ -593,7 +929,7 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename T>
-	bool operator== (const maybe<T>& m, nothing_t) noexcept {
+	constexpr bool operator== (const maybe<T>& m, nothing_t) noexcept {
 		return !static_cast<bool>(m);
 	}
 
@@ -603,7 +939,7 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename T>
-	bool operator== (nothing_t, const maybe<T>& m) noexcept {
+	constexpr bool operator== (nothing_t, const maybe<T>& m) noexcept {
 		return !static_cast<bool>(m);
 	}
 
@@ -616,7 +952,7 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename A>
-	bool operator!= (const maybe<A>& m1, const maybe<A>& m2) {
+	constexpr bool operator!= (const maybe<A>& m1, const maybe<A>& m2) {
 		return !(m1 == m2);
 	}
 
@@ -626,7 +962,7 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename T>
-	bool operator!= (const maybe<T>& m, nothing_t) noexcept {
+	constexpr bool operator!= (const maybe<T>& m, nothing_t) noexcept {
 		return static_cast<bool>(m);
 	}
 
@@ -636,7 +972,7 @@ namespace ftl {
 	 * \ingroup maybe
 	 */
 	template<typename T>
-	bool operator!= (nothing_t, const maybe<T>& m) noexcept {
+	constexpr bool operator!= (nothing_t, const maybe<T>& m) noexcept {
 		return static_cast<bool>(m);
 	}
 
@@ -781,18 +1117,36 @@ namespace ftl {
 		 *   bar(ftl::value(5)); // Results in value(10)
 		 *   bar(ftl::nothing);  // Results in nothing
 		 * \endcode
+		 *
+		 * \note When both `T` and `U` satisfy \ref maybe_speculation, `f`
+		 *       is applied _unconditionally_&mdash;to a value initialised
+		 *       dummy if `m` is nothing&mdash;and the result selected
+		 *       branch-free. See the trait for the contract this places
+		 *       on `f`.
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static maybe<U> map(F&& f, const maybe<T>& m) {
-			return m ? value(std::forward<F>(f)(*m)) : maybe<U>();
+			return _dtl::maybe_map<U>(
+				std::forward<F>(f), m,
+				std::integral_constant<bool,
+					maybe_speculation<T>::value
+					&& maybe_speculation<U>::value
+				>{}
+			);
 		}
-		
+
 		/**
 		 * \overload
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static maybe<U> map(F&& f, maybe<T>&& m) {
-			return m ? value(std::forward<F>(f)(std::move(*m))) : maybe<U>();
+			return _dtl::maybe_map<U>(
+				std::forward<F>(f), std::move(m),
+				std::integral_constant<bool,
+					maybe_speculation<T>::value
+					&& maybe_speculation<U>::value
+				>{}
+			);
 		}
 
 		/**
@@ -849,6 +1203,71 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Monad_rec implementation for maybe.
+	 *
+	 * The trampoline iterates for as long as the step function yields
+	 * `value(left)`; nothing aborts the loop, exactly as a chain of binds
+	 * would.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T>
+	struct monad_rec<maybe<T>> {
+
+		template<typename F, typename S, typename R = Value_type<T>>
+		static maybe<R> tailRec(F&& f, S seed) {
+			for(;;) {
+				auto m = f(std::move(seed));
+				if(!m)
+					return maybe<R>{};
+
+				auto& step = *m;
+				if(step)
+					return value(std::move(*step));
+
+				seed = std::move(step.left());
+			}
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Applicative_traverse implementation for maybe.
+	 *
+	 * A single pass over the container with the output reserved up front;
+	 * the first element mapped to `nothing` makes the whole traversal
+	 * `nothing`.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T>
+	struct applicative_traverse<maybe<T>> {
+
+		template<
+				typename F,
+				typename C,
+				typename Cu = Rebind<plain_type<C>,T>
+		>
+		static maybe<Cu> traverse(F&& f, C&& c) {
+			Cu out;
+			_dtl::try_reserve(out, c.size(), 0);
+
+			for(auto& x : c) {
+				auto m = f(_dtl::forward_element<C>(x));
+				if(!m)
+					return maybe<Cu>{};
+
+				out.push_back(std::move(*m));
+			}
+
+			return value(std::move(out));
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	/**
 	 * Implementation of ftl::monoidA concept.
 	 *
@@ -884,8 +1303,31 @@ namespace ftl {
 	 */
 	template<typename T>
 	struct foldable<maybe<T>>
-	: deriving_foldl<maybe<T>>
-	, deriving_foldMap<maybe<T>>, deriving_fold<maybe<T>> {
+	: deriving_foldMap<maybe<T>>, deriving_fold<maybe<T>> {
+
+		/**
+		 * \note When `T` satisfies \ref maybe_speculation and the
+		 *       accumulator is trivially copyable, `fn` is applied
+		 *       unconditionally and the result selected branch-free; see
+		 *       the trait for the contract this places on `fn`.
+		 */
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const maybe<T>& m) {
+			static_assert(
+				std::is_convertible<
+					typename std::result_of<Fn(U,T)>::type,U
+				>::value,
+				"The result of Fn(U,T) must be convertible to U"
+			);
+
+			return _dtl::maybe_fold(
+				std::forward<Fn>(fn), std::move(z), m,
+				std::integral_constant<bool,
+					maybe_speculation<T>::value
+					&& std::is_trivially_copyable<U>::value
+				>{}
+			);
+		}
 
 		template<
 				typename Fn,
@@ -897,15 +1339,146 @@ namespace ftl {
 				>
 		>
 		static U foldr(Fn&& fn, U&& z, const maybe<T>& m) {
-			if(m) {
-				return fn(std::forward<U>(z), *m);
-			}
-
-			return z;
+			return _dtl::maybe_fold(
+				std::forward<Fn>(fn), std::forward<U>(z), m,
+				std::integral_constant<bool,
+					maybe_speculation<T>::value
+					&& std::is_trivially_copyable<U>::value
+				>{}
+			);
 		}
 
 		static constexpr bool instance = true;
 	};
+
+	/**
+	 * A `maybe` with caller-chosen alignment.
+	 *
+	 * Behaves exactly like `maybe<T>`&mdash;it _is_ one, and binds to
+	 * everything that accepts the plain type&mdash;but is aligned to (and
+	 * hence sized in multiples of) `Align` bytes. Like
+	 * `sum_type_aligned`, its main use is giving each concurrently
+	 * written slot in a shared array a cache line of its own, instead of
+	 * hand-rolled padding wrappers:
+	 *
+	 * \code
+	 *   // One result slot per worker; no false sharing between workers
+	 *   std::vector<maybe_aligned<64,result>> slots(nworkers);
+	 * \endcode
+	 *
+	 * `Align` must be a power of two at least as strict as the natural
+	 * alignment of `maybe<T>`. The bytes spent on padding are reported by
+	 * `maybe_layout`.
+	 *
+	 * \see maybe_layout
+	 *
+	 * \ingroup maybe
+	 */
+	template<size_t Align, typename T>
+	struct alignas(Align) maybe_aligned : maybe<T> {
+		static_assert(
+			(Align & (Align - 1)) == 0,
+			"Alignment must be a power of two"
+		);
+
+		static_assert(
+			Align >= alignof(maybe<T>),
+			"Alignment may not be weaker than maybe's natural one"
+		);
+
+		/// Defaults to `nothing`, like the base.
+		constexpr maybe_aligned() noexcept {}
+
+		maybe_aligned(const maybe_aligned&) = default;
+		maybe_aligned(maybe_aligned&&) = default;
+
+		maybe_aligned& operator= (const maybe_aligned&) = default;
+		maybe_aligned& operator= (maybe_aligned&&) = default;
+
+		/// \see maybe::maybe
+		explicit constexpr maybe_aligned(const T& v)
+		noexcept(std::is_nothrow_copy_constructible<T>::value)
+		: maybe<T>(v) {}
+
+		/// \overload
+		explicit constexpr maybe_aligned(T&& v)
+		noexcept(std::is_nothrow_move_constructible<T>::value)
+		: maybe<T>(std::move(v)) {}
+
+		constexpr maybe_aligned(nothing_t) noexcept {}
+
+		constexpr maybe_aligned(std::nullptr_t) noexcept {}
+
+		template<typename...Ts>
+		constexpr maybe_aligned(inplace_tag t, Ts&&...ts)
+		noexcept(std::is_nothrow_constructible<T,Ts...>::value)
+		: maybe<T>(t, std::forward<Ts>(ts)...) {}
+
+		/// Widen a plain maybe into an aligned slot.
+		maybe_aligned(const maybe<T>& m) : maybe<T>(m) {}
+
+		/// \overload
+		maybe_aligned(maybe<T>&& m) : maybe<T>(std::move(m)) {}
+	};
+
+	namespace _dtl {
+		template<typename Complete, typename T>
+		struct maybe_layout_base {
+			static constexpr size_t size = sizeof(Complete);
+			static constexpr size_t alignment = alignof(Complete);
+
+			static constexpr size_t payload_offset = 0;
+			static constexpr size_t payload_size = sizeof(T);
+
+			/* Niche representations encode emptiness in the payload
+			 * itself; there is no flag byte and tag_offset degenerates to
+			 * one-past-the-element.
+			 */
+			static constexpr size_t tag_size =
+				maybe_niche<T>::value ? 0 : sizeof(bool);
+			static constexpr size_t tag_offset =
+				maybe_niche<T>::value ? size : payload_size;
+
+			static constexpr size_t padding =
+				size - payload_size - tag_size;
+		};
+	}
+
+	/**
+	 * Compile-time layout report for a maybe.
+	 *
+	 * The `maybe` analogue of `sum_type_layout`, for packing shared or
+	 * serialized arrays deliberately. All members are `constexpr`:
+	 *
+	 * - `size`, `alignment`: as `sizeof`/`alignof` of the element type
+	 * - `payload_offset`, `payload_size`: the contained `T`
+	 * - `tag_offset`, `tag_size`: the validity flag; `tag_size` is `0`
+	 *   for niche-encoded payloads (see `maybe_niche`), whose emptiness
+	 *   lives inside the payload bytes
+	 * - `padding`: bytes per element spent on neither, whether from the
+	 *   natural layout or from a `maybe_aligned` over-alignment
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   // Niche encoding: a maybe'd pointer costs nothing extra
+	 *   static_assert(maybe_layout<maybe<int*>>::padding == 0, "");
+	 * \endcode
+	 *
+	 * \see sum_type_layout
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename>
+	struct maybe_layout;
+
+	template<typename T>
+	struct maybe_layout<maybe<T>>
+	: _dtl::maybe_layout_base<maybe<T>,T> {};
+
+	template<size_t Align, typename T>
+	struct maybe_layout<maybe_aligned<Align,T>>
+	: _dtl::maybe_layout_base<maybe_aligned<Align,T>,T> {};
 }
 
 #endif
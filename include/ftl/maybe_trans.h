@@ -35,6 +35,20 @@ namespace ftl {
 	 *   #include <ftl/maybe_trans.h>
 	 * \endcode
 	 *
+	 * \note When transforming `ftl::function`, long bind chains can avoid
+	 *       per-combinator type erasure the same way
+	 *       \ref ftl::fused_eitherT "fused eitherT chains" do: compose
+	 *       closures returning `maybe<T>` statically and erase only the
+	 *       finished chain.
+	 *
+	 * \note When transforming a container monad, every bind step constructs
+	 *       a wrapper container per layer. Such intermediaries can be routed
+	 *       to the thread's scratch arena by using
+	 *       `ftl::scoped_arena_allocator` as the container's allocator and
+	 *       running the chain inside \ref ftl::scratch_scope
+	 *       "ftl::scratch_scope" (or \ref ftl::withScratch "withScratch"),
+	 *       which releases them wholesale at the outermost bind.
+	 *
 	 * \par Dependencies
 	 * - \ref maybe
 	 */
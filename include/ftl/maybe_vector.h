@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MAYBE_VECTOR_H
+#define FTL_MAYBE_VECTOR_H
+
+#include <cstdint>
+#include <vector>
+#include "maybe.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup maybe_vector Maybe Vector
+	 *
+	 * Columnar sequence of optional values, with bulk kernels.
+	 *
+	 * \code
+	 *   #include <ftl/maybe_vector.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<cstdint>`
+	 * - `<vector>`
+	 * - \ref maybe
+	 */
+
+	/**
+	 * A sequence of optional values, stored column-wise.
+	 *
+	 * A `std::vector<maybe<T>>` interleaves each value with its occupancy
+	 * flag, so every bulk operation over it branches per element and the
+	 * values are never contiguous in memory. `maybe_vector` instead keeps
+	 * all values in one dense array and the occupancy flags in a separate,
+	 * packed validity bitmask&mdash;the layout columnar formats such as
+	 * Arrow use. The bulk kernels \ref mapMaybes, \ref catMaybes and
+	 * \ref sumMaybes exploit it: they run branch-free over whole 64-element
+	 * blocks whenever a bitmask word is fully set, which lets the compiler
+	 * vectorize the value loop.
+	 *
+	 * Unoccupied slots hold a value-initialized `T` rather than raw memory,
+	 * so kernels may touch every lane unconditionally; such lanes are
+	 * masked out of any observable result.
+	 *
+	 * `T` must be DefaultConstructible and CopyConstructible.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::maybe_vector<double> v;
+	 *   v.push_back(1.5);
+	 *   v.push_back(ftl::nothing);
+	 *   v.push_back(2.5);
+	 *
+	 *   auto total = ftl::sumMaybes(v);  // == 4.0
+	 * \endcode
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	class maybe_vector {
+		static_assert(
+			std::is_default_constructible<T>::value,
+			"maybe_vector requires a DefaultConstructible value type"
+		);
+
+	public:
+		using value_type = T;
+
+		maybe_vector() = default;
+		maybe_vector(const maybe_vector&) = default;
+		maybe_vector(maybe_vector&&) = default;
+		~maybe_vector() = default;
+
+		maybe_vector& operator= (const maybe_vector&) = default;
+		maybe_vector& operator= (maybe_vector&&) = default;
+
+		/// Convert from the interleaved representation.
+		explicit maybe_vector(const std::vector<maybe<T>>& v) {
+			reserve(v.size());
+			for(const auto& m : v) {
+				if(m)
+					push_back(*m);
+				else
+					push_back(nothing);
+			}
+		}
+
+		size_t size() const noexcept {
+			return vals.size();
+		}
+
+		bool empty() const noexcept {
+			return vals.empty();
+		}
+
+		/// The number of occupied slots.
+		size_t count() const noexcept {
+			return nvalid;
+		}
+
+		void reserve(size_t n) {
+			vals.reserve(n);
+			bits.reserve((n + 63)/64);
+		}
+
+		void clear() noexcept {
+			vals.clear();
+			bits.clear();
+			nvalid = 0;
+		}
+
+		/// Append a value.
+		void push_back(const T& t) {
+			grow_mask();
+			bits.back() |= word_type(1) << (vals.size() % 64);
+			vals.push_back(t);
+			++nvalid;
+		}
+
+		/// \overload
+		void push_back(T&& t) {
+			grow_mask();
+			bits.back() |= word_type(1) << (vals.size() % 64);
+			vals.push_back(std::move(t));
+			++nvalid;
+		}
+
+		/// Append an unoccupied slot.
+		void push_back(nothing_t) {
+			grow_mask();
+			vals.emplace_back();
+		}
+
+		/// \overload
+		void push_back(const maybe<T>& m) {
+			if(m)
+				push_back(*m);
+			else
+				push_back(nothing);
+		}
+
+		/// Check whether the slot at index `i` is occupied.
+		bool isValueAt(size_t i) const {
+			return (bits[i/64] >> (i % 64)) & word_type(1);
+		}
+
+		/**
+		 * Element access, in the interleaved representation.
+		 *
+		 * Note that this necessarily copies the value; `maybe_vector` never
+		 * materializes `maybe<T>` objects internally.
+		 */
+		maybe<T> operator[] (size_t i) const {
+			return isValueAt(i) ? maybe<T>(vals[i]) : maybe<T>{};
+		}
+
+		/// Convert back to the interleaved representation.
+		std::vector<maybe<T>> toMaybes() const {
+			std::vector<maybe<T>> r;
+			r.reserve(size());
+
+			for(size_t i = 0; i < size(); ++i)
+				r.push_back((*this)[i]);
+
+			return r;
+		}
+
+		/// The dense value column. Unoccupied slots read as `T()`.
+		const std::vector<T>& values() const noexcept {
+			return vals;
+		}
+
+		/// The packed validity bitmask, 64 slots per word, LSB first.
+		const std::vector<uint64_t>& validity() const noexcept {
+			return bits;
+		}
+
+	private:
+		using word_type = uint64_t;
+
+		template<typename F, typename U>
+		friend maybe_vector<result_of<F(U)>>
+		mapMaybes(F, const maybe_vector<U>&);
+
+		void grow_mask() {
+			if(vals.size() % 64 == 0)
+				bits.push_back(0);
+		}
+
+		std::vector<T> vals;
+		std::vector<word_type> bits;
+		size_t nvalid = 0;
+	};
+
+	/**
+	 * Map a function over every slot of a `maybe_vector`.
+	 *
+	 * Equivalent to `fmap`ping `f` over each element of the corresponding
+	 * `std::vector<maybe<T>>`, but implemented as a single branch-free pass
+	 * over the value column: `f` is applied to _every_ slot, occupied or
+	 * not, and the validity bitmask is carried over untouched. Results
+	 * computed in unoccupied lanes are never observable.
+	 *
+	 * \note Because unoccupied lanes hold value-initialized values, `f`
+	 *       must be total over `T`&mdash;in particular, `f(T())` must be
+	 *       well defined (its result is discarded).
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename F, typename T>
+	maybe_vector<result_of<F(T)>> mapMaybes(F f, const maybe_vector<T>& v) {
+		maybe_vector<result_of<F(T)>> r;
+		r.vals.reserve(v.size());
+
+		for(const auto& x : v.values())
+			r.vals.push_back(f(x));
+
+		r.bits = v.validity();
+		r.nvalid = v.count();
+
+		return r;
+	}
+
+	/**
+	 * Extract the occupied values of a `maybe_vector`, in order.
+	 *
+	 * Fully set bitmask words are copied as whole 64-element blocks; only
+	 * words with at least one unoccupied slot fall back to per-bit
+	 * selection.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	std::vector<T> catMaybes(const maybe_vector<T>& v) {
+		const auto& vals = v.values();
+		const auto& bits = v.validity();
+
+		std::vector<T> r;
+		r.reserve(v.count());
+
+		const size_t full = v.size() / 64;
+
+		for(size_t w = 0; w < full; ++w) {
+			const T* p = vals.data() + w*64;
+
+			if(bits[w] == ~uint64_t(0)) {
+				r.insert(r.end(), p, p + 64);
+			}
+			else if(bits[w] != 0) {
+				for(size_t i = 0; i < 64; ++i) {
+					if((bits[w] >> i) & uint64_t(1))
+						r.push_back(p[i]);
+				}
+			}
+		}
+
+		for(size_t i = full*64; i < v.size(); ++i) {
+			if(v.isValueAt(i))
+				r.push_back(vals[i]);
+		}
+
+		return r;
+	}
+
+	/**
+	 * Sum the occupied values of a `maybe_vector`.
+	 *
+	 * Accumulates with `operator+=`, starting from a value-initialized `T`.
+	 * Fully set bitmask words are accumulated in an unmasked inner loop
+	 * that the compiler can vectorize; words with unoccupied slots use a
+	 * branchless select of `T()` for the masked lanes.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	T sumMaybes(const maybe_vector<T>& v) {
+		const auto& vals = v.values();
+		const auto& bits = v.validity();
+
+		T sum = T();
+		const size_t full = v.size() / 64;
+
+		for(size_t w = 0; w < full; ++w) {
+			const T* p = vals.data() + w*64;
+
+			if(bits[w] == ~uint64_t(0)) {
+				for(size_t i = 0; i < 64; ++i)
+					sum += p[i];
+			}
+			else if(bits[w] != 0) {
+				for(size_t i = 0; i < 64; ++i)
+					sum += ((bits[w] >> i) & uint64_t(1)) ? p[i] : T();
+			}
+		}
+
+		for(size_t i = full*64; i < v.size(); ++i)
+			sum += v.isValueAt(i) ? vals[i] : T();
+
+		return sum;
+	}
+
+}
+
+#endif
@@ -23,6 +23,12 @@
 #ifndef FTL_ORD_H
 #define FTL_ORD_H
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "concepts/orderable.h"
 #include "concepts/monoid.h"
 
@@ -40,6 +46,10 @@ namespace ftl {
 	 * "equal", or "greater than".
 	 *
 	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<functional>`
+	 * - `<numeric>`
+	 * - `<vector>`
 	 * - \ref orderable
 	 * - \ref monoid
 	 */
@@ -162,6 +172,112 @@ namespace ftl {
 		return lhs < rhs ? ord::Lt : (lhs == rhs ? ord::Eq : ord::Gt);
 	}
 
+	/**
+	 * Whether comparing two `T` is a plain scalar comparison.
+	 *
+	 * Such fields can be three-way compared without branching, which is
+	 * what makes the tuple \ref compare overload below branchless.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename T>
+	struct is_trivially_comparable
+	: std::integral_constant<
+		bool,
+		std::is_arithmetic<T>::value
+			|| std::is_enum<T>::value
+			|| std::is_pointer<T>::value
+	> {};
+
+	namespace _dtl {
+		// Three-way compare of one scalar field, sans branches
+		template<typename T>
+		int scalar_cmp(const T& a, const T& b) noexcept {
+			return static_cast<int>(a > b) - static_cast<int>(a < b);
+		}
+
+		template<typename...Ts, size_t...Is>
+		ord lex_compare(
+				const std::tuple<Ts...>& l, const std::tuple<Ts...>& r,
+				seq<Is...>) noexcept {
+
+			int ds[] = {
+				scalar_cmp(std::get<Is>(l), std::get<Is>(r))...
+			};
+
+			// The first non-zero field decides; masking with "still equal
+			// so far" folds the usual early-exit cascade into pure
+			// arithmetic, so near-equal keys cost no mispredicts
+			int o = 0;
+			for(size_t i = 0; i < sizeof...(Is); ++i)
+				o |= ds[i] & -static_cast<int>(o == 0);
+
+			// o is in {-1,0,1} and ord's orderings are Lt=0, Eq=1, Gt=2
+			return ord(static_cast<ord::ordering>(o + 1));
+		}
+
+		template<typename...Ts>
+		struct all_trivially_comparable;
+
+		template<>
+		struct all_trivially_comparable<> : std::true_type {};
+
+		template<typename T, typename...Ts>
+		struct all_trivially_comparable<T,Ts...>
+		: std::integral_constant<
+			bool,
+			is_trivially_comparable<T>::value
+				&& all_trivially_comparable<Ts...>::value
+		> {};
+	}
+
+	/**
+	 * Branchless comparison of tuples with scalar fields only.
+	 *
+	 * Lexicographic tuple comparison is normally a cascade of early-exit
+	 * branches, one per field, which mispredicts badly when keys agree in
+	 * their leading fields. This overload instead three-way compares every
+	 * field up front and combines the results with selects, so hot
+	 * composite keys&mdash;e.g. `tuple<int32_t,int32_t,uint64_t>`&mdash;
+	 * compare in a handful of straight-line instructions.
+	 *
+	 * Semantics are exactly those of the generic \ref compare; anything
+	 * built on it, like \ref getComparator, uses this overload
+	 * automatically when the field types allow.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename...Ts,
+			typename = Requires<
+				(sizeof...(Ts) > 0)
+				&& _dtl::all_trivially_comparable<Ts...>::value
+			>
+	>
+	ord compare(const std::tuple<Ts...>& lhs, const std::tuple<Ts...>& rhs)
+	noexcept {
+		return _dtl::lex_compare(
+			lhs, rhs, gen_seq<0,sizeof...(Ts)-1>{}
+		);
+	}
+
+	/// \overload
+	template<
+			typename A,
+			typename B,
+			typename = Requires<
+				_dtl::all_trivially_comparable<A,B>::value
+			>
+	>
+	ord compare(const std::pair<A,B>& lhs, const std::pair<A,B>& rhs)
+	noexcept {
+		int d1 = _dtl::scalar_cmp(lhs.first, rhs.first);
+		int d2 = _dtl::scalar_cmp(lhs.second, rhs.second);
+
+		int o = d1 | (d2 & -static_cast<int>(d1 == 0));
+		return ord(static_cast<ord::ordering>(o + 1));
+	}
+
 	/**
 	 * Convenience function to get a comparator for a certain type.
 	 *
@@ -332,6 +448,360 @@ namespace ftl {
 			return cmp(a, b) == ord::Eq;
 		};
 	}
+
+	/**
+	 * Non-erased version of \ref comparing.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename F>
+	struct comparing_fn {
+		F f;
+
+		template<typename A>
+		ord operator() (const A& a, const A& b) const {
+			return compare(f(a), f(b));
+		}
+	};
+
+	/**
+	 * Non-erased version of \ref asc.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	struct asc_fn {
+		Cmp cmp;
+
+		template<typename A>
+		bool operator() (const A& a, const A& b) const {
+			return cmp(a, b) == ord::Lt;
+		}
+	};
+
+	/**
+	 * Non-erased version of \ref desc.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	struct desc_fn {
+		Cmp cmp;
+
+		template<typename A>
+		bool operator() (const A& a, const A& b) const {
+			return cmp(a, b) == ord::Gt;
+		}
+	};
+
+	/**
+	 * As \ref comparing, but without type erasure.
+	 *
+	 * The combinators built on `ftl::function` are convenient to store
+	 * and compose, but every comparison goes through an indirect call. In
+	 * a sort's inner loop that indirection is paid O(n log n) times, so
+	 * this and its companions \ref ascBy and \ref descBy keep the
+	 * callable's concrete type, letting the comparison inline.
+	 *
+	 * Example:
+	 * \code
+	 *   std::sort(v.begin(), v.end(),
+	 *       ftl::ascBy(ftl::comparingBy(&record::key)));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename F>
+	comparing_fn<plain_type<F>> comparingBy(F&& f) {
+		return comparing_fn<plain_type<F>>{std::forward<F>(f)};
+	}
+
+	template<typename A, typename R>
+	comparing_fn<decltype(std::mem_fn(std::declval<R (A::*)() const>()))>
+	comparingBy(R (A::*method)() const) {
+		using F = decltype(std::mem_fn(method));
+		return comparing_fn<F>{std::mem_fn(method)};
+	}
+
+	/**
+	 * As \ref asc, but without type erasure.
+	 *
+	 * \see comparingBy
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	asc_fn<plain_type<Cmp>> ascBy(Cmp&& cmp) {
+		return asc_fn<plain_type<Cmp>>{std::forward<Cmp>(cmp)};
+	}
+
+	/**
+	 * As \ref desc, but without type erasure.
+	 *
+	 * \see comparingBy
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	desc_fn<plain_type<Cmp>> descBy(Cmp&& cmp) {
+		return desc_fn<plain_type<Cmp>>{std::forward<Cmp>(cmp)};
+	}
+
+	/**
+	 * Tie-breaking composition of two `ord`-returning comparators.
+	 *
+	 * Falls through to `c2` whenever `c1` deems the operands equal; the
+	 * statically typed mirror of the monoid append of `ftl::function` and
+	 * `ftl::ord`.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename C1, typename C2>
+	struct then_cmp {
+		C1 c1;
+		C2 c2;
+
+		template<typename A>
+		ord operator() (const A& a, const A& b) const {
+			auto o = c1(a, b);
+			return o == ord::Eq ? c2(a, b) : o;
+		}
+	};
+
+	/**
+	 * Order-reversing wrapper of an `ord`-returning comparator.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	struct reverse_cmp {
+		Cmp cmp;
+
+		template<typename A>
+		ord operator() (const A& a, const A& b) const {
+			return cmp(b, a);
+		}
+	};
+
+	/**
+	 * Fluent, statically typed comparator combinator.
+	 *
+	 * Wraps an `ord`-returning callable and exposes the combinators as
+	 * chainable methods, while every intermediate remains a concrete
+	 * type&mdash;no `ftl::function` erasure anywhere, so the whole chain
+	 * inlines into a sort's inner loop.
+	 *
+	 * The call operator is already the strict weak order `std::sort`
+	 * expects, so a finished chain is passed straight in:
+	 *
+	 * \code
+	 *   std::sort(v.begin(), v.end(),
+	 *       ftl::byKey(&record::group)
+	 *           .thenBy(&record::score).descending());
+	 * \endcode
+	 *
+	 * Note that `descending` reverses everything chained so far; chain it
+	 * last to reverse the complete order, or first to reverse only the
+	 * primary key.
+	 *
+	 * Use \ref byKey or \ref byComparing to create one; the latter accepts
+	 * any `ord`-returning callable, including the erased ones built with
+	 * \ref comparing or the monoid instances, so both styles mix freely.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	struct comparator {
+		Cmp cmp;
+
+		/// The underlying three-way comparison.
+		template<typename A>
+		ord compare(const A& a, const A& b) const {
+			return cmp(a, b);
+		}
+
+		/// Strict weak order predicate: `true` iff `a` orders before `b`.
+		template<typename A>
+		bool operator() (const A& a, const A& b) const {
+			return cmp(a, b) == ord::Lt;
+		}
+
+		/// Tie-break by a further key function.
+		template<typename F>
+		comparator<then_cmp<Cmp,comparing_fn<plain_type<F>>>>
+		thenBy(F&& f) const {
+			return {{cmp, comparing_fn<plain_type<F>>{std::forward<F>(f)}}};
+		}
+
+		/// \overload
+		template<typename A, typename R>
+		comparator<then_cmp<
+			Cmp,
+			comparing_fn<decltype(std::mem_fn(std::declval<R (A::*)() const>()))>
+		>>
+		thenBy(R (A::*method)() const) const {
+			using F = decltype(std::mem_fn(method));
+			return {{cmp, comparing_fn<F>{std::mem_fn(method)}}};
+		}
+
+		/// Tie-break by another full comparator.
+		template<typename C2>
+		comparator<then_cmp<Cmp,C2>> thenByComparing(C2 c2) const {
+			return {{cmp, std::move(c2)}};
+		}
+
+		/// Reverse the order established by the chain so far.
+		comparator<reverse_cmp<Cmp>> descending() const {
+			return {reverse_cmp<Cmp>{cmp}};
+		}
+
+		/// No-op, for symmetry with descending.
+		comparator ascending() const {
+			return *this;
+		}
+	};
+
+	/**
+	 * Start a comparator chain from a key function.
+	 *
+	 * Like \ref comparingBy, but the result is an \ref comparator, so
+	 * further keys and direction can be chained on. Also accepts getter
+	 * members, as in `byKey(&record::key)`.
+	 *
+	 * \see comparator
+	 *
+	 * \ingroup ord
+	 */
+	template<typename F>
+	comparator<comparing_fn<plain_type<F>>> byKey(F&& f) {
+		return {comparing_fn<plain_type<F>>{std::forward<F>(f)}};
+	}
+
+	/// \overload
+	template<typename A, typename R>
+	comparator<
+		comparing_fn<decltype(std::mem_fn(std::declval<R (A::*)() const>()))>
+	>
+	byKey(R (A::*method)() const) {
+		using F = decltype(std::mem_fn(method));
+		return {comparing_fn<F>{std::mem_fn(method)}};
+	}
+
+	/**
+	 * Start a comparator chain from an `ord`-returning callable.
+	 *
+	 * The bridge from the rest of the ord ecosystem: anything built with
+	 * \ref comparing, \ref getComparator, or the monoid instances can be
+	 * lifted into the fluent interface (at the cost of whatever erasure
+	 * the wrapped callable already carries).
+	 *
+	 * \see comparator
+	 *
+	 * \ingroup ord
+	 */
+	template<typename Cmp>
+	comparator<plain_type<Cmp>> byComparing(Cmp&& cmp) {
+		return {std::forward<Cmp>(cmp)};
+	}
+
+	/**
+	 * Sort a container by an `ord`-returning comparator.
+	 *
+	 * \param cmp Binary function from two `Value_type<C>` to \ref ord,
+	 *            e.g. something built with \ref comparingBy. Ascending
+	 *            order; wrap the result in a reversing comparator for
+	 *            descending.
+	 * \param c The container to sort. Must be iterable and support
+	 *          `push_back`; it is left untouched.
+	 *
+	 * \return A sorted copy of `c`. The sort is stable.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename C,
+			typename Cmp,
+			typename T = Value_type<C>
+	>
+	C sortBy(Cmp cmp, const C& c) {
+		std::vector<const T*> ptrs;
+		for(auto& e : c)
+			ptrs.push_back(&e);
+
+		std::stable_sort(
+			ptrs.begin(), ptrs.end(),
+			[&cmp](const T* a, const T* b) {
+				return cmp(*a, *b) == ord::Lt;
+			}
+		);
+
+		C r;
+		for(auto p : ptrs)
+			r.push_back(*p);
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Fluent comparators yield `bool`, not \ref ord, from their call
+	 * operator; this overload unwraps to the underlying three-way
+	 * comparison instead of comparing that bool against `ord::Lt`.
+	 */
+	template<typename C, typename Cmp>
+	C sortBy(comparator<Cmp> cmp, const C& c) {
+		return sortBy(cmp.cmp, c);
+	}
+
+	/**
+	 * Decorate-sort-undecorate by a key function.
+	 *
+	 * Sorting with \ref comparing re-invokes the key extraction on both
+	 * operands of every comparison&mdash;O(n log n) invocations. sortOn
+	 * instead applies `f` exactly once per element into a key buffer,
+	 * sorts indices by the cached keys, and applies the resulting
+	 * permutation. The right choice whenever the key is more expensive
+	 * than copying it.
+	 *
+	 * \param f Key extraction function; its result type must satisfy
+	 *          \ref orderablepg.
+	 * \param c The container to sort. Must be iterable and support
+	 *          `push_back`; it is left untouched.
+	 *
+	 * \return A copy of `c`, sorted by ascending key. The sort is stable.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename C,
+			typename F,
+			typename T = Value_type<C>,
+			typename K = result_of<F(T)>,
+			typename = Requires<Orderable<K>{}>
+	>
+	C sortOn(F f, const C& c) {
+		std::vector<K> keys;
+		std::vector<const T*> ptrs;
+		for(auto& e : c) {
+			keys.push_back(f(e));
+			ptrs.push_back(&e);
+		}
+
+		std::vector<size_t> is(ptrs.size());
+		std::iota(is.begin(), is.end(), size_t(0));
+
+		std::stable_sort(
+			is.begin(), is.end(),
+			[&keys](size_t i, size_t j) { return keys[i] < keys[j]; }
+		);
+
+		C r;
+		for(auto i : is)
+			r.push_back(*ptrs[i]);
+
+		return r;
+	}
 }
 
 #endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PAR_H
+#define FTL_PAR_H
+
+#include "lazy.h"
+#include "thread_pool.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup par Par
+	 *
+	 * Speculative parallel evaluation of lazy values.
+	 *
+	 * \code
+	 *   #include <ftl/par.h>
+	 * \endcode
+	 *
+	 * Forcing a lazy value normally happens on demand, on the forcing
+	 * thread; a wide dependency graph of deferred computations is thus
+	 * evaluated serially, depth first, no matter how many cores are idle.
+	 * This module provides _sparks_ in the style of Haskell's `par`: a
+	 * spark marks an \ref ftl::atomic_lazy "atomic_lazy" as profitable to
+	 * evaluate speculatively, and a \ref ftl::spark_pool "spark_pool"
+	 * forces sparked values on idle workers while the annotating thread
+	 * continues. Whoever needs the value first computes it; everyone else
+	 * gets the memoized result.
+	 *
+	 * \code
+	 *   ftl::spark_pool sparks;
+	 *
+	 *   auto a = ftl::par(sparks, expensiveA);
+	 *   auto b = ftl::par(sparks, expensiveB);
+	 *
+	 *   // a and b may now be computing in the background
+	 *   auto r = combine(ftl::sync(a), ftl::sync(b));
+	 * \endcode
+	 *
+	 * Sparks require `atomic_lazy` rather than plain `lazy`, as the latter
+	 * performs no synchronisation of its shared state and must never be
+	 * forced from two threads at once. `atomic_lazy`'s once-only forcing is
+	 * exactly what makes speculation safe: a spark that loses the race to
+	 * a sync (or vice versa) is simply a no-op.
+	 *
+	 * \par Dependencies
+	 * - \ref lazy
+	 * - \ref threadpool
+	 */
+
+	/**
+	 * A pool of workers that force sparked computations.
+	 *
+	 * Sparks are drained in FIFO order by whichever worker becomes idle
+	 * first. A spark is purely advisory: if the value has already been
+	 * forced&mdash;or is being forced&mdash;by the time a worker picks it
+	 * up, the worker moves straight on to the next spark.
+	 *
+	 * Exceptions raised by a sparked computation are swallowed by the
+	 * worker; the computation reverts to its deferred state (as per
+	 * `atomic_lazy`) and the exception surfaces on whichever thread
+	 * eventually \ref ftl::sync "syncs" the value.
+	 *
+	 * The destructor waits for already started sparks to finish, like
+	 * ftl::thread_pool. Every sparked value must therefore be safe to
+	 * evaluate for as long as the pool lives.
+	 *
+	 * \ingroup par
+	 */
+	class spark_pool {
+	public:
+		/**
+		 * Create a pool of `nthreads` spark workers.
+		 *
+		 * Defaults to one worker per hardware thread, like
+		 * ftl::thread_pool.
+		 */
+		explicit spark_pool(
+				size_t nthreads = std::thread::hardware_concurrency()
+		) : pool(nthreads) {}
+
+		spark_pool(const spark_pool&) = delete;
+		spark_pool(spark_pool&&) = delete;
+
+		spark_pool& operator= (const spark_pool&) = delete;
+		spark_pool& operator= (spark_pool&&) = delete;
+
+		/**
+		 * Submit a lazy value for speculative evaluation.
+		 *
+		 * Usually invoked through \ref ftl::par "par" rather than
+		 * directly.
+		 */
+		template<typename T>
+		void spark(atomic_lazy<T> l) {
+			pool.submit(function<void()>{[l]() {
+				if(l.status() == value_status::deferred) {
+					try {
+						*l;
+					}
+					catch(...) {
+						// Speculation must not kill the worker; the
+						// exception recurs when the value is synced.
+					}
+				}
+			}});
+		}
+
+		/// The number of spark workers in the pool.
+		size_t size() const noexcept {
+			return pool.size();
+		}
+
+	private:
+		thread_pool pool;
+	};
+
+	/**
+	 * Annotate a lazy value as profitable to evaluate in parallel.
+	 *
+	 * Sparks `l` on the given pool and immediately returns it, so calls can
+	 * be inserted in the middle of building a dependency graph:
+	 * \code
+	 *   auto node = combineLazily(
+	 *       ftl::par(sparks, leftSubtree),
+	 *       ftl::par(sparks, rightSubtree)
+	 *   );
+	 * \endcode
+	 *
+	 * Like its Haskell namesake, `par` makes no promise of parallelism; it
+	 * only creates the opportunity. If all workers stay busy, the value is
+	 * computed on whichever thread syncs it first, exactly as without the
+	 * annotation.
+	 *
+	 * \ingroup par
+	 */
+	template<typename T>
+	atomic_lazy<T> par(spark_pool& pool, atomic_lazy<T> l) {
+		pool.spark(l);
+		return l;
+	}
+
+	/**
+	 * Wait for, and get, the value of a lazy computation.
+	 *
+	 * If no spark has gotten to `l` yet, it is evaluated here and now, on
+	 * the calling thread; if one is evaluating it at this moment, `sync`
+	 * waits for it to finish. Either way, exactly one evaluation takes
+	 * place across all copies of `l`.
+	 *
+	 * Exceptions raised by the computation&mdash;even on a spark worker
+	 * &mdash;propagate from `sync`.
+	 *
+	 * \ingroup par
+	 */
+	template<typename T>
+	const T& sync(const atomic_lazy<T>& l) {
+		return *l;
+	}
+
+}
+
+#endif
+
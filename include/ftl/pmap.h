@@ -0,0 +1,631 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PMAP_H
+#define FTL_PMAP_H
+
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "maybe.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup pmap Persistent Map
+	 *
+	 * A persistent hash map with structural sharing.
+	 *
+	 * \code
+	 *   #include <ftl/pmap.h>
+	 * \endcode
+	 *
+	 * Snapshotting a `std::map` or `std::unordered_map` means copying all
+	 * of it, so workflows that keep a version of the map per transaction
+	 * pay O(n) per change. An ftl::pmap is a hash array mapped trie:
+	 * `insert` and `erase` return a _new_ map in O(log32 n) by copying
+	 * only the path from root to the affected entry, and the new version
+	 * shares everything else with the old, which remains valid and
+	 * unmodified.
+	 *
+	 * Unlike `std::unordered_map`, pmap does get a \ref foldablepg
+	 * instance: trie traversal order is determined entirely by the hashes
+	 * of the stored keys, never by insertion order or a bucket count, so
+	 * two maps holding the same entries always fold in the same
+	 * order&mdash;the unspecified-result objection raised in \ref
+	 * unord_map does not apply. The order itself is still arbitrary from
+	 * the user's point of view, of course.
+	 *
+	 * This module implements the following concepts for pmap:
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \par Dependencies
+	 * - `<functional>`
+	 * - `<initializer_list>`
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - \ref maybe
+	 * - \ref foldable
+	 */
+
+	template<typename K, typename V, typename Hash, typename Eq>
+	class pmap;
+
+	template<typename K, typename V, typename Hash, typename Eq>
+	struct foldable<pmap<K,V,Hash,Eq>>;
+
+	/**
+	 * A persistent hash map with structural sharing.
+	 *
+	 * Entries live in a 32-way trie indexed by successive 5-bit slices of
+	 * the key's hash, with popcount-compressed nodes. All operations that
+	 * "modify" the map&mdash;\ref pmap::insert "insert" and \ref
+	 * pmap::erase "erase"&mdash;leave it untouched and return a new map
+	 * in O(log32 n), sharing all unaffected structure with the original.
+	 * Copying a pmap is O(1).
+	 *
+	 * Keys whose hashes collide completely are kept in a linearly scanned
+	 * overflow node at maximum depth, as usual for hash tries.
+	 *
+	 * \tparam Hash must be a hash function object for `K`, like
+	 *         `std::hash<K>`.
+	 * \tparam Eq must be an equivalence relation on `K`.
+	 *
+	 * \par Concepts
+	 * - \ref copycons (O(1), shares structure)
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref eq, if `V` is EqualityComparable.
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \ingroup pmap
+	 */
+	template<
+			typename K,
+			typename V,
+			typename Hash = std::hash<K>,
+			typename Eq = std::equal_to<K>
+	>
+	class pmap {
+		static constexpr size_t bits = 5;
+		static constexpr size_t mask = (1 << bits) - 1;
+		static constexpr size_t hash_bits = 8*sizeof(size_t);
+
+		struct entry {
+			entry(K k, V v) : key(std::move(k)), val(std::move(v)) {}
+
+			K key;
+			V val;
+		};
+
+		struct node;
+		using node_ptr = std::shared_ptr<node>;
+		using entry_ptr = std::shared_ptr<entry>;
+
+		/* Each set bit in `bitmap` corresponds to one element of `slots`,
+		 * which holds either a direct entry or a sub-node. A node past
+		 * maximum depth instead keeps fully colliding entries in
+		 * `collisions` and leaves the other members empty.
+		 */
+		struct slot {
+			entry_ptr kv;
+			node_ptr child;
+		};
+
+		struct node {
+			uint32_t bitmap = 0;
+			std::vector<slot> slots;
+			std::vector<entry> collisions;
+		};
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using size_type = size_t;
+
+		pmap() = default;
+		pmap(const pmap&) = default;
+		pmap(pmap&&) = default;
+		~pmap() = default;
+
+		pmap(std::initializer_list<std::pair<K,V>> l) {
+			for(auto& kv : l)
+				*this = insert(kv.first, kv.second);
+		}
+
+		pmap& operator= (const pmap&) = default;
+		pmap& operator= (pmap&&) = default;
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_type size() const noexcept {
+			return count;
+		}
+
+		/**
+		 * Look a key up, in O(log32 n).
+		 *
+		 * \return The associated value, or `nothing` if the key is
+		 *         absent.
+		 */
+		maybe<V> lookup(const K& k) const {
+			if(!root)
+				return maybe<V>{};
+
+			const node* n = root.get();
+			size_t h = hasher(k);
+
+			for(size_t shift = 0; shift < hash_bits; shift += bits) {
+				uint32_t bit = uint32_t(1) << ((h >> shift) & mask);
+				if(!(n->bitmap & bit))
+					return maybe<V>{};
+
+				auto& s = n->slots[slot_index(n->bitmap, bit)];
+				if(s.kv) {
+					if(eq(s.kv->key, k))
+						return value(s.kv->val);
+
+					return maybe<V>{};
+				}
+
+				n = s.child.get();
+			}
+
+			for(auto& e : n->collisions) {
+				if(eq(e.key, k))
+					return value(e.val);
+			}
+
+			return maybe<V>{};
+		}
+
+		/**
+		 * Produce a new map with the given association added.
+		 *
+		 * Replaces the value if the key is already present. O(log32 n):
+		 * only the path from root to the affected entry is copied; the
+		 * rest is shared with this map, which is left unmodified.
+		 */
+		pmap insert(K k, V v) const {
+			pmap r{*this};
+			bool added = true;
+			size_t h = hasher(k);
+
+			if(r.root) {
+				r.root = insert_in(
+					r.root, 0, h,
+					std::make_shared<entry>(std::move(k), std::move(v)),
+					added, hasher, eq
+				);
+			}
+			else {
+				r.root = std::make_shared<node>();
+				r.root->bitmap = uint32_t(1) << (h & mask);
+				r.root->slots.resize(1);
+				r.root->slots[0].kv =
+					std::make_shared<entry>(std::move(k), std::move(v));
+			}
+
+			if(added)
+				++r.count;
+
+			return r;
+		}
+
+		/**
+		 * Produce a new map without the given key.
+		 *
+		 * O(log32 n) by path copying, like \ref pmap::insert "insert". If
+		 * the key is absent, the result is equal to this map.
+		 */
+		pmap erase(const K& k) const {
+			if(!root)
+				return *this;
+
+			pmap r{*this};
+			bool removed = false;
+			r.root = erase_in(r.root, 0, hasher(k), k, removed, eq);
+
+			if(removed)
+				--r.count;
+
+			return r;
+		}
+
+	private:
+		static size_t popcount(uint32_t x) noexcept {
+			x = x - ((x >> 1) & 0x55555555u);
+			x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+			x = (x + (x >> 4)) & 0x0f0f0f0fu;
+			return (x * 0x01010101u) >> 24;
+		}
+
+		// Compressed index of `bit`'s slot within a node
+		static size_t slot_index(uint32_t bitmap, uint32_t bit) noexcept {
+			return popcount(bitmap & (bit - 1));
+		}
+
+		// Build the smallest sub-trie distinguishing two entries
+		static node_ptr merge(
+				size_t shift, size_t h1, entry_ptr e1,
+				size_t h2, entry_ptr e2) {
+			auto n = std::make_shared<node>();
+
+			if(shift >= hash_bits) {
+				n->collisions.push_back(*e1);
+				n->collisions.push_back(*e2);
+				return n;
+			}
+
+			size_t i1 = (h1 >> shift) & mask;
+			size_t i2 = (h2 >> shift) & mask;
+
+			if(i1 == i2) {
+				n->bitmap = uint32_t(1) << i1;
+				n->slots.resize(1);
+				n->slots[0].child = merge(
+					shift + bits, h1, std::move(e1), h2, std::move(e2)
+				);
+			}
+			else {
+				n->bitmap = (uint32_t(1) << i1) | (uint32_t(1) << i2);
+				n->slots.resize(2);
+				n->slots[i1 < i2 ? 0 : 1].kv = std::move(e1);
+				n->slots[i1 < i2 ? 1 : 0].kv = std::move(e2);
+			}
+
+			return n;
+		}
+
+		static node_ptr insert_in(
+				const node_ptr& n, size_t shift, size_t h, entry_ptr e,
+				bool& added, const Hash& hasher, const Eq& eq) {
+			auto c = std::make_shared<node>(*n);
+
+			if(shift >= hash_bits) {
+				for(auto& old : c->collisions) {
+					if(eq(old.key, e->key)) {
+						old.val = std::move(e->val);
+						added = false;
+						return c;
+					}
+				}
+
+				c->collisions.push_back(*e);
+				return c;
+			}
+
+			uint32_t bit = uint32_t(1) << ((h >> shift) & mask);
+			size_t i = slot_index(c->bitmap, bit);
+
+			if(!(c->bitmap & bit)) {
+				c->bitmap |= bit;
+				slot s;
+				s.kv = std::move(e);
+				c->slots.insert(c->slots.begin() + i, std::move(s));
+			}
+			else if(c->slots[i].kv) {
+				auto& old = c->slots[i].kv;
+				if(eq(old->key, e->key)) {
+					old = std::move(e);
+					added = false;
+				}
+				else {
+					/* The hash must be taken before the call: merge takes
+					 * its entry by value, and argument evaluation order is
+					 * unspecified, so hasher(old->key) could otherwise run
+					 * after old has been moved from.
+					 */
+					auto h_old = hasher(old->key);
+
+					c->slots[i].child = merge(
+						shift + bits,
+						h_old, std::move(old),
+						h, std::move(e)
+					);
+					c->slots[i].kv = nullptr;
+				}
+			}
+			else {
+				c->slots[i].child = insert_in(
+					c->slots[i].child, shift + bits, h, std::move(e),
+					added, hasher, eq
+				);
+			}
+
+			return c;
+		}
+
+		// Returns nullptr if the node ends up empty
+		static node_ptr erase_in(
+				const node_ptr& n, size_t shift, size_t h, const K& k,
+				bool& removed, const Eq& eq) {
+			if(shift >= hash_bits) {
+				auto c = std::make_shared<node>(*n);
+				for(auto it = c->collisions.begin();
+						it != c->collisions.end(); ++it) {
+					if(eq(it->key, k)) {
+						c->collisions.erase(it);
+						removed = true;
+						break;
+					}
+				}
+
+				return c->collisions.empty() ? nullptr : c;
+			}
+
+			uint32_t bit = uint32_t(1) << ((h >> shift) & mask);
+			if(!(n->bitmap & bit))
+				return n;
+
+			size_t i = slot_index(n->bitmap, bit);
+
+			if(n->slots[i].kv) {
+				if(!eq(n->slots[i].kv->key, k))
+					return n;
+
+				removed = true;
+				if(n->slots.size() == 1)
+					return nullptr;
+
+				auto c = std::make_shared<node>(*n);
+				c->bitmap &= ~bit;
+				c->slots.erase(c->slots.begin() + i);
+				return c;
+			}
+
+			auto sub = erase_in(n->slots[i].child, shift + bits, h, k,
+					removed, eq);
+
+			if(sub == n->slots[i].child)
+				return n;
+
+			auto c = std::make_shared<node>(*n);
+			if(sub) {
+				c->slots[i].child = std::move(sub);
+			}
+			else {
+				if(c->slots.size() == 1)
+					return nullptr;
+
+				c->bitmap &= ~bit;
+				c->slots.erase(c->slots.begin() + i);
+			}
+
+			return c;
+		}
+
+		// Visit every entry; f must return true to continue the walk
+		template<typename F>
+		static bool walk(const node_ptr& n, F& f) {
+			for(auto& e : n->collisions) {
+				if(!f(e))
+					return false;
+			}
+
+			for(auto& s : n->slots) {
+				if(s.kv) {
+					if(!f(*s.kv))
+						return false;
+				}
+				else if(!walk(s.child, f)) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// As walk, but visiting entries in reverse traversal order
+		template<typename F>
+		static bool walk_reverse(const node_ptr& n, F& f) {
+			for(auto it = n->slots.rbegin(); it != n->slots.rend(); ++it) {
+				if(it->kv) {
+					if(!f(*it->kv))
+						return false;
+				}
+				else if(!walk_reverse(it->child, f)) {
+					return false;
+				}
+			}
+
+			for(auto it = n->collisions.rbegin();
+					it != n->collisions.rend(); ++it) {
+				if(!f(*it))
+					return false;
+			}
+
+			return true;
+		}
+
+		// Clone the whole trie, transforming values and sharing nothing
+		// but the keys
+		template<typename U, typename F>
+		static typename pmap<K,U,Hash,Eq>::node_ptr map_node(
+				F& f, const node_ptr& n) {
+			using rmap = pmap<K,U,Hash,Eq>;
+
+			auto rn = std::make_shared<typename rmap::node>();
+			rn->bitmap = n->bitmap;
+
+			for(auto& e : n->collisions)
+				rn->collisions.emplace_back(e.key, f(e.val));
+
+			for(auto& s : n->slots) {
+				typename rmap::slot rs;
+				if(s.kv) {
+					rs.kv = std::make_shared<typename rmap::entry>(
+						s.kv->key, f(s.kv->val)
+					);
+				}
+				else {
+					rs.child = map_node<U>(f, s.child);
+				}
+
+				rn->slots.push_back(std::move(rs));
+			}
+
+			return rn;
+		}
+
+		friend bool operator== (const pmap& m1, const pmap& m2) {
+			if(m1.count != m2.count)
+				return false;
+
+			if(!m1.root)
+				return true;
+
+			auto check = [&m2](const entry& e) {
+				auto v = m2.lookup(e.key);
+				return v && *v == e.val;
+			};
+
+			return walk(m1.root, check);
+		}
+
+		friend bool operator!= (const pmap& m1, const pmap& m2) {
+			return !(m1 == m2);
+		}
+
+		template<typename, typename, typename, typename>
+		friend class pmap;
+
+		// The functor instance builds maps of a different value type, so
+		// friendship must span all instances
+		template<typename>
+		friend struct functor;
+
+		template<typename>
+		friend struct foldable;
+
+		node_ptr root;
+		size_type count = 0;
+		Hash hasher;
+		Eq eq;
+	};
+
+	template<typename K, typename V, typename H, typename E>
+	struct parametric_type_traits<pmap<K,V,H,E>> {
+		using value_type = V;
+
+		template<typename W>
+		using rebind = pmap<K,W,H,E>;
+	};
+
+	/**
+	 * Functor instance for pmap.
+	 *
+	 * Maps over the values, like the std map instances do. The result
+	 * shares the trie's keys with the source, but no nodes&mdash;every
+	 * value changes, so there is nothing else to share.
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename T, typename H, typename E>
+	struct functor<pmap<K,T,H,E>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using p_map = pmap<K,U,H,E>;
+
+		/**
+		 * Maps the function `f` over all values in `m`.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static p_map<U> map(F&& f, const p_map<T>& m) {
+			p_map<U> rm;
+			if(m.root)
+				rm.root = p_map<T>::template map_node<U>(f, m.root);
+
+			rm.count = m.count;
+			return rm;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for pmap.
+	 *
+	 * Folds over the values. Traversal order follows the trie, i.e. the
+	 * hashes of the keys: arbitrary, but the same for any two maps
+	 * holding the same entries.
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename T, typename H, typename E>
+	struct foldable<pmap<K,T,H,E>>
+	: deriving_fold<pmap<K,T,H,E>>, deriving_foldMap<pmap<K,T,H,E>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const pmap<K,T,H,E>& m) {
+			if(!m.root)
+				return z;
+
+			auto step = [&f,&z](const typename pmap<K,T,H,E>::entry& e) {
+				z = f(z, e.val);
+				return true;
+			};
+
+			pmap<K,T,H,E>::walk(m.root, step);
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const pmap<K,T,H,E>& m) {
+			if(!m.root)
+				return z;
+
+			auto step = [&f,&z](const typename pmap<K,T,H,E>::entry& e) {
+				z = f(e.val, z);
+				return true;
+			};
+
+			pmap<K,T,H,E>::walk_reverse(m.root, step);
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
+
@@ -405,6 +405,67 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * Function composition base case for non-owning references.
+	 *
+	 * Composes an arbitrary function object with an ftl::function_ref. Note
+	 * that the referenced callable is _not_ copied into the composition; it
+	 * must outlive the returned function.
+	 *
+	 * \ingroup prelude
+	 */
+	template<
+		typename F,
+		typename A,
+		typename B = typename std::result_of<F(A)>::type,
+		typename...Ps>
+	function<B(Ps...)> compose(F f, function_ref<A(Ps...)> fn) {
+		return [f,fn](Ps...ps) {
+			return f(fn(std::forward<Ps>(ps)...));
+		};
+	}
+
+	namespace _dtl {
+		// Statically typed composition of two arbitrary function objects.
+		// Unlike the type erased compose base cases, calls through this
+		// object are ordinary inlineable member calls.
+		template<typename F, typename G>
+		struct composed {
+			F f;
+			G g;
+
+			composed(F f, G g) : f(std::move(f)), g(std::move(g)) {}
+
+			template<typename...Ps>
+			constexpr auto operator() (Ps&&...ps) const
+			-> decltype(f(g(std::forward<Ps>(ps)...))) {
+				return f(g(std::forward<Ps>(ps)...));
+			}
+		};
+	}
+
+	/**
+	 * Function composition base case for arbitrary function objects.
+	 *
+	 * Unlike the other base cases, the result is _not_ collapsed to an
+	 * ftl::function: it is a statically typed composition object through
+	 * which the compiler can inline the entire call chain. Assign it to an
+	 * ftl::function if type erasure is actually desired.
+	 *
+	 * \ingroup prelude
+	 */
+	template<typename F, typename G>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::composed<plain_type<F>,plain_type<G>>
+#else
+	ImplementationDefined
+#endif
+	compose(F&& f, G&& g) {
+		return _dtl::composed<plain_type<F>,plain_type<G>>(
+			std::forward<F>(f), std::forward<G>(g)
+		);
+	}
+
 	/**
 	 * Generalised, n-ary function composition.
 	 *
@@ -446,6 +507,21 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Flips a non-owning function reference; the referenced callable is not
+	 * copied, and must outlive the returned function.
+	 *
+	 * \ingroup prelude
+	 */
+	template<typename A, typename B, typename R>
+	function<R(B,A)> flip(function_ref<R(A,B)> f) {
+		return [f](B b, A a) {
+			return f(std::forward<A>(a), std::forward<B>(b));
+		};
+	}
+
 	/**
 	 * Flip parameter order of a curried binary function.
 	 *
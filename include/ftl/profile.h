@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PROFILE_H
+#define FTL_PROFILE_H
+
+#include <cstdint>
+
+#ifdef FTL_PROFILE
+#include <atomic>
+#endif
+
+namespace ftl {
+
+	/**
+	 * \defgroup profile Profile
+	 *
+	 * Opt-in instrumentation of FTL's hidden costs.
+	 *
+	 * \code
+	 *   #include <ftl/profile.h>
+	 * \endcode
+	 *
+	 * Some of FTL's conveniences have costs that are invisible at the call
+	 * site: an `ftl::function` quietly heap allocates when its target does
+	 * not fit the inline storage, every first dereference of a `lazy` runs
+	 * a deferred thunk, and `sum_type::match` performs a dynamic dispatch.
+	 * Compiling with `-DFTL_PROFILE` makes FTL count these events in a set
+	 * of process wide, thread safe counters:
+	 *
+	 * \code
+	 *   auto before = ftl::profile_snapshot();
+	 *   runWorkload();
+	 *   auto after = ftl::profile_snapshot();
+	 *
+	 *   std::cout
+	 *       << "heap allocated closures: "
+	 *       << after.function_heap_allocations
+	 *          - before.function_heap_allocations
+	 *       << std::endl;
+	 * \endcode
+	 *
+	 * Without `FTL_PROFILE`, the counting hooks are empty inline functions
+	 * and the query API always reports zero, so instrumented code compiles
+	 * and runs unchanged&mdash;there is no need to guard uses of this header
+	 * with the preprocessor.
+	 *
+	 * \par Dependencies
+	 * - <cstdint>
+	 * - <atomic> (only when `FTL_PROFILE` is defined)
+	 */
+
+	/**
+	 * Snapshot of the process wide instrumentation counters.
+	 *
+	 * All counts are cumulative since process start (or the most recent
+	 * profile_reset()). Take a snapshot before and one after the region of
+	 * interest and subtract.
+	 *
+	 * \ingroup profile
+	 */
+	struct profile_counters {
+		/// ftl::function constructions that fell back to the heap
+		uint64_t function_heap_allocations;
+
+		/// lazy/atomic_lazy thunks actually run (not mere accesses)
+		uint64_t lazy_thunk_forces;
+
+		/// sum_type::match dispatches
+		uint64_t sum_type_matches;
+	};
+
+	namespace _dtl {
+#ifdef FTL_PROFILE
+		inline std::atomic<uint64_t>& profile_function_heap_count() {
+			static std::atomic<uint64_t> count{0};
+			return count;
+		}
+
+		inline std::atomic<uint64_t>& profile_lazy_force_count() {
+			static std::atomic<uint64_t> count{0};
+			return count;
+		}
+
+		inline std::atomic<uint64_t>& profile_sum_type_match_count() {
+			static std::atomic<uint64_t> count{0};
+			return count;
+		}
+#endif
+
+		inline void profile_count_function_heap_allocation() noexcept {
+#ifdef FTL_PROFILE
+			profile_function_heap_count().fetch_add(
+				1, std::memory_order_relaxed
+			);
+#endif
+		}
+
+		inline void profile_count_lazy_force() noexcept {
+#ifdef FTL_PROFILE
+			profile_lazy_force_count().fetch_add(
+				1, std::memory_order_relaxed
+			);
+#endif
+		}
+
+		inline void profile_count_sum_type_match() noexcept {
+#ifdef FTL_PROFILE
+			profile_sum_type_match_count().fetch_add(
+				1, std::memory_order_relaxed
+			);
+#endif
+		}
+	}
+
+	/**
+	 * Query the current counter values.
+	 *
+	 * Always zero unless compiled with `FTL_PROFILE`.
+	 *
+	 * \ingroup profile
+	 */
+	inline profile_counters profile_snapshot() noexcept {
+#ifdef FTL_PROFILE
+		return profile_counters{
+			_dtl::profile_function_heap_count().load(
+				std::memory_order_relaxed
+			),
+			_dtl::profile_lazy_force_count().load(
+				std::memory_order_relaxed
+			),
+			_dtl::profile_sum_type_match_count().load(
+				std::memory_order_relaxed
+			)
+		};
+#else
+		return profile_counters{0, 0, 0};
+#endif
+	}
+
+	/**
+	 * Reset all counters to zero.
+	 *
+	 * \ingroup profile
+	 */
+	inline void profile_reset() noexcept {
+#ifdef FTL_PROFILE
+		_dtl::profile_function_heap_count().store(
+			0, std::memory_order_relaxed
+		);
+		_dtl::profile_lazy_force_count().store(
+			0, std::memory_order_relaxed
+		);
+		_dtl::profile_sum_type_match_count().store(
+			0, std::memory_order_relaxed
+		);
+#endif
+	}
+
+}
+
+#endif
+
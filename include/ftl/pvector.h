@@ -0,0 +1,547 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PVECTOR_H
+#define FTL_PVECTOR_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup pvector Persistent Vector
+	 *
+	 * An immutable vector with structural sharing.
+	 *
+	 * \code
+	 *   #include <ftl/pvector.h>
+	 * \endcode
+	 *
+	 * Functional style code over `std::vector` pays a full deep copy per
+	 * transformation whenever the old version must be preserved. An
+	 * ftl::pvector is a bit-partitioned trie in the style of Clojure's
+	 * persistent vectors: copying one is O(1) and shares the entire tree,
+	 * while updating an element path-copies only the O(log n) nodes
+	 * between root and leaf. Keeping hundreds of historical versions of a
+	 * large vector thus costs memory proportional to the _changes_, not to
+	 * versions times size.
+	 *
+	 * This module implements the following concepts for pvector:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<initializer_list>`
+	 * - `<iterator>`
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - \ref foldable
+	 * - \ref monad
+	 */
+
+	/**
+	 * A persistent vector with structural sharing.
+	 *
+	 * Elements live in the leaves of a 32-way trie, with the last partial
+	 * batch kept in a small tail buffer for amortised O(1) `push_back`.
+	 * Indexed access is O(log32 n)&mdash;effectively constant&mdash;and
+	 * \ref pvector::set "set" produces a _new_ vector in O(log32 n) by
+	 * path copying, leaving the original untouched and sharing everything
+	 * but the updated path.
+	 *
+	 * Mutating members (`push_back`, `emplace_back`, `insert`) have the
+	 * usual value semantics: they affect only this instance, path copying
+	 * any structure shared with other vectors. Copy construction is O(1)
+	 * and is the way to snapshot a version before transforming it.
+	 *
+	 * \par Concepts
+	 * - \ref copycons (O(1), shares structure)
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref fwditerable
+	 * - \ref eq, if `T` is EqualityComparable.
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	class pvector {
+		static constexpr size_t bits = 5;
+		static constexpr size_t width = 1 << bits;
+		static constexpr size_t mask = width - 1;
+
+		/* A node is either internal (children used, values empty) or a
+		 * leaf (values used, always exactly `width` elements).
+		 */
+		struct node {
+			std::vector<std::shared_ptr<node>> children;
+			std::vector<T> values;
+		};
+
+		using node_ptr = std::shared_ptr<node>;
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using const_reference = const T&;
+
+		class const_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+
+			reference operator* () const {
+				if(i < first || i >= last)
+					refresh();
+
+				return leaf[i - first];
+			}
+
+			pointer operator-> () const {
+				return &**this;
+			}
+
+			const_iterator& operator++ () {
+				++i;
+				return *this;
+			}
+
+			const_iterator operator++ (int) {
+				auto old = *this;
+				++i;
+				return old;
+			}
+
+			const_iterator& operator-- () {
+				--i;
+				return *this;
+			}
+
+			const_iterator operator-- (int) {
+				auto old = *this;
+				--i;
+				return old;
+			}
+
+			bool operator== (const const_iterator& other) const {
+				return i == other.i;
+			}
+
+			bool operator!= (const const_iterator& other) const {
+				return i != other.i;
+			}
+
+		private:
+			friend class pvector;
+
+			const_iterator(const pvector* v, size_t i) : v(v), i(i) {}
+
+			void refresh() const {
+				auto& vals = v->leaf_for(i);
+				leaf = vals.data();
+				first = i & ~mask;
+				last = first + vals.size();
+			}
+
+			const pvector* v = nullptr;
+			size_t i = 0;
+
+			// Cached leaf, so sequential iteration is mostly array walking
+			mutable const T* leaf = nullptr;
+			mutable size_t first = 0;
+			mutable size_t last = 0;
+		};
+
+		using iterator = const_iterator;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using reverse_iterator = const_reverse_iterator;
+
+		pvector() = default;
+		pvector(const pvector&) = default;
+		pvector(pvector&&) = default;
+		~pvector() = default;
+
+		pvector(std::initializer_list<T> elems) {
+			for(auto& e : elems)
+				push_back(e);
+		}
+
+		pvector& operator= (const pvector&) = default;
+		pvector& operator= (pvector&&) = default;
+
+		const_iterator begin() const noexcept {
+			return const_iterator{this, 0};
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{this, count};
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator{end()};
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator{begin()};
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_type size() const noexcept {
+			return count;
+		}
+
+		/// Indexed access, in O(log32 n).
+		const T& operator[] (size_t i) const {
+			return leaf_for(i)[i & mask];
+		}
+
+		const T& front() const {
+			return (*this)[0];
+		}
+
+		const T& back() const {
+			return tail.back();
+		}
+
+		/**
+		 * Append an element, in amortised O(1).
+		 *
+		 * Affects only this instance; structure shared with other vectors
+		 * is path copied as needed.
+		 */
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			if(tail.size() == width)
+				push_tail();
+
+			tail.emplace_back(std::forward<Args>(args)...);
+			++count;
+		}
+
+		void push_back(const T& t) {
+			emplace_back(t);
+		}
+
+		void push_back(T&& t) {
+			emplace_back(std::move(t));
+		}
+
+		/**
+		 * Insert an element before the given position.
+		 *
+		 * Amortised O(1) at the end; anywhere else the vector is rebuilt
+		 * in O(n). Chiefly present to satisfy the container interface the
+		 * concept machinery expects; persistent code should prefer
+		 * `push_back` and `set`.
+		 *
+		 * \return An iterator to the inserted element.
+		 */
+		const_iterator insert(const_iterator pos, const T& t) {
+			if(pos.i == count) {
+				push_back(t);
+				return const_iterator{this, count - 1};
+			}
+
+			pvector r;
+			for(size_t j = 0; j < pos.i; ++j)
+				r.push_back((*this)[j]);
+
+			r.push_back(t);
+			for(size_t j = pos.i; j < count; ++j)
+				r.push_back((*this)[j]);
+
+			*this = std::move(r);
+			return const_iterator{this, pos.i};
+		}
+
+		/**
+		 * Produce a new vector with the element at `i` replaced.
+		 *
+		 * O(log32 n): only the path from root to the affected leaf is
+		 * copied; everything else is shared with this vector, which is
+		 * left unmodified.
+		 */
+		pvector set(size_t i, T t) const {
+			pvector r{*this};
+
+			if(i >= r.tail_offset())
+				r.tail[i & mask] = std::move(t);
+			else
+				r.root = set_in(r.root, r.shift, i, std::move(t));
+
+			return r;
+		}
+
+	private:
+		// Index of the first element held in the tail buffer
+		size_t tail_offset() const noexcept {
+			return count - tail.size();
+		}
+
+		const std::vector<T>& leaf_for(size_t i) const {
+			if(i >= tail_offset())
+				return tail;
+
+			node* n = root.get();
+			for(size_t s = shift; s > 0; s -= bits)
+				n = n->children[(i >> s) & mask].get();
+
+			return n->values;
+		}
+
+		// Wrap a leaf in enough single-child nodes to sit at depth `s`
+		static node_ptr path_to(size_t s, node_ptr leaf) {
+			while(s > 0) {
+				auto p = std::make_shared<node>();
+				p->children.push_back(std::move(leaf));
+				leaf = std::move(p);
+				s -= bits;
+			}
+
+			return leaf;
+		}
+
+		static node_ptr push_leaf(
+				const node_ptr& n, size_t s, size_t i, node_ptr leaf) {
+			auto c = std::make_shared<node>(*n);
+			size_t slot = (i >> s) & mask;
+
+			if(s == bits) {
+				c->children.push_back(std::move(leaf));
+			}
+			else if(slot < c->children.size()) {
+				c->children[slot] =
+					push_leaf(c->children[slot], s - bits, i, std::move(leaf));
+			}
+			else {
+				c->children.push_back(path_to(s - bits, std::move(leaf)));
+			}
+
+			return c;
+		}
+
+		// Move the full tail buffer into the trie
+		void push_tail() {
+			auto leaf = std::make_shared<node>();
+			leaf->values = std::move(tail);
+			tail.clear();
+
+			size_t tree_size = count - width;
+
+			if(!root) {
+				root = std::move(leaf);
+				return;
+			}
+
+			if(tree_size == (size_t(1) << (shift + bits))) {
+				// Trie is full; grow a new root on top
+				auto r = std::make_shared<node>();
+				r->children.push_back(std::move(root));
+				r->children.push_back(path_to(shift, std::move(leaf)));
+				root = std::move(r);
+				shift += bits;
+			}
+			else {
+				root = push_leaf(root, shift, tree_size, std::move(leaf));
+			}
+		}
+
+		static node_ptr set_in(const node_ptr& n, size_t s, size_t i, T t) {
+			auto c = std::make_shared<node>(*n);
+
+			if(s == 0)
+				c->values[i & mask] = std::move(t);
+			else {
+				size_t slot = (i >> s) & mask;
+				c->children[slot] = set_in(c->children[slot], s - bits, i,
+						std::move(t));
+			}
+
+			return c;
+		}
+
+		node_ptr root;
+		std::vector<T> tail;
+		size_type count = 0;
+		size_type shift = 0;
+	};
+
+	template<typename T>
+	bool operator== (const pvector<T>& v1, const pvector<T>& v2) {
+		return v1.size() == v2.size()
+			&& std::equal(v1.begin(), v1.end(), v2.begin());
+	}
+
+	template<typename T>
+	bool operator!= (const pvector<T>& v1, const pvector<T>& v2) {
+		return !(v1 == v2);
+	}
+
+	/**
+	 * Monoid implementation for pvector.
+	 *
+	 * The identity element is the empty vector; append concatenates.
+	 * Concatenation pushes the right operand's elements onto (a copy of)
+	 * the left, so it is O(n log n) in the size of the right operand, but
+	 * shares all of the left operand's structure.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct monoid<pvector<T>> {
+		static pvector<T> id() {
+			return pvector<T>();
+		}
+
+		static pvector<T> append(
+				const pvector<T>& v1, const pvector<T>& v2) {
+			auto v3 = v1;
+			for(auto& e : v2)
+				v3.push_back(e);
+
+			return v3;
+		}
+
+		static pvector<T> append(pvector<T>&& v1, const pvector<T>& v2) {
+			for(auto& e : v2)
+				v1.push_back(e);
+
+			return std::move(v1);
+		}
+
+		static pvector<T> append(const pvector<T>& v1, pvector<T>&& v2) {
+			if(v1.empty())
+				return std::move(v2);
+
+			return append(v1, static_cast<const pvector<T>&>(v2));
+		}
+
+		static pvector<T> append(pvector<T>&& v1, pvector<T>&& v2) {
+			if(v1.empty())
+				return std::move(v2);
+
+			return append(std::move(v1), static_cast<const pvector<T>&>(v2));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad implementation for pvector.
+	 *
+	 * Behaves like the other container monads: a pvector models a
+	 * nondeterministic computation with many possible results.
+	 *
+	 * Written by hand rather than derived, because the deriving mixins
+	 * assume in-place element mutation, which an immutable container does
+	 * not offer.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct monad<pvector<T>>
+	: deriving_join<in_terms_of_bind<pvector<T>>>
+	, deriving_apply<in_terms_of_bind<pvector<T>>> {
+
+		template<typename U>
+		using p = pvector<U>;
+
+		static p<T> pure(const T& t) {
+			return p<T>{t};
+		}
+
+		static p<T> pure(T&& t) {
+			return p<T>{std::move(t)};
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static p<U> map(F&& f, const p<T>& v) {
+			p<U> r;
+			for(auto& e : v)
+				r.push_back(f(e));
+
+			return r;
+		}
+
+		template<
+				typename F,
+				typename Cu = result_of<F(T)>,
+				typename U = Value_type<Cu>,
+				typename = Requires<ForwardIterable<Cu>()>
+		>
+		static p<U> bind(const p<T>& v, F&& f) {
+			p<U> r;
+			for(auto& e : v) {
+				auto c = f(e);
+				for(auto& u : c)
+					r.push_back(std::move(u));
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for pvector.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct foldable<pvector<T>>
+	: deriving_foldable<bidirectional_iterable<pvector<T>>> {};
+
+}
+
+#endif
+
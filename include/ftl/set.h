@@ -106,7 +106,7 @@ namespace ftl {
 				const std::set<T,Cmp,A>& s2) {
 
 			s1.insert(s2.begin(), s2.end());
-			return s1;
+			return std::move(s1);
 		}
 
 		static std::set<T,Cmp,A> append(
@@ -114,7 +114,7 @@ namespace ftl {
 				std::set<T,Cmp,A>&& s2) {
 
 			s2.insert(s1.begin(), s1.end());
-			return s2;
+			return std::move(s2);
 		}
 
 		static std::set<T,Cmp,A> append(
@@ -124,13 +124,13 @@ namespace ftl {
 			if(s1.size() > s2.size()) {
 				s1.insert(s2.begin(), s2.end());
 
-				return s1;
+				return std::move(s1);
 			}
 
 			else {
 				s2.insert(s1.begin(), s1.end());
 
-				return s2;
+				return std::move(s2);
 			}
 		}
 
@@ -188,8 +188,11 @@ namespace ftl {
 		template<typename F, typename U = result_of<F(T)>>
 		static set<U> map(F&& f, const set<T>& s) {
 			set<U> rs;
+			// When f preserves the element order, hinting at end() makes
+			// every insertion amortized O(1); when it does not, the hint is
+			// simply ignored at the cost of one extra comparison
 			for(const auto& e : s) {
-				rs.insert(f(e));
+				rs.insert(rs.end(), f(e));
 			}
 
 			return rs;
@@ -200,7 +203,7 @@ namespace ftl {
 		static set<U> map(F&& f, set<T>&& s) {
 			set<U> rs;
 			for(auto& e : s) {
-				rs.insert(f(std::move(e)));
+				rs.insert(rs.end(), f(std::move(e)));
 			}
 
 			return rs;
@@ -249,11 +252,14 @@ namespace ftl {
 	/**
 	 * Foldable instance for `std::set`.
 	 *
+	 * Derived with node prefetching, since walking the tree is a cache
+	 * miss per element otherwise.
+	 *
 	 * \ingroup set
 	 */
 	template<typename T, typename C, typename A>
 	struct foldable<std::set<T,C,A>>
-	: deriving_foldable<bidirectional_iterable<std::set<T,C,A>>> {};
+	: deriving_foldable<node_based_container<std::set<T,C,A>>> {};
 
 }
 
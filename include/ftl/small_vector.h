@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SMALL_VECTOR_H
+#define FTL_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup smallvector Small Vector
+	 *
+	 * A vector with inline storage and full concept coverage.
+	 *
+	 * \code
+	 *   #include <ftl/small_vector.h>
+	 * \endcode
+	 *
+	 * Functorial values are usually tiny&mdash;a handful of alternatives
+	 * in a non-deterministic computation, a few intermediate results&mdash;
+	 * yet `std::vector` pays a heap allocation for every one of them.
+	 * ftl::small_vector stores up to `N` elements inline in the object
+	 * itself and only spills to the heap beyond that, so monadic and
+	 * applicative code over small collections never allocates.
+	 *
+	 * This module implements the following concepts for small_vector:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<initializer_list>`
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 */
+
+	/**
+	 * A contiguous vector with inline capacity for `N` elements.
+	 *
+	 * Behaves like a pared down `std::vector`, except the first `N`
+	 * elements live in the object itself. Only when the size exceeds `N`
+	 * does the buffer move to the heap, where it doubles as it grows. A
+	 * spilled vector never moves back inline.
+	 *
+	 * All of the container concept instances&mdash;functor, applicative,
+	 * monad, and friends&mdash;behave exactly as their `std::vector`
+	 * counterparts; the only difference is where the elements live.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref fwditerable
+	 * - \ref eq, if `T` is EqualityComparable.
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N = 8>
+	class small_vector {
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		small_vector() noexcept : elems(inlineData()) {}
+
+		small_vector(std::initializer_list<T> l) : small_vector() {
+			reserve(l.size());
+			for(const auto& e : l)
+				::new (elems + sz++) T(e);
+		}
+
+		small_vector(const small_vector& other) : elems(inlineData()) {
+			reserve(other.sz);
+			for(size_t i = 0; i < other.sz; ++i)
+				::new (elems + i) T(other.elems[i]);
+
+			sz = other.sz;
+		}
+
+		small_vector(small_vector&& other) : elems(inlineData()) {
+			if(other.onHeap()) {
+				// Steal the heap buffer outright
+				elems = other.elems;
+				sz = other.sz;
+				cap = other.cap;
+				other.elems = other.inlineData();
+				other.sz = 0;
+				other.cap = N;
+			}
+			else {
+				for(size_t i = 0; i < other.sz; ++i)
+					::new (elems + i) T(std::move(other.elems[i]));
+
+				sz = other.sz;
+				other.clear();
+			}
+		}
+
+		~small_vector() {
+			clear();
+			if(onHeap())
+				::operator delete(elems);
+		}
+
+		small_vector& operator= (const small_vector& other) {
+			if(this != std::addressof(other)) {
+				clear();
+				reserve(other.sz);
+				for(size_t i = 0; i < other.sz; ++i)
+					::new (elems + i) T(other.elems[i]);
+
+				sz = other.sz;
+			}
+
+			return *this;
+		}
+
+		small_vector& operator= (small_vector&& other) {
+			if(this != std::addressof(other)) {
+				clear();
+				if(onHeap()) {
+					::operator delete(elems);
+					elems = inlineData();
+					cap = N;
+				}
+
+				if(other.onHeap()) {
+					elems = other.elems;
+					sz = other.sz;
+					cap = other.cap;
+					other.elems = other.inlineData();
+					other.sz = 0;
+					other.cap = N;
+				}
+				else {
+					for(size_t i = 0; i < other.sz; ++i)
+						::new (elems + i) T(std::move(other.elems[i]));
+
+					sz = other.sz;
+					other.clear();
+				}
+			}
+
+			return *this;
+		}
+
+		iterator begin() noexcept {
+			return elems;
+		}
+
+		const_iterator begin() const noexcept {
+			return elems;
+		}
+
+		iterator end() noexcept {
+			return elems + sz;
+		}
+
+		const_iterator end() const noexcept {
+			return elems + sz;
+		}
+
+		T* data() noexcept {
+			return elems;
+		}
+
+		const T* data() const noexcept {
+			return elems;
+		}
+
+		size_type size() const noexcept {
+			return sz;
+		}
+
+		bool empty() const noexcept {
+			return sz == 0;
+		}
+
+		size_type capacity() const noexcept {
+			return cap;
+		}
+
+		/// Whether the elements currently live in the inline buffer.
+		bool inline_storage() const noexcept {
+			return !onHeap();
+		}
+
+		reference operator[] (size_type i) {
+			return elems[i];
+		}
+
+		const_reference operator[] (size_type i) const {
+			return elems[i];
+		}
+
+		reference front() {
+			return elems[0];
+		}
+
+		const_reference front() const {
+			return elems[0];
+		}
+
+		reference back() {
+			return elems[sz-1];
+		}
+
+		const_reference back() const {
+			return elems[sz-1];
+		}
+
+		void push_back(const T& e) {
+			if(sz == cap)
+				growAndConstruct(e);
+			else
+				::new (elems + sz) T(e);
+
+			++sz;
+		}
+
+		void push_back(T&& e) {
+			if(sz == cap)
+				growAndConstruct(std::move(e));
+			else
+				::new (elems + sz) T(std::move(e));
+
+			++sz;
+		}
+
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			if(sz == cap)
+				growAndConstruct(std::forward<Args>(args)...);
+			else
+				::new (elems + sz) T(std::forward<Args>(args)...);
+
+			++sz;
+		}
+
+		void pop_back() {
+			elems[--sz].~T();
+		}
+
+		/// Insert an element before `pos`, shifting the tail one slot.
+		iterator insert(const_iterator pos, const T& e) {
+			return insertAt(pos, e);
+		}
+
+		/// \overload
+		iterator insert(const_iterator pos, T&& e) {
+			return insertAt(pos, std::move(e));
+		}
+
+		/// Grow the buffer to hold at least `n` elements without spilling.
+		void reserve(size_type n) {
+			if(n > cap)
+				grow(n);
+		}
+
+		void clear() noexcept {
+			for(size_t i = 0; i < sz; ++i)
+				elems[i].~T();
+
+			sz = 0;
+		}
+
+		bool operator== (const small_vector& other) const {
+			return sz == other.sz
+				&& std::equal(begin(), end(), other.begin());
+		}
+
+		bool operator!= (const small_vector& other) const {
+			return !(*this == other);
+		}
+
+	private:
+		T* inlineData() noexcept {
+			return reinterpret_cast<T*>(inlineStorage);
+		}
+
+		bool onHeap() const noexcept {
+			return elems != reinterpret_cast<const T*>(inlineStorage);
+		}
+
+		template<typename E>
+		iterator insertAt(const_iterator pos, E&& e) {
+			auto i = static_cast<size_t>(pos - elems);
+			if(sz == cap)
+				grow(cap * 2);
+
+			if(i < sz) {
+				// Shift the tail one slot right, back to front
+				::new (elems + sz) T(std::move(elems[sz-1]));
+				for(size_t j = sz - 1; j > i; --j)
+					elems[j] = std::move(elems[j-1]);
+
+				elems[i] = std::forward<E>(e);
+			}
+			else {
+				::new (elems + i) T(std::forward<E>(e));
+			}
+
+			++sz;
+			return elems + i;
+		}
+
+		void grow(size_type newCap) {
+			auto bigger = static_cast<T*>(
+				::operator new(newCap * sizeof(T))
+			);
+
+			for(size_t i = 0; i < sz; ++i) {
+				::new (bigger + i) T(std::move(elems[i]));
+				elems[i].~T();
+			}
+
+			if(onHeap())
+				::operator delete(elems);
+
+			elems = bigger;
+			cap = newCap;
+		}
+
+		/* Append at capacity: the new element is constructed into the new
+		 * allocation _before_ the old elements are moved out of the old
+		 * one, so arguments referring into the vector itself&mdash;
+		 * v.push_back(v[0])&mdash;stay valid across the growth, as they do
+		 * for std::vector. A throw from the construction leaves the vector
+		 * untouched.
+		 */
+		template<typename...Args>
+		void growAndConstruct(Args&&...args) {
+			auto newCap = cap * 2;
+			auto bigger = static_cast<T*>(
+				::operator new(newCap * sizeof(T))
+			);
+
+			try {
+				::new (bigger + sz) T(std::forward<Args>(args)...);
+			}
+			catch(...) {
+				::operator delete(bigger);
+				throw;
+			}
+
+			for(size_t i = 0; i < sz; ++i) {
+				::new (bigger + i) T(std::move(elems[i]));
+				elems[i].~T();
+			}
+
+			if(onHeap())
+				::operator delete(elems);
+
+			elems = bigger;
+			cap = newCap;
+		}
+
+		typename std::aligned_storage<
+			sizeof(T), alignof(T)
+		>::type inlineStorage[N];
+
+		T* elems;
+		size_t sz = 0;
+		size_t cap = N;
+	};
+
+	template<typename T, size_t N>
+	struct parametric_type_traits<small_vector<T,N>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = small_vector<U,N>;
+	};
+
+	// The generic is_same_template cannot see past small_vector's non-type
+	// capacity parameter, so spell the answer out: two small_vectors are
+	// the same base template regardless of T and N.
+	template<typename T, size_t N, typename U, size_t M>
+	struct is_same_template<small_vector<T,N>,small_vector<U,M>> {
+		static constexpr bool value = true;
+	};
+
+	/**
+	 * Monoid implementation for small_vector.
+	 *
+	 * Essentially equivalent of monoid<std::vector<T>>.
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N>
+	struct monoid<small_vector<T,N>> {
+		static small_vector<T,N> id() noexcept {
+			return small_vector<T,N>{};
+		}
+
+		static small_vector<T,N> append(
+				const small_vector<T,N>& v1,
+				const small_vector<T,N>& v2) {
+
+			small_vector<T,N> rv;
+			rv.reserve(v1.size() + v2.size());
+			for(const auto& e : v1)
+				rv.push_back(e);
+
+			for(const auto& e : v2)
+				rv.push_back(e);
+
+			return rv;
+		}
+
+		static small_vector<T,N> append(
+				small_vector<T,N>&& v1,
+				const small_vector<T,N>& v2) {
+
+			v1.reserve(v1.size() + v2.size());
+			for(const auto& e : v2)
+				v1.push_back(e);
+
+			return std::move(v1);
+		}
+
+		static small_vector<T,N> append(
+				const small_vector<T,N>& v1,
+				small_vector<T,N>&& v2) {
+
+			// Prepending into v2 would shift its tail once per element, so
+			// a fresh result is cheaper despite forfeiting v2's buffer
+			small_vector<T,N> rv;
+			rv.reserve(v1.size() + v2.size());
+			for(const auto& e : v1)
+				rv.push_back(e);
+
+			for(auto& e : v2)
+				rv.push_back(std::move(e));
+
+			return rv;
+		}
+
+		static small_vector<T,N> append(
+				small_vector<T,N>&& v1,
+				small_vector<T,N>&& v2) {
+
+			v1.reserve(v1.size() + v2.size());
+			for(auto& e : v2)
+				v1.push_back(std::move(e));
+
+			return std::move(v1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Accumulator instance for small_vector.
+	 *
+	 * Splices new elements onto the end of the accumulator in place, just
+	 * like the std::vector instance.
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N>
+	struct accumulator<small_vector<T,N>> {
+		static void append_to(
+				small_vector<T,N>& v1,
+				const small_vector<T,N>& v2) {
+
+			v1.reserve(v1.size() + v2.size());
+			for(const auto& e : v2)
+				v1.push_back(e);
+		}
+
+		static void append_to(
+				small_vector<T,N>& v1,
+				small_vector<T,N>&& v2) {
+
+			if(v1.empty())
+				v1 = std::move(v2);
+
+			else {
+				v1.reserve(v1.size() + v2.size());
+				for(auto& e : v2)
+					v1.push_back(std::move(e));
+			}
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad instance for small_vector.
+	 *
+	 * Semantically identical to the std::vector instance: the usual
+	 * non-deterministic computation view, with `pure` producing a one
+	 * element vector&mdash;which, of course, lives entirely inline.
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N>
+	struct monad<small_vector<T,N>>
+	: deriving_monad<back_insertable_container<small_vector<T,N>>> {
+
+		/**
+		 * Cartesian apply with product size preallocation.
+		 *
+		 * As with std::vector, the result's size is known to be exactly
+		 * `fs.size() * v.size()` up front, so it is reserved in one step.
+		 */
+		template<
+				typename Mf,
+				typename F = Value_type<plain_type<Mf>>,
+				typename U = result_of<F(T)>
+		>
+		static small_vector<U,N> apply(
+				Mf&& fs, const small_vector<T,N>& v) {
+			small_vector<U,N> r;
+			r.reserve(fs.size() * v.size());
+
+			for(auto& f : fs) {
+				for(auto& x : v)
+					r.push_back(f(x));
+			}
+
+			return r;
+		}
+	};
+
+	/**
+	 * Foldable instance for small_vector.
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N>
+	struct foldable<small_vector<T,N>>
+	: deriving_foldable<bidirectional_iterable<small_vector<T,N>>> {};
+
+	/**
+	 * Zippable instance for small_vector.
+	 *
+	 * As with std::vector, a small_vector can be zipped with any
+	 * \ref fwditerable, not only other small_vectors.
+	 *
+	 * \ingroup smallvector
+	 */
+	template<typename T, size_t N>
+	struct zippable<small_vector<T,N>>
+	: deriving_zippable<back_insertable_container<small_vector<T,N>>> {};
+
+}
+
+#endif
+
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_STREAM_H
+#define FTL_STREAM_H
+
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "function.h"
+#include "maybe.h"
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup stream Stream
+	 *
+	 * Lazy, possibly infinite sequences with chunked evaluation.
+	 *
+	 * \code
+	 *   #include <ftl/stream.h>
+	 * \endcode
+	 *
+	 * \ref lazy covers single deferred values, but generate-transform-take
+	 * pipelines over sequences have so far had to materialise a bounded
+	 * container up front, computing every element whether the consumer
+	 * looks at it or not. An ftl::stream is the sequence analogue of
+	 * `lazy`: nothing is computed until demanded, demanded prefixes are
+	 * memoised and shared, and the rest of the sequence is never touched.
+	 *
+	 * Rather than paying one heap-allocated thunk per element, a stream
+	 * evaluates in chunks of \ref stream::chunk_size "chunk_size"
+	 * elements: forcing any element of a chunk computes the whole chunk
+	 * into a contiguous buffer. Consumers that stop early waste at most
+	 * one chunk of work, while consumers that do iterate get
+	 * cache-friendly, allocation-light traversal.
+	 *
+	 * This module implements the following concepts for stream:
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 *
+	 * \par Dependencies
+	 * - `<initializer_list>`
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - \ref function
+	 * - \ref maybe
+	 * - \ref foldable
+	 * - \ref monad
+	 */
+
+	/**
+	 * A lazy, possibly infinite sequence.
+	 *
+	 * Structurally, a stream is a chain of suspended _chunks_: vectors of
+	 * up to `chunk_size` elements, each followed by a thunk producing the
+	 * next chunk on demand. Forcing is memoised, so a prefix is computed
+	 * at most once no matter how many copies of the stream observe it;
+	 * copies are O(1) and share all structure.
+	 *
+	 * Streams are created with the \ref stream::iterate "iterate" and
+	 * \ref stream::unfold "unfold" factories (or an initializer list for
+	 * small finite ones) and consumed through `take`/`takeWhile`, \ref
+	 * stream::head "head", or any \ref foldablepg operation&mdash;the
+	 * latter only on provably finite streams, naturally.
+	 *
+	 * Like \ref lazy "lazy", forcing is not synchronised; share a stream
+	 * between threads only with external synchronisation.
+	 *
+	 * \par Concepts
+	 * - \ref copycons (O(1), shares structure)
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	class stream {
+		struct cell;
+		using cell_ptr = std::shared_ptr<cell>;
+
+		// A memoised suspension of one chunk
+		struct susp {
+			function<cell_ptr()> thunk;
+			cell_ptr val;
+			bool forced = false;
+		};
+
+		using susp_ptr = std::shared_ptr<susp>;
+
+		struct cell {
+			std::vector<T> chunk;
+			susp_ptr tail;	// nullptr = stream ends after this chunk
+		};
+
+	public:
+		using value_type = T;
+
+		/// Number of elements computed per forced thunk.
+		static constexpr size_t chunk_size = 64;
+
+		/// The empty stream.
+		stream() = default;
+
+		stream(const stream&) = default;
+		stream(stream&&) = default;
+		~stream() = default;
+
+		/// Construct a small, finite, already evaluated stream.
+		stream(std::initializer_list<T> l) {
+			std::vector<T> v(l);
+
+			susp_ptr tail = nullptr;
+			size_t n = v.size();
+			while(n > 0) {
+				size_t start = (n-1) - (n-1) % chunk_size;
+
+				auto c = std::make_shared<cell>();
+				c->chunk.assign(v.begin() + start, v.begin() + n);
+				c->tail = std::move(tail);
+
+				tail = std::make_shared<susp>();
+				tail->val = std::move(c);
+				tail->forced = true;
+
+				n = start;
+			}
+
+			s = std::move(tail);
+		}
+
+		stream& operator= (const stream&) = default;
+		stream& operator= (stream&&) = default;
+
+		/**
+		 * The infinite stream `x, f(x), f(f(x)), ...`
+		 *
+		 * Nothing is computed until the stream is consumed; consumption
+		 * applies `f` in bursts of `chunk_size`.
+		 */
+		template<typename F>
+		static stream iterate(T x, F f) {
+			return stream{make_susp(function<cell_ptr()>{
+				[x,f]() -> cell_ptr {
+					auto c = std::make_shared<cell>();
+					c->chunk.reserve(chunk_size);
+
+					T cur = x;
+					for(size_t i = 0; i < chunk_size; ++i) {
+						c->chunk.push_back(cur);
+						cur = f(cur);
+					}
+
+					c->tail = iterate(std::move(cur), f).s;
+					return c;
+				}
+			})};
+		}
+
+		/**
+		 * Build a stream from a seed, anamorphism style.
+		 *
+		 * `f` must map an `S` to a `maybe<std::pair<T,S>>`: `nothing`
+		 * ends the stream, while a value yields the next element and the
+		 * next seed. Equivalent to Haskell's `unfoldr`.
+		 */
+		template<typename S, typename F>
+		static stream unfold(S seed, F f) {
+			return stream{make_susp(function<cell_ptr()>{
+				[seed,f]() -> cell_ptr {
+					auto c = std::make_shared<cell>();
+					c->chunk.reserve(chunk_size);
+
+					S cur = seed;
+					while(c->chunk.size() < chunk_size) {
+						auto r = f(cur);
+						if(!r)
+							return c->chunk.empty() ? nullptr : c;
+
+						c->chunk.push_back(std::move((*r).first));
+						cur = std::move((*r).second);
+					}
+
+					c->tail = unfold(std::move(cur), f).s;
+					return c;
+				}
+			})};
+		}
+
+		/// The first element, or `nothing` if the stream is empty.
+		maybe<T> head() const {
+			auto c = s ? force(s) : nullptr;
+			if(!c)
+				return maybe<T>{};
+
+			return value(c->chunk.front());
+		}
+
+		/**
+		 * At most the first `n` elements, as a stream.
+		 *
+		 * Lazy: nothing is forced until the result is consumed, and no
+		 * chunk beyond the `n`th element is ever computed.
+		 */
+		stream take(size_t n) const {
+			auto src = s;
+			return stream{make_susp(function<cell_ptr()>{
+				[src,n]() -> cell_ptr {
+					auto c = (n > 0 && src) ? force(src) : nullptr;
+					if(!c)
+						return nullptr;
+
+					auto r = std::make_shared<cell>();
+					if(n < c->chunk.size()) {
+						r->chunk.assign(
+							c->chunk.begin(), c->chunk.begin() + n
+						);
+					}
+					else {
+						r->chunk = c->chunk;
+						if(n > c->chunk.size() && c->tail) {
+							r->tail = stream{c->tail}
+								.take(n - c->chunk.size()).s;
+						}
+					}
+
+					return r;
+				}
+			})};
+		}
+
+		/**
+		 * The longest prefix whose elements all satisfy `pred`.
+		 *
+		 * Lazy, like \ref stream::take "take".
+		 */
+		template<typename F>
+		stream takeWhile(F pred) const {
+			auto src = s;
+			return stream{make_susp(function<cell_ptr()>{
+				[src,pred]() -> cell_ptr {
+					auto c = src ? force(src) : nullptr;
+					if(!c)
+						return nullptr;
+
+					auto r = std::make_shared<cell>();
+					for(auto& t : c->chunk) {
+						if(!pred(t))
+							return r->chunk.empty() ? nullptr : r;
+
+						r->chunk.push_back(t);
+					}
+
+					if(c->tail)
+						r->tail = stream{c->tail}.takeWhile(pred).s;
+
+					return r;
+				}
+			})};
+		}
+
+	private:
+		explicit stream(susp_ptr s) : s(std::move(s)) {}
+
+		static susp_ptr make_susp(function<cell_ptr()> thunk) {
+			auto sp = std::make_shared<susp>();
+			sp->thunk = std::move(thunk);
+			return sp;
+		}
+
+		static const cell_ptr& force(const susp_ptr& sp) {
+			if(!sp->forced) {
+				sp->val = sp->thunk();
+				sp->thunk = function<cell_ptr()>{};
+				sp->forced = true;
+			}
+
+			return sp->val;
+		}
+
+		// Lazily map a chunk at a time
+		template<typename U, typename F>
+		static typename stream<U>::susp_ptr map_susp(susp_ptr src, F f) {
+			using rcell_ptr = typename stream<U>::cell_ptr;
+
+			return stream<U>::make_susp(function<rcell_ptr()>{
+				[src,f]() -> rcell_ptr {
+					auto c = src ? force(src) : nullptr;
+					if(!c)
+						return nullptr;
+
+					auto r = std::make_shared<typename stream<U>::cell>();
+					r->chunk.reserve(c->chunk.size());
+					for(auto& t : c->chunk)
+						r->chunk.push_back(f(t));
+
+					if(c->tail)
+						r->tail = map_susp<U>(c->tail, f);
+
+					return r;
+				}
+			});
+		}
+
+		// Lazily concatenate; the continuation is not even constructed
+		// until the first operand runs out
+		static susp_ptr append_susp(
+				susp_ptr a, function<susp_ptr()> rest) {
+			return make_susp(function<cell_ptr()>{
+				[a,rest]() -> cell_ptr {
+					auto c = a ? force(a) : nullptr;
+					if(!c) {
+						auto b = rest();
+						return b ? force(b) : nullptr;
+					}
+
+					auto r = std::make_shared<cell>(*c);
+					r->tail = append_susp(c->tail, rest);
+					return r;
+				}
+			});
+		}
+
+		template<typename>
+		friend class stream;
+
+		template<typename>
+		friend struct monad;
+
+		template<typename>
+		friend struct foldable;
+
+		susp_ptr s;
+	};
+
+	/**
+	 * Monad instance for stream.
+	 *
+	 * All of `map`, `bind` and the derived operations are lazy: they
+	 * return immediately, and their cost is paid chunk by chunk as the
+	 * result is consumed.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct monad<stream<T>>
+	: deriving_join<in_terms_of_bind<stream<T>>>
+	, deriving_apply<in_terms_of_bind<stream<T>>> {
+
+		/// Type alias for cleaner type signatures.
+		template<typename U>
+		using s = stream<U>;
+
+		static s<T> pure(const T& t) {
+			return s<T>{t};
+		}
+
+		static s<T> pure(T&& t) {
+			return s<T>{std::move(t)};
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static s<U> map(F&& f, const s<T>& strm) {
+			return s<U>{s<T>::template map_susp<U>(strm.s, f)};
+		}
+
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static s<U> bind(const s<T>& strm, F f) {
+			return s<U>{bind_susp(strm.s, 0, f)};
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		// The stream of f applied to every element from (c,i) onwards,
+		// all concatenated. Forces one source chunk at a time.
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
+		static typename stream<U>::susp_ptr bind_susp(
+				typename stream<T>::susp_ptr src, size_t i, F f) {
+			using rsusp_ptr = typename stream<U>::susp_ptr;
+			using rcell_ptr = typename stream<U>::cell_ptr;
+
+			return stream<U>::make_susp(function<rcell_ptr()>{
+				[src,i,f]() -> rcell_ptr {
+					auto c = src ? stream<T>::force(src) : nullptr;
+					if(!c || i >= c->chunk.size()) {
+						if(!c || !c->tail)
+							return nullptr;
+
+						auto cont = bind_susp(c->tail, 0, f);
+						return stream<U>::force(cont);
+					}
+
+					auto inner = f(c->chunk[i]).s;
+					auto rest = stream<U>::append_susp(
+						inner,
+						function<rsusp_ptr()>{
+							[src,i,f]() {
+								return bind_susp(src, i+1, f);
+							}
+						}
+					);
+
+					return stream<U>::force(rest);
+				}
+			});
+		}
+	};
+
+	/**
+	 * Foldable instance for stream.
+	 *
+	 * The folds force the entire stream, so they terminate only on
+	 * finite streams; `take`/`takeWhile` an infinite one first.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct foldable<stream<T>>
+	: deriving_fold<stream<T>>, deriving_foldMap<stream<T>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const stream<T>& strm) {
+			auto sp = strm.s;
+			while(sp) {
+				auto c = stream<T>::force(sp);
+				if(!c)
+					break;
+
+				for(auto& t : c->chunk)
+					z = f(z, t);
+
+				sp = c->tail;
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const stream<T>& strm) {
+			std::vector<const T*> elems;
+
+			auto sp = strm.s;
+			while(sp) {
+				auto c = stream<T>::force(sp);
+				if(!c)
+					break;
+
+				for(auto& t : c->chunk)
+					elems.push_back(&t);
+
+				sp = c->tail;
+			}
+
+			for(auto it = elems.rbegin(); it != elems.rend(); ++it)
+				z = f(**it, z);
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
+
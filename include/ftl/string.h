@@ -23,7 +23,11 @@
 #ifndef FTL_STRING_H
 #define FTL_STRING_H
 
+#include <cctype>
+#include <memory>
 #include <string>
+#include <vector>
+#include "concepts/functor.h"
 #include "concepts/monoid.h"
 
 namespace ftl {
@@ -34,7 +38,9 @@ namespace ftl {
 	 * Concept implementations for the standard string classes.
 	 *
 	 * \par Dependencies
+	 * - <cctype>
 	 * - <string>
+	 * - \ref functor
 	 * - \ref monoid
 	 */
 
@@ -75,7 +81,7 @@ namespace ftl {
 				const std::basic_string<Ts...>& s2) {
 
 			s1 += s2;
-			return s1;
+			return std::move(s1);
 		}
 
 		static std::basic_string<Ts...> append(
@@ -83,15 +89,387 @@ namespace ftl {
 				std::basic_string<Ts...>&& s2) {
 
 			s2.insert(s2.begin(), s1.begin(), s1.end());
-			return s2;
+			return std::move(s2);
 		}
 
 		static std::basic_string<Ts...> append(
 				std::basic_string<Ts...>&& s1,
 				std::basic_string<Ts...>&& s2) {
 
-			std::move(s2.begin(), s2.end(), std::back_inserter(s1));
-			return s1;
+			s1 += s2;
+			return std::move(s1);
+		}
+
+		static constexpr bool instance = true;
+
+	};
+
+	template<typename CharT, typename Traits, typename A>
+	struct parametric_type_traits<std::basic_string<CharT,Traits,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = CharT;
+
+		template<typename U>
+		using rebind
+			= std::basic_string<U,std::char_traits<U>,rebind_allocator<U>>;
+	};
+
+	/**
+	 * A precomputed byte translation table.
+	 *
+	 * Character-wise transforms of narrow strings&mdash;case folding,
+	 * transliteration, and the like&mdash;only ever see 256 distinct inputs,
+	 * so the transform can be applied to each of them once, up front, and
+	 * every subsequent character becomes a single table load. Mapping a
+	 * `char_table` over a `std::string` takes a bulk path through the
+	 * string's contiguous buffer instead of invoking a callable per
+	 * character (see `functor<std::basic_string>`).
+	 *
+	 * A `char_table` is itself callable as a `char -> char` function, so it
+	 * composes with the rest of the library like any other function object.
+	 *
+	 * \note The tabulated function is applied to \em every byte value at
+	 *       construction, whether or not it later occurs in any input; it
+	 *       must be total over `char`.
+	 *
+	 * \par Concepts
+	 * \li \ref fullycons
+	 *
+	 * \ingroup string
+	 */
+	class char_table {
+	public:
+		char_table(const char_table&) noexcept = default;
+		char_table(char_table&&) noexcept = default;
+
+		/// Tabulates f over every byte value.
+		template<
+				typename F,
+				typename = Requires<
+					!std::is_same<plain_type<F>,char_table>::value
+				>
+		>
+		explicit char_table(F&& f) {
+			for(int i = 0; i < 256; ++i)
+				table[i] = f(static_cast<char>(i));
+		}
+
+		char_table& operator= (const char_table&) noexcept = default;
+		char_table& operator= (char_table&&) noexcept = default;
+
+		char operator() (char c) const noexcept {
+			return table[static_cast<unsigned char>(c)];
+		}
+
+	private:
+		char table[256];
+	};
+
+	/**
+	 * Convenience function to concisely tabulate a character transform.
+	 *
+	 * \code
+	 *   auto rot13 = ftl::tabulate([](char c) { ... });
+	 *   auto s = rot13 % std::string("attack at dawn");
+	 * \endcode
+	 *
+	 * \ingroup string
+	 */
+	template<typename F>
+	char_table tabulate(F&& f) {
+		return char_table{std::forward<F>(f)};
+	}
+
+	/**
+	 * The `std::toupper` transform, tabulated.
+	 *
+	 * \ingroup string
+	 */
+	inline const char_table& toUpperTable() {
+		static const char_table t{[](char c) {
+			return static_cast<char>(
+				std::toupper(static_cast<unsigned char>(c))
+			);
+		}};
+
+		return t;
+	}
+
+	/**
+	 * The `std::tolower` transform, tabulated.
+	 *
+	 * \ingroup string
+	 */
+	inline const char_table& toLowerTable() {
+		static const char_table t{[](char c) {
+			return static_cast<char>(
+				std::tolower(static_cast<unsigned char>(c))
+			);
+		}};
+
+		return t;
+	}
+
+	/**
+	 * Functor instance for the standard string classes.
+	 *
+	 * Maps are character-wise; mapping to a different character type
+	 * rebinds the string accordingly:
+	 *
+	 * \code
+	 *   auto shouted = ftl::toUpperTable() % request;
+	 * \endcode
+	 *
+	 * Endofunctions applied to temporaries transform in place, and mapping
+	 * a `char_table` over a narrow string runs over the contiguous buffer
+	 * with one table load per character, rather than one callable
+	 * invocation per character.
+	 *
+	 * \ingroup string
+	 */
+	template<typename CharT, typename Traits, typename A>
+	struct functor<std::basic_string<CharT,Traits,A>> {
+
+		using string_type = std::basic_string<CharT,Traits,A>;
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Str = Rebind<string_type,U>;
+
+		/**
+		 * Maps the function `f` over all characters in `s`.
+		 */
+		template<typename F, typename U = result_of<F(CharT)>>
+		static Str<U> map(F&& f, const string_type& s) {
+			Str<U> r;
+			r.reserve(s.size());
+			for(auto c : s)
+				r.push_back(f(c));
+
+			return r;
+		}
+
+		/**
+		 * No-copy overload for endofunctions on temporary strings.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<CharT,result_of<F(CharT)>>::value
+				>
+		>
+		static string_type map(F&& f, string_type&& s) {
+			for(auto& c : s)
+				c = f(c);
+
+			return std::move(s);
+		}
+
+		/**
+		 * R-value overload for maps to a different character type.
+		 */
+		template<
+				typename F,
+				typename U = result_of<F(CharT)>,
+				typename = Requires<!std::is_same<CharT,U>::value>
+		>
+		static Str<U> map(F&& f, string_type&& s) {
+			Str<U> r;
+			r.reserve(s.size());
+			for(auto c : s)
+				r.push_back(f(c));
+
+			return r;
+		}
+
+		/**
+		 * Bulk overload for precomputed translation tables.
+		 *
+		 * One table load per character over the contiguous buffer; no
+		 * per-character callable invocation.
+		 */
+		static string_type map(const char_table& t, const string_type& s) {
+			auto r = s;
+			for(auto& c : r)
+				c = t(c);
+
+			return r;
+		}
+
+		/// \overload
+		static string_type map(const char_table& t, string_type&& s) {
+			for(auto& c : s)
+				c = t(c);
+
+			return std::move(s);
+		}
+
+		static constexpr bool instance = true;
+
+	};
+
+	/**
+	 * Accumulator instance for the standard string classes.
+	 *
+	 * Appends fragments onto the accumulator in place, so a streaming fold
+	 * of N fragments copies each character once instead of re-copying the
+	 * accumulated prefix per fragment. For the many-small-fragments case,
+	 * `ftl::string_builder` remains the cheapest option, as it joins with a
+	 * single exact-size allocation.
+	 *
+	 * \ingroup string
+	 */
+	template<typename...Ts>
+	struct accumulator<std::basic_string<Ts...>> {
+		static void append_to(
+				std::basic_string<Ts...>& s1,
+				const std::basic_string<Ts...>& s2) {
+			s1 += s2;
+		}
+
+		static void append_to(
+				std::basic_string<Ts...>& s1,
+				std::basic_string<Ts...>&& s2) {
+			if(s1.empty())
+				s1 = std::move(s2);
+			else
+				s1 += s2;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * A string building monoid.
+	 *
+	 * Appending strings directly copies both operands' characters, so folding
+	 * N fragments performs O(N&sup2;) character copies. A `string_builder`
+	 * merely buffers the fragments; `str()` joins them once, with a single
+	 * allocation of exactly the total length:
+	 *
+	 * \code
+	 *   auto document = ftl::foldMap(
+	 *       [](const record& r){ return ftl::fragment(render(r)); },
+	 *       records
+	 *   ).str();
+	 * \endcode
+	 *
+	 * \ingroup string
+	 */
+	template<typename...Ts>
+	class string_builder {
+	public:
+		using string_type = std::basic_string<Ts...>;
+
+		string_builder() = default;
+		string_builder(const string_builder&) = default;
+		string_builder(string_builder&&) = default;
+
+		explicit string_builder(string_type s) {
+			pieces.push_back(std::move(s));
+		}
+
+		string_builder& operator= (const string_builder&) = default;
+		string_builder& operator= (string_builder&&) = default;
+
+		/// Append another builder's fragments to this one.
+		string_builder& operator+= (string_builder other) {
+			pieces.insert(
+					pieces.end(),
+					std::make_move_iterator(other.pieces.begin()),
+					std::make_move_iterator(other.pieces.end())
+			);
+
+			return *this;
+		}
+
+		/// Join all buffered fragments with one exactly-sized allocation.
+		string_type str() const {
+			size_t total = 0;
+			for(const auto& p : pieces)
+				total += p.size();
+
+			string_type result;
+			result.reserve(total);
+			for(const auto& p : pieces)
+				result += p;
+
+			return result;
+		}
+
+	private:
+		std::vector<string_type> pieces;
+	};
+
+	/**
+	 * Convenience function to concisely create string_builder fragments.
+	 *
+	 * \ingroup string
+	 */
+	template<typename...Ts>
+	string_builder<Ts...> fragment(std::basic_string<Ts...> s) {
+		return string_builder<Ts...>{std::move(s)};
+	}
+
+	/// \overload
+	inline string_builder<char> fragment(const char* s) {
+		return string_builder<char>{std::string(s)};
+	}
+
+	/**
+	 * Monoid instance for string_builder.
+	 *
+	 * Append concatenates the fragment buffers; no characters are copied
+	 * until `str()` is called. Folding N fragments is hence O(N) in both
+	 * copies and allocations, instead of the O(N&sup2;) copies of folding
+	 * the strings directly.
+	 *
+	 * \ingroup string
+	 */
+	template<typename...Ts>
+	struct monoid<string_builder<Ts...>> {
+
+		static string_builder<Ts...> id() {
+			return string_builder<Ts...>{};
+		}
+
+		static string_builder<Ts...> append(
+				const string_builder<Ts...>& b1,
+				const string_builder<Ts...>& b2) {
+
+			auto b = b1;
+			b += b2;
+			return b;
+		}
+
+		static string_builder<Ts...> append(
+				string_builder<Ts...>&& b1,
+				const string_builder<Ts...>& b2) {
+
+			b1 += b2;
+			return std::move(b1);
+		}
+
+		static string_builder<Ts...> append(
+				const string_builder<Ts...>& b1,
+				string_builder<Ts...>&& b2) {
+
+			auto b = b1;
+			b += std::move(b2);
+			return b;
+		}
+
+		static string_builder<Ts...> append(
+				string_builder<Ts...>&& b1,
+				string_builder<Ts...>&& b2) {
+
+			b1 += std::move(b2);
+			return std::move(b1);
 		}
 
 		static constexpr bool instance = true;
@@ -23,12 +23,16 @@
 #ifndef FTL_SUM_TYPE_H
 #define FTL_SUM_TYPE_H
 
+#include <array>
 #include <stdexcept>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <vector>
 #include "type_functions.h"
 #include "concepts/basic.h"
 #include "concepts/orderable.h"
+#include "profile.h"
 
 namespace ftl {
 
@@ -42,12 +46,14 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<array>`
 	 * - `<stdexcept>`
 	 * - `<memory>`
 	 * - `<string>`
 	 * - \ref typelevel
 	 * - \ref concepts_basic
 	 * - \ref orderablepg
+	 * - \ref profile
 	 */
 
 	/**
@@ -100,6 +106,38 @@ namespace ftl {
 	struct constructor {
 	};
 
+	/**
+	 * Annotation telling `match` which alternative dominates at runtime.
+	 *
+	 * The jump table dispatch in `match` costs an indirect call per match.
+	 * When one alternative is known to account for the vast majority of
+	 * matches&mdash;a skew the \ref sum_type_profile counters can
+	 * confirm&mdash;passing this tag as the first argument turns the hot
+	 * case into a direct, predictable comparison that the branch predictor
+	 * resolves ahead of the table, which only the cold remainder falls
+	 * back to:
+	 *
+	 * \code
+	 *   // parse results are overwhelmingly the first alternative
+	 *   auto r = result.match(
+	 *       likely_alternative<0>{},
+	 *       [](value v){ ... },
+	 *       [](parse_error e){ ... }
+	 *   );
+	 * \endcode
+	 *
+	 * `N` is an index in declaration order, like `type_at`. The annotation
+	 * never changes which case is run; a wrong guess merely costs the
+	 * comparison before the usual dispatch.
+	 *
+	 * \see sum_type::match, sum_type_profile
+	 *
+	 * \ingroup sum_type
+	 */
+	template<size_t N>
+	struct likely_alternative {
+	};
+
 	namespace _dtl {
 
 		template<typename, typename...>
@@ -122,6 +160,27 @@ namespace ftl {
 			static constexpr bool value = false;
 		};
 
+		/* Checks whether every type in a pack is trivially copyable.
+		 *
+		 * Used to select raw memory based fast paths for copying, moving and
+		 * destroying sum types whose alternatives are all trivial. Note that
+		 * trivially copyable implies trivially destructible.
+		 */
+		template<typename...>
+		struct is_trivial_pack;
+
+		template<>
+		struct is_trivial_pack<> {
+			static constexpr bool value = true;
+		};
+
+		template<typename T, typename...Ts>
+		struct is_trivial_pack<T,Ts...> {
+			static constexpr bool value =
+				std::is_trivially_copyable<T>::value
+				&& is_trivial_pack<Ts...>::value;
+		};
+
 		template<typename,typename...>
 		struct find_call_match {
 			using type = _dtl::no;
@@ -286,51 +345,81 @@ namespace ftl {
 			}
 		};
 
-		template<typename R, typename...Ts>
-		struct union_visitor<R,seq<>,Ts...> {
+		/* Visits a single, statically known alternative of the union.
+		 *
+		 * Used as the building block of the dispatch table below: each entry
+		 * in the table is one instantiation of `visit`, with the recursive
+		 * indexing resolved entirely at compile time.
+		 */
+		template<typename R, size_t I, typename...Ts>
+		struct union_alternative_visitor {
+			using T = type_at<I,Ts...>;
+
 			template<typename...Fs>
-			static R visit(const recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+			static R visit(const recursive_union<Ts...>& u, Fs&&...fs) {
+				return union_visitor<R,T>::visit(
+					overload_tag<T>{},
+					union_indexer<I,Ts...>::ref(u),
+					std::forward<Fs>(fs)...
+				);
 			}
 
 			template<typename...Fs>
-			static R visit(recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+			static R visit(recursive_union<Ts...>& u, Fs&&...fs) {
+				return union_visitor<R,T>::visit(
+					overload_tag<T>{},
+					union_indexer<I,Ts...>::ref(u),
+					std::forward<Fs>(fs)...
+				);
 			}
 		};
 
+		/* Jump table based visitation of a recursive_union.
+		 *
+		 * Dispatches on the active index with a single indirect call through
+		 * a table of function pointers, built at compile time. This keeps
+		 * visitation O(1) in the number of alternatives, instead of the
+		 * chain of compares a naive recursive dispatch results in.
+		 */
 		template<typename R, size_t I, size_t...Is, typename T, typename...Ts>
 		struct union_visitor<R,seq<I,Is...>,T,Ts...> {
 			template<typename...Fs>
 			static R visit(
 					const recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
 			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
+				using visit_fn =
+					R(*)(const recursive_union<T,Ts...>&, Fs&&...);
+
+				static constexpr visit_fn table[] = {
+					&union_alternative_visitor<R,I,T,Ts...>
+						::template visit<Fs...>,
+					&union_alternative_visitor<R,Is,T,Ts...>
+						::template visit<Fs...>...
+				};
+
+				if(i >= sizeof...(Is) + 1)
+					throw invalid_sum_type_access{""};
+
+				return table[i](u, std::forward<Fs>(fs)...);
 			}
 
 			template<typename...Fs>
 			static R visit(
 					recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
 			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
+				using visit_fn = R(*)(recursive_union<T,Ts...>&, Fs&&...);
+
+				static constexpr visit_fn table[] = {
+					&union_alternative_visitor<R,I,T,Ts...>
+						::template visit<Fs...>,
+					&union_alternative_visitor<R,Is,T,Ts...>
+						::template visit<Fs...>...
+				};
+
+				if(i >= sizeof...(Is) + 1)
+					throw invalid_sum_type_access{""};
+
+				return table[i](u, std::forward<Fs>(fs)...);
 			}
 		};
 
@@ -344,19 +433,58 @@ namespace ftl {
 			{ return false; }
 		};
 
-		template<typename T, typename...Ts>
-		struct recursive_union<T,Ts...> {
-			constexpr recursive_union() noexcept {}
+#ifdef FTL_PROFILE
+		/* Per-instantiation, per-alternative match counters. One array of
+		 * counters per distinct sum_type, held as a function local static so
+		 * a header only build needs no out-of-line definitions.
+		 */
+		template<typename...Ts>
+		struct sum_type_match_counters {
+			static std::atomic<uint64_t>* counts() noexcept {
+				static std::atomic<uint64_t> cs[sizeof...(Ts)] = {};
+				return cs;
+			}
+		};
+#endif
+
+		/* Counting hook for match, following the conventions of profile.h:
+		 * without FTL_PROFILE it is an empty inline function.
+		 */
+		template<typename...Ts>
+		inline void profile_count_sum_type_match_at(size_t i) noexcept {
+#ifdef FTL_PROFILE
+			sum_type_match_counters<Ts...>::counts()[i].fetch_add(
+				1, std::memory_order_relaxed
+			);
+#else
+			(void) i;
+#endif
+		}
+
+		/* Storage layer of recursive_union: owns the union itself, so that
+		 * the destructor can be trivial when every alternative is trivially
+		 * copyable&mdash;a requirement for recursive_union (and, by
+		 * extension, sum_type) to be a literal type, usable in constant
+		 * expressions.
+		 *
+		 * Destruction of a non-trivial active member is always performed
+		 * explicitly through recursive_union::destruct; the destructor here
+		 * never has anything to do, but C++11 demands a user-provided one
+		 * whenever the union holds a non-trivially destructible member.
+		 */
+		template<bool Trivial, typename T, typename...Ts>
+		struct union_storage {
+			constexpr union_storage() noexcept {}
 
 			// Construct this element type
 			template<typename...Args>
-			explicit constexpr recursive_union(constructor<T>, Args&&...args)
+			explicit constexpr union_storage(constructor<T>, Args&&...args)
 			noexcept(std::is_nothrow_constructible<T,Args...>::value)
 			: v(std::forward<Args>(args)...) {}
 
 			// Forward construction to U
 			template<typename U, typename...Args>
-			explicit constexpr recursive_union(constructor<U> t, Args&&...args)
+			explicit constexpr union_storage(constructor<U> t, Args&&...args)
 			noexcept(
 				std::is_nothrow_constructible<
 					recursive_union<Ts...>,Args...
@@ -366,14 +494,56 @@ namespace ftl {
 
 			// Construct this element using an initializer_list
 			template<typename U>
-			constexpr recursive_union(constructor<T>, std::initializer_list<U> l)
+			constexpr union_storage(constructor<T>, std::initializer_list<U> l)
 			noexcept(
 				std::is_nothrow_constructible<T,std::initializer_list<U>>::value
 			) : v(l) {}
 
 			// Forward construction using initializer_list to U
 			template<typename U, typename V>
-			constexpr recursive_union(
+			constexpr union_storage(
+					constructor<U> t, std::initializer_list<V> l
+			)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,
+					constructor<U>,
+					std::initializer_list<V>
+				>::value
+			) : r(t, l) {}
+
+			union {
+				T v;
+				recursive_union<Ts...> r;
+			};
+		};
+
+		template<typename T, typename...Ts>
+		struct union_storage<false,T,Ts...> {
+			constexpr union_storage() noexcept {}
+
+			template<typename...Args>
+			explicit constexpr union_storage(constructor<T>, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value)
+			: v(std::forward<Args>(args)...) {}
+
+			template<typename U, typename...Args>
+			explicit constexpr union_storage(constructor<U> t, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,Args...
+				>::value
+			)
+			: r(t, std::forward<Args>(args)...) {}
+
+			template<typename U>
+			constexpr union_storage(constructor<T>, std::initializer_list<U> l)
+			noexcept(
+				std::is_nothrow_constructible<T,std::initializer_list<U>>::value
+			) : v(l) {}
+
+			template<typename U, typename V>
+			constexpr union_storage(
 					constructor<U> t, std::initializer_list<V> l
 			)
 			noexcept(
@@ -384,7 +554,43 @@ namespace ftl {
 				>::value
 			) : r(t, l) {}
 
-			~recursive_union() {}
+			~union_storage() {}
+
+			union {
+				T v;
+				recursive_union<Ts...> r;
+			};
+		};
+
+		template<typename T, typename...Ts>
+		struct recursive_union<T,Ts...>
+		: union_storage<is_trivial_pack<T,Ts...>::value,T,Ts...> {
+		private:
+			using storage =
+				union_storage<is_trivial_pack<T,Ts...>::value,T,Ts...>;
+
+		public:
+			constexpr recursive_union() noexcept : storage() {}
+
+			template<typename U, typename...Args>
+			explicit constexpr recursive_union(constructor<U> t, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					storage,constructor<U>,Args...
+				>::value
+			)
+			: storage(t, std::forward<Args>(args)...) {}
+
+			template<typename U, typename V>
+			constexpr recursive_union(
+					constructor<U> t, std::initializer_list<V> l
+			)
+			noexcept(
+				std::is_nothrow_constructible<
+					storage,constructor<U>,std::initializer_list<V>
+				>::value
+			)
+			: storage(t, l) {}
 
 			void copy(size_t i, const recursive_union& u)
 			noexcept(
@@ -393,10 +599,10 @@ namespace ftl {
 			)
 			{
 				if(i == 0) {
-					new (std::addressof(v)) T(u.v);
+					new (std::addressof(this->v)) T(u.v);
 				}
 				else {
-					r.copy(i-1, u.r);
+					this->r.copy(i-1, u.r);
 				}
 			}
 
@@ -409,10 +615,10 @@ namespace ftl {
 			)
 			{
 				if(i == 0) {
-					new (std::addressof(v)) T(std::move(u.v));
+					new (std::addressof(this->v)) T(std::move(u.v));
 				}
 				else {
-					r.move(i-1, std::move(u.r));
+					this->r.move(i-1, std::move(u.r));
 				}
 			}
 
@@ -424,28 +630,103 @@ namespace ftl {
 			{
 				if(i == 0)
 				{
-					v.~T();
+					this->v.~T();
 				}
 				else {
-					r.destruct(i-1);
+					this->r.destruct(i-1);
 				}
 			}
 
 			constexpr bool compare(size_t i, const recursive_union& rhs) const
 			noexcept {
-				return i == 0 ? v == rhs.v : r.compare(i-1, rhs.r);
+				return i == 0 ? this->v == rhs.v : this->r.compare(i-1, rhs.r);
 			}
-
-			union {
-				T v;
-				recursive_union<Ts...> r;
-			};
 		};
 
 		template<size_t I, typename...Ts>
 		class get_sum_type_element;
 
 		class sum_type_accessor;
+
+		/* Storage layer of sum_type: owns the union and the discriminant, so
+		 * that the special members can be trivial&mdash;and sum_type a
+		 * literal type&mdash;when every alternative is trivially copyable.
+		 * Copies, moves and destruction then reduce to raw copies of the
+		 * underlying storage and a no-op, respectively, with no
+		 * per-alternative dispatch.
+		 *
+		 * The non-trivial specialisation implements the usual tag-directed
+		 * copying, moving and destruction.
+		 */
+		template<bool Trivial, typename...Ts>
+		struct sum_type_base {
+			template<typename...Args>
+			explicit constexpr sum_type_base(size_t i, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,Args...
+				>::value
+			)
+			: data(std::forward<Args>(args)...), cons(i) {}
+
+			recursive_union<Ts...> data;
+			size_t cons;
+		};
+
+		template<typename...Ts>
+		struct sum_type_base<false,Ts...> {
+			template<typename...Args>
+			explicit constexpr sum_type_base(size_t i, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,Args...
+				>::value
+			)
+			: data(std::forward<Args>(args)...), cons(i) {}
+
+			sum_type_base(const sum_type_base& s)
+			: data(), cons(s.cons) {
+				data.copy(cons, s.data);
+			}
+
+			sum_type_base(sum_type_base&& s)
+			: data(), cons(s.cons) {
+				data.move(cons, std::move(s.data));
+			}
+
+			// TODO: Use assignment instead of construction if cons and s.cons
+			// are equal
+			sum_type_base& operator= (const sum_type_base& s) {
+				// Deal with self assignment
+				if(std::addressof(s) == this)
+					return *this;
+
+				data.destruct(cons);
+				cons = s.cons;
+				data.copy(cons, s.data);
+
+				return *this;
+			}
+
+			sum_type_base& operator= (sum_type_base&& s) {
+				// Deal with self assignment
+				if(std::addressof(s) == this)
+					return *this;
+
+				data.destruct(cons);
+				cons = s.cons;
+				data.move(cons, std::move(s.data));
+
+				return *this;
+			}
+
+			~sum_type_base() {
+				data.destruct(cons);
+			}
+
+			recursive_union<Ts...> data;
+			size_t cons;
+		};
 	}
 
 	/**
@@ -461,6 +742,11 @@ namespace ftl {
 	 * recommended to stick with operations that can be statically verified,
 	 * e.g. using `match` to access values instead of `get`.
 	 *
+	 * When every sub-type is trivially copyable, `sum_type` is a literal
+	 * type: construction, `get`, and comparison are all usable in constant
+	 * expressions, so tables of sum type values can be built at compile time
+	 * and placed in read-only storage.
+	 *
 	 * \par Concepts
 	 * - \ref copycons, if all sub-types are
 	 * - \ref movecons, if all sub-types are
@@ -470,7 +756,8 @@ namespace ftl {
 	 * \ingroup sum_type
 	 */
 	template<typename...Ts>
-	class sum_type {
+	class sum_type
+	: private _dtl::sum_type_base<_dtl::is_trivial_pack<Ts...>::value,Ts...> {
 		static_assert(
 			_dtl::is_type_set<Ts...>::value,
 			"Each sub-type of a sum type must be unique"
@@ -481,15 +768,18 @@ namespace ftl {
 
 		friend class ::ftl::_dtl::sum_type_accessor;
 
+		/* The base class owns the storage and the discriminant. When every
+		 * alternative is trivially copyable, all special members below
+		 * default to trivial ones—raw copies of the underlying storage and
+		 * no-op destruction—skipping the per-alternative dispatch entirely.
+		 */
+		using base =
+			_dtl::sum_type_base<_dtl::is_trivial_pack<Ts...>::value,Ts...>;
+
 	public:
 		sum_type() = delete;
-		sum_type(const sum_type& st) : cons(st.cons) {
-			data.copy(cons, st.data);
-		}
-
-		sum_type(sum_type&& st) : cons(st.cons) {
-			data.move(cons, std::move(st.data));
-		}
+		sum_type(const sum_type&) = default;
+		sum_type(sum_type&&) = default;
 
 		/**
 		 * Construct the sum type as an instance of `T`.
@@ -503,8 +793,7 @@ namespace ftl {
 				_dtl::recursive_union<Ts...>,Args...
 			>::value
 		)
-		: data(t, std::forward<Args>(args)...)
-		, cons(index_of<T,Ts...>::value) {}
+		: base(index_of<T,Ts...>::value, t, std::forward<Args>(args)...) {}
 
 		/**
 		 * Construct as an instance of `T`, using an initializer_list.
@@ -526,16 +815,9 @@ namespace ftl {
 				std::initializer_list<U>
 			>::value
 		)
-		: data(t, l), cons(index_of<T,Ts...>::value)
+		: base(index_of<T,Ts...>::value, t, l)
 		{}
 
-		~sum_type() noexcept(
-			noexcept(std::declval<_dtl::recursive_union<Ts...>>().destruct(0))
-		)
-		{
-			data.destruct(cons);
-		}
-
 		/**
 		 * Check whether the `sum_type` is currently an instance of `T`.
 		 *
@@ -550,7 +832,7 @@ namespace ftl {
 		 */
 		template<typename T>
 		constexpr bool is() const noexcept {
-			return cons == index_of<T,Ts...>::value;
+			return this->cons == index_of<T,Ts...>::value;
 		}
 
 		/**
@@ -567,34 +849,11 @@ namespace ftl {
 		 */
 		template<size_t I>
 		constexpr bool isTypeAt() const noexcept {
-			return cons == I;
+			return this->cons == I;
 		}
 
-		// TODO: Use assignment instead of construction if cons and s.cons
-		// are equal
-		sum_type& operator= (const sum_type& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
-
-			data.destruct(cons);
-			cons = s.cons;
-			data.copy(cons, s.data);
-
-			return *this;
-		}
-
-		sum_type& operator= (sum_type&& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
-
-			data.destruct(cons);
-			cons = s.cons;
-			data.move(cons, std::move(s.data));
-
-			return *this;
-		}
+		sum_type& operator= (const sum_type&) = default;
+		sum_type& operator= (sum_type&&) = default;
 
 		/**
 		 * Pseudo pattern match method.
@@ -660,8 +919,11 @@ namespace ftl {
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
+			_dtl::profile_count_sum_type_match();
+			_dtl::profile_count_sum_type_match_at<Ts...>(this->cons);
+
 			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+				::visit(this->data, this->cons, std::forward<Fs>(fs)...);
 		}
 
 		/// \overload
@@ -680,14 +942,163 @@ namespace ftl {
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
+			_dtl::profile_count_sum_type_match();
+			_dtl::profile_count_sum_type_match_at<Ts...>(this->cons);
+
+			return _dtl::union_visitor<return_type,indices,Ts...>
+				::visit(this->data, this->cons, std::forward<Fs>(fs)...);
+		}
+
+		/**
+		 * \overload
+		 *
+		 * Matches with a hint that alternative `N` is almost always the
+		 * active one: the hot case is tested with a direct comparison
+		 * before the jump table, which only the remaining alternatives
+		 * fall back to. See \ref likely_alternative.
+		 */
+		template<size_t N, typename...Fs>
+		auto match(likely_alternative<N>, Fs&&...fs) const
+		-> typename ::ftl::_dtl::common_return_type<
+			type_seq<Ts...>,type_seq<Fs...>
+		>::type {
+
+			static_assert(
+				N < sizeof...(Ts),
+				"likely_alternative index out of bounds"
+			);
+
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+				"Match statements must be exhaustive"
+			);
+
+			using indices = gen_seq<0,sizeof...(Ts)-1>;
+			using return_type = typename _dtl::common_return_type<
+				type_seq<Ts...>,type_seq<Fs...>
+			>::type;
+
+			_dtl::profile_count_sum_type_match();
+			_dtl::profile_count_sum_type_match_at<Ts...>(this->cons);
+
+			if(this->cons == N) {
+				return _dtl::union_alternative_visitor<return_type,N,Ts...>
+					::visit(this->data, std::forward<Fs>(fs)...);
+			}
+
+			return _dtl::union_visitor<return_type,indices,Ts...>
+				::visit(this->data, this->cons, std::forward<Fs>(fs)...);
+		}
+
+		/// \overload
+		template<size_t N, typename...Fs>
+		auto match(likely_alternative<N>, Fs&&...fs)
+		-> typename ::ftl::_dtl::common_return_type<
+			type_seq<Ts...>,type_seq<Fs...>
+		>::type {
+
+			static_assert(
+				N < sizeof...(Ts),
+				"likely_alternative index out of bounds"
+			);
+
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+				"Match statements must be exhaustive"
+			);
+
+			using indices = gen_seq<0,sizeof...(Ts)-1>;
+			using return_type = typename _dtl::common_return_type<
+				type_seq<Ts...>,type_seq<Fs...>
+			>::type;
+
+			_dtl::profile_count_sum_type_match();
+			_dtl::profile_count_sum_type_match_at<Ts...>(this->cons);
+
+			if(this->cons == N) {
+				return _dtl::union_alternative_visitor<return_type,N,Ts...>
+					::visit(this->data, std::forward<Fs>(fs)...);
+			}
+
 			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+				::visit(this->data, this->cons, std::forward<Fs>(fs)...);
+		}
+	};
+
+	/**
+	 * Per-alternative match statistics of a particular sum_type.
+	 *
+	 * Complements the process wide counters of \ref profile: where those
+	 * count every `match` of every sum type, these break the counts down by
+	 * alternative, per distinct `sum_type` instantiation&mdash;exactly the
+	 * data needed to decide whether a call site is skewed enough to deserve
+	 * a \ref likely_alternative annotation, and which index to name in it.
+	 *
+	 * Like the rest of the instrumentation, counting is compiled in only
+	 * with `FTL_PROFILE`; without it, the hooks are empty and this query
+	 * API reports all zeroes.
+	 *
+	 * \code
+	 *   using result = ftl::sum_type<value,parse_error>;
+	 *
+	 *   runWorkload();
+	 *
+	 *   auto cs = ftl::sum_type_profile<result>::counts();
+	 *   // cs[0] matches landed on value, cs[1] on parse_error
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename>
+	struct sum_type_profile;
+
+	template<typename...Ts>
+	struct sum_type_profile<sum_type<Ts...>> {
+		/**
+		 * Cumulative match counts, indexed by alternative in declaration
+		 * order.
+		 *
+		 * Counts accumulate since process start or the most recent reset().
+		 */
+		static std::array<uint64_t,sizeof...(Ts)> counts() noexcept {
+			std::array<uint64_t,sizeof...(Ts)> r = {};
+#ifdef FTL_PROFILE
+			for(size_t i = 0; i < sizeof...(Ts); ++i) {
+				r[i] = _dtl::sum_type_match_counters<Ts...>::counts()[i]
+					.load(std::memory_order_relaxed);
+			}
+#endif
+			return r;
 		}
 
+		/**
+		 * The index of the most frequently matched alternative so far.
+		 *
+		 * The natural candidate for a \ref likely_alternative annotation.
+		 * Ties resolve to the lowest index.
+		 */
+		static size_t hottest() noexcept {
+			auto cs = counts();
+
+			size_t best = 0;
+			for(size_t i = 1; i < cs.size(); ++i) {
+				if(cs[i] > cs[best])
+					best = i;
+			}
+
+			return best;
+		}
 
-	private:
-		_dtl::recursive_union<Ts...> data;
-		size_t cons;
+		/// Reset this instantiation's counters to zero.
+		static void reset() noexcept {
+#ifdef FTL_PROFILE
+			for(size_t i = 0; i < sizeof...(Ts); ++i) {
+				_dtl::sum_type_match_counters<Ts...>::counts()[i].store(
+					0, std::memory_order_relaxed
+				);
+			}
+#endif
+		}
 	};
 
 	namespace _dtl {
@@ -706,37 +1117,52 @@ namespace ftl {
 			{
 				return a.data.compare(i, b.data);
 			}
+
+			/* Unchecked element access, for callers that have already
+			 * established the active index some other way (e.g. by
+			 * partitioning on it). No per-access tag test, unlike get.
+			 */
+			template<size_t I, typename...Ts>
+			static auto rawGet(sum_type<Ts...>& u) noexcept
+			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
+				return union_indexer<I,Ts...>::ref(u.data);
+			}
+
+			template<size_t I, typename...Ts>
+			static constexpr auto rawGet(const sum_type<Ts...>& u) noexcept
+			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
+				return union_indexer<I,Ts...>::ref(u.data);
+			}
 		};
 
 		template<size_t I, typename...Ts>
 		class get_sum_type_element {
 		public:
-			// TODO: C++14: With relaxed constexpr requirements,
-			// these are possible candidates
-			static auto get(sum_type<Ts...>& u)
+			/* The conditional-expression form keeps these constexpr under
+			 * C++11; the throw is simply never evaluated on the happy path.
+			 */
+			static constexpr auto get(sum_type<Ts...>& u)
 			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
-					throw invalid_sum_type_access{
+				return u.cons == I
+					? union_indexer<I,Ts...>::ref(u.data)
+					: throw invalid_sum_type_access{
 						std::string("Indexing with ")
 						+ std::to_string(I)
 						+ std::string(", but active index is ")
 						+ std::to_string(u.cons)
 					};
-
-				return union_indexer<I,Ts...>::ref(u.data);
 			}
 
-			static auto get(const sum_type<Ts...>& u)
+			static constexpr auto get(const sum_type<Ts...>& u)
 			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
-					throw invalid_sum_type_access{
+				return u.cons == I
+					? union_indexer<I,Ts...>::ref(u.data)
+					: throw invalid_sum_type_access{
 						std::string("Indexing with ")
 						+ std::to_string(I)
 						+ std::string(", but active index is ")
 						+ std::to_string(u.cons)
 					};
-
-				return union_indexer<I,Ts...>::ref(u.data);
 			}
 		};
 	}
@@ -807,17 +1233,371 @@ namespace ftl {
 			typename...Ts,
 			typename = typename std::enable_if<All<Eq,Ts...>{}>::type
 	>
-	bool operator== (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
-		size_t i1 = ::ftl::_dtl::sum_type_accessor::activeIndex(a);
-		size_t i2 = ::ftl::_dtl::sum_type_accessor::activeIndex(b);
-
-		return i1 == i2 && ::ftl::_dtl::sum_type_accessor::compareAt(i1, a, b);
+	constexpr bool operator== (
+			const sum_type<Ts...>& a, const sum_type<Ts...>& b
+	) {
+		return ::ftl::_dtl::sum_type_accessor::activeIndex(a)
+			== ::ftl::_dtl::sum_type_accessor::activeIndex(b)
+			&& ::ftl::_dtl::sum_type_accessor::compareAt(
+				::ftl::_dtl::sum_type_accessor::activeIndex(a), a, b
+			);
 	}
 
 	template<typename...Ts>
-	bool operator!= (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
+	constexpr bool operator!= (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
 		return !(a == b);
 	}
+
+	namespace _dtl {
+		// Select the first of Fs callable with T (same resolution order
+		// as match's find_call_match, but yielding the callable itself)
+		template<typename T, bool, typename...Fs>
+		struct pick_handler_impl;
+
+		template<typename T, typename F, typename...Fs>
+		struct pick_handler_impl<T, true, F, Fs...> {
+			using type = F;
+
+			static F& get(F& f, Fs&...) noexcept {
+				return f;
+			}
+		};
+
+		template<typename T, typename F, typename F2, typename...Fs>
+		struct pick_handler_impl<T, false, F, F2, Fs...> {
+		private:
+			using base =
+				pick_handler_impl<T, is_callable<F2,T>::value, F2, Fs...>;
+
+		public:
+			using type = typename base::type;
+
+			static type& get(F&, F2& f2, Fs&...fs) noexcept {
+				return base::get(f2, fs...);
+			}
+		};
+
+		template<typename T, typename F, typename...Fs>
+		struct pick_handler
+		: pick_handler_impl<T, is_callable<F,T>::value, F, Fs...> {};
+
+		template<size_t I, size_t N>
+		struct match_all_group {
+			template<typename...Ts, typename A, typename...Fs>
+			static void run(
+					const std::vector<sum_type<Ts...>,A>& v,
+					const std::vector<size_t>* groups,
+					Fs&...fs) {
+				using T = type_at<I,Ts...>;
+
+				auto& f = pick_handler<const T&, Fs...>::get(fs...);
+				for(auto i : groups[I])
+					f(sum_type_accessor::rawGet<I>(v[i]));
+
+				match_all_group<I+1,N>::run(v, groups, fs...);
+			}
+
+			template<typename...Ts, typename A, typename...Fs>
+			static void run(
+					std::vector<sum_type<Ts...>,A>& v,
+					const std::vector<size_t>* groups,
+					Fs&...fs) {
+				using T = type_at<I,Ts...>;
+
+				auto& f = pick_handler<T&, Fs...>::get(fs...);
+				for(auto i : groups[I])
+					f(sum_type_accessor::rawGet<I>(v[i]));
+
+				match_all_group<I+1,N>::run(v, groups, fs...);
+			}
+		};
+
+		template<size_t N>
+		struct match_all_group<N,N> {
+			template<typename V, typename...Fs>
+			static void run(V&, const std::vector<size_t>*, Fs&...) noexcept {
+			}
+		};
+	}
+
+	/**
+	 * Bulk pattern match over a vector of sum types.
+	 *
+	 * Semantically equivalent to calling `e.match(fs...)` on every
+	 * element in order of tag, but evaluated group-wise: one pass
+	 * partitions the element indices by active type, then each case
+	 * clause runs over its whole group as a tight, homogeneous loop with
+	 * no per-element dispatch&mdash;a shape compilers can hoist through
+	 * and often vectorize. The case clauses are checked for
+	 * exhaustiveness exactly like in `sum_type::match`.
+	 *
+	 * Note that elements are _not_ visited in container order; handlers
+	 * that depend on the relative order of differently-typed elements
+	 * should use per-element `match` instead. Within one type, elements
+	 * are visited in order.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<sum_type<A,B>> events = ...;
+	 *
+	 *   ftl::matchAll(
+	 *       events,
+	 *       [&](const A& a){ handleA(a); },
+	 *       [&](const B& b){ handleB(b); }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename...Ts, typename A, typename...Fs>
+	void matchAll(const std::vector<sum_type<Ts...>,A>& v, Fs&&...fs) {
+		static_assert(
+			_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+			"Match statements must be exhaustive"
+		);
+
+		std::vector<size_t> groups[sizeof...(Ts)];
+		for(size_t i = 0; i < v.size(); ++i) {
+			groups[
+				::ftl::_dtl::sum_type_accessor::activeIndex(v[i])
+			].push_back(i);
+		}
+
+		_dtl::match_all_group<0,sizeof...(Ts)>::run(v, groups, fs...);
+	}
+
+	/// \overload
+	template<typename...Ts, typename A, typename...Fs>
+	void matchAll(std::vector<sum_type<Ts...>,A>& v, Fs&&...fs) {
+		static_assert(
+			_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+			"Match statements must be exhaustive"
+		);
+
+		std::vector<size_t> groups[sizeof...(Ts)];
+		for(size_t i = 0; i < v.size(); ++i) {
+			groups[
+				::ftl::_dtl::sum_type_accessor::activeIndex(v[i])
+			].push_back(i);
+		}
+
+		_dtl::match_all_group<0,sizeof...(Ts)>::run(v, groups, fs...);
+	}
+
+	namespace _dtl {
+		template<size_t I, size_t N>
+		struct from_columns_step {
+			template<typename...Ts, typename Cols>
+			static void run(
+					size_t tag,
+					std::vector<sum_type<Ts...>>& out, Cols& cols) {
+				if(tag != I) {
+					from_columns_step<I+1,N>::run(tag, out, cols);
+					return;
+				}
+
+				auto& p = std::get<I>(cols);
+				out.emplace_back(constructor<type_at<I,Ts...>>(), *p);
+				++p;
+			}
+		};
+
+		template<size_t N>
+		struct from_columns_step<N,N> {
+			// Unreachable: tags are range-checked before dispatch
+			template<typename...Ts, typename Cols>
+			static void run(
+					size_t, std::vector<sum_type<Ts...>>&, Cols&) noexcept {
+			}
+		};
+	}
+
+	/**
+	 * Bulk construction of a sum type vector from columnar input.
+	 *
+	 * Given one contiguous array per alternative and a stream of `n` tags
+	 * (each a valid alternative index), builds the vector a tagged
+	 * deserializer would otherwise assemble element by element: element
+	 * `i` holds the next unconsumed value from the column selected by
+	 * `tags[i]`. Column `j` must hold at least as many elements as `j`
+	 * occurs in the tag stream; columns whose tag never occurs are not
+	 * read and may be null.
+	 *
+	 * The destination is reserved up front and each element is emitted by
+	 * a compile-time-unrolled dispatch on its tag, so the loop compiles to
+	 * the same stores as a hand-fused switch over the columns: no
+	 * per-element allocation, erasure or re-checking of column bounds.
+	 * With trivially copyable alternatives each step is a payload copy
+	 * plus a tag word, leaving the pass store-bound.
+	 *
+	 * A tag outside `[0, sizeof...(Ts))` throws
+	 * `invalid_sum_type_access`; elements appended before the offending
+	 * tag are discarded along with the destination vector.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   const unsigned char tags[]{0, 0, 1, 0};
+	 *   const int ints[]{1, 2, 3};
+	 *   const char chars[]{'a'};
+	 *
+	 *   auto v = ftl::fromColumns(tags, 4, ints, chars);
+	 *   // v == {1, 2, 'a', 3}
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename...Ts>
+	std::vector<sum_type<Ts...>> fromColumns(
+			const unsigned char* tags, size_t n, const Ts*...columns) {
+		std::vector<sum_type<Ts...>> out;
+		out.reserve(n);
+
+		auto cols = std::make_tuple(columns...);
+
+		for(size_t i = 0; i < n; ++i) {
+			if(tags[i] >= sizeof...(Ts)) {
+				throw invalid_sum_type_access{
+					std::string("Tag stream contains ")
+					+ std::to_string(tags[i])
+					+ std::string(", but sum type has only ")
+					+ std::to_string(sizeof...(Ts))
+					+ std::string(" alternatives")
+				};
+			}
+
+			_dtl::from_columns_step<0,sizeof...(Ts)>::run(tags[i], out, cols);
+		}
+
+		return out;
+	}
+
+	/**
+	 * A `sum_type` with caller-chosen alignment.
+	 *
+	 * Behaves exactly like `sum_type<Ts...>`&mdash;it _is_ one, and binds
+	 * to everything that accepts the plain type, including `get`, the
+	 * comparison operators and the concept instances&mdash;but is aligned
+	 * to (and hence sized in multiples of) `Align` bytes. The main use is
+	 * padding concurrently written slots out to a cache line each, so
+	 * writers on adjacent elements do not falsely share:
+	 *
+	 * \code
+	 *   // One slot per producer thread; no two slots share a cache line
+	 *   std::vector<sum_type_aligned<64,idle,event>> slots(nproducers);
+	 * \endcode
+	 *
+	 * `Align` must be a power of two at least as strict as the natural
+	 * alignment of `sum_type<Ts...>`. The bytes spent on padding are
+	 * reported by `sum_type_layout`.
+	 *
+	 * \see sum_type_layout
+	 *
+	 * \ingroup sum_type
+	 */
+	template<size_t Align, typename...Ts>
+	struct alignas(Align) sum_type_aligned : sum_type<Ts...> {
+		static_assert(
+			(Align & (Align - 1)) == 0,
+			"Alignment must be a power of two"
+		);
+
+		static_assert(
+			Align >= alignof(sum_type<Ts...>),
+			"Alignment may not be weaker than the sum type's natural one"
+		);
+
+		sum_type_aligned() = delete;
+		sum_type_aligned(const sum_type_aligned&) = default;
+		sum_type_aligned(sum_type_aligned&&) = default;
+
+		sum_type_aligned& operator= (const sum_type_aligned&) = default;
+		sum_type_aligned& operator= (sum_type_aligned&&) = default;
+
+		/// \see sum_type::sum_type
+		template<typename T, typename...Args>
+		explicit constexpr sum_type_aligned(constructor<T> t, Args&&...args)
+		noexcept(
+			std::is_nothrow_constructible<
+				_dtl::recursive_union<Ts...>,Args...
+			>::value
+		)
+		: sum_type<Ts...>(t, std::forward<Args>(args)...) {}
+
+		/// \overload
+		template<typename T, typename U>
+		constexpr sum_type_aligned(
+			constructor<T> t, std::initializer_list<U> l
+		)
+		: sum_type<Ts...>(t, l) {}
+
+		/// Widen a plain sum type into an aligned slot.
+		sum_type_aligned(const sum_type<Ts...>& s)
+		: sum_type<Ts...>(s) {}
+
+		/// \overload
+		sum_type_aligned(sum_type<Ts...>&& s)
+		: sum_type<Ts...>(std::move(s)) {}
+	};
+
+	namespace _dtl {
+		template<typename Complete, typename...Ts>
+		struct sum_type_layout_base {
+			static constexpr size_t size = sizeof(Complete);
+			static constexpr size_t alignment = alignof(Complete);
+
+			static constexpr size_t payload_offset = 0;
+			static constexpr size_t payload_size =
+				sizeof(recursive_union<Ts...>);
+
+			static constexpr size_t tag_size = sizeof(size_t);
+			static constexpr size_t tag_offset =
+				(payload_size + alignof(size_t) - 1)
+				& ~(alignof(size_t) - 1);
+
+			static constexpr size_t padding =
+				size - payload_size - tag_size;
+		};
+	}
+
+	/**
+	 * Compile-time layout report for a sum type.
+	 *
+	 * Describes where the payload union and the tag word sit within an
+	 * element and how many bytes per element are padding, for code that
+	 * packs shared or serialized arrays deliberately rather than by
+	 * accident. All members are `constexpr`:
+	 *
+	 * - `size`, `alignment`: as `sizeof`/`alignof` of the element type
+	 * - `payload_offset`, `payload_size`: the alternatives' union
+	 * - `tag_offset`, `tag_size`: the discriminant word
+	 * - `padding`: bytes per element spent on neither, whether from the
+	 *   natural layout or from a `sum_type_aligned` over-alignment
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using slot = sum_type_aligned<64,idle,event>;
+	 *
+	 *   static_assert(
+	 *       sum_type_layout<slot>::size == 64,
+	 *       "one slot per cache line"
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename>
+	struct sum_type_layout;
+
+	template<typename...Ts>
+	struct sum_type_layout<sum_type<Ts...>>
+	: _dtl::sum_type_layout_base<sum_type<Ts...>,Ts...> {};
+
+	template<size_t Align, typename...Ts>
+	struct sum_type_layout<sum_type_aligned<Align,Ts...>>
+	: _dtl::sum_type_layout_base<sum_type_aligned<Align,Ts...>,Ts...> {};
 }
 
 #endif
@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SUM_VECTOR_H
+#define FTL_SUM_VECTOR_H
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "sum_type.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup sum_vector Sum Vector
+	 *
+	 * Structure-of-arrays sequence of sum type values.
+	 *
+	 * \code
+	 *   #include <ftl/sum_vector.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<cstdint>`
+	 * - `<tuple>`
+	 * - `<vector>`
+	 * - \ref sum_type
+	 */
+
+	namespace _dtl {
+
+		/* Runtime-tag dispatch over a tuple of per-alternative pools.
+		 *
+		 * The moral equivalent of union_visitor, except the element lives in
+		 * std::get<tag>(pools)[idx] instead of in a recursive_union.
+		 */
+		template<size_t I, size_t N>
+		struct sum_vector_visitor {
+			template<typename R, typename Pools, typename...Fs>
+			static R visit(Pools& pools, size_t tag, size_t idx, Fs&...fs) {
+				if(tag == I) {
+					auto& pool = std::get<I>(pools);
+					auto& f =
+						pick_handler<decltype(pool[idx]),Fs...>::get(fs...);
+
+					return f(pool[idx]);
+				}
+
+				return sum_vector_visitor<I+1,N>::template visit<R>(
+					pools, tag, idx, fs...
+				);
+			}
+		};
+
+		template<size_t N>
+		struct sum_vector_visitor<N,N> {
+			template<typename R, typename Pools, typename...Fs>
+			static R visit(Pools&, size_t, size_t, Fs&...) {
+				throw invalid_sum_type_access(
+					"Visitation of sum_vector element with invalid tag"
+				);
+			}
+		};
+
+		/* Runs each case clause over the whole of its pool, one pool at a
+		 * time. Same shape as match_all_group, minus the index indirection:
+		 * the pools are already homogeneous and contiguous.
+		 */
+		template<size_t I, size_t N>
+		struct sum_vector_group {
+			template<typename Pools, typename...Fs>
+			static void run(Pools& pools, Fs&...fs) {
+				auto& pool = std::get<I>(pools);
+				if(!pool.empty()) {
+					auto& f =
+						pick_handler<decltype(pool[0]),Fs...>::get(fs...);
+
+					for(auto& e : pool)
+						f(e);
+				}
+
+				sum_vector_group<I+1,N>::run(pools, fs...);
+			}
+		};
+
+		template<size_t N>
+		struct sum_vector_group<N,N> {
+			template<typename Pools, typename...Fs>
+			static void run(Pools&, Fs&...) noexcept {
+			}
+		};
+	}
+
+	/**
+	 * A sequence of sum type values, stored structure-of-arrays style.
+	 *
+	 * A `std::vector<sum_type<Ts...>>` pads every element to the size of the
+	 * largest alternative. When the alternatives differ significantly in
+	 * size, most of each cache line fetched while traversing such a vector is
+	 * padding. `sum_vector` instead keeps one contiguous pool per
+	 * alternative, plus a compact tag+index stream recording the insertion
+	 * order, so each element occupies exactly the size of its own
+	 * alternative (plus eight bytes of locator).
+	 *
+	 * Elements are immovable between alternatives once inserted; the
+	 * container is append-only apart from `clear`. Visitation mirrors
+	 * `sum_type`: per-element `match` with the same exhaustiveness checking,
+	 * and a grouped `matchAll` that runs each case clause over its entire
+	 * pool as one tight loop.
+	 *
+	 * \note Each alternative's pool is limited to 2^32 elements, as is the
+	 *       number of alternatives. The locator stream is kept at eight
+	 *       bytes per element on that account.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::sum_vector<small,large> ticks;
+	 *   ticks.emplace_back(ftl::constructor<small>(), ...);
+	 *   ticks.emplace_back(ftl::constructor<large>(), ...);
+	 *
+	 *   for(auto e : ticks) {
+	 *       e.match(
+	 *           [](const small& s){ ... },
+	 *           [](const large& l){ ... }
+	 *       );
+	 *   }
+	 * \endcode
+	 *
+	 * \ingroup sum_vector
+	 */
+	template<typename...Ts>
+	class sum_vector {
+	public:
+		using size_type = size_t;
+
+	private:
+		struct locator {
+			uint32_t tag;
+			uint32_t index;
+		};
+
+		using pools_type = std::tuple<std::vector<Ts>...>;
+
+	public:
+		/**
+		 * Proxy referring to one element of a `sum_vector`.
+		 *
+		 * Holds no storage of its own; `match` resolves through the owning
+		 * container's pools.
+		 */
+		class const_reference {
+		public:
+			const_reference() = delete;
+			const_reference(const const_reference&) = default;
+			~const_reference() = default;
+
+			/**
+			 * Pattern match on the referenced element.
+			 *
+			 * Semantics&mdash;including the exhaustiveness check and the
+			 * common return type&mdash;are exactly those of
+			 * `sum_type::match`, with the case clauses receiving `const`
+			 * references.
+			 */
+			template<typename...Fs>
+			auto match(Fs&&...fs) const
+			-> typename ::ftl::_dtl::common_return_type<
+				type_seq<Ts...>,type_seq<Fs...>
+			>::type {
+
+				static_assert(
+					_dtl::exhaustive_match<
+						type_seq<Fs...>,type_seq<Ts...>
+					>::value,
+					"Match statements must be exhaustive"
+				);
+
+				using return_type = typename _dtl::common_return_type<
+					type_seq<Ts...>,type_seq<Fs...>
+				>::type;
+
+				return _dtl::sum_vector_visitor<0,sizeof...(Ts)>
+					::template visit<return_type>(
+						vec->pools, loc.tag, loc.index, fs...
+					);
+			}
+
+			/// The index of the active alternative.
+			constexpr size_t activeIndex() const noexcept {
+				return loc.tag;
+			}
+
+		private:
+			friend class sum_vector;
+
+			const_reference(const sum_vector& v, locator l) noexcept
+			: vec(&v), loc(l) {}
+
+			const sum_vector* vec;
+			locator loc;
+		};
+
+		/**
+		 * Forward iterator traversing elements in insertion order.
+		 *
+		 * Dereferences to a `const_reference` proxy; mutate elements through
+		 * `matchAll` instead.
+		 */
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = const_reference;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const const_reference*;
+			using reference = const_reference;
+
+			const_iterator() = default;
+			const_iterator(const const_iterator&) = default;
+			~const_iterator() = default;
+
+			const_iterator& operator= (const const_iterator&) = default;
+
+			const_reference operator* () const {
+				return const_reference(*vec, vec->locs[i]);
+			}
+
+			const_iterator& operator++ () {
+				++i;
+				return *this;
+			}
+
+			const_iterator operator++ (int) {
+				auto it(*this);
+				++i;
+				return it;
+			}
+
+			bool operator== (const const_iterator& other) const noexcept {
+				return vec == other.vec && i == other.i;
+			}
+
+			bool operator!= (const const_iterator& other) const noexcept {
+				return !(*this == other);
+			}
+
+		private:
+			friend class sum_vector;
+
+			const_iterator(const sum_vector& v, size_type n) noexcept
+			: vec(&v), i(n) {}
+
+			const sum_vector* vec = nullptr;
+			size_type i = 0;
+		};
+
+		sum_vector() = default;
+		sum_vector(const sum_vector&) = default;
+		sum_vector(sum_vector&&) = default;
+		~sum_vector() = default;
+
+		sum_vector& operator= (const sum_vector&) = default;
+		sum_vector& operator= (sum_vector&&) = default;
+
+		/**
+		 * Construct an element of alternative `T` in place, at the back.
+		 *
+		 * As with `sum_type`, the alternative is selected explicitly with a
+		 * constructor tag:
+		 * \code
+		 *   v.emplace_back(ftl::constructor<B>(), 12, "foo");
+		 * \endcode
+		 */
+		template<typename T, typename...Args>
+		void emplace_back(constructor<T>, Args&&...args) {
+			constexpr size_t I = index_of<T,Ts...>::value;
+
+			/* The pool grows first: if the element constructor or the
+			 * pool's reallocation throws, no locator has been appended yet,
+			 * so the container never holds a locator indexing past the end
+			 * of its pool. A throw from the locator push itself leaves only
+			 * an unreferenced pool element behind.
+			 */
+			auto& pool = std::get<I>(pools);
+			pool.emplace_back(std::forward<Args>(args)...);
+			locs.push_back(locator{
+				static_cast<uint32_t>(I),
+				static_cast<uint32_t>(pool.size() - 1)
+			});
+		}
+
+		/**
+		 * Append a value of one of the alternatives.
+		 *
+		 * The alternative is deduced from the argument; it must match one of
+		 * `Ts` exactly (after stripping references and cv-qualifiers).
+		 */
+		template<typename T, size_t I = index_of<plain_type<T>,Ts...>::value>
+		void push_back(T&& t) {
+			// Pool first, locator second; see emplace_back
+			auto& pool = std::get<I>(pools);
+			pool.push_back(std::forward<T>(t));
+			locs.push_back(locator{
+				static_cast<uint32_t>(I),
+				static_cast<uint32_t>(pool.size() - 1)
+			});
+		}
+
+		/// Number of elements, over all alternatives.
+		size_type size() const noexcept {
+			return locs.size();
+		}
+
+		bool empty() const noexcept {
+			return locs.empty();
+		}
+
+		/// Number of elements of alternative `T`.
+		template<typename T>
+		size_type count() const noexcept {
+			return std::get<index_of<T,Ts...>::value>(pools).size();
+		}
+
+		void clear() noexcept {
+			clear_pools<0>();
+			locs.clear();
+		}
+
+		/// Unchecked access to the element at insertion position `i`.
+		const_reference operator[] (size_type i) const {
+			return const_reference(*this, locs[i]);
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(*this, 0);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(*this, locs.size());
+		}
+
+		/**
+		 * Pattern match every element, pool by pool.
+		 *
+		 * Each case clause runs over its entire alternative's pool as one
+		 * contiguous, homogeneous loop&mdash;the traversal the
+		 * structure-of-arrays layout exists to make fast. Pools are visited
+		 * in the order the alternatives appear in `Ts`, and each pool in
+		 * insertion order; insertion order _between_ alternatives is not
+		 * respected. Use plain iteration when it must be.
+		 *
+		 * Exhaustiveness is checked exactly as in `sum_type::match`.
+		 */
+		template<typename...Fs>
+		void matchAll(Fs&&...fs) const {
+			static_assert(
+				_dtl::exhaustive_match<
+					type_seq<Fs...>,type_seq<Ts...>
+				>::value,
+				"Match statements must be exhaustive"
+			);
+
+			_dtl::sum_vector_group<0,sizeof...(Ts)>::run(pools, fs...);
+		}
+
+		/// \overload
+		template<typename...Fs>
+		void matchAll(Fs&&...fs) {
+			static_assert(
+				_dtl::exhaustive_match<
+					type_seq<Fs...>,type_seq<Ts...>
+				>::value,
+				"Match statements must be exhaustive"
+			);
+
+			_dtl::sum_vector_group<0,sizeof...(Ts)>::run(pools, fs...);
+		}
+
+	private:
+		template<size_t I>
+		typename std::enable_if<(I < sizeof...(Ts))>::type clear_pools()
+		noexcept {
+			std::get<I>(pools).clear();
+			clear_pools<I+1>();
+		}
+
+		template<size_t I>
+		typename std::enable_if<I == sizeof...(Ts)>::type clear_pools()
+		noexcept {
+		}
+
+		pools_type pools;
+		std::vector<locator> locs;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,1192 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_THREAD_POOL_H
+#define FTL_THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <iterator>
+#include "prelude.h"
+#include "future.h"
+#include "lazy.h"
+#include "concepts/monoid.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup threadpool Thread Pool
+	 *
+	 * A fixed-size, work-stealing thread pool, for use as executor with
+	 * ftl::task.
+	 *
+	 * \code
+	 *   #include <ftl/thread_pool.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<chrono>`
+	 * - `<cstdint>`
+	 * - `<memory>`
+	 * - `<thread>`
+	 * - `<deque>`
+	 * - `<vector>`
+	 * - \ref prelude
+	 * - \ref future
+	 * - \ref lazy
+	 * - \ref monoid
+	 */
+
+	namespace _dtl {
+		/* Chase-Lev work-stealing deque, holding pointers to heap-allocated
+		 * jobs.
+		 *
+		 * The owning worker pushes and pops at the bottom without locking;
+		 * other workers steal from the top with a single CAS. The memory
+		 * ordering follows Lê et al., "Correct and Efficient Work-Stealing
+		 * for Weakly Ordered Memory Models" (PPoPP '13).
+		 */
+		class work_stealing_deque {
+		public:
+			using job_ptr = function<void()>*;
+
+			work_stealing_deque() : top(1), bottom(1), buf(new ring(6)) {}
+
+			work_stealing_deque(const work_stealing_deque&) = delete;
+			work_stealing_deque& operator= (const work_stealing_deque&)
+				= delete;
+
+			// Only reached once every thread touching the deque has stopped
+			~work_stealing_deque() {
+				for(auto j = pop(); j; j = pop())
+					delete j;
+
+				delete buf.load(std::memory_order_relaxed);
+				for(auto r : retired)
+					delete r;
+			}
+
+			/// Push a job at the bottom. Owner only.
+			void push(job_ptr j) {
+				auto b = bottom.load(std::memory_order_relaxed);
+				auto t = top.load(std::memory_order_acquire);
+				auto a = buf.load(std::memory_order_relaxed);
+
+				if(b - t > static_cast<int64_t>(a->size()) - 1)
+					a = grow(a, t, b);
+
+				a->put(b, j);
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			/// Pop a job from the bottom, or nullptr. Owner only.
+			job_ptr pop() {
+				auto b = bottom.load(std::memory_order_relaxed) - 1;
+				auto a = buf.load(std::memory_order_relaxed);
+				bottom.store(b, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto t = top.load(std::memory_order_relaxed);
+
+				job_ptr j = nullptr;
+				if(t <= b) {
+					j = a->get(b);
+					if(t == b) {
+						// Last element; race any stealers for it
+						if(!top.compare_exchange_strong(
+								t, t + 1,
+								std::memory_order_seq_cst,
+								std::memory_order_relaxed))
+							j = nullptr;
+
+						bottom.store(b + 1, std::memory_order_relaxed);
+					}
+				}
+				else {
+					bottom.store(b + 1, std::memory_order_relaxed);
+				}
+
+				return j;
+			}
+
+			/// Steal a job from the top, or nullptr. Any thread.
+			job_ptr steal() {
+				auto t = top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto b = bottom.load(std::memory_order_acquire);
+
+				if(t >= b)
+					return nullptr;
+
+				auto a = buf.load(std::memory_order_acquire);
+				auto j = a->get(t);
+				if(!top.compare_exchange_strong(
+						t, t + 1,
+						std::memory_order_seq_cst,
+						std::memory_order_relaxed))
+					return nullptr;
+
+				return j;
+			}
+
+		private:
+			/* Power-of-two circular buffer. The slots are atomic because
+			 * stealers may read them while the owner writes unrelated ones.
+			 */
+			struct ring {
+				explicit ring(unsigned lg)
+				: log_size(lg)
+				, slots(new std::atomic<job_ptr>[size_t(1) << lg]) {}
+
+				~ring() {
+					delete[] slots;
+				}
+
+				size_t size() const noexcept {
+					return size_t(1) << log_size;
+				}
+
+				job_ptr get(int64_t i) const {
+					return slots[i & (size() - 1)]
+						.load(std::memory_order_relaxed);
+				}
+
+				void put(int64_t i, job_ptr j) {
+					slots[i & (size() - 1)]
+						.store(j, std::memory_order_relaxed);
+				}
+
+				unsigned log_size;
+				std::atomic<job_ptr>* slots;
+			};
+
+			// Owner only; called from push when the buffer is full
+			ring* grow(ring* a, int64_t t, int64_t b) {
+				auto bigger = new ring(a->log_size + 1);
+				for(auto i = t; i < b; ++i)
+					bigger->put(i, a->get(i));
+
+				buf.store(bigger, std::memory_order_release);
+
+				// Stealers may still be reading the old buffer; retire it
+				// instead of deleting it
+				retired.push_back(a);
+				return bigger;
+			}
+
+			std::atomic<int64_t> top;
+			std::atomic<int64_t> bottom;
+			std::atomic<ring*> buf;
+			std::vector<ring*> retired;
+		};
+	}
+
+	/**
+	 * A fixed-size pool of work-stealing worker threads.
+	 *
+	 * Each worker owns a lock-free deque of jobs. Jobs forked from a worker
+	 * (see ftl::fork) go to the bottom of its own deque and are run by that
+	 * same worker in LIFO order&mdash;preserving locality&mdash;unless an
+	 * idle worker steals them from the top first. Jobs submitted from
+	 * outside the pool go to a shared FIFO queue that the workers poll
+	 * between deque jobs. The destructor waits for all submitted jobs to
+	 * finish before joining the workers.
+	 *
+	 * The pool itself is deliberately minimal; the intended ways of using it
+	 * are through ftl::async for coarse, independent computations and
+	 * ftl::fork/ftl::join for fine-grained recursive ones.
+	 *
+	 * \ingroup threadpool
+	 */
+	class thread_pool {
+	public:
+		/**
+		 * Create a pool of `nthreads` workers.
+		 *
+		 * By default, as many workers as the hardware has concurrent threads
+		 * are created (or a single one, if that cannot be determined).
+		 */
+		explicit thread_pool(
+				size_t nthreads = std::thread::hardware_concurrency()
+		) : idlers(0), done(false) {
+			if(nthreads == 0)
+				nthreads = 1;
+
+			deques.reserve(nthreads);
+			for(size_t i = 0; i < nthreads; ++i) {
+				deques.emplace_back(
+					new _dtl::work_stealing_deque()
+				);
+			}
+
+			workers.reserve(nthreads);
+			for(size_t i = 0; i < nthreads; ++i)
+				workers.emplace_back([this,i](){ work(i); });
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool(thread_pool&&) = delete;
+
+		~thread_pool() {
+			{
+				std::unique_lock<std::mutex> l{lock};
+				done = true;
+			}
+
+			job_signal.notify_all();
+
+			for(auto& w : workers)
+				w.join();
+		}
+
+		thread_pool& operator= (const thread_pool&) = delete;
+		thread_pool& operator= (thread_pool&&) = delete;
+
+		/**
+		 * Submit a job for execution on one of the workers.
+		 *
+		 * Jobs must not throw; wrap anything that might in something that
+		 * captures the exception (ftl::async does exactly that).
+		 */
+		void submit(function<void()> job) {
+			{
+				std::unique_lock<std::mutex> l{lock};
+				jobs.push_back(std::move(job));
+			}
+
+			job_signal.notify_one();
+		}
+
+		/**
+		 * Submit a job, preferring the calling worker's own deque.
+		 *
+		 * When called from one of this pool's workers, the job goes to the
+		 * bottom of that worker's deque: no locks are taken, and the job is
+		 * the next thing the worker runs unless an idle worker steals it
+		 * first. From any other thread, identical to submit.
+		 *
+		 * The same no-throw requirement as submit's applies.
+		 */
+		void submit_local(function<void()> job) {
+			auto& id = this_worker();
+			if(id.pool == this) {
+				deques[id.index]->push(
+					new function<void()>(std::move(job))
+				);
+
+				if(idlers.load(std::memory_order_relaxed) > 0)
+					job_signal.notify_one();
+			}
+			else
+				submit(std::move(job));
+		}
+
+		/**
+		 * Run one pending job on the calling thread, if one can be found.
+		 *
+		 * Only does anything when called from one of this pool's workers;
+		 * ftl::join uses it to keep a waiting worker busy instead of
+		 * blocking it.
+		 *
+		 * \return Whether a job was found and run.
+		 */
+		bool run_pending_job() {
+			auto& id = this_worker();
+			if(id.pool != this)
+				return false;
+
+			return run_one(id.index);
+		}
+
+		/// Check whether the calling thread is one of this pool's workers.
+		bool is_worker_thread() const noexcept {
+			return this_worker().pool == this;
+		}
+
+		/// The number of worker threads in the pool.
+		size_t size() const noexcept {
+			return workers.size();
+		}
+
+	private:
+		/* Identifies the pool and deque owned by the calling thread, if it
+		 * is a worker. Kept as a function-local thread_local so that a
+		 * header-only build needs no out-of-line definition.
+		 */
+		struct worker_id {
+			thread_pool* pool = nullptr;
+			size_t index = 0;
+		};
+
+		static worker_id& this_worker() noexcept {
+			static thread_local worker_id id;
+			return id;
+		}
+
+		// Own deque first (LIFO), then the shared queue, then steal
+		bool run_one(size_t me) {
+			if(auto j = deques[me]->pop())
+				return run_owned(j);
+
+			function<void()> job;
+			bool found = false;
+			{
+				std::unique_lock<std::mutex> l{lock};
+				if(!jobs.empty()) {
+					job = std::move(jobs.front());
+					jobs.pop_front();
+					found = true;
+				}
+			}
+
+			if(found) {
+				job();
+				return true;
+			}
+
+			for(size_t k = 1; k < deques.size(); ++k) {
+				auto victim = (me + k) % deques.size();
+				if(auto j = deques[victim]->steal())
+					return run_owned(j);
+			}
+
+			return false;
+		}
+
+		bool run_owned(_dtl::work_stealing_deque::job_ptr j) {
+			std::unique_ptr<function<void()>> job{j};
+			(*job)();
+			return true;
+		}
+
+		void work(size_t me) {
+			auto& id = this_worker();
+			id.pool = this;
+			id.index = me;
+
+			while(true) {
+				if(run_one(me))
+					continue;
+
+				std::unique_lock<std::mutex> l{lock};
+				if(!jobs.empty())
+					continue;
+
+				if(done)
+					return;
+
+				// The deques are not covered by the lock, so a push may race
+				// with going idle; the timeout bounds how long such a missed
+				// signal can keep this worker asleep.
+				++idlers;
+				job_signal.wait_for(l, std::chrono::milliseconds(1));
+				--idlers;
+			}
+		}
+
+		std::mutex lock;
+		std::condition_variable job_signal;
+		std::deque<function<void()>> jobs;
+		std::vector<std::unique_ptr<_dtl::work_stealing_deque>> deques;
+		std::vector<std::thread> workers;
+		std::atomic<size_t> idlers;
+		bool done;
+	};
+
+	/**
+	 * Run a computation on a thread pool, yielding a task of its result.
+	 *
+	 * The FTL counterpart of `std::async`: `f` is invoked with `args...` on
+	 * one of `pool`'s workers, and the returned ftl::task completes&mdash;
+	 * running any attached continuations on that worker&mdash;as soon as it
+	 * returns. Exceptions raised by `f` are captured and rethrown from
+	 * `task::get`.
+	 *
+	 * Because ftl::task's applicative instance completes as soon as all of
+	 * its operands have, combining independent pool-launched computations
+	 * with `apply` runs them concurrently:
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto r = fn
+	 *       % ftl::async(pool, fetchA)
+	 *       * ftl::async(pool, fetchB);
+	 *   // fetchA and fetchB run in parallel; r completes when both have
+	 * \endcode
+	 *
+	 * As with ftl::defer, all parameters are _copied_. Use `std::cref` if
+	 * call by reference is desired.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<typename F, typename T = result_of<F()>>
+	task<T> async(thread_pool& pool, F f) {
+		auto state = std::make_shared<_dtl::task_state<T>>();
+
+		pool.submit(function<void()>{[f,state]() {
+			try {
+				state->complete(f());
+			}
+			catch(...) {
+				state->fail(std::current_exception());
+			}
+		}});
+
+		return task<T>{std::move(state)};
+	}
+
+	/// \overload
+	template<
+			typename F,
+			typename A,
+			typename...Args,
+			typename T = result_of<F(A,Args...)>
+	>
+	task<T> async(thread_pool& pool, F f, A&& a, Args&&...args) {
+		auto t = std::make_tuple(
+			std::forward<A>(a), std::forward<Args>(args)...
+		);
+		auto state = std::make_shared<_dtl::task_state<T>>();
+
+		pool.submit(function<void()>{[f,t,state]() {
+			try {
+				state->complete(tuple_apply(f, t));
+			}
+			catch(...) {
+				state->fail(std::current_exception());
+			}
+		}});
+
+		return task<T>{std::move(state)};
+	}
+
+	/**
+	 * Spawn a computation as a lightweight child task.
+	 *
+	 * The fine-grained counterpart of ftl::async, intended for recursive
+	 * divide and conquer: called from one of `pool`'s workers, the child is
+	 * pushed to that worker's own deque&mdash;a handful of atomic
+	 * operations, no locks&mdash;where the same worker picks it up in LIFO
+	 * order unless an idle worker steals it first. Called from any other
+	 * thread, behaves exactly like ftl::async.
+	 *
+	 * Use together with ftl::join, which collapses the child back into its
+	 * parent without ever blocking a worker:
+	 *
+	 * \code
+	 *   int treeSum(ftl::thread_pool& pool, const node* n) {
+	 *       if(!n)
+	 *           return 0;
+	 *
+	 *       auto l = ftl::fork(pool, [&pool,n]{
+	 *           return treeSum(pool, n->left);
+	 *       });
+	 *       auto r = treeSum(pool, n->right);
+	 *
+	 *       return ftl::join(pool, std::move(l)) + r;
+	 *   }
+	 * \endcode
+	 *
+	 * Exceptions raised by `f` are captured and rethrown from join (or
+	 * task::get).
+	 *
+	 * \ingroup threadpool
+	 */
+	template<typename F, typename T = result_of<F()>>
+	task<T> fork(thread_pool& pool, F f) {
+		auto state = std::make_shared<_dtl::task_state<T>>();
+
+		pool.submit_local(function<void()>{[f,state]() {
+			try {
+				state->complete(f());
+			}
+			catch(...) {
+				state->fail(std::current_exception());
+			}
+		}});
+
+		return task<T>{std::move(state)};
+	}
+
+	/**
+	 * Wait for a forked task, helping the pool along the way.
+	 *
+	 * Where task::get blocks the calling thread, join keeps running other
+	 * pending jobs from `pool` until `t`'s result is available. This is what
+	 * makes unbounded recursive forking safe: a worker waiting on a child it
+	 * spawned runs that child (or some other useful job) itself rather than
+	 * occupying a thread, so a computation may fork hundreds of thousands of
+	 * subtasks onto a handful of workers without deadlock or thread
+	 * explosion.
+	 *
+	 * Called from a thread outside the pool, equivalent to task::get.
+	 *
+	 * Like get, consumes the task and rethrows any captured exception.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<typename T>
+	T join(thread_pool& pool, task<T> t) {
+		if(pool.is_worker_thread()) {
+			while(!t.is_ready()) {
+				if(!pool.run_pending_job())
+					std::this_thread::yield();
+			}
+		}
+
+		return t.get();
+	}
+
+	/**
+	 * Map each element to a monoid and fold the results in parallel.
+	 *
+	 * The parallel counterpart of `ftl::foldMap`: `c` is split into one chunk
+	 * per worker in `pool`, each chunk is folded locally on the pool, and the
+	 * per-chunk results are combined with `monoid::append`. The monoid laws
+	 * guarantee associativity, so the result equals that of the sequential
+	 * fold whenever `append` is law-abiding.
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto total = ftl::parallelFoldMap(pool, ftl::sum<int>, hugeVector);
+	 * \endcode
+	 *
+	 * \tparam C must be a random access container.
+	 * \tparam Fn must satisfy \ref fn`<`\ref monoidpg`(T)>`, where `T` is
+	 *         `C`'s element type.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<
+			typename Fn,
+			typename C,
+			typename T = Value_type<C>,
+			typename M = result_of<plain_type<Fn>(T)>
+	>
+	M parallelFoldMap(thread_pool& pool, Fn fn, const C& c) {
+		static_assert(
+			Monoid<M>(),
+			"The result of Fn(T) is not an instance of Monoid."
+		);
+
+		using iterator = typename C::const_iterator;
+
+		static_assert(
+			std::is_base_of<
+				std::random_access_iterator_tag,
+				typename std::iterator_traits<iterator>::iterator_category
+			>::value,
+			"C must be a random access container."
+		);
+
+		auto const n = c.size();
+
+		if(n == 0)
+			return monoid<M>::id();
+
+		auto nchunks = pool.size();
+		if(nchunks > n)
+			nchunks = n;
+
+		auto const chunk = n / nchunks;
+		auto const longer = n % nchunks;
+
+		std::vector<task<M>> parts;
+		parts.reserve(nchunks);
+
+		auto it = c.begin();
+		for(size_t i = 0; i < nchunks; ++i) {
+			auto first = it;
+			auto last = first + (chunk + (i < longer ? 1 : 0));
+			it = last;
+
+			parts.push_back(async(pool, [fn,first,last]() -> M {
+				auto m = monoid<M>::id();
+				for(auto j = first; j != last; ++j)
+					m = monoid<M>::append(std::move(m), fn(*j));
+
+				return m;
+			}));
+		}
+
+		auto m = monoid<M>::id();
+		for(auto& p : parts)
+			m = monoid<M>::append(std::move(m), p.get());
+
+		return m;
+	}
+
+	namespace _dtl {
+		/* Output staging for the parallel combinators below.
+		 *
+		 * Workers write their chunks of the pre-sized result in place,
+		 * which is only safe while distinct elements occupy distinct
+		 * storage. std::vector<bool> is bit-packed&mdash;adjacent elements
+		 * share words&mdash;so concurrent chunk writes into it are a data
+		 * race no matter where the chunk boundaries fall. bool results are
+		 * therefore staged in a byte-per-element buffer, which the workers
+		 * fill instead, and converted to the packed result only after
+		 * every worker has joined.
+		 */
+		template<typename R, typename U>
+		struct par_output {
+			using buffer = R;
+
+			static R finish(R&& buf) {
+				return std::move(buf);
+			}
+		};
+
+		template<typename R>
+		struct par_output<R,bool> {
+			using buffer = std::vector<char>;
+
+			static R finish(buffer&& buf) {
+				R r(buf.size());
+
+				auto out = r.begin();
+				for(auto b : buf)
+					*out++ = b != 0;
+
+				return r;
+			}
+		};
+	}
+
+	/**
+	 * Parallel cartesian apply for vectors.
+	 *
+	 * The parallel counterpart of the vector applicative's `apply`: the
+	 * result is pre-sized to `fs.size() * xs.size()` and the outer loop
+	 * over `fs` is partitioned across the workers in `pool`, each writing
+	 * its own contiguous range of slots. Result order is identical to the
+	 * sequential instance's.
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto grid = ftl::parallelApply(pool, models, inputs);
+	 * \endcode
+	 *
+	 * \tparam U The result type of applying an `F` to a `T`; must be
+	 *         DefaultConstructible, since the slots are materialised
+	 *         before the workers fill them. For `U` = `bool`, the workers
+	 *         write a byte-per-element staging buffer rather than the
+	 *         bit-packed `std::vector<bool>` directly, whose shared words
+	 *         would otherwise make adjacent chunks race.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<
+			typename F,
+			typename Af,
+			typename T,
+			typename A,
+			typename U = result_of<F(T)>
+	>
+	Rebind<std::vector<T,A>,U> parallelApply(
+			thread_pool& pool,
+			const std::vector<F,Af>& fs,
+			const std::vector<T,A>& xs) {
+		static_assert(
+			std::is_default_constructible<U>::value,
+			"The result type of F(T) must be DefaultConstructible."
+		);
+
+		using output = _dtl::par_output<Rebind<std::vector<T,A>,U>,U>;
+
+		typename output::buffer r(fs.size() * xs.size());
+
+		if(r.empty())
+			return output::finish(std::move(r));
+
+		auto nchunks = pool.size();
+		if(nchunks > fs.size())
+			nchunks = fs.size();
+
+		auto const chunk = fs.size() / nchunks;
+		auto const longer = fs.size() % nchunks;
+
+		std::vector<task<bool>> parts;
+		parts.reserve(nchunks);
+
+		size_t row = 0;
+		for(size_t i = 0; i < nchunks; ++i) {
+			auto const first = row;
+			auto const last = first + chunk + (i < longer ? 1 : 0);
+			row = last;
+
+			parts.push_back(async(pool, [&fs,&xs,&r,first,last]() -> bool {
+				auto out = r.begin() + first*xs.size();
+				for(size_t j = first; j < last; ++j) {
+					for(auto& x : xs)
+						*out++ = fs[j](x);
+				}
+
+				return true;
+			}));
+		}
+
+		// Joining also rethrows anything a worker threw
+		for(auto& p : parts)
+			p.get();
+
+		return output::finish(std::move(r));
+	}
+
+	/**
+	 * Map a function over a random access container, in parallel.
+	 *
+	 * The parallel counterpart of `functor::map`: the result is pre-sized to
+	 * `c.size()` and the elements are partitioned into one contiguous chunk
+	 * per worker in `pool`, each writing its own range of slots. Element
+	 * order is preserved, so the result equals `f % c` exactly.
+	 *
+	 * Containers smaller than `seqThreshold` are mapped sequentially on the
+	 * calling thread instead; below that point, the cost of scheduling the
+	 * chunks dwarfs the work they contain. Tune the threshold down for very
+	 * expensive `f`, up for very cheap ones.
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto enriched = ftl::parallelMap(pool, enrich, ticks);
+	 * \endcode
+	 *
+	 * \tparam C must be a random access container.
+	 * \tparam U The result type of applying an `F` to an element; must be
+	 *         DefaultConstructible, since the slots are materialised before
+	 *         the workers fill them. For `U` = `bool`, the workers write a
+	 *         byte-per-element staging buffer rather than the bit-packed
+	 *         `std::vector<bool>` directly, whose shared words would
+	 *         otherwise make adjacent chunks race.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<
+			typename F,
+			typename C,
+			typename T = Value_type<C>,
+			typename U = result_of<F(T)>
+	>
+	Rebind<C,U> parallelMap(
+			thread_pool& pool, F f, const C& c, size_t seqThreshold = 1024) {
+		static_assert(
+			std::is_default_constructible<U>::value,
+			"The result type of F(T) must be DefaultConstructible."
+		);
+
+		using iterator = typename C::const_iterator;
+
+		static_assert(
+			std::is_base_of<
+				std::random_access_iterator_tag,
+				typename std::iterator_traits<iterator>::iterator_category
+			>::value,
+			"C must be a random access container."
+		);
+
+		auto const n = c.size();
+
+		using output = _dtl::par_output<Rebind<C,U>,U>;
+
+		typename output::buffer r(n);
+
+		if(n == 0)
+			return output::finish(std::move(r));
+
+		if(n < seqThreshold || pool.size() == 1) {
+			auto out = r.begin();
+			for(auto it = c.begin(); it != c.end(); ++it)
+				*out++ = f(*it);
+
+			return output::finish(std::move(r));
+		}
+
+		auto nchunks = pool.size();
+		if(nchunks > n)
+			nchunks = n;
+
+		auto const chunk = n / nchunks;
+		auto const longer = n % nchunks;
+
+		std::vector<task<bool>> parts;
+		parts.reserve(nchunks);
+
+		auto it = c.begin();
+		size_t pos = 0;
+		for(size_t i = 0; i < nchunks; ++i) {
+			auto const len = chunk + (i < longer ? 1 : 0);
+			auto const first = it;
+			auto const last = first + len;
+			auto const out0 = pos;
+			it = last;
+			pos += len;
+
+			parts.push_back(async(pool, [f,first,last,out0,&r]() -> bool {
+				auto out = r.begin() + out0;
+				for(auto j = first; j != last; ++j)
+					*out++ = f(*j);
+
+				return true;
+			}));
+		}
+
+		// Joining also rethrows anything a worker threw
+		for(auto& p : parts)
+			p.get();
+
+		return output::finish(std::move(r));
+	}
+
+	/**
+	 * Force every lazy value in a container, in parallel.
+	 *
+	 * The parallel counterpart of `ftl::deepForce`: the elements are
+	 * partitioned into one contiguous chunk per worker in `pool`, and each
+	 * chunk is deep-forced on the pool. The memoized results land in the
+	 * lazies' shared states as usual, so once this returns, every copy of
+	 * every computation in `c` is ready. Pre-forcing a large structure at
+	 * startup thus costs roughly its sequential time divided by the number
+	 * of workers.
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   std::vector<ftl::lazy<model>> models = ...;
+	 *
+	 *   // Warm every model before serving
+	 *   ftl::parallelDeepForce(pool, models);
+	 * \endcode
+	 *
+	 * \note Forcing plain `lazy` values is not synchronised; this is safe
+	 *       as long as distinct elements do not share a deferred
+	 *       computation. Elements copied from one another _do_ share state,
+	 *       and concurrently forcing such copies from different chunks is a
+	 *       data race&mdash;build the structure from `atomic_lazy` if that
+	 *       can happen.
+	 *
+	 * \tparam C must be a random access container of deep-forceable
+	 *         elements.
+	 *
+	 * \ingroup threadpool
+	 */
+	template<typename C, typename T = Value_type<C>>
+	void parallelDeepForce(thread_pool& pool, const C& c) {
+		static_assert(
+			_dtl::deep_forceable<T>::value,
+			"C's elements contain nothing to force"
+		);
+
+		using iterator = typename C::const_iterator;
+
+		static_assert(
+			std::is_base_of<
+				std::random_access_iterator_tag,
+				typename std::iterator_traits<iterator>::iterator_category
+			>::value,
+			"C must be a random access container."
+		);
+
+		auto const n = c.size();
+
+		if(n == 0)
+			return;
+
+		auto nchunks = pool.size();
+		if(nchunks > n)
+			nchunks = n;
+
+		auto const chunk = n / nchunks;
+		auto const longer = n % nchunks;
+
+		std::vector<task<bool>> parts;
+		parts.reserve(nchunks);
+
+		auto it = c.begin();
+		for(size_t i = 0; i < nchunks; ++i) {
+			auto first = it;
+			auto last = first + (chunk + (i < longer ? 1 : 0));
+			it = last;
+
+			parts.push_back(async(pool, [first,last]() -> bool {
+				for(auto j = first; j != last; ++j)
+					deepForce(*j);
+
+				return true;
+			}));
+		}
+
+		// Joining also rethrows anything a forced thunk threw
+		for(auto& p : parts)
+			p.get();
+	}
+
+	/**
+	 * Exception thrown by work refused or skipped by a cancelled scope.
+	 *
+	 * Tasks spawned in an ftl::async_scope that has been cancelled fail with
+	 * this exception instead of running their computation.
+	 *
+	 * \ingroup threadpool
+	 */
+	class scope_cancelled : public std::exception {
+	public:
+		const char* what() const noexcept override {
+			return "ftl::async_scope cancelled";
+		}
+	};
+
+	namespace _dtl {
+		/* Shared bookkeeping of an async_scope: the cancellation flag, plus
+		 * a count of jobs the scope has spawned but not yet seen finish.
+		 */
+		struct scope_state {
+			std::atomic<bool> cancelled{false};
+			std::mutex lock;
+			std::condition_variable all_done;
+			size_t in_flight = 0;
+
+			void started() {
+				std::lock_guard<std::mutex> l{lock};
+				++in_flight;
+			}
+
+			void finished() {
+				std::unique_lock<std::mutex> l{lock};
+				if(--in_flight == 0) {
+					l.unlock();
+					all_done.notify_all();
+				}
+			}
+		};
+	}
+
+	/**
+	 * Copyable handle for observing a scope's cancellation.
+	 *
+	 * Long-running computations spawned in an async_scope can poll their
+	 * token at convenient points and bail out early when the scope no longer
+	 * wants their result.
+	 *
+	 * \see async_scope
+	 *
+	 * \ingroup threadpool
+	 */
+	class cancel_token {
+	public:
+		cancel_token() = delete;
+		cancel_token(const cancel_token&) = default;
+		cancel_token(cancel_token&&) = default;
+
+		cancel_token& operator= (const cancel_token&) = default;
+		cancel_token& operator= (cancel_token&&) = default;
+
+		/// Check whether cancellation has been requested, without blocking.
+		bool cancelled() const noexcept {
+			return state->cancelled.load(std::memory_order_relaxed);
+		}
+
+		/// Throw scope_cancelled if cancellation has been requested.
+		void check() const {
+			if(cancelled())
+				throw scope_cancelled{};
+		}
+
+	private:
+		friend class async_scope;
+
+		explicit cancel_token(std::shared_ptr<_dtl::scope_state> s)
+		: state(std::move(s)) {}
+
+		std::shared_ptr<_dtl::scope_state> state;
+	};
+
+	/**
+	 * A structured-concurrency scope for pool-launched tasks.
+	 *
+	 * ftl::async hands back a task and forgets about it: abandoning the task
+	 * leaks queued work that still runs to completion and occupies a worker.
+	 * An async_scope keeps its spawned computations on a leash instead. Its
+	 * destructor joins everything still in flight, so no spawned work
+	 * outlives the scope, and `cancel()` makes every not-yet-started job
+	 * fail cheaply with scope_cancelled instead of running:
+	 *
+	 * \code
+	 *   ftl::async_scope scope;
+	 *   auto primary = scope.spawn(pool, queryPrimary);
+	 *   auto backup = scope.spawn(pool, queryBackup);
+	 *
+	 *   auto r = primary.get();
+	 *   scope.cancel();     // the backup is now irrelevant
+	 * \endcode                // ~scope joins whatever did start
+	 *
+	 * Cancellation is cooperative: jobs that have already started run to
+	 * completion unless they poll a `token()` themselves, and continuation
+	 * chains can insert checks at bind boundaries with `then`.
+	 *
+	 * \par Concepts
+	 * \li Not CopyConstructible, not MoveConstructible
+	 *
+	 * \ingroup threadpool
+	 */
+	class async_scope {
+	public:
+		async_scope() : state(std::make_shared<_dtl::scope_state>()) {}
+		async_scope(const async_scope&) = delete;
+		async_scope(async_scope&&) = delete;
+
+		/// Joins all spawned work still in flight.
+		~async_scope() {
+			join();
+		}
+
+		async_scope& operator= (const async_scope&) = delete;
+		async_scope& operator= (async_scope&&) = delete;
+
+		/**
+		 * Run a computation on a thread pool, owned by this scope.
+		 *
+		 * Exactly like ftl::async, except the scope tracks the job: `join()`
+		 * (and the destructor) waits for it, and if the scope is cancelled
+		 * before the job reaches a worker, the computation never runs and
+		 * the task fails with scope_cancelled instead.
+		 */
+		template<typename F, typename T = result_of<F()>>
+		task<T> spawn(thread_pool& pool, F f) {
+			auto s = state;
+
+			if(s->cancelled)
+				return failed<T>();
+
+			s->started();
+			auto tstate = std::make_shared<_dtl::task_state<T>>();
+
+			pool.submit(function<void()>{[f,s,tstate]() {
+				if(s->cancelled) {
+					tstate->fail(
+						std::make_exception_ptr(scope_cancelled{})
+					);
+					s->finished();
+					return;
+				}
+
+				try {
+					tstate->complete(f());
+				}
+				catch(...) {
+					tstate->fail(std::current_exception());
+				}
+
+				// Attached continuations have run by now; joiners may
+				// proceed
+				s->finished();
+			}});
+
+			return task<T>{std::move(tstate)};
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename A,
+				typename...Args,
+				typename T = result_of<F(A,Args...)>
+		>
+		task<T> spawn(thread_pool& pool, F f, A&& a, Args&&...args) {
+			auto t = std::make_tuple(
+				std::forward<A>(a), std::forward<Args>(args)...
+			);
+
+			return spawn(pool, [f,t]() { return tuple_apply(f, t); });
+		}
+
+		/**
+		 * Attach a continuation with a cancellation check at the boundary.
+		 *
+		 * Exactly like task::then, except that if the scope has been
+		 * cancelled by the time the predecessor completes, `f` is never
+		 * invoked and the resulting task fails with scope_cancelled. In a
+		 * chain of such binds, cancellation thus takes effect at the next
+		 * step boundary rather than after the whole chain.
+		 */
+		template<typename T, typename F, typename U = result_of<F(T)>>
+		task<U> then(task<T>&& t, F f) {
+			auto tok = token();
+
+			return t.then([tok,f](T&& x) -> U {
+				tok.check();
+				return f(std::move(x));
+			});
+		}
+
+		/**
+		 * Request cancellation of all work owned by the scope.
+		 *
+		 * Spawned jobs that have not yet started, and `then` continuations
+		 * that have not yet run, fail with scope_cancelled instead of
+		 * executing. Jobs already running are unaffected unless they poll a
+		 * token.
+		 */
+		void cancel() noexcept {
+			state->cancelled = true;
+		}
+
+		/// Check whether the scope has been cancelled.
+		bool cancelled() const noexcept {
+			return state->cancelled.load(std::memory_order_relaxed);
+		}
+
+		/// A token for spawned computations to poll for cancellation.
+		cancel_token token() const {
+			return cancel_token{state};
+		}
+
+		/**
+		 * Block until no spawned work remains in flight.
+		 *
+		 * Does not consume the spawned tasks' results; exceptions&mdash;
+		 * including scope_cancelled&mdash;surface only from their `get`.
+		 */
+		void join() {
+			std::unique_lock<std::mutex> l{state->lock};
+			while(state->in_flight > 0)
+				state->all_done.wait(l);
+		}
+
+	private:
+		// An already failed task; the cheap path for refused work
+		template<typename T>
+		static task<T> failed() {
+			auto s = std::make_shared<_dtl::task_state<T>>();
+			s->fail(std::make_exception_ptr(scope_cancelled{}));
+			return task<T>{std::move(s)};
+		}
+
+		std::shared_ptr<_dtl::scope_state> state;
+	};
+}
+
+#endif
+
@@ -431,7 +431,7 @@ namespace ftl {
 			>::value;
 	};
 
-	template<typename>
+	template<typename, typename>
 	class function;
 
 	/**
@@ -462,8 +462,8 @@ namespace ftl {
 		static constexpr bool value = true;
 	};
 
-	template<typename R, typename...Args>
-	struct is_monomorphic<ftl::function<R(Args...)>> {
+	template<typename R, typename S, typename...Args>
+	struct is_monomorphic<ftl::function<R(Args...),S>> {
 		static constexpr bool value = true;
 	};
 
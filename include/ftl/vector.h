@@ -24,6 +24,7 @@
 #define FTL_VECTOR_H
 
 #include <vector>
+#include <cstring>
 #include "concepts/foldable.h"
 #include "concepts/monad.h"
 #include "concepts/zippable.h"
@@ -49,6 +50,7 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <vector>
+	 * - <cstring>
 	 * - \ref foldable
 	 * - \ref monad
 	 */
@@ -67,9 +69,64 @@ namespace ftl {
 		using rebind = std::vector<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		// Trivially copyable elements are appended with a single bulk copy,
+		// anything else is moved one element at a time.
+		template<typename U>
+		using is_memcpy_appendable = std::integral_constant<
+			bool,
+			std::is_trivially_copyable<U>::value
+			&& std::is_default_constructible<U>::value
+		>;
+
+		template<typename U, typename Au>
+		void vector_append(
+				std::vector<U,Au>& out, std::vector<U,Au>& el,
+				std::true_type) {
+
+			if(el.empty())
+				return;
+
+			auto n = out.size();
+			out.resize(n + el.size());
+			std::memcpy(&out[n], el.data(), el.size() * sizeof(U));
+		}
+
+		template<typename U, typename Au>
+		void vector_append(
+				std::vector<U,Au>& out, std::vector<U,Au>& el,
+				std::false_type) {
+
+			out.insert(
+					out.end(),
+					std::make_move_iterator(el.begin()),
+					std::make_move_iterator(el.end())
+			);
+		}
+
+		template<typename U, typename Au, typename Nested>
+		std::vector<U,Au> vector_concat(Nested& nested) {
+			size_t total = 0;
+			for(auto& el : nested)
+				total += el.size();
+
+			std::vector<U,Au> result;
+			result.reserve(total);
+
+			for(auto& el : nested)
+				vector_append(result, el, is_memcpy_appendable<U>{});
+
+			return result;
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * The result is sized by a first pass over the mapped vectors, so it is
+	 * allocated exactly once, regardless of how many elements the inner
+	 * vectors hold.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref container`<B>(A)>`
 	 *
 	 * \ingroup vector
@@ -83,19 +140,9 @@ namespace ftl {
 	>
 	std::vector<U,Au> concatMap(F f, const std::vector<T,A>& v) {
 
-		std::vector<U,Au> result;
-		result.reserve(v.size() * 2);
 		auto nested = f % v;
 
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
-		}
-
-		return result;
+		return _dtl::vector_concat<U,Au>(nested);
 	}
 
 	/**
@@ -114,18 +161,7 @@ namespace ftl {
 
 		auto nested = f % std::move(v);
 
-		std::vector<U,Au> result;
-		result.reserve(nested.size() * 2);
-
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
-		}
-
-		return result;
+		return _dtl::vector_concat<U,Au>(nested);
 	}
 
 	/**
@@ -177,6 +213,38 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Accumulator instance for std::vector.
+	 *
+	 * Splices new elements onto the end of the accumulator in place, so a
+	 * streaming fold of N fragments is O(total elements) instead of copying
+	 * the accumulated state once per fragment.
+	 *
+	 * \ingroup vector
+	 */
+	template<typename...Ts>
+	struct accumulator<std::vector<Ts...>> {
+		static void append_to(
+				std::vector<Ts...>& v1,
+				const std::vector<Ts...>& v2) {
+			v1.insert(v1.end(), v2.begin(), v2.end());
+		}
+
+		static void append_to(
+				std::vector<Ts...>& v1,
+				std::vector<Ts...>&& v2) {
+			if(v1.empty())
+				v1 = std::move(v2);
+
+			else {
+				v1.reserve(v1.size() + v2.size());
+				std::move(v2.begin(), v2.end(), std::back_inserter(v1));
+			}
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	/**
 	 * Monad implementation of vectors
 	 *
@@ -251,16 +319,110 @@ namespace ftl {
 		>
 		static vector<U> bind(vector<T>&& v, F&& f);
 #endif
+
+		/**
+		 * Cartesian apply with product size preallocation.
+		 *
+		 * Overrides the derived implementation, which appends into an
+		 * unreserved result through bind and so reallocates O(log n)
+		 * times. The result's size is known to be exactly
+		 * `fs.size() * v.size()` up front, so it is reserved in one step.
+		 */
+		template<
+				typename Mf,
+				typename F = Value_type<plain_type<Mf>>,
+				typename U = result_of<F(T)>
+		>
+		static Rebind<std::vector<T,A>,U> apply(
+				Mf&& fs, const std::vector<T,A>& v) {
+			Rebind<std::vector<T,A>,U> r;
+			r.reserve(fs.size() * v.size());
+
+			for(auto& f : fs) {
+				for(auto& x : v)
+					r.push_back(f(x));
+			}
+
+			return r;
+		}
 	};
 
+	namespace _dtl {
+		// foldMap fast path for the arithmetic monoids: four independent
+		// accumulators on the underlying primitive break the sequential
+		// dependency chain, so the optimizer can keep multiple vector lanes
+		// busy. The monoid laws make the reassociation observable only
+		// through floating point rounding.
+		template<typename M, typename Fn, typename T, typename A>
+		M vector_foldMap(Fn& fn, const std::vector<T,A>& v, std::true_type) {
+			using AM = arith_monoid<M>;
+			using N = typename AM::primitive;
+
+			N a0 = AM::raw_id();
+			N a1 = AM::raw_id();
+			N a2 = AM::raw_id();
+			N a3 = AM::raw_id();
+
+			auto const n = v.size();
+			size_t i = 0;
+			for(; i + 4 <= n; i += 4) {
+				a0 = AM::combine(a0, static_cast<N>(fn(v[i])));
+				a1 = AM::combine(a1, static_cast<N>(fn(v[i+1])));
+				a2 = AM::combine(a2, static_cast<N>(fn(v[i+2])));
+				a3 = AM::combine(a3, static_cast<N>(fn(v[i+3])));
+			}
+
+			for(; i < n; ++i)
+				a0 = AM::combine(a0, static_cast<N>(fn(v[i])));
+
+			return M(AM::combine(AM::combine(a0,a1), AM::combine(a2,a3)));
+		}
+
+		template<typename M, typename Fn, typename T, typename A>
+		M vector_foldMap(Fn& fn, const std::vector<T,A>& v, std::false_type) {
+			auto m = monoid<M>::id();
+			for(const auto& e : v)
+				appendTo(m, fn(e));
+
+			return m;
+		}
+	}
+
 	/**
 	 * Foldable instance for std::vector.
 	 *
+	 * `foldMap` (and hence `fold`) of one of the arithmetic monoids&mdash;
+	 * \ref ftl::sum_monoid "sum_monoid", \ref ftl::prod_monoid "prod_monoid",
+	 * \ref ftl::min_monoid "min_monoid", \ref ftl::max_monoid "max_monoid" or
+	 * one of the bitwise monoids, over an arithmetic type&mdash;runs as a
+	 * reassociated
+	 * multi-accumulator loop over the vector's contiguous storage, which
+	 * compilers can vectorize. All other folds behave exactly like the
+	 * derived implementations.
+	 *
 	 * \ingroup vector
 	 */
 	template<typename T, typename A>
 	struct foldable<std::vector<T,A>>
-	: deriving_foldable<bidirectional_iterable<std::vector<T,A>>> {};
+	: deriving_foldl<std::vector<T,A>>
+	, deriving_foldr<std::vector<T,A>>
+	, deriving_fold<std::vector<T,A>> {
+
+		template<
+				typename Fn,
+				typename M = plain_type<result_of<plain_type<Fn>(T)>>
+		>
+		static M foldMap(Fn fn, const std::vector<T,A>& v) {
+			static_assert(
+				Monoid<M>(),
+				"The result of Fn(T) is not an instance of Monoid."
+			);
+
+			return _dtl::vector_foldMap<M>(fn, v, _dtl::arith_monoid<M>{});
+		}
+
+		static constexpr bool instance = true;
+	};
 
 	/**
 	 * Zippable instance for std::vector.
@@ -0,0 +1,739 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_VIEW_H
+#define FTL_VIEW_H
+
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup view Views
+	 *
+	 * Lazy, fusing views of containers.
+	 *
+	 * \code
+	 *   #include <ftl/view.h>
+	 * \endcode
+	 *
+	 * A view is a cheap, non-owning description of a container traversal.
+	 * Mapping or filtering a view produces another view; no work is done and
+	 * no intermediate container is materialized until the pipeline hits a
+	 * terminal operation&mdash;one of the \ref foldablepg folds, or
+	 * `ftl::materialize`. A chain of any number of maps and filters is thus
+	 * fused into a single traversal of the underlying container:
+	 *
+	 * \code
+	 *   std::vector<int> v = ...;
+	 *
+	 *   auto sum = ftl::foldl(
+	 *       std::plus<int>(), 0,
+	 *       g % (f % ftl::view(v))   // one pass over v, no temporaries
+	 *   );
+	 * \endcode
+	 *
+	 * Views reference the container they were created from; they must not
+	 * outlive it.
+	 *
+	 * \par Dependencies
+	 * - `<iterator>`
+	 * - `<vector>`
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref zippable
+	 */
+
+	/**
+	 * A view of a plain container.
+	 *
+	 * The root of every view pipeline. Holds a reference to the viewed
+	 * container, which must satisfy \ref fwditerable.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	class container_view {
+	public:
+		using value_type = Value_type<C>;
+
+		explicit container_view(const C& c) noexcept : c(&c) {}
+
+		/// Invoke `fn` on each element of the underlying container.
+		template<typename Fn>
+		void each(Fn fn) const {
+			for(const auto& e : *c)
+				fn(e);
+		}
+
+	private:
+		const C* c;
+	};
+
+	/**
+	 * A view with a function applied to each element.
+	 *
+	 * Created by mapping any function over an existing view; elements are
+	 * transformed on the fly as the pipeline is traversed.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V, typename F>
+	class mapped_view {
+	public:
+		using value_type = result_of<F(Value_type<V>)>;
+
+		mapped_view(V src, F f) : src(std::move(src)), f(std::move(f)) {}
+
+		template<typename Fn>
+		void each(Fn fn) const {
+			const F& f_ = f;
+			src.each([&f_,&fn](const Value_type<V>& e){
+				fn(f_(e));
+			});
+		}
+
+	private:
+		V src;
+		F f;
+	};
+
+	/**
+	 * A view restricted to the elements satisfying a predicate.
+	 *
+	 * Created by `ftl::filter`; elements failing the predicate are simply
+	 * skipped during traversal.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V, typename P>
+	class filtered_view {
+	public:
+		using value_type = Value_type<V>;
+
+		filtered_view(V src, P p) : src(std::move(src)), p(std::move(p)) {}
+
+		template<typename Fn>
+		void each(Fn fn) const {
+			const P& p_ = p;
+			src.each([&p_,&fn](const Value_type<V>& e){
+				if(p_(e))
+					fn(e);
+			});
+		}
+
+	private:
+		V src;
+		P p;
+	};
+
+	/**
+	 * A view with a container-valued function mapped and flattened.
+	 *
+	 * Created by the view overload of `concatMap`; the inner containers
+	 * produced by the mapped function are traversed in place, never
+	 * concatenated into an intermediate result.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V, typename F>
+	class flat_mapped_view {
+	public:
+		using value_type = Value_type<result_of<F(Value_type<V>)>>;
+
+		flat_mapped_view(V src, F f) : src(std::move(src)), f(std::move(f)) {}
+
+		template<typename Fn>
+		void each(Fn fn) const {
+			const F& f_ = f;
+			src.each([&f_,&fn](const Value_type<V>& e){
+				auto&& inner = f_(e);
+				for(auto& ie : inner)
+					fn(ie);
+			});
+		}
+
+	private:
+		V src;
+		F f;
+	};
+
+	/**
+	 * A view of two containers zipped with a function.
+	 *
+	 * Created by `ftl::zipView` or `ftl::zipWithView`. Traversal walks both
+	 * containers in lockstep, ending with the shorter of the two; no result
+	 * container is ever allocated.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C1, typename C2, typename F>
+	class zipped_view {
+	public:
+		using value_type = result_of<F(Value_type<C1>,Value_type<C2>)>;
+
+		zipped_view(const C1& c1, const C2& c2, F f)
+		: c1(&c1), c2(&c2), f(std::move(f)) {}
+
+		template<typename Fn>
+		void each(Fn fn) const {
+			auto i1 = c1->begin();
+			auto i2 = c2->begin();
+
+			for(; i1 != c1->end() && i2 != c2->end(); ++i1, ++i2)
+				fn(f(*i1, *i2));
+		}
+
+	private:
+		const C1* c1;
+		const C2* c2;
+		F f;
+	};
+
+	template<typename C>
+	struct parametric_type_traits<container_view<C>> {
+		using value_type = typename container_view<C>::value_type;
+	};
+
+	template<typename V, typename F>
+	struct parametric_type_traits<mapped_view<V,F>> {
+		using value_type = typename mapped_view<V,F>::value_type;
+	};
+
+	template<typename V, typename P>
+	struct parametric_type_traits<filtered_view<V,P>> {
+		using value_type = typename filtered_view<V,P>::value_type;
+	};
+
+	template<typename V, typename F>
+	struct parametric_type_traits<flat_mapped_view<V,F>> {
+		using value_type = typename flat_mapped_view<V,F>::value_type;
+	};
+
+	template<typename C1, typename C2, typename F>
+	struct parametric_type_traits<zipped_view<C1,C2,F>> {
+		using value_type = typename zipped_view<C1,C2,F>::value_type;
+	};
+
+	namespace _dtl {
+		template<typename>
+		struct is_view : std::false_type {};
+
+		template<typename C>
+		struct is_view<container_view<C>> : std::true_type {};
+
+		template<typename V, typename F>
+		struct is_view<mapped_view<V,F>> : std::true_type {};
+
+		template<typename V, typename P>
+		struct is_view<filtered_view<V,P>> : std::true_type {};
+
+		template<typename V, typename F>
+		struct is_view<flat_mapped_view<V,F>> : std::true_type {};
+
+		template<typename C1, typename C2, typename F>
+		struct is_view<zipped_view<C1,C2,F>> : std::true_type {};
+
+		// Functor implementation shared by all view types: mapping defers
+		// the function instead of materializing anything.
+		template<typename V>
+		struct view_functor {
+			using T = Value_type<V>;
+
+			template<typename Fn, typename = Requires<
+					!std::is_same<result_of<Fn(T)>,void>::value
+			>>
+			static mapped_view<V,plain_type<Fn>> map(Fn&& fn, const V& v) {
+				return mapped_view<V,plain_type<Fn>>(v, std::forward<Fn>(fn));
+			}
+		};
+
+		// Foldable implementation shared by all view types. The folds are
+		// the terminal operations of a view pipeline; this is where the
+		// single fused traversal actually runs.
+		template<typename V>
+		struct view_foldable {
+			using T = Value_type<V>;
+
+			template<
+					typename Fn,
+					typename U,
+					typename = Requires<
+						std::is_same<U, result_of<Fn(U,T)>>::value
+					>
+			>
+			static U foldl(Fn&& fn, U z, const V& v) {
+				v.each([&fn,&z](const T& t){
+					z = fn(std::move(z), t);
+				});
+
+				return z;
+			}
+
+			template<
+					typename Fn,
+					typename M = result_of<plain_type<Fn>(T)>
+			>
+			static M foldMap(Fn&& fn, const V& v) {
+				static_assert(
+					Monoid<M>(),
+					"The result of Fn(T) is not an instance of Monoid."
+				);
+
+				auto m = monoid<M>::id();
+				v.each([&fn,&m](const T& t){
+					m = monoid<M>::append(std::move(m), fn(t));
+				});
+
+				return m;
+			}
+
+			template<typename M = T>
+			static M fold(const V& v) {
+				static_assert(Monoid<M>(), "M must satisfy Monoid");
+
+				auto m = monoid<M>::id();
+				v.each([&m](const M& t){
+					m = monoid<M>::append(std::move(m), t);
+				});
+
+				return m;
+			}
+		};
+	}
+
+	/**
+	 * Functor instance for views.
+	 *
+	 * Unlike the container instances, `map` does not produce a new container;
+	 * it produces another view, with the mapped function fused into the
+	 * traversal.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	struct functor<container_view<C>>
+	: _dtl::view_functor<container_view<C>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename F>
+	struct functor<mapped_view<V,F>>
+	: _dtl::view_functor<mapped_view<V,F>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename P>
+	struct functor<filtered_view<V,P>>
+	: _dtl::view_functor<filtered_view<V,P>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename F>
+	struct functor<flat_mapped_view<V,F>>
+	: _dtl::view_functor<flat_mapped_view<V,F>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename C1, typename C2, typename F>
+	struct functor<zipped_view<C1,C2,F>>
+	: _dtl::view_functor<zipped_view<C1,C2,F>> {
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for views.
+	 *
+	 * Folding is terminal: the whole pipeline runs as one traversal of the
+	 * underlying container, with every fused map and filter applied on the
+	 * fly.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	struct foldable<container_view<C>>
+	: _dtl::view_foldable<container_view<C>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename F>
+	struct foldable<mapped_view<V,F>>
+	: _dtl::view_foldable<mapped_view<V,F>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename P>
+	struct foldable<filtered_view<V,P>>
+	: _dtl::view_foldable<filtered_view<V,P>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename V, typename F>
+	struct foldable<flat_mapped_view<V,F>>
+	: _dtl::view_foldable<flat_mapped_view<V,F>> {
+		static constexpr bool instance = true;
+	};
+
+	template<typename C1, typename C2, typename F>
+	struct foldable<zipped_view<C1,C2,F>>
+	: _dtl::view_foldable<zipped_view<C1,C2,F>> {
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Create a view of a container.
+	 *
+	 * The container is referenced, not copied; it must outlive the view and
+	 * every pipeline built from it.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	container_view<C> view(const C& c) noexcept {
+		return container_view<C>{c};
+	}
+
+	/**
+	 * Restrict a view to the elements satisfying `p`.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`, where `T` is the view's
+	 *         element type.
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename P,
+			typename V,
+			typename = Requires<_dtl::is_view<V>::value>
+	>
+	filtered_view<V,plain_type<P>> filter(P&& p, V v) {
+		return filtered_view<V,plain_type<P>>(
+				std::move(v), std::forward<P>(p)
+		);
+	}
+
+	/**
+	 * Maps and flattens in one step, lazily.
+	 *
+	 * The view counterpart of the container `concatMap`s: `f` may return any
+	 * \ref fwditerable, whose elements are traversed in place rather than
+	 * concatenated into a new container.
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename F,
+			typename V,
+			typename = Requires<_dtl::is_view<V>::value>
+	>
+	flat_mapped_view<V,plain_type<F>> concatMap(F&& f, V v) {
+		return flat_mapped_view<V,plain_type<F>>(
+				std::move(v), std::forward<F>(f)
+		);
+	}
+
+	/**
+	 * Run a view pipeline and collect the result in a container.
+	 *
+	 * `C` can be any container with a `push_back` accepting the view's
+	 * element type.
+	 *
+	 * \ingroup view
+	 */
+	namespace _dtl {
+		// Tuple-maker for zipView, mirroring _zip::mktup.
+		template<typename T, typename U>
+		struct view_mktup {
+			std::tuple<T,U> operator() (const T& t, const U& u) const {
+				return std::make_tuple(t, u);
+			}
+		};
+	}
+
+	/**
+	 * Zip two containers with a function, lazily.
+	 *
+	 * The view counterpart of `ftl::zipWith`: elements are combined pairwise
+	 * on the fly as the view is traversed, truncating to the shorter of the
+	 * two containers. Both containers are referenced, not copied; they must
+	 * outlive the view.
+	 *
+	 * \ingroup view
+	 */
+	template<typename F, typename C1, typename C2>
+	zipped_view<C1,C2,plain_type<F>>
+	zipWithView(F&& f, const C1& c1, const C2& c2) {
+		return zipped_view<C1,C2,plain_type<F>>(
+				c1, c2, std::forward<F>(f)
+		);
+	}
+
+	/**
+	 * Zip two containers into a view of tuples.
+	 *
+	 * Equivalent of `zipWithView(make_tuple, c1, c2)`; the allocation-free
+	 * counterpart of `ftl::zip`.
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename C1,
+			typename C2,
+			typename T = Value_type<C1>,
+			typename U = Value_type<C2>
+	>
+	zipped_view<C1,C2,_dtl::view_mktup<T,U>>
+	zipView(const C1& c1, const C2& c2) {
+		return zipped_view<C1,C2,_dtl::view_mktup<T,U>>(
+				c1, c2, _dtl::view_mktup<T,U>{}
+		);
+	}
+
+	template<
+			typename C,
+			typename V,
+			typename = Requires<_dtl::is_view<V>::value>
+	>
+	C materialize(const V& v) {
+		C c;
+		v.each([&c](const Value_type<V>& e){
+			c.push_back(e);
+		});
+
+		return c;
+	}
+
+	/**
+	 * A non-owning view of a contiguous sequence.
+	 *
+	 * Where the pipeline views above describe a _traversal_, a span merely
+	 * borrows a subrange of someone else's contiguous storage: two words,
+	 * trivially copyable, nothing owned. Folding a window of a large vector
+	 * through a span touches only the window; no elements are copied out
+	 * first:
+	 *
+	 * \code
+	 *   std::vector<double> samples = ...;
+	 *
+	 *   for(size_t i = 0; i + 4096 <= samples.size(); ++i) {
+	 *       auto w = ftl::foldl(
+	 *           accumulate, window_state{},
+	 *           ftl::slice(samples, i, 4096)
+	 *       );
+	 *       ...
+	 *   }
+	 * \endcode
+	 *
+	 * Like every view, a span references storage it does not own and must
+	 * not outlive it. For fused map/filter pipelines over a span, use it as
+	 * the root of a view: `ftl::view(ftl::slice(v, i, n))`.
+	 *
+	 * \par Concepts
+	 * \li \ref fullycons
+	 * \li \ref fwditerable
+	 * \li \ref functorpg (maps materialize; see `functor<span<T>>`)
+	 * \li \ref foldablepg
+	 * \li \ref zippablepg
+	 *
+	 * \ingroup view
+	 */
+	template<typename T>
+	class span {
+	public:
+		using value_type = T;
+		using const_iterator = const T*;
+		using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+		/// The empty span; views nothing.
+		constexpr span() noexcept : first(nullptr), n(0) {}
+
+		constexpr span(const T* p, size_t n) noexcept : first(p), n(n) {}
+
+		constexpr span(const span&) noexcept = default;
+		constexpr span(span&&) noexcept = default;
+
+		span& operator= (const span&) noexcept = default;
+		span& operator= (span&&) noexcept = default;
+
+		const_iterator begin() const noexcept {
+			return first;
+		}
+
+		const_iterator end() const noexcept {
+			return first + n;
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		constexpr size_t size() const noexcept {
+			return n;
+		}
+
+		constexpr bool empty() const noexcept {
+			return n == 0;
+		}
+
+		constexpr const T& operator[] (size_t i) const noexcept {
+			return first[i];
+		}
+
+		const T& front() const noexcept {
+			return first[0];
+		}
+
+		const T& back() const noexcept {
+			return first[n-1];
+		}
+
+		/**
+		 * A sub-span of this span.
+		 *
+		 * Out-of-range requests are clamped: slicing past the end yields an
+		 * empty span, over-long counts are truncated.
+		 */
+		constexpr span slice(size_t from, size_t count) const noexcept {
+			return from >= n
+				? span()
+				: span(first + from, count < n - from ? count : n - from);
+		}
+
+	private:
+		const T* first;
+		size_t n;
+	};
+
+	/**
+	 * Borrow a subrange of a contiguous container as a span.
+	 *
+	 * `C` may be any container with contiguous storage exposed through
+	 * `data()` and `size()`&mdash;`std::vector`, `std::array`,
+	 * `std::basic_string`, `ftl::small_vector`, and so on. Out-of-range
+	 * requests are clamped, exactly as in `span::slice`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C, typename T = Value_type<C>>
+	span<T> slice(const C& c, size_t from, size_t count) noexcept {
+		return span<T>(c.data(), c.size()).slice(from, count);
+	}
+
+	/// \overload
+	template<typename T>
+	constexpr span<T> slice(span<T> s, size_t from, size_t count) noexcept {
+		return s.slice(from, count);
+	}
+
+	template<typename T>
+	struct parametric_type_traits<span<T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = std::vector<U>;
+	};
+
+	/**
+	 * Functor instance for span.
+	 *
+	 * A span cannot own computed elements, so unlike the pipeline views,
+	 * `map` materializes its result as a `std::vector`. For a lazy, fusing
+	 * map, root a view in the span instead: `f % ftl::view(s)`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename T>
+	struct functor<span<T>> {
+
+		template<typename F, typename U = result_of<F(T)>>
+		static std::vector<U> map(F&& f, span<T> s) {
+			std::vector<U> result;
+			result.reserve(s.size());
+			for(const auto& e : s)
+				result.push_back(f(e));
+
+			return result;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for span.
+	 *
+	 * The folds run straight over the borrowed storage (in reverse for
+	 * `foldr`); nothing is copied into an intermediate container.
+	 *
+	 * \ingroup view
+	 */
+	template<typename T>
+	struct foldable<span<T>>
+	: deriving_foldable<bidirectional_iterable<span<T>>> {};
+
+	/**
+	 * Zippable instance for span.
+	 *
+	 * As with the functor instance, the result of a zip cannot be another
+	 * span; it materializes as a `std::vector`. The borrowed operand itself
+	 * is still streamed, not copied. The second operand may be any
+	 * \ref fwditerable.
+	 *
+	 * \ingroup view
+	 */
+	template<typename T>
+	struct zippable<span<T>> {
+		template<
+				typename F, typename Iterable,
+				typename U = result_of<F(T,Value_type<Iterable>)>,
+				typename = Requires<
+					ForwardIterable<Iterable>()
+				>
+		>
+		static std::vector<U> zipWith(F f, span<T> z, const Iterable& i) {
+			auto it1 = z.begin();
+			auto it2 = i.begin();
+
+			std::vector<U> result;
+
+			while(it1 != z.end() && it2 != i.end()) {
+				result.push_back(f(*it1, *it2));
+				++it1; ++it2;
+			}
+
+			return result;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
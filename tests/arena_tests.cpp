@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <vector>
+#include <ftl/arena.h>
+#include <ftl/function.h>
+#include <ftl/maybe_trans.h>
+#include <ftl/vector.h>
+#include "arena_tests.h"
+
+test_set arena_tests{
+	std::string("arena"),
+	{
+		std::make_tuple(
+			std::string("bump allocation and rewind"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{256};
+
+				auto p1 = a.allocate(16);
+				auto p2 = a.allocate(16);
+
+				auto used = a.used();
+
+				auto mark = a.save();
+				a.allocate(64);
+				a.rewind(mark);
+
+				return p1 != p2 && used >= 32 && a.used() == used;
+			})
+		),
+		std::make_tuple(
+			std::string("grows past initial capacity"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{32};
+
+				auto p1 = a.allocate(16);
+				auto p2 = a.allocate(1024);
+				auto p3 = a.allocate(4096);
+
+				return p1 && p2 && p3 && a.used() >= 16 + 1024 + 4096;
+			})
+		),
+		std::make_tuple(
+			std::string("arena_scope rewinds on destruction"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{128};
+
+				a.allocate(8);
+				auto used = a.used();
+
+				{
+					ftl::arena_scope scope{a};
+					a.allocate(64);
+
+					{
+						ftl::arena_scope inner{a};
+						a.allocate(512);
+					}
+				}
+
+				return a.used() == used;
+			})
+		),
+		std::make_tuple(
+			std::string("arena_allocator in a container"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{1024};
+
+				std::vector<int,ftl::arena_allocator<int>> v{
+					ftl::arena_allocator<int>{a}
+				};
+
+				for(int i = 0; i < 100; ++i)
+					v.push_back(i);
+
+				return v[99] == 99 && a.used() >= 100*sizeof(int);
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::function heap fallback uses the arena"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{1024};
+				ftl::arena_scope scope{a};
+
+				// Too large for the inline buffer, so storage must come
+				// from the arena
+				struct big {
+					size_t xs[8];
+				};
+
+				big b{{1,2,3,4,5,6,7,8}};
+
+				auto used0 = a.used();
+
+				size_t r = 0;
+				{
+					ftl::function<size_t(size_t)> f{
+						std::allocator_arg,
+						ftl::scoped_arena_allocator<char>{},
+						[b](size_t i){ return b.xs[i]; }
+					};
+
+					r = f(3);
+				}
+
+				return r == 4 && a.used() > used0;
+			})
+		),
+		std::make_tuple(
+			std::string("closure graph freed wholesale"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a{1024};
+
+				auto used0 = a.used();
+				int r = 0;
+
+				{
+					ftl::arena_scope scope{a};
+
+					struct big {
+						int xs[16];
+					};
+
+					big b{};
+					b.xs[7] = 7;
+
+					std::vector<ftl::function<int()>> fs;
+					for(int i = 0; i < 100; ++i) {
+						fs.emplace_back(
+							std::allocator_arg,
+							ftl::scoped_arena_allocator<char>{},
+							[b,i](){ return b.xs[7] + i; }
+						);
+					}
+
+					for(auto& f : fs)
+						r += f();
+				}
+
+				return r == 100*7 + 99*100/2 && a.used() == used0;
+			})
+		),
+		std::make_tuple(
+			std::string("scratch scope backs transformer intermediaries"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using scratch_vec
+					= std::vector<int, scoped_arena_allocator<int>>;
+
+				auto used0 = scratch_arena().used();
+				bool allocated = false;
+
+				auto r = withScratch([&]() -> std::vector<int> {
+					using Mmt = typename maybeT<scratch_vec>::Mmt;
+
+					maybeT<scratch_vec> m{
+						Mmt{value(1), maybe<int>{}, value(3)}
+					};
+
+					auto r1 = m >>= [](int x) -> maybeT<scratch_vec> {
+						return maybeT<scratch_vec>{
+							Mmt{value(x), value(10*x)}
+						};
+					};
+
+					// All wrapper containers drew from the scratch arena
+					allocated = scratch_arena().used() > used0;
+
+					std::vector<int> out;
+					for(auto& e : *r1) {
+						if(e)
+							out.push_back(*e);
+					}
+
+					return out;
+				});
+
+				return allocated
+					&& r == std::vector<int>{1, 10, 3, 30}
+					&& scratch_arena().used() == used0;
+			})
+		)
+	}
+};
+
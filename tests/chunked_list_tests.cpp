@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/chunked_list.h>
+#include "chunked_list_tests.h"
+
+test_set chunked_list_tests{
+	std::string("chunked_list"),
+	{
+		std::make_tuple(
+			std::string("Iteration across chunk boundaries"),
+			std::function<bool()>([]() -> bool {
+				ftl::chunked_list<int> l;
+				for(int i = 0; i < 100; ++i)
+					l.push_back(i);
+
+				int expected = 0;
+				for(auto& e : l) {
+					if(e != expected++)
+						return false;
+				}
+
+				int rexpected = 99;
+				for(auto it = l.rbegin(); it != l.rend(); ++it) {
+					if(*it != rexpected--)
+						return false;
+				}
+
+				return l.size() == 100 && l.front() == 0 && l.back() == 99;
+			})
+		),
+		std::make_tuple(
+			std::string("Insert mid-list"),
+			std::function<bool()>([]() -> bool {
+				ftl::chunked_list<int> l;
+				for(int i = 0; i < 40; ++i)
+					l.push_back(i);
+
+				// Land in the middle of a full chunk
+				auto it = l.begin();
+				for(int i = 0; i < 20; ++i)
+					++it;
+
+				auto r = l.insert(it, -1);
+
+				ftl::chunked_list<int> expected;
+				for(int i = 0; i < 20; ++i)
+					expected.push_back(i);
+				expected.push_back(-1);
+				for(int i = 20; i < 40; ++i)
+					expected.push_back(i);
+
+				return *r == -1 && l == expected;
+			})
+		),
+		std::make_tuple(
+			std::string("concatMap[&]"),
+			std::function<bool()>([]() -> bool {
+				ftl::chunked_list<int> l{1,2,3,4};
+
+				auto l2 = ftl::concatMap(
+					[](int x){
+						return ftl::chunked_list<int>{2*x, 2*x-1};
+					},
+					l
+				);
+
+				return l2 == ftl::chunked_list<int>{2,1,4,3,6,5,8,7};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::id"),
+			std::function<bool()>([]() -> bool {
+
+				return ftl::monoid<ftl::chunked_list<float>>::id().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[&,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				auto l1 = ftl::chunked_list<int>{1,2};
+				auto l2 = ftl::chunked_list<int>{2,3};
+
+				return (l1 ^ l2) == ftl::chunked_list<int>{1,2,2,3}
+					&& l1.size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[&&,&&] splices"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				ftl::chunked_list<int> l1;
+				ftl::chunked_list<int> l2;
+				for(int i = 0; i < 20; ++i) {
+					l1.push_back(i);
+					l2.push_back(20 + i);
+				}
+
+				auto l3 = std::move(l1) ^ std::move(l2);
+
+				int expected = 0;
+				for(auto& e : l3) {
+					if(e != expected++)
+						return false;
+				}
+
+				return l3.size() == 40;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return float(x)+.5f; };
+				auto l = ftl::chunked_list<int>{1,2,3};
+				auto l2 = f % l;
+
+				return l2 == ftl::chunked_list<float>{1.5f, 2.5f, 3.5f};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return x+1; };
+				auto l = f % ftl::chunked_list<int>{1,2,3};
+
+				return l == ftl::chunked_list<int>{2,3,4};
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::pure"),
+			std::function<bool()>([]() -> bool {
+
+				auto l = ftl::applicative<ftl::chunked_list<int>>::pure(2);
+
+				return l == ftl::chunked_list<int>{2};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::chunked_list<int> l{1,2,3};
+
+				auto l2 = l >>= [](int x){
+					return ftl::chunked_list<int>{x, 2*x};
+				};
+
+				return l2 == ftl::chunked_list<int>{1,2,2,4,3,6};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::chunked_list<int> l;
+				for(int i = 0; i <= 100; ++i)
+					l.push_back(i);
+
+				auto r = ftl::foldl(
+					[](int acc, int x){ return acc + x; }, 0, l
+				);
+
+				return r == 5050;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::chunked_list<std::string> l{"a","b","c"};
+
+				auto r = ftl::foldr(
+					[](const std::string& x, std::string acc){
+						return acc + x;
+					},
+					std::string(""), l
+				);
+
+				return r == "cba";
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::chunked_list<int> l1{1,2,3};
+				ftl::chunked_list<int> l2{3,2,1,0};
+
+				auto l3 = ftl::zipWith(
+					[](int x, int y){ return x+y; }, l1, l2
+				);
+
+				return l3 == ftl::chunked_list<int>{4,4,4};
+			})
+		)
+	}
+};
+
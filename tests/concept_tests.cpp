@@ -115,6 +115,23 @@ test_set concept_tests{
 					((m1 >>= f1) >>= f2) == value(3);
 			})
 		),
+		std::make_tuple(
+			std::string("Monad: mdo"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f1 = [](int x){ return value(float(x)*0.5f); };
+				auto f2 = [](float x){ return value(int(x*3.33f)); };
+
+				bool ran = false;
+				auto f3 = [&ran](int x){ ran = true; return value(x); };
+
+				auto m1 = mdo(value(2), f1, f2);
+				auto m2 = mdo(maybe<int>{}, f3, f1);
+
+				return m1 == value(3) && m2 == nothing && !ran;
+			})
+		),
 		std::make_tuple(
 			std::string("Monad: >>= [member fn]"),
 			std::function<bool()>([]() -> bool {
@@ -21,11 +21,38 @@
  * distribution.
  */
 #include <ftl/either.h>
+#include <ftl/vector.h>
 #include "either_tests.h"
 
 test_set either_tests{
 	std::string("either"),
 	{
+		std::make_tuple(
+			std::string("Trivially copyable sub-types"),
+			std::function<bool()>([]() -> bool {
+
+				return std::is_trivially_copyable<ftl::either<int,int>>::value
+					&& std::is_trivially_copyable<
+						ftl::either<char,double>>::value
+					&& !std::is_trivially_copyable<
+						ftl::either<int,std::string>>::value;
+			})
+		),
+		std::make_tuple(
+			std::string("Empty left stores no L"),
+			std::function<bool()>([]() -> bool {
+				struct unit {};
+
+				ftl::either<unit,std::string> e =
+					ftl::make_right<unit>(std::string("test"));
+
+				auto e2 = e;
+				e = ftl::make_left<std::string>(unit{});
+
+				return sizeof(e) <= sizeof(std::string) + alignof(std::string)
+					&& !e && e2 && *e2 == std::string("test");
+			})
+		),
 		std::make_tuple(
 			std::string("Preserves Eq[L]"),
 			std::function<bool()>([]() -> bool {
@@ -244,6 +271,221 @@ test_set either_tests{
 
 				return monad<either<int,int>>::join(e) == make_left<int>(2);
 			})
+		),
+		std::make_tuple(
+			std::string("match"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto el = make_left<std::string>(4);
+				auto er = make_right<int>(std::string("foo"));
+
+				auto s1 = el.match(
+					[](int x){ return x; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				auto s2 = er.match(
+					[](int x){ return x; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				return s1 == 4 && s2 == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("match [&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto e = make_right<int>(5.f);
+
+				e.match(
+					[](int&){},
+					[](float& r){ r += 1.f; }
+				);
+
+				return e.right() == 6.f;
+			})
+		),
+		std::make_tuple(
+			std::string("is_nothrow_either"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(
+					is_nothrow_either<either<int,float>>::value,
+					"either of trivial types must be on the noexcept tier"
+				);
+				static_assert(
+					!is_nothrow_either<either<int,std::string>>::value,
+					"std::string may throw on copy"
+				);
+				static_assert(
+					!is_nothrow_either<int>::value,
+					"non-either types are never nothrow eithers"
+				);
+
+				return NothrowEither<either<int,float>>();
+			})
+		),
+		std::make_tuple(
+			std::string("tailRecM runs in constant space"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// A bind chain this long would overflow the stack
+				auto r = tailRecM(
+					[](int n) -> either<std::string,either<int,int>> {
+						return n < 1000000
+							? make_right<std::string>(make_left<int>(n+1))
+							: make_right<std::string>(make_right<int>(n));
+					},
+					0
+				);
+
+				auto aborted = tailRecM(
+					[](int n) -> either<std::string,either<int,int>> {
+						return n < 10
+							? make_right<std::string>(make_left<int>(n+1))
+							: make_left<either<int,int>>(std::string("err"));
+					},
+					0
+				);
+
+				return r && *r == 1000000
+					&& !aborted && aborted.left() == std::string("err");
+			})
+		),
+		std::make_tuple(
+			std::string("lefts, rights and partitionEithers"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<either<int,char>> es;
+				for(int i = 0; i < 100; ++i) {
+					if(i % 3 == 0)
+						es.push_back(make_left<char>(i));
+					else
+						es.push_back(make_right<int>(char('a' + i % 26)));
+				}
+
+				auto ls = lefts(es);
+				auto rs = rights(es);
+				auto parts = partitionEithers(es);
+
+				if(ls.size() != 34 || rs.size() != 66)
+					return false;
+
+				// Order preserved on both sides
+				return ls.front() == 0 && ls.back() == 99
+					&& rs.front() == 'b'
+					&& parts.first == ls && parts.second == rs
+					&& lefts(std::vector<either<int,char>>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("partition kernels move from temporaries"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<either<std::string,std::string>> es;
+				es.push_back(make_left<std::string>(std::string("e1")));
+				es.push_back(make_right<std::string>(std::string("ok1")));
+				es.push_back(make_right<std::string>(std::string("ok2")));
+
+				auto parts = partitionEithers(std::move(es));
+
+				auto rs = rights(
+					std::vector<either<int,std::string>>{
+						make_right<int>(std::string("a")),
+						make_left<std::string>(1)
+					}
+				);
+
+				return parts.first == std::vector<std::string>{"e1"}
+					&& parts.second
+						== (std::vector<std::string>{"ok1", "ok2"})
+					&& rs == std::vector<std::string>{"a"};
+			})
+		),
+		std::make_tuple(
+			std::string("lefts of non-default-constructible payloads"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Trivially copyable, but no default constructor: must
+				// not take the pre-sized fast path
+				struct id {
+					explicit id(int x) : value(x) {}
+					int value;
+				};
+
+				std::vector<either<id,int>> es{
+					make_left<int>(id(1)),
+					make_right<id>(2),
+					make_left<int>(id(3))
+				};
+
+				auto ls = lefts(es);
+
+				return ls.size() == 2
+					&& ls[0].value == 1 && ls[1].value == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("traverse short-circuits on the first left"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::string;
+
+				int evals = 0;
+				auto parse = [&evals](int x) -> either<string,int> {
+					++evals;
+					return x >= 0
+						? make_right<string>(2*x)
+						: make_left<int>(string("negative"));
+				};
+
+				std::vector<int> good{1,2,3,4};
+				std::vector<int> bad{1,-2,3,4};
+
+				auto r1 = traverse(parse, good);
+
+				evals = 0;
+				auto r2 = traverse(parse, bad);
+
+				return r1 && *r1 == (std::vector<int>{2,4,6,8})
+					&& !r2 && r2.left() == string("negative")
+					&& evals == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("sequenceA inverts a vector of eithers"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::string;
+				using vec = std::vector<either<string,string>>;
+
+				vec oks{
+					make_right<string>(string("a")),
+					make_right<string>(string("b"))
+				};
+
+				auto rs = sequenceA(oks);
+
+				vec mixed{
+					make_right<string>(string("a")),
+					make_left<string>(string("e"))
+				};
+
+				// Rvalue container: payloads are moved, not copied
+				auto ls = sequenceA(std::move(mixed));
+
+				return rs && *rs == (std::vector<string>{"a","b"})
+					&& *oks[0] == string("a")
+					&& !ls && ls.left() == string("e");
+			})
 		)
 	}
 };
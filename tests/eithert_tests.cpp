@@ -60,6 +60,50 @@ test_set eithert_tests{
 				return (*g)(3) == ftl::make_left<float>(std::string("test"));
 			})
 		),
+		std::make_tuple(
+			std::string("fused bind and map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ef = eitherT<std::string,function<int(int)>>;
+
+				ef f{inplace_tag(), [](int x){
+					return make_right<std::string>(x+1);
+				}};
+
+				auto g = (
+					fuse(f)
+					>>= [](int x) -> ef {
+						return ef{inplace_tag(), [x](int y){
+							return make_right<std::string>(x*y);
+						}};
+					}
+				);
+
+				auto h = ([](int x){ return x - 1; } % g).unfuse();
+
+				return g(3) == make_right<std::string>(12)
+					&& (*h)(3) == make_right<std::string>(11);
+			})
+		),
+		std::make_tuple(
+			std::string("fused bind short-circuits on left"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ef = eitherT<std::string,function<int(int)>>;
+
+				ef f{inplace_tag(), [](int){
+					return make_left<int>(std::string("fail"));
+				}};
+
+				bool ran = false;
+				auto g = fuse(f) >>= [&ran](int x) -> ef {
+					ran = true;
+					return applicative<ef>::pure(x);
+				};
+
+				return g(3) == make_left<int>(std::string("fail")) && !ran;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/flat_map.h>
+#include "flat_map_tests.h"
+
+test_set flat_map_tests{
+	std::string("flat_map"),
+	{
+		std::make_tuple(
+			std::string("insert & find"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<int,std::string> m;
+
+				m.insert(std::make_pair(2, "two"));
+				m.insert(std::make_pair(0, "zero"));
+				m.insert(std::make_pair(1, "one"));
+
+				// Duplicate key leaves the existing entry untouched
+				auto r = m.insert(std::make_pair(1, "uno"));
+
+				return m.size() == 3
+					&& !r.second
+					&& m.find(1)->second == "one"
+					&& m.find(3) == m.end()
+					&& m.count(0) == 1 && m.count(3) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("iteration is sorted"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<int,int> m{
+					std::make_pair(3, 30),
+					std::make_pair(1, 10),
+					std::make_pair(2, 20)
+				};
+
+				int prev = 0;
+				for(const auto& kv : m) {
+					if(kv.first <= prev || kv.second != 10*kv.first)
+						return false;
+
+					prev = kv.first;
+				}
+
+				return prev == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("operator[]"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<std::string,int> m;
+
+				m["b"] = 2;
+				m["a"] = 1;
+				m["a"] += 10;
+
+				return m.size() == 2 && m["a"] == 11 && m["b"] == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("spills to heap past N"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<int,int,4> m;
+
+				for(int i = 0; i < 4; ++i)
+					m.insert(std::make_pair(i, 2*i));
+
+				bool wasInline = m.inline_storage();
+
+				for(int i = 4; i < 64; ++i)
+					m.insert(std::make_pair(i, 2*i));
+
+				bool intact = true;
+				for(int i = 0; i < 64; ++i)
+					intact &= m.find(i)->second == 2*i;
+
+				return wasInline && !m.inline_storage()
+					&& m.size() == 64 && intact;
+			})
+		),
+		std::make_tuple(
+			std::string("copy & move"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<int,std::string,2> m;
+				for(int i = 0; i < 8; ++i)
+					m.insert(std::make_pair(i, std::string("v")));
+
+				auto c = m;
+				auto s = std::move(m);
+
+				return c == s && s.size() == 8 && m.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using std::make_pair;
+
+				auto f = [](int x){ return x+1; };
+				auto s = f % ftl::flat_map<int,int>{
+					make_pair(0, 1),
+					make_pair(1, 2),
+					make_pair(2, 3)
+				};
+
+				return s == ftl::flat_map<int,int>{
+					make_pair(0, 2),
+					make_pair(1, 3),
+					make_pair(2, 4)
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				using std::make_pair;
+
+				ftl::flat_map<int,int> s{
+					make_pair(0, 1),
+					make_pair(1, 2),
+					make_pair(2, 3)
+				};
+
+				auto f = [](float x, int y){ return x + float(y); };
+
+				return ftl::foldl(f, 0.5f, s) == .5f + 1.f + 2.f + 3.f;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::make_pair;
+
+				flat_map<int,float> s{
+					make_pair(0, 2.f),
+					make_pair(1, 4.f),
+					make_pair(2, 5.f)
+				};
+				auto f = [](float x, float y){ return x/y; };
+
+				return fequal(foldr(f, 16.f, s), .15625f);
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::make_pair;
+
+				flat_map<int,int> m1{
+					make_pair(0, 1),
+					make_pair(2, 3)
+				};
+
+				flat_map<int,int> m2{
+					make_pair(1, 2),
+					make_pair(2, 99)
+				};
+
+				// Left operand wins on duplicate keys
+				auto m3 = m1 ^ m2;
+				auto m4 = m2 ^ m1;
+
+				return m3 == flat_map<int,int>{
+						make_pair(0, 1),
+						make_pair(1, 2),
+						make_pair(2, 3)
+					}
+					&& m4 == flat_map<int,int>{
+						make_pair(0, 1),
+						make_pair(1, 2),
+						make_pair(2, 99)
+					};
+			})
+		)
+	}
+};
+
@@ -20,11 +20,31 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <memory>
 #include <vector>
+#include <ftl/either.h>
 #include <ftl/functional.h>
 #include <ftl/ord.h>
 #include "functional_tests.h"
 
+namespace {
+	// Stand-in for a compiled-rule closure: too big for inline storage, and
+	// opted in to shared heap storage below.
+	struct shared_rule {
+		std::shared_ptr<int> state;
+		char table[256];
+
+		const void* operator()() const {
+			return state.get();
+		}
+	};
+}
+
+namespace ftl {
+	template<>
+	struct share_function_heap_storage<shared_rule> : std::true_type {};
+}
+
 test_set functional_tests{
 	std::string("functional"),
 	{
@@ -44,6 +64,61 @@ test_set functional_tests{
 					&& g(1,2,3) == 6;
 			})
 		),
+		std::make_tuple(
+			std::string("function with widened inline storage"),
+			std::function<bool()>([]() -> bool {
+
+				struct big_closure {
+					int a[12];
+				};
+
+				big_closure c{{1,2,3,4,5,6,7,8,9,10,11,12}};
+
+				auto fn = [c](int i){ return c.a[i]; };
+
+				static_assert(
+					ftl::_dtl::is_inplace_allocated<
+						decltype(fn),
+						std::allocator<decltype(fn)>,
+						64
+					>::value,
+					"A 48 byte closure should fit a 64 byte buffer"
+				);
+
+				ftl::function<int(int),ftl::inline_storage<64>> f = fn;
+				auto g(f);
+
+				return f(0) == 1 && g(11) == 12;
+			})
+		),
+		std::make_tuple(
+			std::string("function_ref"),
+			std::function<bool()>([]() -> bool {
+
+				static_assert(
+					std::is_trivially_copyable<
+						ftl::function_ref<int(int)>
+					>::value,
+					"function_ref must be trivially copyable"
+				);
+
+				auto f = [](int x){ return 2*x; };
+
+				ftl::function_ref<int(int)> fr = f;
+				auto fr2(fr);
+
+				auto g = ftl::compose(
+					[](int x){ return x+1; },
+					fr
+				);
+
+				auto sub = [](int x, int y){ return x - y; };
+				auto h = ftl::flip(ftl::function_ref<int(int,int)>(sub));
+
+				return fr(2) == 4 && fr2(3) == 6
+					&& g(2) == 5 && h(1, 3) == 2;
+			})
+		),
 		std::make_tuple(
 			std::string("functor<function>::map"),
 			std::function<bool()>([]() -> bool {
@@ -188,6 +263,88 @@ test_set functional_tests{
 
 				return static_cast<int>((f ^ g)(2)) == 7;
 			})
+		),
+		std::make_tuple(
+			std::string("unique_function wraps move-only targets"),
+			std::function<bool()>([]() -> bool {
+				struct owner {
+					std::unique_ptr<int> buf;
+					int operator()() const { return *buf; }
+				};
+
+				ftl::unique_function<int()> f{
+					owner{std::unique_ptr<int>(new int(42))}
+				};
+
+				auto g = std::move(f);
+
+				return g() == 42 && !f;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_function from ftl::function"),
+			std::function<bool()>([]() -> bool {
+				ftl::function<int(int)> f = [](int x){ return x+1; };
+
+				ftl::unique_function<int(int)> g = f;
+
+				return g(1) == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("tailRecM in the function monad"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Counts down to zero in steps of the argument
+				auto f = tailRecM(
+					[](int n) -> function<either<int,int>(int)> {
+						return [n](int step) -> either<int,int> {
+							return n > 0
+								? make_left<int>(n - step)
+								: make_right<int>(n);
+						};
+					},
+					100000
+				);
+
+				return f(1) == 0 && f(3) == -2;
+			})
+		),
+		std::make_tuple(
+			std::string("shared heap storage for opted-in targets"),
+			std::function<bool()>([]() -> bool {
+				static_assert(
+					!ftl::_dtl::is_inplace_allocated<
+						shared_rule,
+						std::allocator<shared_rule>
+					>::value,
+					"shared_rule must take the heap path"
+				);
+
+				auto state = std::make_shared<int>(7);
+
+				shared_rule r{state, {}};
+
+				long during;
+				const void* a;
+				const void* b;
+
+				{
+					ftl::function<const void*()> f = r;
+					auto g(f);
+					ftl::function<const void*()> h;
+					h = g;
+
+					// state, r and exactly one shared heap block
+					during = state.use_count();
+					a = f();
+					b = h();
+				}
+
+				return during == 3 && a == b
+					&& state.use_count() == 2;
+			})
 		)
 	}
 };
@@ -96,6 +96,129 @@ test_set future_tests{
 					::join(std::move(f)).get() == 1;
 			})
 		),
+		std::make_tuple(
+			std::string("task: continuation chain"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator>>=;
+
+				ftl::task_promise<int> p;
+
+				auto t = [](int x){ return x+1; } % p.get_task()
+					>>= [](int x) {
+						return ftl::task<int>::ready(2*x);
+					};
+
+				p.set_value(1);
+
+				return t.get() == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("task: applicative::apply"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::function<int(int,int)> fn = [](int x, int y){ return x+y; };
+
+				ftl::task_promise<int> p1;
+				ftl::task_promise<int> p2;
+
+				auto t = fn % p1.get_task() * p2.get_task();
+
+				// Complete in reverse order; apply must not care
+				p2.set_value(2);
+				p1.set_value(1);
+
+				return t.get() == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("task: exception propagation"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::task_promise<int> p;
+				auto t = p.get_task() >>= [](int x) {
+					return ftl::task<int>::ready(x);
+				};
+
+				p.set_exception(
+					std::make_exception_ptr(std::runtime_error("oops"))
+				);
+
+				try {
+					t.get();
+				}
+				catch(const std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("task: whenAll"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::task_promise<int> p1;
+				ftl::task_promise<std::string> p2;
+
+				auto t = ftl::whenAll(p1.get_task(), p2.get_task());
+
+				// Complete in reverse order; whenAll must not care
+				p2.set_value(std::string("two"));
+				p1.set_value(1);
+
+				auto r = t.get();
+
+				return std::get<0>(r) == 1
+					&& std::get<1>(r) == std::string("two");
+			})
+		),
+		std::make_tuple(
+			std::string("task: whenAll exception propagation"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::task_promise<int> p1;
+				ftl::task_promise<int> p2;
+
+				auto t = ftl::whenAll(p1.get_task(), p2.get_task());
+
+				p1.set_value(1);
+				p2.set_exception(
+					std::make_exception_ptr(std::runtime_error("oops"))
+				);
+
+				try {
+					t.get();
+				}
+				catch(const std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("task: whenAny"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::task_promise<int> p1;
+				ftl::task_promise<std::string> p2;
+
+				auto t = ftl::whenAny(p1.get_task(), p2.get_task());
+
+				p2.set_value(std::string("first"));
+				p1.set_value(1);
+
+				return t.get().match(
+					[](int) { return false; },
+					[](const std::string& s) { return s == "first"; }
+				);
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::append"),
 			std::function<bool()>([]() -> bool {
@@ -109,6 +232,80 @@ test_set future_tests{
 				return static_cast<int>(f.get()) == 2;
 			})
 		),
+		std::make_tuple(
+			std::string("asyncEither: bind chain of rights"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using step = asyncEither<std::string,int>;
+
+				task_promise<either<std::string,int>> p;
+				step e{p.get_task()};
+
+				auto r = std::move(e)
+					>>= [](int x){ return step::right(2*x); };
+
+				p.set_value(make_right<std::string>(3));
+
+				auto v = r.get();
+				return v && *v == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("asyncEither: left short-circuits continuations"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using step = asyncEither<std::string,int>;
+
+				int invoked = 0;
+
+				auto r = step::left(std::string("no"))
+					>>= [&invoked](int x){
+						++invoked;
+						return step::right(x+1);
+					};
+
+				auto v = r.get();
+				return !v && v.left() == std::string("no") && invoked == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("asyncEither: functor::map and lift"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ftl::operator%;
+
+				task_promise<int> p;
+				auto e = asyncEither<std::string,int>::lift(p.get_task());
+
+				auto r = [](int x){ return x+1; } % std::move(e);
+
+				p.set_value(41);
+
+				auto v = r.get();
+				return v && *v == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("asyncEither: exception propagation"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using step = asyncEither<std::string,int>;
+
+				auto r = step::right(1)
+					>>= [](int) -> step {
+						throw std::runtime_error("boom");
+					};
+
+				try {
+					r.get();
+				}
+				catch(const std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
 	}
 };
 
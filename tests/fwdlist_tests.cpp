@@ -201,6 +201,25 @@ test_set fwdlist_tests{
 				return foldr(f, 16.f, l) == .125f;
 			})
 		),
+		std::make_tuple(
+			std::string("foldable::foldr[large]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Deep enough that a recursive right fold would
+				// overflow the stack
+				std::forward_list<int> l;
+				long expected = 0;
+				for(int i = 0; i < 1000000; ++i) {
+					l.push_front(i);
+					expected += i;
+				}
+
+				auto f = [](int x, long z){ return z + x; };
+
+				return foldr(f, 0L, l) == expected;
+			})
+		),
 		std::make_tuple(
 			std::string("foldable::fold"),
 			std::function<bool()>([]() -> bool {
@@ -293,6 +312,73 @@ test_set fwdlist_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("fwdlist_builder basics"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				fwdlist_builder<int> b;
+				b.push_back(1);
+				b.push_back(2);
+				b.append(std::forward_list<int>{3,4});
+
+				fwdlist_builder<int> b2{std::forward_list<int>{5,6}};
+				b.append(std::move(b2));
+
+				return b.take() == std::forward_list<int>{1,2,3,4,5,6}
+					&& b2.empty() && b.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("fwdlist_builder splices nodes"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::forward_list<int> frag{1,2,3};
+				const int* addr = &frag.front();
+
+				fwdlist_builder<int> b;
+				b.push_back(0);
+				b.append(std::move(frag));
+
+				auto l = b.take();
+
+				// The fragment's nodes are reused, not copied
+				return &*std::next(l.begin()) == addr;
+			})
+		),
+		std::make_tuple(
+			std::string("fwdlist_builder monoid fold"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Many small fragments; quadratic appends would crawl here
+				std::forward_list<int> is;
+				auto it0 = is.before_begin();
+				for(int i = 0; i < 5000; ++i)
+					it0 = is.insert_after(it0, i);
+
+				auto b = foldMap(
+					[](int x){
+						fwdlist_builder<int> f;
+						f.push_back(x);
+						f.push_back(x);
+						return f;
+					},
+					is
+				);
+
+				auto l = b.take();
+
+				auto it = l.begin();
+				for(int j = 0; j < 5000; ++j) {
+					if(*it++ != j || *it++ != j)
+						return false;
+				}
+
+				return it == l.end();
+			})
 		)
 	}
 };
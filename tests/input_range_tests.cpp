@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ftl/input_range.h>
+#include "input_range_tests.h"
+
+test_set input_range_tests{
+	std::string("input_range"),
+	{
+		std::make_tuple(
+			std::string("foldl over input iterators is single-pass"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::istringstream source{"abc\ndef\ngh\n"};
+
+				input_range<char> chars{
+					std::istreambuf_iterator<char>{source},
+					std::istreambuf_iterator<char>{},
+					4
+				};
+
+				auto lines = foldl(
+					[](size_t n, char c){ return c == '\n' ? n+1 : n; },
+					size_t(0),
+					chars
+				);
+
+				// The source is consumed; a second fold sees nothing
+				auto again = foldl(
+					[](size_t n, char){ return n+1; },
+					size_t(0),
+					chars
+				);
+
+				return lines == 3 && again == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("chunk callback source reads per block"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Produces 1..1000, in whatever block size it is asked for
+				int next = 1;
+				int reads = 0;
+				auto produce = [&next,&reads](int* out, size_t max)
+				-> size_t {
+					++reads;
+
+					size_t i = 0;
+					while(i < max && next <= 1000)
+						out[i++] = next++;
+
+					return i;
+				};
+
+				input_range<int> xs{produce, 256};
+
+				auto total = foldl(
+					[](int z, int x){ return z + x; }, 0, xs
+				);
+
+				// 4 blocks of 250..256 elements, then the empty read
+				return total == 1000*1001/2 && reads == 5;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap and fold accumulate blockwise"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v(100);
+				std::iota(v.begin(), v.end(), 1);
+
+				input_range<int> xs{v.begin(), v.end(), 16};
+
+				auto m = foldMap(sum<int>, xs);
+
+				// Folding the empty source yields the monoid identity
+				input_range<int> empty{
+					[](int*, size_t) -> size_t { return 0; }
+				};
+
+				return static_cast<int>(m) == 5050
+					&& static_cast<int>(foldMap(sum<int>, empty)) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("fmap transforms lazily and streams"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ftl::operator%;
+
+				std::vector<std::string> words{"foo", "quux", "a"};
+
+				int applications = 0;
+				auto len = [&applications](const std::string& s) -> size_t {
+					++applications;
+					return s.size();
+				};
+
+				input_range<std::string> ws{words.begin(), words.end(), 2};
+
+				auto lens = len % std::move(ws);
+
+				// Nothing is read or transformed until consumption
+				if(applications != 0)
+					return false;
+
+				auto total = foldl(
+					[](size_t z, size_t n){ return z + n; },
+					size_t(0),
+					lens
+				);
+
+				return total == 8 && applications == 3;
+			})
+		)
+	}
+};
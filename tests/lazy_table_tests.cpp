@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <stdexcept>
+#include <string>
+#include <ftl/lazy_table.h>
+#include "lazy_table_tests.h"
+
+test_set lazy_table_tests{
+	std::string("lazy_table"),
+	{
+		std::make_tuple(
+			std::string("recursive definition is memoised"),
+			std::function<bool()>([]() -> bool {
+				using table = ftl::lazy_table<int,long long>;
+
+				int evaluations = 0;
+				table fib{[&evaluations](table& self, const int& n)
+						-> long long {
+					++evaluations;
+					return n < 2 ? n : self[n-1] + self[n-2];
+				}};
+
+				auto x = fib[40];
+
+				// Without memoisation this would be ~10^8 evaluations
+				return x == 102334155LL
+					&& evaluations == 41
+					&& fib.size() == 41;
+			})
+		),
+		std::make_tuple(
+			std::string("keys force at most once, on first access"),
+			std::function<bool()>([]() -> bool {
+				using table = ftl::lazy_table<int,int>;
+
+				int evaluations = 0;
+				table t{[&evaluations](table&, const int& n) {
+					++evaluations;
+					return 2*n;
+				}};
+
+				if(t.status(3) != ftl::value_status::deferred)
+					return false;
+
+				auto a = t[3];
+				auto b = t[3];
+
+				return a == 6 && b == 6 && evaluations == 1
+					&& t.status(3) == ftl::value_status::ready
+					&& t.status(4) == ftl::value_status::deferred;
+			})
+		),
+		std::make_tuple(
+			std::string("exceptions revert the key to deferred"),
+			std::function<bool()>([]() -> bool {
+				using table = ftl::lazy_table<int,std::string>;
+
+				int attempts = 0;
+				table t{[&attempts](table&, const int& n) -> std::string {
+					if(++attempts == 1)
+						throw std::runtime_error("transient");
+
+					return std::to_string(n);
+				}};
+
+				try {
+					t[1];
+					return false;
+				}
+				catch(const std::runtime_error&) {}
+
+				return t.status(1) == ftl::value_status::deferred
+					&& t[1] == std::string("1")
+					&& attempts == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("cyclic definitions are detected"),
+			std::function<bool()>([]() -> bool {
+				using table = ftl::lazy_table<int,int>;
+
+				table t{[](table& self, const int& n) {
+					return self[(n + 1) % 2];
+				}};
+
+				try {
+					t[0];
+				}
+				catch(const std::logic_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		)
+	}
+};
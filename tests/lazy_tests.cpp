@@ -20,10 +20,23 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 #include <ftl/lazy.h>
+#include <ftl/vector.h>
 #include "lazy_tests.h"
 
+namespace {
+	int dc_evals = 0;
+
+	int dcTwice(int x) {
+		++dc_evals;
+		return 2*x;
+	}
+}
+
 test_set lazy_tests{
 	std::string("lazy"),
 	{
@@ -176,6 +189,45 @@ test_set lazy_tests{
 				return *l == 3;
 			})
 		),
+		std::make_tuple(
+			std::string("atomic_lazy: concurrent forcing is once-only"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> invocations{0};
+				ftl::atomic_lazy<int> l{[&invocations]() {
+					++invocations;
+					return 42;
+				}};
+
+				std::vector<std::thread> threads;
+				std::atomic<bool> ok{true};
+				for(int i = 0; i < 8; ++i) {
+					threads.emplace_back([l,&ok]() {
+						if(*l != 42)
+							ok = false;
+					});
+				}
+
+				for(auto& t : threads)
+					t.join();
+
+				return ok && invocations == 1
+					&& l.status() == ftl::value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("atomic_lazy: monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](int x) {
+					return atomic_lazy<float>{[x](){ return float(x)/2.f; }};
+				};
+				auto l1 = applicative<atomic_lazy<int>>::pure(1);
+				auto l2 = l1 >>= f;
+
+				return *l2 == .5f;
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind"),
 			std::function<bool()>([]() -> bool {
@@ -187,6 +239,187 @@ test_set lazy_tests{
 
 				return *l2 == .5f;
 			})
+		),
+		std::make_tuple(
+			std::string("lazyAnd short-circuits"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int forced = 0;
+				lazy<bool> no{[&forced](){ ++forced; return false; }};
+				lazy<bool> expensive{[&forced]() -> bool {
+					++forced;
+					return true;
+				}};
+
+				auto l = lazyAnd(no, expensive);
+
+				// Nothing runs until the combination is forced
+				if(forced != 0)
+					return false;
+
+				return !l && forced == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("lazyOr short-circuits"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int forced = 0;
+				lazy<bool> yes{[&forced](){ ++forced; return true; }};
+				lazy<bool> expensive{[&forced]() -> bool {
+					++forced;
+					return false;
+				}};
+
+				auto l = lazyOr(yes, expensive);
+
+				return l && forced == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("lazyAll and lazyAny stop when decisive"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int forced = 0;
+				auto pred = [&forced](bool b) {
+					return lazy<bool>{[&forced,b](){ ++forced; return b; }};
+				};
+
+				auto all = lazyAll({pred(true), pred(false), pred(true)});
+				auto any = lazyAny({pred(false), pred(true), pred(true)});
+
+				bool allOk = !all && forced == 2;
+
+				forced = 0;
+				bool anyOk = any && forced == 2;
+
+				return allOk && anyOk
+					&& lazyAll(std::vector<lazy<bool>>{})
+					&& !lazyAny(std::vector<lazy<bool>>{});
+			})
+		),
+		std::make_tuple(
+			std::string("deepForce forces nested structures"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int forced = 0;
+				std::vector<lazy<int>> ls;
+				for(int i = 0; i < 4; ++i)
+					ls.emplace_back([i,&forced](){ ++forced; return i; });
+
+				deepForce(ls);
+
+				bool flat = forced == 4
+					&& ls[2].status() == value_status::ready;
+
+				forced = 0;
+				lazy<lazy<int>> ll{[&forced]() {
+					return lazy<int>{[&forced](){ ++forced; return 7; }};
+				}};
+
+				deepForce(ll);
+
+				return flat && forced == 1
+					&& (*ll).status() == value_status::ready
+					&& **ll == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy from move-only thunk"),
+			std::function<bool()>([]() -> bool {
+				struct owner {
+					std::unique_ptr<int> buf;
+					int operator()() const { return *buf; }
+				};
+
+				ftl::lazy<int> l{ftl::unique_function<int()>{
+					owner{std::unique_ptr<int>(new int(42))}
+				}};
+
+				return *l == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("tailRecM trampolines the thunk chain"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int steps = 0;
+				auto l = tailRecM(
+					[&steps](int n) -> lazy<either<int,int>> {
+						return lazy<either<int,int>>{[&steps,n]() {
+							++steps;
+							return n < 1000000
+								? make_left<int>(n+1)
+								: make_right<int>(n);
+						}};
+					},
+					0
+				);
+
+				// Still deferred; nothing has run
+				if(steps != 0 || l.status() != value_status::deferred)
+					return false;
+
+				// A chain of binds this deep would overflow on force
+				return *l == 1000000 && steps == 1000001;
+			})
+		),
+		std::make_tuple(
+			std::string("defer_cache shares equal thunks"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				dc_evals = 0;
+
+				defer_cache cache;
+
+				auto l1 = cache.defer(dcTwice, 21);
+				auto l2 = cache.defer(dcTwice, 21);
+				auto l3 = cache.defer(dcTwice, 4);
+
+				bool deferred = dc_evals == 0
+					&& l2.status() == value_status::deferred;
+
+				// Forcing l1 forces the shared cell
+				bool shared = *l1 == 42 && *l2 == 42 && dc_evals == 1
+					&& l2.status() == value_status::ready;
+
+				return deferred && shared
+					&& *l3 == 8 && dc_evals == 2
+					&& cache.size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("defer_cache distinguishes functions and clears"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				defer_cache cache;
+
+				auto dbl = [](int x) { return 2*x; };
+				auto sqr = [](int x) { return x*x; };
+
+				auto l1 = cache.defer(dbl, 3);
+				auto l2 = cache.defer(sqr, 3);
+
+				// Same arguments, different functions: separate cells
+				bool distinct = *l1 == 6 && *l2 == 9 && cache.size() == 2;
+
+				cache.clear();
+
+				// Previously returned cells outlive the cache entries
+				auto l3 = cache.defer(dbl, 3);
+				bool fresh = l3.status() == value_status::deferred
+					&& l1.status() == value_status::ready
+					&& *l3 == 6;
+
+				return distinct && fresh;
+			})
 		)
 	}
 };
@@ -113,6 +113,60 @@ test_set lazyt_tests{
 
 				return ***b == 6;
 			})
+		),
+		std::make_tuple(
+			std::string("fused map chain"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using lazyM = lazyT<maybe<int>>;
+
+				lazyM a = aPure<lazyM>()(3);
+
+				auto r = (
+					[](int x){ return x + 1; }
+					% ([](int x){ return 2*x; } % fuse(a))
+				).unfuse();
+
+				return ***r == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("fusion stays lazy"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using lazyM = lazyT<maybe<int>>;
+
+				lazyM a = aPure<lazyM>()(3);
+
+				int runs = 0;
+				auto r = (
+					[&runs](int x){ ++runs; return x + 1; }
+					% ([&runs](int x){ ++runs; return 3*x; } % fuse(a))
+				).unfuse();
+
+				// Nothing runs until the combined thunk is forced
+				bool lazy_enough = runs == 0;
+				bool correct = ***r == 10;
+
+				return lazy_enough && correct && runs == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("fused bind collapses maps"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using lazyM = lazyT<maybe<int>>;
+
+				lazyM a = aPure<lazyM>()(3);
+
+				auto b =
+					([](int x){ return x + 1; } % fuse(a))
+					>>= [](int x) {
+						return aPure<maybe<int>>()(x*2);
+					};
+
+				return ***b == 8;
+			})
 		)
 	}
 };
@@ -309,6 +309,23 @@ test_set list_tests{
 				return l3 == std::list<int>{};
 			})
 		),
+		std::make_tuple(
+			std::string("zippable::zipWith[n-way]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::list<int> l1{1,2,3};
+				std::list<int> l2{10,20,30};
+				std::list<int> l3{100,200,300,400};
+
+				auto r = ftl::zipWith(
+					[](int x, int y, int z){ return x + y + z; },
+					l1, l2, l3
+				);
+
+				return r == std::list<int>{111,222,333};
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zip[3,3]"),
 			std::function<bool()>([]() -> bool {
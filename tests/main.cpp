@@ -25,21 +25,36 @@
 #include "either_tests.h"
 #include "maybe_tests.h"
 #include "future_tests.h"
+#include "thread_pool_tests.h"
 #include "lazy_tests.h"
+#include "lazy_table_tests.h"
 #include "ord_tests.h"
 #include "functional_tests.h"
 #include "prelude_tests.h"
+#include "view_tests.h"
+#include "arena_tests.h"
+#include "par_tests.h"
+#include "chunked_list_tests.h"
+#include "pvector_tests.h"
+#include "pmap_tests.h"
+#include "stream_tests.h"
+#include "sum_vector_tests.h"
+#include "maybe_vector_tests.h"
+#include "mapped_range_tests.h"
+#include "input_range_tests.h"
 #include "maybet_tests.h"
 #include "eithert_tests.h"
 #include "lazyt_tests.h"
 #include "list_tests.h"
 #include "vector_tests.h"
+#include "small_vector_tests.h"
 #include "fwdlist_tests.h"
 #include "tuple_tests.h"
 #include "memory_tests.h"
 #include "string_tests.h"
 #include "set_tests.h"
 #include "map_tests.h"
+#include "flat_map_tests.h"
 #include "unordered_map_tests.h"
 #include "concept_tests.h"
 
@@ -89,18 +104,33 @@ int main(int, char**) {
 	flawless &= run_test_set(maybe_tests, std::cout);
 	flawless &= run_test_set(maybet_tests, std::cout);
 	flawless &= run_test_set(future_tests, std::cout);
+	flawless &= run_test_set(thread_pool_tests, std::cout);
 	flawless &= run_test_set(lazy_tests, std::cout);
 	flawless &= run_test_set(lazyt_tests, std::cout);
+	flawless &= run_test_set(lazy_table_tests, std::cout);
 	flawless &= run_test_set(ord_tests, std::cout);
 	flawless &= run_test_set(functional_tests, std::cout);
 	flawless &= run_test_set(list_tests, std::cout);
 	flawless &= run_test_set(vector_tests, std::cout);
+	flawless &= run_test_set(small_vector_tests, std::cout);
 	flawless &= run_test_set(fwdlist_tests, std::cout);
+	flawless &= run_test_set(view_tests, std::cout);
+	flawless &= run_test_set(arena_tests, std::cout);
+	flawless &= run_test_set(par_tests, std::cout);
+	flawless &= run_test_set(chunked_list_tests, std::cout);
+	flawless &= run_test_set(pvector_tests, std::cout);
+	flawless &= run_test_set(pmap_tests, std::cout);
+	flawless &= run_test_set(stream_tests, std::cout);
+	flawless &= run_test_set(sum_vector_tests, std::cout);
+	flawless &= run_test_set(maybe_vector_tests, std::cout);
+	flawless &= run_test_set(mapped_range_tests, std::cout);
+	flawless &= run_test_set(input_range_tests, std::cout);
 	flawless &= run_test_set(tuple_tests, std::cout);
 	flawless &= run_test_set(memory_tests, std::cout);
 	flawless &= run_test_set(string_tests, std::cout);
 	flawless &= run_test_set(set_tests, std::cout);
 	flawless &= run_test_set(map_tests, std::cout);
+	flawless &= run_test_set(flat_map_tests, std::cout);
 	flawless &= run_test_set(unordered_map_tests, std::cout);
 	flawless &= run_test_set(concept_tests, std::cout);
 
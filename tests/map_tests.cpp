@@ -114,6 +114,43 @@ test_set map_tests{
 
 				return fold(m) == 24;
 			})
+		),
+		std::make_tuple(
+			std::string("foldl over many nodes"),
+			std::function<bool()>([]() -> bool {
+				std::map<int,long> m;
+				long expect = 0;
+				for(int i = 0; i < 1000; ++i) {
+					m[i] = 2*i;
+					expect += 2*i;
+				}
+
+				auto f = [](long z, long x){ return z + x; };
+
+				// Exercises the prefetching loop well past its lookahead
+				return ftl::foldl(f, 0L, m) == expect;
+			})
+		),
+		std::make_tuple(
+			std::string("snapshot & foldSnapshot"),
+			std::function<bool()>([]() -> bool {
+				using std::make_pair;
+
+				std::map<int,int> m{
+					make_pair(0, 1),
+					make_pair(1, 2),
+					make_pair(2, 3)
+				};
+
+				auto f = [](int z, int x){ return z + x; };
+
+				// The snapshot holds the values in fold order and is an
+				// ordinary, reusable vector
+				auto s = ftl::snapshot(m);
+
+				return s == std::vector<int>{1,2,3}
+					&& ftl::foldSnapshot(f, 0, m) == ftl::foldl(f, 0, m);
+			})
 		)
 	}
 };
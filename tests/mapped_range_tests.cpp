@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <cstdio>
+#include <ftl/mapped_range.h>
+#include "mapped_range_tests.h"
+
+namespace {
+	/* Writes the given elements as raw binary and removes the file again
+	 * when destroyed, so each test can set up its own input.
+	 */
+	struct scoped_data_file {
+		template<typename T>
+		scoped_data_file(const char* p, const std::vector<T>& v) : path(p) {
+			std::FILE* f = std::fopen(p, "wb");
+			if(f) {
+				if(!v.empty())
+					std::fwrite(v.data(), sizeof(T), v.size(), f);
+
+				std::fclose(f);
+			}
+		}
+
+		~scoped_data_file() {
+			std::remove(path);
+		}
+
+		const char* path;
+	};
+}
+
+test_set mapped_range_tests{
+	std::string("mapped_range"),
+	{
+		std::make_tuple(
+			std::string("mapping & iteration"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<double> data;
+				for(int i = 0; i < 1000; ++i)
+					data.push_back(.25*i);
+
+				scoped_data_file file{"mapped_range_test.bin", data};
+
+				mapped_range<double> r{file.path};
+
+				bool ok = r.size() == data.size() && !r.empty();
+				size_t i = 0;
+				for(auto x : r)
+					ok = ok && x == data[i++];
+
+				return ok && i == data.size();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> data{1,2,3,4,5};
+				scoped_data_file file{"mapped_range_test.bin", data};
+
+				mapped_range<int> r{file.path};
+
+				auto s = foldl([](int x, int y){ return x+y; }, 0, r);
+
+				return s == 15;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> data{1,2,3};
+				scoped_data_file file{"mapped_range_test.bin", data};
+
+				mapped_range<int> r{file.path};
+
+				auto s = foldr(
+					[](int x, std::string s){
+						return s + std::to_string(x);
+					},
+					std::string(""), r
+				);
+
+				// foldr combines right to left
+				return s == "321";
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldMap"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<double> data;
+				double expect = 0;
+				for(int i = 0; i < 500; ++i) {
+					data.push_back(.5*i);
+					expect += .5*i;
+				}
+
+				scoped_data_file file{"mapped_range_test.bin", data};
+
+				mapped_range<double> r{file.path};
+
+				auto s = foldMap([](double x){ return sum(x); }, r);
+
+				return static_cast<double>(s) == expect;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> data{1,2,3,4};
+				scoped_data_file file{"mapped_range_test.bin", data};
+
+				mapped_range<int> r{file.path};
+				std::vector<int> v{10,20,30};
+
+				auto z = zipWith(
+					[](int x, int y){ return x+y; }, r, v
+				);
+
+				return z == std::vector<int>{11,22,33};
+			})
+		),
+		std::make_tuple(
+			std::string("empty & missing files"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				scoped_data_file file{
+					"mapped_range_test.bin", std::vector<int>{}
+				};
+
+				mapped_range<int> r{file.path};
+
+				bool threw = false;
+				try {
+					mapped_range<int> missing{"mapped_range_no_such_file"};
+				}
+				catch(const std::system_error&) {
+					threw = true;
+				}
+
+				return r.empty() && r.size() == 0
+					&& foldl([](int x, int y){ return x+y; }, 0, r) == 0
+					&& threw;
+			})
+		),
+	}
+};
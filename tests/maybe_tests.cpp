@@ -20,12 +20,52 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <cstdint>
+#include <ftl/either.h>
 #include <ftl/maybe.h>
+#include <ftl/vector.h>
 #include "maybe_tests.h"
 
 test_set maybe_tests{
 	std::string("maybe"),
 	{
+		std::make_tuple(
+			std::string("Niche: maybe<T*> is pointer sized"),
+			std::function<bool()>([]() -> bool {
+
+				return sizeof(ftl::maybe<int*>) == sizeof(int*)
+					&& sizeof(ftl::maybe<std::shared_ptr<int>>)
+						== sizeof(std::shared_ptr<int>);
+			})
+		),
+		std::make_tuple(
+			std::string("Niche: pointer value and nothing"),
+			std::function<bool()>([]() -> bool {
+				int x = 42;
+
+				auto m = ftl::value(&x);
+				ftl::maybe<int*> n = ftl::nothing;
+
+				// A null pointer value is indistinguishable from nothing
+				int* null = nullptr;
+				auto m2 = ftl::value(null);
+
+				return m && **m == 42 && !n && !m2;
+			})
+		),
+		std::make_tuple(
+			std::string("Niche: shared_ptr payload"),
+			std::function<bool()>([]() -> bool {
+				auto p = std::make_shared<int>(7);
+
+				ftl::maybe<std::shared_ptr<int>> m{p};
+				auto m2 = m;
+
+				m2 = ftl::nothing;
+
+				return m && **m == 7 && !m2 && p.use_count() == 2;
+			})
+		),
 		std::make_tuple(
 			std::string("Swap [primitive]"),
 			std::function<bool()>([]() -> bool {
@@ -367,6 +407,170 @@ test_set maybe_tests{
 
 				return (a | b) == nothing;
 			})
+		),
+		std::make_tuple(
+			std::string("constexpr construction and access"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static constexpr maybe<int> table[] = {
+					maybe<int>(1),
+					maybe<int>(),
+					maybe<int>(inplace_tag(), 3)
+				};
+
+				static_assert(
+					*table[0] == 1,
+					"dereference must be usable in constant expressions"
+				);
+				static_assert(table[1].isNothing(), "table[1] should be nothing");
+				static_assert(
+					table[0] != table[1],
+					"comparison must be usable in constant expressions"
+				);
+
+				return *table[0] == 1 && !table[1] && *table[2] == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("speculative map agrees with branching map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(
+					maybe_speculation<int>::value,
+					"int payloads should take the speculative path"
+				);
+				static_assert(
+					!maybe_speculation<int*>::value,
+					"niche payloads must not be computed on speculatively"
+				);
+				static_assert(
+					!maybe_speculation<std::string>::value,
+					"non-trivial payloads must take the branching path"
+				);
+
+				auto f = [](int x){ return 3*x + 1; };
+
+				maybe<int> m;
+				auto v = value(2);
+
+				return fmap(f, v) == value(7)
+					&& fmap(f, m) == nothing
+					&& fmap(f, value(4)) == value(13);
+			})
+		),
+		std::make_tuple(
+			std::string("speculative folds agree with branching folds"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto fn = [](int z, int x){ return z + x; };
+
+				maybe<int> m;
+				auto v = value(3);
+
+				return foldl(fn, 7, v) == 10
+					&& foldl(fn, 7, m) == 7
+					&& foldr(fn, 7, v) == 10
+					&& foldr(fn, 7, m) == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("tailRecM iterates on left, aborts on nothing"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto r = tailRecM(
+					[](int n) -> maybe<either<int,int>> {
+						return n < 100000
+							? value(make_left<int>(n+1))
+							: value(make_right<int>(n));
+					},
+					0
+				);
+
+				auto aborted = tailRecM(
+					[](int n) -> maybe<either<int,int>> {
+						return n < 10
+							? value(make_left<int>(n+1))
+							: maybe<either<int,int>>{};
+					},
+					0
+				);
+
+				return r && *r == 100000 && !aborted;
+			})
+		),
+		std::make_tuple(
+			std::string("traverse and sequenceA"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int evals = 0;
+				auto half = [&evals](int x) -> maybe<int> {
+					++evals;
+					return x % 2 == 0 ? value(x/2) : maybe<int>{};
+				};
+
+				std::vector<int> even{2,4,6};
+				std::vector<int> mixed{2,3,4,6};
+
+				auto r1 = traverse(half, even);
+
+				evals = 0;
+				auto r2 = traverse(half, mixed);
+
+				auto s = sequenceA(
+					std::vector<maybe<int>>{value(1), value(2)}
+				);
+
+				return r1 && *r1 == (std::vector<int>{1,2,3})
+					&& !r2 && evals == 2
+					&& s && *s == (std::vector<int>{1,2});
+			})
+		),
+		std::make_tuple(
+			std::string("maybe_aligned and layout introspection"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using L = maybe_layout<maybe<int>>;
+				using LP = maybe_layout<maybe<int*>>;
+				using slot = maybe_aligned<64,int>;
+
+				static_assert(
+					L::payload_offset == 0
+						&& L::payload_size == sizeof(int)
+						&& L::tag_offset == sizeof(int)
+						&& L::tag_size == sizeof(bool),
+					"flag-discriminated layout: payload first, then flag"
+				);
+
+				static_assert(
+					LP::size == sizeof(int*)
+						&& LP::tag_size == 0
+						&& LP::padding == 0,
+					"niche-encoded payloads carry no flag and no padding"
+				);
+
+				static_assert(
+					alignof(slot) == 64
+						&& sizeof(slot) == 64
+						&& maybe_layout<slot>::padding
+							== 64 - sizeof(int) - sizeof(bool),
+					"aligned slots pad out to one cache line"
+				);
+
+				slot s{};
+				bool wasNothing = s.isNothing();
+
+				s = value(10);
+				slot t{value(3)};
+
+				return wasNothing && *s == 10 && *t == 3
+					&& reinterpret_cast<std::uintptr_t>(&s) % 64 == 0;
+			})
 		)
 	}
 };
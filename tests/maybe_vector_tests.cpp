@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/maybe_vector.h>
+#include "maybe_vector_tests.h"
+
+test_set maybe_vector_tests{
+	std::string("maybe_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back & element access"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				maybe_vector<double> v;
+				v.push_back(1.5);
+				v.push_back(nothing);
+				v.push_back(2.5);
+
+				return v.size() == 3 && v.count() == 2
+					&& v.isValueAt(0) && !v.isValueAt(1) && v.isValueAt(2)
+					&& *v[0] == 1.5 && v[1].isNothing() && *v[2] == 2.5;
+			})
+		),
+		std::make_tuple(
+			std::string("round trip through std::vector<maybe>"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<maybe<int>> orig;
+				for(int i = 0; i < 200; ++i) {
+					if(i % 3 == 0)
+						orig.push_back(maybe<int>::nothing());
+					else
+						orig.push_back(value(i));
+				}
+
+				maybe_vector<int> v{orig};
+
+				return v.toMaybes() == orig;
+			})
+		),
+		std::make_tuple(
+			std::string("mapMaybes"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				maybe_vector<int> v;
+				for(int i = 0; i < 100; ++i) {
+					if(i % 7 == 0)
+						v.push_back(nothing);
+					else
+						v.push_back(i);
+				}
+
+				auto r = mapMaybes([](int x){ return 2*x; }, v);
+
+				bool ok = r.size() == v.size() && r.count() == v.count();
+				for(size_t i = 0; i < r.size(); ++i) {
+					ok = ok && r.isValueAt(i) == v.isValueAt(i);
+					if(r.isValueAt(i))
+						ok = ok && *r[i] == 2*(*v[i]);
+				}
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("catMaybes"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Cover a fully set word, a partially set word, and a tail
+				maybe_vector<int> v;
+				std::vector<int> expect;
+				for(int i = 0; i < 150; ++i) {
+					if(i >= 64 && i % 2 == 0) {
+						v.push_back(nothing);
+					}
+					else {
+						v.push_back(i);
+						expect.push_back(i);
+					}
+				}
+
+				return catMaybes(v) == expect;
+			})
+		),
+		std::make_tuple(
+			std::string("sumMaybes"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				maybe_vector<double> v;
+				double expect = 0;
+				for(int i = 0; i < 150; ++i) {
+					if(i >= 64 && i % 2 == 0) {
+						v.push_back(nothing);
+					}
+					else {
+						v.push_back(.5*i);
+						expect += .5*i;
+					}
+				}
+
+				return sumMaybes(v) == expect
+					&& sumMaybes(maybe_vector<double>{}) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("clear"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				maybe_vector<int> v;
+				v.push_back(1);
+				v.push_back(nothing);
+				v.clear();
+
+				return v.empty() && v.count() == 0 && sumMaybes(v) == 0;
+			})
+		),
+	}
+};
@@ -232,6 +232,56 @@ test_set memory_tests{
 
 				return foldr([](int x, int y){ return x+y; }, 1, p) == 1;
 			})
+		),
+		std::make_tuple(
+			std::string("pureWith in monadic chain"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				pool_allocator<int> pool;
+
+				auto r = pureWith(pool, 12)
+					>>= [pool](int x){ return pureWith(pool, x+1); };
+
+				return r && *r == 13;
+			})
+		),
+		std::make_tuple(
+			std::string("pool_allocator recycles blocks"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				pool_allocator<int> pool;
+
+				auto p1 = pureWith(pool, 1);
+				auto addr = static_cast<void*>(p1.get());
+				p1.reset();
+
+				// The freed block goes back on the free list, and the
+				// next allocation of the same size reuses it
+				auto p2 = pureWith(pool, 2);
+
+				return static_cast<void*>(p2.get()) == addr && *p2 == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("mapWith"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				pool_allocator<int> pool;
+
+				auto p = mapWith(
+					pool,
+					[](int x){ return float(x)+.5f; },
+					pureWith(pool, 2)
+				);
+
+				std::shared_ptr<int> n{};
+				auto pn = mapWith(pool, [](int x){ return x+1; }, n);
+
+				return p && *p == 2.5f && !pn;
+			})
 		)
 	}
 };
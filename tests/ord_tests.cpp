@@ -99,6 +99,195 @@ test_set ord_tests{
 					&& (gt ^ lt) == ord::Gt
 					&& (gt ^ eq) == ord::Gt;
 			})
+		),
+		std::make_tuple(
+			std::string("comparingBy and ascBy/descBy"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<std::string> v{"aaaa", "a", "aaa", "aa"};
+				std::sort(
+					v.begin(), v.end(),
+					ftl::ascBy(ftl::comparingBy(&std::string::size))
+				);
+
+				auto sorted = v == std::vector<std::string>{
+					"a", "aa", "aaa", "aaaa"
+				};
+
+				std::sort(
+					v.begin(), v.end(),
+					ftl::descBy(ftl::comparingBy(&std::string::size))
+				);
+
+				return sorted && v == std::vector<std::string>{
+					"aaaa", "aaa", "aa", "a"
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("sortBy"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<int> v{3,-1,2,-2,1,-3};
+
+				auto v2 = ftl::sortBy(
+					ftl::comparingBy([](int x){ return x*x; }), v
+				);
+
+				// Stable: equal keys keep their relative order
+				return v2 == std::vector<int>{-1,1,2,-2,3,-3}
+					&& v == std::vector<int>{3,-1,2,-2,1,-3};
+			})
+		),
+		std::make_tuple(
+			std::string("byKey chains"),
+			std::function<bool()>([]() -> bool {
+				using elem = std::pair<int,std::string>;
+
+				std::vector<elem> v{
+					{2,"b"}, {1,"a"}, {2,"a"}, {1,"b"}
+				};
+
+				// The double reversal cancels out; ascending is a no-op
+				std::sort(
+					v.begin(), v.end(),
+					ftl::byKey([](const elem& e){ return e.first; })
+						.thenBy([](const elem& e){ return e.second; })
+						.descending().descending().ascending()
+				);
+
+				return v == std::vector<elem>{
+					{1,"a"}, {1,"b"}, {2,"a"}, {2,"b"}
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("byKey[method] & descending"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<std::string> v{"aa", "aaaa", "a", "aaa"};
+				std::sort(
+					v.begin(), v.end(),
+					ftl::byKey(&std::string::size).descending()
+				);
+
+				return v == std::vector<std::string>{
+					"aaaa", "aaa", "aa", "a"
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("byComparing interoperates"),
+			std::function<bool()>([]() -> bool {
+				using ftl::ord;
+
+				// Lift an erased comparator into the fluent interface
+				auto c = ftl::byComparing(ftl::getComparator<int>());
+
+				return c(1,2) && !c(2,1)
+					&& c.compare(1,2) == ord::Lt
+					&& c.compare(2,2) == ord::Eq;
+			})
+		),
+		std::make_tuple(
+			std::string("sortBy[comparator]"),
+			std::function<bool()>([]() -> bool {
+				using elem = std::pair<int,int>;
+
+				std::vector<elem> v{{1,0}, {-2,1}, {1,2}, {-1,3}};
+
+				// The overload must use the three-way comparison, not the
+				// bool call operator
+				auto v2 = ftl::sortBy(
+					ftl::byKey([](const elem& e){ return e.first*e.first; })
+						.thenByComparing(
+							ftl::byKey([](const elem& e){ return e.second; })
+								.descending().cmp
+						),
+					v
+				);
+
+				return v2 == std::vector<elem>{
+					{-1,3}, {1,2}, {1,0}, {-2,1}
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn caches keys"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<int> v;
+				for(int i = 0; i < 100; ++i)
+					v.push_back(99 - i);
+
+				int calls = 0;
+				auto v2 = ftl::sortOn(
+					[&calls](int x){ ++calls; return x; }, v
+				);
+
+				for(int i = 0; i < 100; ++i) {
+					if(v2[size_t(i)] != i)
+						return false;
+				}
+
+				// Decorate-sort-undecorate: one key extraction per element
+				return calls == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("compare[tuple] is lexicographic"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using key = std::tuple<int32_t,int32_t,uint64_t>;
+
+				key a{1, 2, 3};
+				key b{1, 2, 4};
+				key c{1, 3, 0};
+				key d{1, 2, 3};
+
+				return compare(a, b) == ord::Lt
+					&& compare(b, a) == ord::Gt
+					&& compare(a, c) == ord::Lt
+					&& compare(c, a) == ord::Gt
+					&& compare(a, d) == ord::Eq;
+			})
+		),
+		std::make_tuple(
+			std::string("compare[tuple] agrees with operator<"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using key = std::tuple<int,char,unsigned>;
+
+				std::vector<key> ks;
+				for(int i = -2; i <= 2; ++i)
+					for(char c = 'a'; c <= 'c'; ++c)
+						for(unsigned u = 0; u <= 2; ++u)
+							ks.emplace_back(i, c, u);
+
+				for(const auto& x : ks) {
+					for(const auto& y : ks) {
+						auto o = compare(x, y);
+						if((o == ord::Lt) != (x < y)
+								|| (o == ord::Eq) != (x == y))
+							return false;
+					}
+				}
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("compare[pair] & getComparator"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using key = std::pair<int,int>;
+
+				auto cmp = getComparator<key>();
+
+				return cmp(key{1,2}, key{1,3}) == ord::Lt
+					&& cmp(key{2,0}, key{1,9}) == ord::Gt
+					&& cmp(key{1,2}, key{1,2}) == ord::Eq;
+			})
 		)
 	}
 };
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <stdexcept>
+#include <ftl/par.h>
+#include "par_tests.h"
+
+test_set par_tests{
+	std::string("par"),
+	{
+		std::make_tuple(
+			std::string("spark forces in the background"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				spark_pool sparks{2};
+
+				auto l = par(sparks, atomic_lazy<int>{
+					function<int()>{[](){ return 42; }}
+				});
+
+				while(l.status() != value_status::ready)
+					std::this_thread::yield();
+
+				return *l == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("sync uses memoized result"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				spark_pool sparks{2};
+
+				auto runs = std::make_shared<std::atomic<int>>(0);
+				auto l = par(sparks, atomic_lazy<int>{
+					function<int()>{[runs](){ ++*runs; return 7; }}
+				});
+
+				// Whoever gets there first computes; the other is a no-op
+				auto r = sync(l);
+
+				return r == 7 && *runs == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("sync without spark evaluates on caller"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				atomic_lazy<int> l{function<int()>{[](){ return 3; }}};
+
+				return sync(l) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("exceptions surface at sync"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				spark_pool sparks{2};
+
+				auto l = par(sparks, atomic_lazy<int>{
+					function<int()>{[]() -> int {
+						throw std::runtime_error("spark");
+					}}
+				});
+
+				try {
+					sync(l);
+				}
+				catch(std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERF_H
+#define FTL_PERF_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/* Timing assertions for the performance gate (perf_main.cpp).
+ *
+ * Unlike benchmarks/, which prints numbers for a human to compare, this
+ * header supports pass/fail budgets that can run unattended. Budgets are
+ * never absolute nanoseconds&mdash;those would be meaningless across
+ * machines&mdash;but multiples of reference costs measured on the same
+ * machine in the same run (see the calibration functions in perf_main.cpp).
+ */
+
+/* As in benchmarks/bench.h: feeding every result to a volatile stops the
+ * compiler from optimizing measured bodies away.
+ */
+static volatile std::uint64_t perf_sink = 0;
+
+/**
+ * Measures the cost of body in ns per call.
+ *
+ * body must return something convertible to uint64_t (its result is fed to
+ * the sink). After a warm-up round, the loop is timed K times and the
+ * median taken, so a descheduling blip in one round cannot fail a budget.
+ */
+template<typename F>
+double perf_measure(std::size_t iterations, F body) {
+	using clock = std::chrono::steady_clock;
+
+	constexpr int K = 7;
+
+	for(std::size_t i = 0; i < iterations/10 + 1; ++i)
+		perf_sink += static_cast<std::uint64_t>(body());
+
+	std::vector<double> samples;
+	samples.reserve(K);
+
+	for(int rep = 0; rep < K; ++rep) {
+		auto t0 = clock::now();
+		for(std::size_t i = 0; i < iterations; ++i)
+			perf_sink += static_cast<std::uint64_t>(body());
+
+		auto t1 = clock::now();
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			t1 - t0
+		).count();
+
+		samples.push_back(static_cast<double>(ns)/iterations);
+	}
+
+	std::sort(samples.begin(), samples.end());
+	return samples[K/2];
+}
+
+/**
+ * Asserts that measured does not exceed budget (both in ns/op).
+ *
+ * Prints one report line either way and returns whether the budget held;
+ * the caller is expected to accumulate failures into the process exit
+ * status.
+ */
+inline bool perf_expect_under(
+		const std::string& name, double measured, double budget) {
+	bool ok = measured <= budget;
+
+	std::printf(
+		"%-40s %9.1f ns/op  budget %9.1f  %s\n",
+		name.c_str(), measured, budget, ok ? "ok" : "FAIL"
+	);
+
+	return ok;
+}
+
+/**
+ * Asserts that measured stays above a throughput floor (both in MB/s).
+ *
+ * The mirror image of perf_expect_under, for budgets naturally expressed
+ * as bulk throughput rather than per-op latency.
+ */
+inline bool perf_expect_over(
+		const std::string& name, double measured, double floor) {
+	bool ok = measured >= floor;
+
+	std::printf(
+		"%-40s %9.1f MB/s   floor  %9.1f  %s\n",
+		name.c_str(), measured, floor, ok ? "ok" : "FAIL"
+	);
+
+	return ok;
+}
+
+#endif
+
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+
+/* The performance gate: budget assertions over FTL's hot primitives.
+ *
+ * ftl_tests checks behavior only; a change that keeps it green can still
+ * slow a primitive down by an order of magnitude. This binary fails (exits
+ * nonzero) when a primitive overruns its budget, so it can gate upgrades
+ * in CI-like settings the same way ftl_tests does.
+ *
+ * Every budget is calibrated against reference costs measured first in the
+ * same run&mdash;a raw indirect call for per-op latencies, a plain
+ * accumulation loop for throughputs&mdash;so the assertions carry across
+ * machines and compilers. The multipliers are deliberately loose (several
+ * times the ratios observed on the author's system): the gate is meant to
+ * catch regressions of kind&mdash;a new allocation, a lost inlining
+ * opportunity&mdash;not single-digit percentages, which remain the job of
+ * benchmarks/.
+ */
+
+#include <numeric>
+#include <vector>
+
+#include <ftl/functional.h>
+#include <ftl/prelude.h>
+#include <ftl/sum_type.h>
+#include <ftl/vector.h>
+
+#include "perf.h"
+
+int add(int x, int y) {
+	return x + y;
+}
+
+/* Cost of an opaque indirect call, the unit all per-op budgets are
+ * expressed in. The volatile pointer stops inlining and constant folding.
+ */
+static double callUnit() {
+	int (* volatile raw)(int,int) = add;
+
+	return perf_measure(10000000, [&]{
+		return raw(1, 2);
+	});
+}
+
+/* Throughput of a plain accumulation loop over 1000 ints, in MB/s; the
+ * ceiling any per-element combinator can aspire to on this machine.
+ */
+static double loopThroughput() {
+	std::vector<int> v(1000);
+	std::iota(v.begin(), v.end(), 0);
+
+	auto perRun = perf_measure(50000, [&]{
+		int s = 0;
+		for(auto x : v)
+			s += x;
+
+		return s;
+	});
+
+	// bytes per nanosecond happens to equal gigabytes per second
+	return 1000. * (v.size() * sizeof(int)) / perRun;
+}
+
+static bool checkFunctionInvoke(double unit) {
+	ftl::function<int(int,int)> ff = add;
+
+	auto m = perf_measure(10000000, [&]{
+		return ff(1, 2);
+	});
+
+	// One virtual-ish dispatch on top of the call itself
+	return perf_expect_under("ftl::function: invoke", m, 8*unit);
+}
+
+static bool checkSumTypeMatch(double unit) {
+	using ftl::sum_type;
+	using ftl::constructor;
+
+	std::vector<sum_type<int,char>> xs;
+	for(int i = 0; i < 256; ++i) {
+		if(i % 2 == 0)
+			xs.emplace_back(constructor<int>(), i);
+		else
+			xs.emplace_back(constructor<char>(), char(i));
+	}
+
+	size_t i = 0;
+	auto m = perf_measure(10000000, [&]{
+		auto& x = xs[i++ & 255];
+		return x.match(
+			[](int n){ return n; },
+			[](char c){ return int(c); }
+		);
+	});
+
+	// Dispatch over an unpredictable discriminant; no call, no allocation
+	return perf_expect_under("sum_type: exhaustive match", m, 8*unit);
+}
+
+static bool checkCurry(double unit) {
+	auto curried = ftl::curry(add);
+
+	auto m = perf_measure(5000000, [&]{
+		return curried(1, 2);
+	});
+
+	return perf_expect_under("curry: saturated application", m, 8*unit);
+}
+
+static bool checkConcatMap(double loop) {
+	std::vector<int> v(1000);
+	std::iota(v.begin(), v.end(), 0);
+
+	auto perRun = perf_measure(20000, [&]{
+		auto v2 = ftl::concatMap(
+			[](int x){ return std::vector<int>{x, -x}; }, v
+		);
+
+		return v2.back();
+	});
+
+	auto mbps = 1000. * (v.size() * sizeof(int)) / perRun;
+
+	// Each element costs a two-element vector; orders of magnitude off
+	// the plain loop, but bounded
+	return perf_expect_over("concatMap: 1000 ints -> 2000", mbps, loop/2000);
+}
+
+static bool checkFmapVector(double loop) {
+	using ftl::operator%;
+
+	std::vector<int> v(1000);
+	std::iota(v.begin(), v.end(), 0);
+
+	auto perRun = perf_measure(50000, [&]{
+		auto v2 = [](int x){ return 2*x; } % v;
+		return v2.back();
+	});
+
+	auto mbps = 1000. * (v.size() * sizeof(int)) / perRun;
+
+	// One output allocation per run; everything else should fuse into
+	// the loop
+	return perf_expect_over("vector: fmap [1000 ints]", mbps, loop/50);
+}
+
+int main(int, char**) {
+	auto unit = callUnit();
+	auto loop = loopThroughput();
+
+	std::printf(
+		"calibration: indirect call %.1f ns, plain loop %.1f MB/s\n\n",
+		unit, loop
+	);
+
+	int failures = 0;
+
+	failures += !checkFunctionInvoke(unit);
+	failures += !checkSumTypeMatch(unit);
+	failures += !checkCurry(unit);
+	failures += !checkFmapVector(loop);
+	failures += !checkConcatMap(loop);
+
+	if(failures > 0)
+		std::printf("\n%d budget(s) exceeded\n", failures);
+
+	return failures;
+}
+
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/pmap.h>
+#include "pmap_tests.h"
+
+// Degenerate hash, to exercise collision handling
+struct bad_hash {
+	size_t operator() (int) const {
+		return 42;
+	}
+};
+
+test_set pmap_tests{
+	std::string("pmap"),
+	{
+		std::make_tuple(
+			std::string("insert and lookup"),
+			std::function<bool()>([]() -> bool {
+				ftl::pmap<int,int> m;
+				for(int i = 0; i < 1000; ++i)
+					m = m.insert(i, 2*i);
+
+				for(int i = 0; i < 1000; ++i) {
+					auto v = m.lookup(i);
+					if(!v || *v != 2*i)
+						return false;
+				}
+
+				return m.size() == 1000 && !m.lookup(1000);
+			})
+		),
+		std::make_tuple(
+			std::string("insert replaces existing key"),
+			std::function<bool()>([]() -> bool {
+				ftl::pmap<std::string,int> m{{"a",1},{"b",2}};
+
+				auto m2 = m.insert("a", 10);
+
+				return m2.size() == 2
+					&& *m2.lookup("a") == 10 && *m.lookup("a") == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("versions share structure"),
+			std::function<bool()>([]() -> bool {
+				ftl::pmap<int,int> m1;
+				for(int i = 0; i < 100; ++i)
+					m1 = m1.insert(i, i);
+
+				auto m2 = m1.insert(100, 100);
+				auto m3 = m2.erase(0);
+
+				return m1.size() == 100 && !m1.lookup(100)
+					&& m2.size() == 101 && *m2.lookup(100) == 100
+					&& m3.size() == 100 && !m3.lookup(0)
+					&& *m2.lookup(0) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("erase"),
+			std::function<bool()>([]() -> bool {
+				ftl::pmap<int,int> m;
+				for(int i = 0; i < 100; ++i)
+					m = m.insert(i, i);
+
+				for(int i = 0; i < 100; i += 2)
+					m = m.erase(i);
+
+				for(int i = 0; i < 100; ++i) {
+					if(bool(m.lookup(i)) != (i % 2 == 1))
+						return false;
+				}
+
+				// Erasing an absent key is a no-op
+				return m.size() == 50 && m.erase(1000) == m;
+			})
+		),
+		std::make_tuple(
+			std::string("full hash collisions"),
+			std::function<bool()>([]() -> bool {
+				ftl::pmap<int,int,bad_hash> m;
+				for(int i = 0; i < 20; ++i)
+					m = m.insert(i, 3*i);
+
+				for(int i = 0; i < 20; ++i) {
+					auto v = m.lookup(i);
+					if(!v || *v != 3*i)
+						return false;
+				}
+
+				auto m2 = m.erase(10);
+
+				return m.size() == 20 && m2.size() == 19 && !m2.lookup(10);
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return float(x)+.5f; };
+				ftl::pmap<std::string,int> m{{"a",1},{"b",2}};
+
+				auto m2 = f % m;
+
+				return m2.size() == 2
+					&& *m2.lookup("a") == 1.5f && *m2.lookup("b") == 2.5f;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::pmap<int,int> m;
+				for(int i = 0; i <= 100; ++i)
+					m = m.insert(i, i);
+
+				auto r = ftl::foldl(
+					[](int acc, int x){ return acc + x; }, 0, m
+				);
+
+				return r == 5050;
+			})
+		),
+		std::make_tuple(
+			std::string("foldl and foldr agree up to reversal"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::pmap<int,char> m;
+				for(int i = 0; i < 26; ++i)
+					m = m.insert(i, char('a'+i));
+
+				auto l = ftl::foldl(
+					[](std::string acc, char c){ return acc + c; },
+					std::string(""), m
+				);
+
+				auto r = ftl::foldr(
+					[](char c, std::string acc){ return acc + c; },
+					std::string(""), m
+				);
+
+				return l == std::string(r.rbegin(), r.rend());
+			})
+		)
+	}
+};
+
@@ -229,6 +229,20 @@ test_set prelude_tests{
 				return h(2,2) == 8.f/3.f;
 			})
 		),
+		std::make_tuple(
+			std::string("compose[static function objects]"),
+			std::function<bool()>([]() -> bool {
+				auto f = [](int x){ return 2*x; };
+				auto g = [](int x){ return x+1; };
+				auto h = [](int x, int y){ return x*y; };
+
+				auto fgh = ftl::compose(f, g, h);
+
+				ftl::function<int(int,int)> erased = fgh;
+
+				return fgh(2,3) == 14 && erased(2,3) == 14;
+			})
+		),
 		std::make_tuple(
 			std::string("flip[function<R,A,B>]"),
 			std::function<bool()>([]() -> bool {
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/pvector.h>
+#include "pvector_tests.h"
+
+test_set pvector_tests{
+	std::string("pvector"),
+	{
+		std::make_tuple(
+			std::string("push_back and indexing across levels"),
+			std::function<bool()>([]() -> bool {
+				ftl::pvector<int> v;
+
+				// Enough to force a two-level trie (32*32 = 1024) plus tail
+				for(int i = 0; i < 1100; ++i)
+					v.push_back(i);
+
+				for(int i = 0; i < 1100; ++i) {
+					if(v[size_t(i)] != i)
+						return false;
+				}
+
+				int expected = 0;
+				for(auto& e : v) {
+					if(e != expected++)
+						return false;
+				}
+
+				return v.size() == 1100 && v.front() == 0 && v.back() == 1099;
+			})
+		),
+		std::make_tuple(
+			std::string("set leaves the original untouched"),
+			std::function<bool()>([]() -> bool {
+				ftl::pvector<int> v1;
+				for(int i = 0; i < 100; ++i)
+					v1.push_back(i);
+
+				auto v2 = v1.set(10, -1);
+				auto v3 = v2.set(99, -2);
+
+				return v1[10] == 10 && v1[99] == 99
+					&& v2[10] == -1 && v2[99] == 99
+					&& v3[10] == -1 && v3[99] == -2;
+			})
+		),
+		std::make_tuple(
+			std::string("copies share structure"),
+			std::function<bool()>([]() -> bool {
+				ftl::pvector<int> v1;
+				for(int i = 0; i < 100; ++i)
+					v1.push_back(i);
+
+				// Many versions, each differing by one element
+				std::vector<ftl::pvector<int>> versions;
+				for(int i = 0; i < 100; ++i)
+					versions.push_back(v1.set(size_t(i), -i));
+
+				for(int i = 0; i < 100; ++i) {
+					if(versions[size_t(i)][size_t(i)] != -i)
+						return false;
+
+					if(i > 0 && versions[size_t(i)][size_t(i-1)] != i-1)
+						return false;
+				}
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::id and append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				auto v1 = ftl::pvector<int>{1,2};
+				auto v2 = ftl::pvector<int>{3,4};
+
+				return ftl::monoid<ftl::pvector<int>>::id().empty()
+					&& (v1 ^ v2) == ftl::pvector<int>{1,2,3,4}
+					&& v1.size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return float(x)+.5f; };
+				auto v = ftl::pvector<int>{1,2,3};
+				auto v2 = f % v;
+
+				return v2 == ftl::pvector<float>{1.5f, 2.5f, 3.5f};
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::pure"),
+			std::function<bool()>([]() -> bool {
+
+				auto v = ftl::applicative<ftl::pvector<int>>::pure(2);
+
+				return v == ftl::pvector<int>{2};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::pvector<int> v{1,2,3};
+
+				auto v2 = v >>= [](int x){
+					return ftl::pvector<int>{x, 2*x};
+				};
+
+				return v2 == ftl::pvector<int>{1,2,2,4,3,6};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::pvector<int> v;
+				for(int i = 0; i <= 100; ++i)
+					v.push_back(i);
+
+				auto r = ftl::foldl(
+					[](int acc, int x){ return acc + x; }, 0, v
+				);
+
+				return r == 5050;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::pvector<std::string> v{"a","b","c"};
+
+				auto r = ftl::foldr(
+					[](const std::string& x, std::string acc){
+						return acc + x;
+					},
+					std::string(""), v
+				);
+
+				return r == "cba";
+			})
+		)
+	}
+};
+
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/small_vector.h>
+#include <ftl/functional.h>
+#include "small_vector_tests.h"
+
+test_set small_vector_tests{
+	std::string("small_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back & iteration"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v;
+				for(int i = 1; i <= 3; ++i)
+					v.push_back(i);
+
+				int sum = 0;
+				for(auto e : v)
+					sum += e;
+
+				return v.size() == 3 && sum == 6 && v.inline_storage();
+			})
+		),
+		std::make_tuple(
+			std::string("spills to heap past N"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v;
+				for(int i = 0; i < 4; ++i)
+					v.push_back(i);
+
+				bool wasInline = v.inline_storage();
+
+				for(int i = 4; i < 64; ++i)
+					v.push_back(i);
+
+				bool allThere = true;
+				for(int i = 0; i < 64; ++i)
+					allThere &= v[i] == i;
+
+				return wasInline && !v.inline_storage() && allThere;
+			})
+		),
+		std::make_tuple(
+			std::string("copy & move"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v{1,2,3};
+
+				auto c = v;
+				auto m = std::move(v);
+
+				ftl::small_vector<int,4> big;
+				for(int i = 0; i < 32; ++i)
+					big.push_back(i);
+
+				auto p = big.data();
+				auto m2 = std::move(big);
+
+				return c == m
+					&& c == ftl::small_vector<int,4>{1,2,3}
+					&& m2.data() == p && m2.size() == 32;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::small_vector<int,4> v{1,2,3};
+
+				auto v2 = [](int x){ return 2*x; } % v;
+
+				return v2 == ftl::small_vector<int,4>{2,4,6}
+					&& v2.inline_storage();
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				ftl::small_vector<ftl::function<int(int)>,4> vf{
+					[](int x){ return x-1; },
+					[](int x){ return x+1; }
+				};
+
+				auto v = vf * ftl::small_vector<int,4>{1,2};
+
+				return v == ftl::small_vector<int,4>{0,1,2,3}
+					&& v.inline_storage();
+			})
+		),
+		std::make_tuple(
+			std::string("monad::pure & bind stay inline"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				auto v = ftl::monad<ftl::small_vector<int,4>>::pure(2);
+
+				auto f = [](int x){
+					return ftl::small_vector<int,4>{x,x+1};
+				};
+
+				auto v2 = v >>= f;
+
+				return v2 == ftl::small_vector<int,4>{2,3}
+					&& v2.inline_storage();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				ftl::small_vector<int,4> v1{1,2};
+				ftl::small_vector<int,4> v2{3,4};
+
+				return (v1 ^ v2) == ftl::small_vector<int,4>{1,2,3,4}
+					&& ftl::monoid<ftl::small_vector<int,4>>::id().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl & foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				small_vector<float,4> v{4.f,5.f,8.f};
+
+				auto fl = [](float x, float y){ return x+y; };
+				auto fr = [](float x, float y){ return x/y; };
+
+				return foldl(fl, 0.f, v) == 17.f
+					&& fequal(foldr(fr, 2.f, v), 3.2f);
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v1{1,2,3};
+				ftl::small_vector<int,4> v2{3,2,1};
+
+				auto v3 = ftl::zipWith(
+					[](int x, int y){ return x*y; }, v1, v2
+				);
+
+				return v3 == ftl::small_vector<int,4>{3,4,3};
+			})
+		),
+		std::make_tuple(
+			std::string("push_back of own element across growth"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<std::string,4> v{
+					"quite a long string, definitely heap allocated",
+					"b", "c", "d"
+				};
+
+				// At capacity: the push reallocates while the argument
+				// still points into the old buffer
+				v.push_back(v[0]);
+				v.emplace_back(v[1]);
+
+				return v.size() == 6
+					&& v[4] == v[0]
+					&& v[5] == "b";
+			})
+		)
+	}
+};
+
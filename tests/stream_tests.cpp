@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include <ftl/stream.h>
+#include "stream_tests.h"
+
+namespace {
+	std::vector<int> collect(const ftl::stream<int>& s) {
+		return ftl::foldl(
+			[](std::vector<int> acc, int x){
+				acc.push_back(x);
+				return acc;
+			},
+			std::vector<int>{}, s
+		);
+	}
+}
+
+test_set stream_tests{
+	std::string("stream"),
+	{
+		std::make_tuple(
+			std::string("iterate and take"),
+			std::function<bool()>([]() -> bool {
+				auto s = ftl::stream<int>::iterate(
+					0, [](int x){ return x+1; }
+				);
+
+				// Well past one chunk
+				auto v = collect(s.take(200));
+
+				for(int i = 0; i < 200; ++i) {
+					if(v[size_t(i)] != i)
+						return false;
+				}
+
+				return v.size() == 200;
+			})
+		),
+		std::make_tuple(
+			std::string("chunked, demand-driven evaluation"),
+			std::function<bool()>([]() -> bool {
+				auto calls = std::make_shared<int>(0);
+				auto s = ftl::stream<int>::iterate(
+					0, [calls](int x){ ++*calls; return x+1; }
+				);
+
+				// Constructing and trimming the stream computes nothing
+				auto t = s.take(10);
+				if(*calls != 0)
+					return false;
+
+				// Consuming forces exactly one chunk's worth of calls
+				auto v = collect(t);
+
+				return v.size() == 10 && v[9] == 9
+					&& *calls == int(ftl::stream<int>::chunk_size);
+			})
+		),
+		std::make_tuple(
+			std::string("memoisation is shared between copies"),
+			std::function<bool()>([]() -> bool {
+				auto calls = std::make_shared<int>(0);
+				auto s1 = ftl::stream<int>::iterate(
+					1, [calls](int x){ ++*calls; return 2*x; }
+				);
+
+				auto s2 = s1;
+				auto v1 = collect(s1.take(5));
+				auto n = *calls;
+				auto v2 = collect(s2.take(5));
+
+				return v1 == v2 && *calls == n;
+			})
+		),
+		std::make_tuple(
+			std::string("unfold"),
+			std::function<bool()>([]() -> bool {
+				// Finite countdown, ending inside the first chunk
+				auto s = ftl::stream<int>::unfold(
+					5,
+					[](int x) -> ftl::maybe<std::pair<int,int>> {
+						if(x == 0)
+							return ftl::maybe<std::pair<int,int>>{};
+
+						return ftl::value(std::make_pair(x, x-1));
+					}
+				);
+
+				return collect(s) == std::vector<int>{5,4,3,2,1};
+			})
+		),
+		std::make_tuple(
+			std::string("takeWhile"),
+			std::function<bool()>([]() -> bool {
+				auto s = ftl::stream<int>::iterate(
+					0, [](int x){ return x+1; }
+				);
+
+				auto v = collect(s.takeWhile([](int x){ return x < 70; }));
+
+				return v.size() == 70 && v[69] == 69;
+			})
+		),
+		std::make_tuple(
+			std::string("head"),
+			std::function<bool()>([]() -> bool {
+				auto s = ftl::stream<int>::iterate(
+					42, [](int x){ return x+1; }
+				);
+
+				return *s.head() == 42
+					&& !ftl::stream<int>{}.head();
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map is lazy"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto s = ftl::stream<int>::iterate(
+					0, [](int x){ return x+1; }
+				);
+
+				// Mapping an infinite stream must return immediately
+				auto s2 = [](int x){ return 2*x; } % s;
+
+				return collect(s2.take(4)) == std::vector<int>{0,2,4,6};
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::pure"),
+			std::function<bool()>([]() -> bool {
+
+				auto s = ftl::applicative<ftl::stream<int>>::pure(2);
+
+				return collect(s) == std::vector<int>{2};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::stream<int> s{1,2,3};
+
+				auto s2 = s >>= [](int x){
+					return ftl::stream<int>{x, 2*x};
+				};
+
+				return collect(s2) == std::vector<int>{1,2,2,4,3,6};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind on infinite source"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				auto s = ftl::stream<int>::iterate(
+					1, [](int x){ return x+1; }
+				);
+
+				auto s2 = s >>= [](int x){
+					return ftl::stream<int>{x, -x};
+				};
+
+				return collect(s2.take(6))
+					== std::vector<int>{1,-1,2,-2,3,-3};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::stream<std::string> s{"a","b","c"};
+
+				auto r = ftl::foldr(
+					[](const std::string& x, std::string acc){
+						return acc + x;
+					},
+					std::string(""), s
+				);
+
+				return r == "cba";
+			})
+		)
+	}
+};
+
@@ -43,6 +43,20 @@ test_set string_tests{
 				return (s1 ^ s2) == std::string("abcd");
 			})
 		),
+		std::make_tuple(
+			std::string("string_builder joins fragments once"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				auto b = ftl::fragment("ab")
+					^ ftl::fragment("cd")
+					^ ftl::fragment("ef");
+
+				return b.str() == std::string("abcdef")
+					&& ftl::monoid<ftl::string_builder<char>>::id().str()
+						== std::string("");
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::append[&,&&]"),
 			std::function<bool()>([]() -> bool {
@@ -75,6 +89,62 @@ test_set string_tests{
 
 				return (std::move(s1) ^ std::move(s2)) == std::string("abcd");
 			})
+		),
+		std::make_tuple(
+			std::string("accumulator::append_to"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(
+					Accumulator<std::string>::value,
+					"string must have an accumulator instance"
+				);
+
+				auto acc = monoid<std::string>::id();
+				appendTo(acc, std::string("ab"));
+				appendTo(acc, std::string("cd"));
+
+				return acc == std::string("abcd");
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto s = std::string("abc");
+				auto r1 = [](char c) -> char { return c + 1; } % s;
+				auto r2 = [](char c){ return int(c); }
+					% std::string("A");
+
+				return r1 == std::string("bcd")
+					&& s == std::string("abc")
+					&& r2 == std::basic_string<int>{65};
+			})
+		),
+		std::make_tuple(
+			std::string("char_table map agrees with per-character map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto caesar = ftl::tabulate([](char c) -> char {
+					return (c >= 'a' && c <= 'z')
+						? 'a' + (c - 'a' + 3) % 26 : c;
+				});
+
+				auto s = std::string("veni vidi vici");
+				auto bulk = caesar % s;
+
+				std::string loop;
+				for(auto c : s)
+					loop.push_back(caesar(c));
+
+				return bulk == loop
+					&& (ftl::toUpperTable() % std::string("Up, up!"))
+						== std::string("UP, UP!")
+					&& (ftl::toLowerTable() % std::string("DoWn"))
+						== std::string("down");
+			})
 		)
 	}
 };
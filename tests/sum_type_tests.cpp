@@ -20,6 +20,8 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <ftl/sum_type.h>
 #include "sum_type_tests.h"
@@ -279,6 +281,254 @@ test_set sum_type_tests{
 				return s1 == 12;
 			})
 		),
+		std::make_tuple(
+			std::string("matchAll [const&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<sum_type<int,std::string>> v;
+				for(int i = 0; i < 10; ++i) {
+					if(i % 3 == 0)
+						v.emplace_back(constructor<std::string>(), "x");
+					else
+						v.emplace_back(constructor<int>(), i);
+				}
+
+				int intSum = 0;
+				std::string cat;
+				matchAll(
+					v,
+					[&intSum](const int& i){ intSum += i; },
+					[&cat](const std::string& s){ cat += s; }
+				);
+
+				// 1+2+4+5+7+8 == 27; indices 0,3,6,9 are strings
+				return intSum == 27 && cat == "xxxx";
+			})
+		),
+		std::make_tuple(
+			std::string("matchAll [&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<sum_type<int,char>> v{
+					sum_type<int,char>{constructor<int>(), 1},
+					sum_type<int,char>{constructor<char>(), 'a'},
+					sum_type<int,char>{constructor<int>(), 2}
+				};
+
+				matchAll(
+					v,
+					[](int& i){ i *= 10; },
+					[](char& c){ ++c; }
+				);
+
+				return get<int>(v[0]) == 10
+					&& get<char>(v[1]) == 'b'
+					&& get<int>(v[2]) == 20;
+			})
+		),
+		std::make_tuple(
+			std::string("matchAll visits each group in order"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct A { int id; };
+				struct B { int id; };
+
+				std::vector<sum_type<A,B>> v{
+					sum_type<A,B>{constructor<B>(), B{0}},
+					sum_type<A,B>{constructor<A>(), A{1}},
+					sum_type<A,B>{constructor<A>(), A{2}},
+					sum_type<A,B>{constructor<B>(), B{3}}
+				};
+
+				std::vector<int> as, bs;
+				matchAll(
+					v,
+					[&as](const A& a){ as.push_back(a.id); },
+					[&bs](const B& b){ bs.push_back(b.id); }
+				);
+
+				return as == std::vector<int>{1,2}
+					&& bs == std::vector<int>{0,3};
+			})
+		),
+		std::make_tuple(
+			std::string("constexpr construction and access"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static constexpr sum_type<int,double> table[] = {
+					sum_type<int,double>{constructor<int>(), 3},
+					sum_type<int,double>{constructor<double>(), .5}
+				};
+
+				static_assert(table[0].is<int>(), "table[0] should be an int");
+				static_assert(
+					get<int>(table[0]) == 3,
+					"get must be usable in constant expressions"
+				);
+				static_assert(
+					get<1>(table[1]) == .5,
+					"get by index must be usable in constant expressions"
+				);
+				static_assert(
+					table[0] != table[1],
+					"comparison must be usable in constant expressions"
+				);
+
+				return get<int>(table[0]) == 3 && table[1].is<double>();
+			})
+		),
+		std::make_tuple(
+			std::string("match[likely_alternative]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_type<int,std::string> x{constructor<int>(), 10};
+				sum_type<int,std::string> y{
+					constructor<std::string>(), "miss"
+				};
+
+				// Hot case taken directly, cold case through the table
+				auto fx = x.match(
+					likely_alternative<0>{},
+					[](int n){ return n; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				auto fy = y.match(
+					likely_alternative<0>{},
+					[](int n){ return n; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				// Mutation through the annotated match
+				x.match(
+					likely_alternative<0>{},
+					[](int& n){ n += 1; },
+					[](std::string&){ }
+				);
+
+				return fx == 10 && fy == 4 && get<int>(x) == 11;
+			})
+		),
+		std::make_tuple(
+			std::string("sum_type_profile reports"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using S = sum_type<int,std::string>;
+
+				S x{constructor<int>(), 1};
+				x.match(
+					[](int){ },
+					[](const std::string&){ }
+				);
+
+				auto cs = sum_type_profile<S>::counts();
+				sum_type_profile<S>::reset();
+
+				// Zero without FTL_PROFILE, counted with it; in both cases
+				// the int alternative is at least as hot as the string one
+				return cs[1] == 0
+					&& sum_type_profile<S>::hottest() == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("fromColumns matches element-wise construction"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using S = sum_type<int,char>;
+
+				const unsigned char tags[]{0, 0, 1, 0, 1, 1, 0};
+				const int ints[]{1, 2, 3, 4};
+				const char chars[]{'a', 'b', 'c'};
+
+				auto v = fromColumns(tags, 7, ints, chars);
+
+				std::vector<S> expected;
+				size_t i = 0, c = 0;
+				for(auto t : tags) {
+					if(t == 0)
+						expected.emplace_back(constructor<int>(), ints[i++]);
+					else
+						expected.emplace_back(constructor<char>(), chars[c++]);
+				}
+
+				auto empty = fromColumns<int,char>(tags, 0, nullptr, nullptr);
+
+				return v.size() == 7
+					&& std::equal(v.begin(), v.end(), expected.begin())
+					&& empty.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("fromColumns with non-trivial alternative and bad tag"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				const unsigned char tags[]{1, 0, 1};
+				const int ints[]{7};
+				const std::string strs[]{"foo", "bar"};
+
+				auto v = fromColumns(tags, 3, ints, strs);
+
+				bool built = get<std::string>(v[0]) == "foo"
+					&& get<int>(v[1]) == 7
+					&& get<std::string>(v[2]) == "bar";
+
+				const unsigned char bad[]{0, 2};
+				try {
+					fromColumns(bad, 2, ints, strs);
+					return false;
+				}
+				catch(const invalid_sum_type_access&) {
+					return built;
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("sum_type_aligned and layout introspection"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using S = sum_type<int,char>;
+				using slot = sum_type_aligned<64,int,char>;
+				using L = sum_type_layout<S>;
+
+				static_assert(
+					L::payload_offset == 0
+						&& L::tag_size == sizeof(size_t)
+						&& L::tag_offset + L::tag_size <= L::size
+						&& L::size == sizeof(S),
+					"payload first, tag word after it"
+				);
+
+				static_assert(
+					alignof(slot) == 64
+						&& sizeof(slot) == 64
+						&& sum_type_layout<slot>::padding
+							== 64 - L::payload_size - L::tag_size,
+					"aligned slots pad out to one cache line"
+				);
+
+				slot x{constructor<int>(), 5};
+				S y{constructor<char>(), 'a'};
+				slot z = y;
+
+				x.match(
+					[](int& n){ n += 1; },
+					[](char&){ }
+				);
+
+				return static_cast<const void*>(&get<int>(x))
+						== static_cast<const void*>(&x)
+					&& get<int>(x) == 6
+					&& z.is<char>()
+					&& reinterpret_cast<std::uintptr_t>(&x) % 64 == 0;
+			})
+		),
 	}
 };
 
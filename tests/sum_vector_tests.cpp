@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/sum_vector.h>
+#include "sum_vector_tests.h"
+
+namespace {
+	struct small {
+		int x;
+	};
+
+	struct large {
+		large() = default;
+		explicit large(int v) : x(v) {}
+
+		int x = 0;
+		char payload[192] = {0};
+	};
+}
+
+test_set sum_vector_tests{
+	std::string("sum_vector"),
+	{
+		std::make_tuple(
+			std::string("emplace_back and sizes"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<small,large> v;
+				v.emplace_back(constructor<small>(), small{1});
+				v.emplace_back(constructor<large>(), 2);
+				v.emplace_back(constructor<small>(), small{3});
+
+				return v.size() == 3
+					&& !v.empty()
+					&& v.count<small>() == 2
+					&& v.count<large>() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("iteration preserves insertion order"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<small,large> v;
+				v.emplace_back(constructor<large>(), 0);
+				v.emplace_back(constructor<small>(), small{1});
+				v.emplace_back(constructor<large>(), 2);
+				v.emplace_back(constructor<small>(), small{3});
+
+				std::vector<int> order;
+				for(auto e : v) {
+					e.match(
+						[&order](const small& s){ order.push_back(s.x); },
+						[&order](const large& l){ order.push_back(l.x); }
+					);
+				}
+
+				return order == std::vector<int>{0,1,2,3};
+			})
+		),
+		std::make_tuple(
+			std::string("match on operator[]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<int,std::string> v;
+				v.push_back(12);
+				v.push_back(std::string("foo"));
+
+				auto s1 = v[0].match(
+					[](const int& x){ return x; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				auto s2 = v[1].match(
+					[](const int& x){ return x; },
+					[](const std::string& s){ return (int)s.size(); }
+				);
+
+				return s1 == 12 && s2 == 3
+					&& v[0].activeIndex() == 0
+					&& v[1].activeIndex() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("matchAll [const&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<small,large> v;
+				for(int i = 0; i < 10; ++i) {
+					if(i % 3 == 0)
+						v.emplace_back(constructor<large>(), i);
+					else
+						v.emplace_back(constructor<small>(), small{i});
+				}
+
+				int smallSum = 0, largeSum = 0;
+				const auto& cv = v;
+				cv.matchAll(
+					[&smallSum](const small& s){ smallSum += s.x; },
+					[&largeSum](const large& l){ largeSum += l.x; }
+				);
+
+				// 0,3,6,9 are large; the rest small
+				return smallSum == 27 && largeSum == 18;
+			})
+		),
+		std::make_tuple(
+			std::string("matchAll [&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<int,std::string> v;
+				v.push_back(1);
+				v.push_back(std::string("a"));
+				v.push_back(2);
+
+				v.matchAll(
+					[](int& x){ x *= 10; },
+					[](std::string& s){ s += "b"; }
+				);
+
+				int sum = 0;
+				std::string cat;
+				v.matchAll(
+					[&sum](const int& x){ sum += x; },
+					[&cat](const std::string& s){ cat += s; }
+				);
+
+				return sum == 30 && cat == "ab";
+			})
+		),
+		std::make_tuple(
+			std::string("clear"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<int,std::string> v;
+				v.push_back(1);
+				v.push_back(std::string("a"));
+
+				v.clear();
+
+				return v.empty()
+					&& v.size() == 0
+					&& v.count<int>() == 0
+					&& v.count<std::string>() == 0;
+			})
+		)
+	}
+};
+
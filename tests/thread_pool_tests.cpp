@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <string>
+#include <ftl/thread_pool.h>
+#include <ftl/vector.h>
+#include "thread_pool_tests.h"
+
+namespace {
+	// Forks the left half at every split; thousands of subtasks at this grain
+	long long forkedSum(ftl::thread_pool& pool, int lo, int hi) {
+		if(hi - lo <= 16) {
+			long long s = 0;
+			for(int i = lo; i < hi; ++i)
+				s += i;
+
+			return s;
+		}
+
+		int mid = lo + (hi - lo)/2;
+
+		auto left = ftl::fork(pool, [&pool,lo,mid]{
+			return forkedSum(pool, lo, mid);
+		});
+		auto right = forkedSum(pool, mid, hi);
+
+		return ftl::join(pool, std::move(left)) + right;
+	}
+}
+
+test_set thread_pool_tests{
+	std::string("thread_pool"),
+	{
+		std::make_tuple(
+			std::string("async"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{2};
+
+				auto t = ftl::async(pool, [](int x){ return x+1; }, 1);
+
+				return t.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply runs operands concurrently"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::thread_pool pool{2};
+				ftl::function<int(int,int)> fn =
+					[](int x, int y){ return x+y; };
+
+				// Each operand waits for the other to start; a serial
+				// apply would never finish.
+				std::atomic<int> started{0};
+				auto op = [&started](int x) {
+					++started;
+					while(started < 2)
+						std::this_thread::yield();
+
+					return x;
+				};
+
+				auto t = fn
+					% ftl::async(pool, op, 1)
+					* ftl::async(pool, op, 2);
+
+				return t.get() == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelFoldMap"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{4};
+
+				std::vector<int> v(10001);
+				int i = 0;
+				for(auto& e : v)
+					e = i++;
+
+				auto s = ftl::parallelFoldMap(pool, ftl::sum<int>, v);
+
+				// 0 + 1 + ... + 10000
+				return static_cast<int>(s) == 50005000;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelFoldMap[empty]"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{2};
+
+				std::vector<int> v;
+
+				auto s = ftl::parallelFoldMap(pool, ftl::sum<int>, v);
+
+				return static_cast<int>(s) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelApply matches sequential apply"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				ftl::thread_pool pool{4};
+
+				std::vector<ftl::function<int(int)>> vf;
+				for(int i = 0; i < 7; ++i)
+					vf.push_back([i](int x){ return x*i; });
+
+				std::vector<int> xs;
+				for(int i = 0; i < 100; ++i)
+					xs.push_back(i);
+
+				auto par = ftl::parallelApply(pool, vf, xs);
+				std::vector<int> seq = vf * xs;
+
+				return par == seq;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelApply[empty]"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{2};
+
+				std::vector<ftl::function<int(int)>> vf{
+					[](int x){ return x; }
+				};
+				std::vector<int> xs;
+
+				return ftl::parallelApply(pool, vf, xs).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("parallelApply[bool results]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				ftl::thread_pool pool{4};
+
+				// bool results land in bit-packed vectors; chunks must
+				// not scribble over each other's words
+				std::vector<ftl::function<bool(int)>> vf;
+				for(int i = 1; i <= 7; ++i)
+					vf.push_back([i](int x){ return x % i == 0; });
+
+				std::vector<int> xs;
+				for(int i = 0; i < 1000; ++i)
+					xs.push_back(i);
+
+				auto par = ftl::parallelApply(pool, vf, xs);
+				std::vector<bool> seq = vf * xs;
+
+				return par == seq;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelMap matches sequential map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::thread_pool pool{4};
+
+				std::vector<int> v(10000);
+				int i = 0;
+				for(auto& e : v)
+					e = i++;
+
+				auto f = [](int x){ return 2*x + 1; };
+
+				auto par = ftl::parallelMap(pool, f, v);
+				std::vector<int> seq = f % v;
+
+				return par == seq;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelMap[sequential fallback]"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{4};
+
+				std::vector<int> v{1,2,3};
+
+				// Below the threshold; runs on the calling thread
+				auto r = ftl::parallelMap(pool, [](int x){ return x*x; }, v);
+
+				return r == std::vector<int>{1,4,9}
+					&& ftl::parallelMap(
+						pool, [](int x){ return x; }, std::vector<int>{}
+					).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("parallelMap[predicate into vector<bool>]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::thread_pool pool{4};
+
+				std::vector<int> v(10000);
+				int i = 0;
+				for(auto& e : v)
+					e = i++;
+
+				auto isPrimeish = [](int x){ return x % 7 == 0; };
+
+				// Force the parallel path despite the cheap predicate
+				auto par = ftl::parallelMap(pool, isPrimeish, v, 1);
+				std::vector<bool> seq = isPrimeish % v;
+
+				return par == seq;
+			})
+		),
+		std::make_tuple(
+			std::string("fork & join from outside the pool"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{2};
+
+				// From a non-worker thread, fork behaves like async and
+				// join like get
+				auto t = ftl::fork(pool, []{ return 42; });
+
+				return ftl::join(pool, std::move(t)) == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("recursive fork/join"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{4};
+
+				auto t = ftl::async(pool, [&pool]{
+					return forkedSum(pool, 0, 100000);
+				});
+
+				// 0 + 1 + ... + 99999
+				return t.get() == 4999950000LL;
+			})
+		),
+		std::make_tuple(
+			std::string("fork/join never deadlocks a lone worker"),
+			std::function<bool()>([]() -> bool {
+
+				// With a single worker, every join must help; a blocking
+				// join would never finish
+				ftl::thread_pool pool{1};
+
+				auto t = ftl::async(pool, [&pool]{
+					return forkedSum(pool, 0, 10000);
+				});
+
+				return t.get() == 49995000LL;
+			})
+		),
+		std::make_tuple(
+			std::string("join propagates exceptions"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{2};
+
+				auto t = ftl::async(pool, [&pool]() -> bool {
+					auto child = ftl::fork(pool, []() -> int {
+						throw std::runtime_error("oops");
+					});
+
+					try {
+						ftl::join(pool, std::move(child));
+					}
+					catch(const std::runtime_error&) {
+						return true;
+					}
+
+					return false;
+				});
+
+				return t.get();
+			})
+		),
+		std::make_tuple(
+			std::string("async propagates exceptions"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{1};
+
+				auto t = ftl::async(pool, []() -> int {
+					throw std::runtime_error("oops");
+				});
+
+				try {
+					t.get();
+				}
+				catch(const std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("parallelDeepForce warms every thunk"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{4};
+
+				std::atomic<int> forced{0};
+				std::vector<ftl::lazy<int>> ls;
+				for(int i = 0; i < 100; ++i) {
+					ls.emplace_back([i,&forced]() {
+						++forced;
+						return 2*i;
+					});
+				}
+
+				ftl::parallelDeepForce(pool, ls);
+
+				if(forced != 100)
+					return false;
+
+				for(int i = 0; i < 100; ++i) {
+					if(ls[i].status() != ftl::value_status::ready
+							|| *ls[i] != 2*i)
+						return false;
+				}
+
+				return forced == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("async_scope joins spawned work on exit"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{4};
+
+				std::atomic<int> done{0};
+				{
+					ftl::async_scope scope;
+					for(int i = 0; i < 16; ++i) {
+						scope.spawn(pool, [&done]() -> int {
+							std::this_thread::sleep_for(
+								std::chrono::milliseconds(1)
+							);
+							return ++done;
+						});
+					}
+
+					// Every spawned task abandoned; ~scope must still
+					// wait for all of them
+				}
+
+				return done == 16;
+			})
+		),
+		std::make_tuple(
+			std::string("async_scope cancellation skips queued work"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::thread_pool pool{1};
+				ftl::async_scope scope;
+
+				std::atomic<bool> started{false};
+				std::atomic<bool> release{false};
+				std::atomic<int> ran{0};
+
+				auto blocker = scope.spawn(
+					pool, [&started,&release]() -> int {
+						started = true;
+						while(!release)
+							std::this_thread::yield();
+
+						return 0;
+					}
+				);
+
+				// The blocker must be occupying the lone worker before
+				// anything else happens
+				while(!started)
+					std::this_thread::yield();
+
+				// Queued behind the blocker
+				auto speculative = scope.spawn(pool, [&ran]{ return ++ran; });
+
+				scope.cancel();
+				release = true;
+
+				blocker.get();
+
+				// Refused before reaching a worker: spawn after cancel
+				auto refused = scope.spawn(pool, [&ran]{ return ++ran; });
+
+				bool speculativeSkipped = false;
+				try {
+					speculative.get();
+				}
+				catch(const ftl::scope_cancelled&) {
+					speculativeSkipped = true;
+				}
+
+				bool refusedSkipped = false;
+				try {
+					refused.get();
+				}
+				catch(const ftl::scope_cancelled&) {
+					refusedSkipped = true;
+				}
+
+				return speculativeSkipped && refusedSkipped && ran == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("async_scope::then checks at bind boundaries"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::async_scope scope;
+
+				int invoked = 0;
+				ftl::task_promise<int> p;
+				auto t = scope.then(
+					p.get_task(),
+					[&invoked](int x){ return ++invoked + x; }
+				);
+
+				// Cancelled before the predecessor completes; the
+				// continuation must be skipped
+				scope.cancel();
+				p.set_value(1);
+
+				try {
+					t.get();
+				}
+				catch(const ftl::scope_cancelled&) {
+					return invoked == 0 && scope.cancelled()
+						&& scope.token().cancelled();
+				}
+
+				return false;
+			})
+		)
+	}
+};
+
@@ -56,6 +56,88 @@ test_set vector_tests{
 				return v == std::vector<int>{4,3,6,5,8,7};
 			})
 		),
+		std::make_tuple(
+			std::string("concatMap allocates the result exactly once"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{1,2,3,4};
+
+				auto v2 = ftl::concatMap(
+					[](int x){
+						return std::vector<int>(x, x);
+					},
+					v
+				);
+
+				return v2 == std::vector<int>{1,2,2,3,3,3,4,4,4,4}
+					&& v2.capacity() == v2.size();
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&] reuses storage"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3,4};
+				auto p = v.data();
+
+				auto v2 = [](int x){ return 2*x; } % std::move(v);
+
+				return v2 == std::vector<int>{2,4,6,8}
+					&& v2.data() == p;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[sum] with remainder chunk"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{1,2,3,4,5,6,7};
+
+				auto s = ftl::foldMap(ftl::sum<int>, v);
+
+				return static_cast<int>(s) == 28;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[min/max] with remainder chunk"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{5,-3,8,1,9,-7,2};
+
+				auto lo = ftl::foldMap(ftl::minOf<int>, v);
+				auto hi = ftl::foldMap(ftl::maxOf<int>, v);
+
+				// Empty folds yield the respective identities
+				std::vector<int> e{};
+				auto lo0 = ftl::foldMap(ftl::minOf<int>, e);
+
+				return static_cast<int>(lo) == -7
+					&& static_cast<int>(hi) == 9
+					&& static_cast<int>(lo0)
+						== std::numeric_limits<int>::max();
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[bitwise monoids]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<unsigned> v{0xff0u, 0x0ffu, 0x3fcu};
+
+				auto a = ftl::foldMap(ftl::bitAnd<unsigned>, v);
+				auto o = ftl::foldMap(ftl::bitOr<unsigned>, v);
+				auto x = ftl::foldMap(ftl::bitXor<unsigned>, v);
+
+				return static_cast<unsigned>(a) == 0x0f0u
+					&& static_cast<unsigned>(o) == 0xfffu
+					&& static_cast<unsigned>(x) == (0xff0u ^ 0x0ffu ^ 0x3fcu);
+			})
+		),
+		std::make_tuple(
+			std::string("fold[prod_monoid]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<ftl::prod_monoid<int>> v{
+					ftl::prod(2), ftl::prod(3), ftl::prod(4)
+				};
+
+				return static_cast<int>(ftl::fold(v)) == 24;
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::id"),
 			std::function<bool()>([]() -> bool {
@@ -166,6 +248,81 @@ test_set vector_tests{
 				return v == std::vector<int>{0,1,2,2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("applicative::apply preallocates"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				std::vector<ftl::function<int(int)>> vf;
+				for(int i = 0; i < 10; ++i)
+					vf.push_back([i](int x){ return x+i; });
+
+				std::vector<int> xs;
+				for(int i = 0; i < 100; ++i)
+					xs.push_back(i);
+
+				std::vector<int> v = vf * xs;
+
+				// One exact reservation, no growth reallocations
+				return v.size() == 1000 && v.capacity() == 1000
+					&& v[0] == 0 && v[999] == 108;
+			})
+		),
+		std::make_tuple(
+			std::string("ap_expr matches eager chain"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int,int)> fn =
+					[](int x, int y, int z){ return 100*x + 10*y + z; };
+
+				std::vector<int> a{1,2};
+				std::vector<int> b{3,4};
+				std::vector<int> c{5,6};
+
+				std::vector<int> eager = fn % a * b * c;
+				std::vector<int> deferred = fn % ap(a) * b * c;
+
+				return deferred == eager;
+			})
+		),
+		std::make_tuple(
+			std::string("ap_expr preallocates"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int)> fn =
+					[](int x, int y){ return x + y; };
+
+				std::vector<int> xs, ys;
+				for(int i = 0; i < 30; ++i)
+					xs.push_back(i);
+				for(int i = 0; i < 40; ++i)
+					ys.push_back(i);
+
+				std::vector<int> v = fn % ap(xs) * ys;
+
+				// One exact reservation, no growth reallocations
+				return v.size() == 1200 && v.capacity() == 1200
+					&& v[0] == 0 && v[1199] == 68;
+			})
+		),
+		std::make_tuple(
+			std::string("ap_expr[empty operand]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int)> fn =
+					[](int x, int y){ return x + y; };
+
+				std::vector<int> xs{1,2,3};
+				std::vector<int> none;
+
+				std::vector<int> v = fn % ap(xs) * none;
+
+				return v.empty();
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind[&,->vector]"),
 			std::function<bool()>([]() -> bool {
@@ -306,6 +463,45 @@ test_set vector_tests{
 				return v3 == std::vector<int>{};
 			})
 		),
+		std::make_tuple(
+			std::string("zippable::zipWith[n-way]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> a{1,2,3};
+				std::vector<int> b{10,20,30};
+				std::vector<int> c{100,200,300};
+				std::vector<int> d{1000,2000,3000};
+
+				auto v = zipWith(
+					[](int x, int y, int z, int w) {
+						return x + y + z + w;
+					},
+					a, b, c, d
+				);
+
+				return v == std::vector<int>{1111,2222,3333};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[n-way, shortest]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> a{1,2,3};
+				std::vector<int> b{10,20};
+				std::vector<float> c{.5f,.5f,.5f};
+
+				auto v = zipWith(
+					[](int x, int y, float z) {
+						return float(x + y)*z;
+					},
+					a, b, c
+				);
+
+				return v == std::vector<float>{5.5f,11.f};
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zip[3,3]"),
 			std::function<bool()>([]() -> bool {
@@ -322,6 +518,44 @@ test_set vector_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("accumulator::append_to"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(
+					Accumulator<std::vector<int>>::value,
+					"vector must have an accumulator instance"
+				);
+
+				auto acc = monoid<std::vector<int>>::id();
+				appendTo(acc, std::vector<int>{1,2});
+				appendTo(acc, std::vector<int>{3});
+
+				// The generic fall-back must still work for monoids
+				// without an instance
+				auto s = sum(0);
+				appendTo(s, sum(5));
+
+				return acc == std::vector<int>{1,2,3}
+					&& static_cast<int>(s) == 5;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap accumulates in place"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1,2,3};
+
+				auto r = foldMap(
+					[](int x){ return std::vector<int>{x, 10*x}; },
+					v
+				);
+
+				return r == std::vector<int>{1,10,2,20,3,30};
+			})
 		)
 	}
 };
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <vector>
+#include <ftl/view.h>
+#include <ftl/vector.h>
+#include "view_tests.h"
+
+test_set view_tests{
+	std::string("view"),
+	{
+		std::make_tuple(
+			std::string("fused map chain folds in one pass"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3,4};
+
+				int calls = 0;
+				auto f = [&calls](int x){ ++calls; return 2*x; };
+				auto g = [](int x){ return x+1; };
+
+				auto sum = ftl::foldl(
+					[](int z, int x){ return z+x; }, 0,
+					g % (f % ftl::view(v))
+				);
+
+				// f runs once per element, despite two map stages
+				return sum == 24 && calls == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("views are lazy until folded"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3};
+
+				auto pipeline = [](int x){ return 10*x; } % ftl::view(v);
+
+				// Mutations after building the pipeline are visible,
+				// proving no intermediate container was materialized
+				v[0] = 5;
+
+				auto sum = ftl::foldl(
+					[](int z, int x){ return z+x; }, 0, pipeline
+				);
+
+				return sum == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("filter"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3,4,5,6};
+
+				auto odd = [](int x){ return x % 2 == 1; };
+
+				auto r = ftl::materialize<std::vector<int>>(
+					[](int x){ return x*x; }
+					% ftl::filter(odd, ftl::view(v))
+				);
+
+				return r == std::vector<int>{1,9,25};
+			})
+		),
+		std::make_tuple(
+			std::string("concatMap traverses inner containers in place"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{1,2,3};
+
+				auto r = ftl::materialize<std::vector<int>>(
+					ftl::concatMap(
+						[](int x){
+							return std::vector<int>{x, -x};
+						},
+						ftl::view(v)
+					)
+				);
+
+				return r == std::vector<int>{1,-1,2,-2,3,-3};
+			})
+		),
+		std::make_tuple(
+			std::string("zipWithView folds without allocating"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> price{3,4,5};
+				std::vector<int> volume{10,20,30,40};
+
+				// Truncates to the shorter operand
+				auto notional = ftl::foldl(
+					[](int z, int x){ return z+x; }, 0,
+					ftl::zipWithView(
+						[](int p, int v){ return p*v; },
+						price, volume
+					)
+				);
+
+				return notional == 3*10 + 4*20 + 5*30;
+			})
+		),
+		std::make_tuple(
+			std::string("zipView"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> xs{1,2,3};
+				std::vector<int> ys{4,5,6};
+
+				auto r = ftl::materialize<std::vector<int>>(
+					[](const std::tuple<int,int>& t){
+						return std::get<0>(t) * std::get<1>(t);
+					}
+					% ftl::zipView(xs, ys)
+				);
+
+				return r == std::vector<int>{4,10,18};
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap and fold"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3};
+
+				auto s = ftl::foldMap(ftl::sum<int>, ftl::view(v));
+
+				auto s2 = ftl::fold(ftl::sum<int> % ftl::view(v));
+
+				return static_cast<int>(s) == 6 && static_cast<int>(s2) == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("span: slice folds without copying"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<int> v{0,1,2,3,4,5,6,7};
+
+				auto window = ftl::slice(v, 2, 4);
+
+				auto sum = ftl::foldl(
+					[](int z, int x){ return z + x; }, 0, window
+				);
+
+				auto diff = ftl::foldr(
+					[](int x, int z){ return x - z; }, 0, window
+				);
+
+				return sum == 14
+					&& diff == 2 - (3 - (4 - 5))
+					&& window.size() == 4
+					&& window.front() == 2 && window.back() == 5
+					&& &window[0] == &v[2];
+			})
+		),
+		std::make_tuple(
+			std::string("span: out of range slices are clamped"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<int> v{1,2,3};
+
+				return ftl::slice(v, 5, 2).empty()
+					&& ftl::slice(v, 1, 100).size() == 2
+					&& ftl::slice(ftl::slice(v, 0, 3), 2, 2).size() == 1
+					&& ftl::span<int>().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("span: functor map materializes"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3,4};
+
+				auto r = [](int x){ return 2*x; } % ftl::slice(v, 1, 2);
+
+				// Lazy alternative: root a view pipeline in the span
+				auto s = ftl::foldl(
+					[](int z, int x){ return z + x; }, 0,
+					[](int x){ return x*x; } % ftl::view(ftl::slice(v, 1, 2))
+				);
+
+				return r == std::vector<int>{4,6} && s == 13;
+			})
+		),
+		std::make_tuple(
+			std::string("span: zipWith materializes"),
+			std::function<bool()>([]() -> bool {
+
+				std::vector<int> xs{1,2,3,4};
+				std::vector<int> ys{10,20,30};
+
+				auto r = ftl::zippable<ftl::span<int>>::zipWith(
+					[](int x, int y){ return x + y; },
+					ftl::slice(xs, 0, 4), ys
+				);
+
+				return r == std::vector<int>{11,22,33};
+			})
+		)
+	}
+};
+